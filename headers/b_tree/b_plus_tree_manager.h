@@ -0,0 +1,56 @@
+#ifndef __B_PLUS_TREE_MANAGER__H__
+#define __B_PLUS_TREE_MANAGER__H__
+
+#include <stdio.h>
+
+#include "bool.h"
+#include "b_tree_header.h"
+#include "b_tree_bulk_loader.h"
+#include "open_mode.h"
+#include "pair.h"
+
+/*
+	Índice em árvore-B+: os pares (chave, valor) ficam apenas nas folhas, que são encadeadas com as vizinhas
+	(anterior e próxima), e os nós internos guardam apenas as chaves separadoras e os ponteiros para os filhos.
+	Sem os valores (Pr), cada página interna comporta mais filhos que um nó da árvore-B do mesmo tamanho, e
+	os percursos em ordem de chave (buscas por intervalo, exportação) seguem as folhas sem voltar aos nós internos.
+	O arquivo usa os mesmos headers, cache de páginas, log e semântica de status da árvore-B (ver b_tree_manager.h),
+	com a versão B_TREE_FORMAT_PLUS, e não pode ser aberto pelo BTreeManager (nem o contrário).
+	Opcionalmente, as páginas são compactadas (B_TREE_FORMAT_PLUS_PACKED): as chaves e os RRNs de cada nó são guardados
+	como diferenças para uma base, com a quantidade mínima de bits, e cada página comporta bem mais itens.
+*/
+
+typedef struct _b_plus_tree_manager BPlusTreeManager;
+typedef struct _b_plus_tree_cursor BPlusTreeCursor;
+
+BPlusTreeManager *b_plus_tree_manager_create(void);
+OPEN_RESULT b_plus_tree_manager_open(BPlusTreeManager *manager, char *bin_filename, OPEN_MODE mode);
+
+bool b_plus_tree_manager_set_page_size(BPlusTreeManager *manager, int page_size);
+int b_plus_tree_manager_order_for_page_size(int page_size);
+bool b_plus_tree_manager_set_packed(BPlusTreeManager *manager, bool packed);
+int b_plus_tree_manager_packed_order_for_page_size(int page_size);
+
+void b_plus_tree_manager_close(BPlusTreeManager *manager);
+void b_plus_tree_manager_free(BPlusTreeManager **manager_ptr);
+
+bool b_plus_tree_manager_insert(BPlusTreeManager *manager, int key, int value);
+pairIntInt b_plus_tree_manager_search_for(BPlusTreeManager *manager, int key);
+bool b_plus_tree_manager_bulk_load(BPlusTreeManager *manager, BTreeBulkLoader *loader);
+
+pairIntInt b_plus_tree_manager_get_cache_stats(BPlusTreeManager *manager);
+BTreeHeader *b_plus_tree_manager_get_headers(BPlusTreeManager *manager);
+
+//Cursor para percorrer as folhas em ordem de chave (buscas por intervalo)
+BPlusTreeCursor *b_plus_tree_cursor_create(BPlusTreeManager *manager);
+void b_plus_tree_cursor_free(BPlusTreeCursor **cursor_ptr);
+bool b_plus_tree_cursor_seek(BPlusTreeCursor *cursor, int key);
+bool b_plus_tree_cursor_seek_first(BPlusTreeCursor *cursor);
+bool b_plus_tree_cursor_seek_last(BPlusTreeCursor *cursor);
+bool b_plus_tree_cursor_next(BPlusTreeCursor *cursor);
+bool b_plus_tree_cursor_prev(BPlusTreeCursor *cursor);
+bool b_plus_tree_cursor_is_valid(BPlusTreeCursor *cursor);
+pairIntInt b_plus_tree_cursor_get(BPlusTreeCursor *cursor);
+int b_plus_tree_cursor_get_pages(BPlusTreeCursor *cursor);
+
+#endif  //!__B_PLUS_TREE_MANAGER__H__
@@ -0,0 +1,21 @@
+#ifndef __B_TREE_BULK_LOADER__H__
+#define __B_TREE_BULK_LOADER__H__
+
+#include "bool.h"
+#include "pair.h"
+
+//Quantidade de pares (chave, valor) ordenados em RAM antes de serem despejados em um arquivo temporário
+#define B_TREE_BULK_LOAD_RUN_CAPACITY (1 << 20)
+
+typedef struct _b_tree_bulk_loader BTreeBulkLoader;
+
+BTreeBulkLoader *b_tree_bulk_loader_create(int run_capacity);
+void b_tree_bulk_loader_free(BTreeBulkLoader **loader_ptr);
+
+bool b_tree_bulk_loader_add(BTreeBulkLoader *loader, int key, int value);
+bool b_tree_bulk_loader_finish(BTreeBulkLoader *loader);
+
+int b_tree_bulk_loader_get_count(BTreeBulkLoader *loader);
+bool b_tree_bulk_loader_next(BTreeBulkLoader *loader, pairIntInt *pair);
+
+#endif  //!__B_TREE_BULK_LOADER__H__
@@ -6,16 +6,21 @@
 #include "bool.h"
 #include "b_tree_header.h"
 #include "b_tree_node.h"
+#include "b_tree_bulk_loader.h"
 #include "open_mode.h"
 #include "pair.h"
 
 
 typedef struct _insert_answer insert_answer;
 typedef struct _b_tree_manager BTreeManager;
+typedef struct _b_tree_cursor BTreeCursor;
 
 BTreeManager *b_tree_manager_create(void);
 bool b_tree_manager_open(BTreeManager *manager, char* bin_filename, OPEN_MODE mode);
 
+bool b_tree_manager_set_format(BTreeManager *manager, int order, int page_size);
+int b_tree_manager_order_for_page_size(int page_size);
+
 void b_tree_manager_write_headers_to_disk(BTreeManager *manager);
 void b_tree_manager_read_headers_from_disk(BTreeManager *manager);
 
@@ -23,8 +28,30 @@ void b_tree_manager_close(BTreeManager *manager);
 void b_tree_manager_free(BTreeManager **manager_ptr);
 
 void b_tree_manager_insert(BTreeManager *manager, int key, int value);
+int b_tree_manager_insert_batch(BTreeManager *manager, pairIntInt *items, int count);
+bool b_tree_manager_delete(BTreeManager *manager, int key);
 pairIntInt b_tree_manager_search_for (BTreeManager *manager, int key);
-
+bool b_tree_manager_bulk_load(BTreeManager *manager, BTreeBulkLoader *loader);
+
+pairIntInt b_tree_manager_get_cache_stats(BTreeManager *manager);
+
+//Função de mapeamento usada na reescrita dos valores (Pr) do índice: recebe um valor e retorna o novo valor
+typedef int (*BTreeValueMapFunc)(int value, void *context);
+
+bool b_tree_manager_rewrite_values(BTreeManager *manager, char *new_filename, BTreeValueMapFunc map_func, void *context);
+bool b_tree_manager_mark_file_consistent(char *bin_filename);
+
+//Cursor para percorrer a árvore em ordem de chave (buscas por intervalo)
+BTreeCursor *b_tree_cursor_create(BTreeManager *manager);
+void b_tree_cursor_free(BTreeCursor **cursor_ptr);
+bool b_tree_cursor_seek(BTreeCursor *cursor, int key);
+bool b_tree_cursor_seek_first(BTreeCursor *cursor);
+bool b_tree_cursor_seek_last(BTreeCursor *cursor);
+bool b_tree_cursor_next(BTreeCursor *cursor);
+bool b_tree_cursor_prev(BTreeCursor *cursor);
+bool b_tree_cursor_is_valid(BTreeCursor *cursor);
+pairIntInt b_tree_cursor_get(BTreeCursor *cursor);
+int b_tree_cursor_get_pages(BTreeCursor *cursor);
 
 BTreeHeader *b_tree_manager_get_headers(BTreeManager *man);
 
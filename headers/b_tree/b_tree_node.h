@@ -3,12 +3,36 @@
 
 #include "bool.h"
 
+//Ordem e tamanho dos nós do formato original do arquivo de índices (usados por padrão)
 #define B_TREE_ORDER 6
+#define NODE_SIZE 72
+
+//Limites de ordem aceitos para arquivos com formato configurável
+#define B_TREE_MIN_ORDER 3
+#define B_TREE_MAX_ORDER 1024
+
+//Bytes ocupados pelos campos de um nó de uma dada ordem: nivel, n, (order-1) pares (C, Pr) e order pointers P
+#define B_TREE_NODE_SIZE(order) (12 * (order))
+
+//Bytes ocupados por um nó de árvore-B+ de uma dada ordem: o maior entre a folha (nivel, n, anterior, próxima e (order-1) pares (C, Pr))
+//e o nó interno (nivel, n, (order-1) chaves C e order pointers P)
+#define B_PLUS_TREE_NODE_SIZE(order) (8 * ((order) + 1))
+
+//Bytes do cabeçalho de uma página compactada de árvore-B+: folha (nivel, n, anterior, próxima, bases e larguras em bits)
+//e nó interno (nivel, n, bases e larguras em bits)
+#define B_PLUS_TREE_PACKED_LEAF_HEADER_SIZE (6 * 4 + 2)
+#define B_PLUS_TREE_PACKED_INTERNAL_HEADER_SIZE (4 * 4 + 2)
+
+//Tamanho mínimo da página compactada para uma dada ordem: metade de um nó cheio deve caber mesmo sem compressão
+//(8 bytes por item), para que a divisão de um nó que não cabe mais na página sempre produza dois nós que cabem
+#define B_PLUS_TREE_PACKED_NODE_SIZE(order) (B_PLUS_TREE_PACKED_LEAF_HEADER_SIZE + 8 * (((order) + 1) / 2))
 
 typedef struct _b_tree_node BTreeNode;
 
 BTreeNode* b_tree_node_create (int nivel);
+BTreeNode* b_tree_node_create_with_order (int nivel, int order);
 void b_tree_node_free (BTreeNode *node);
+void b_tree_node_copy (BTreeNode *dest, BTreeNode *src);
 
 int b_tree_node_sorted_insert_item (BTreeNode *node, int C, int Pr);
 void b_tree_node_set_item (BTreeNode *node, int C, int Pr, int position);
@@ -17,6 +41,7 @@ void b_tree_node_set_P (BTreeNode *node, int P, int position);
 void b_tree_node_set_nivel (BTreeNode *node, int nivel);
 
 int b_tree_node_get_n (BTreeNode *node);
+int b_tree_node_get_order (BTreeNode *node);
 int b_tree_node_get_nivel (BTreeNode *node);
 int b_tree_node_get_C (BTreeNode *node, int position);
 int b_tree_node_get_Pr (BTreeNode *node, int position);
@@ -25,6 +50,7 @@ int b_tree_node_get_P (BTreeNode *node, int position);
 void b_tree_node_remove_item (BTreeNode *node, int position);
 void b_tree_node_remove_P (BTreeNode *node, int position);
 
+int b_tree_node_search (BTreeNode *node, int key, bool *found);
 int b_tree_node_get_RRN_that_fits (BTreeNode *node, int key);
 
 BTreeNode *b_tree_node_split_one_to_two(BTreeNode *parent, int C, int Pr, int P);
@@ -0,0 +1,32 @@
+#ifndef __B_TREE_PAGE_CACHE__H__
+#define __B_TREE_PAGE_CACHE__H__
+
+#include <stdio.h>
+
+#include "bool.h"
+#include "b_tree_node.h"
+#include "pair.h"
+
+//Quantidade padrão de páginas (nós) mantidas em RAM pelo BTreeManager
+#define B_TREE_PAGE_CACHE_CAPACITY 64
+
+typedef struct _b_tree_page_cache BTreePageCache;
+
+//Funções de leitura e escrita das páginas (por padrão, binary_read_b_tree_node() e binary_write_b_tree_node())
+typedef BTreeNode *(*BTreePageReadFunc)(FILE *file_ptr, int order, int page_size);
+typedef void (*BTreePageWriteFunc)(FILE *file_ptr, BTreeNode *node, int page_size);
+
+BTreePageCache *b_tree_page_cache_create(FILE *bin_file, int order, int page_size, int capacity);
+BTreePageCache *b_tree_page_cache_create_with_codec(FILE *bin_file, int order, int page_size, int capacity,
+    BTreePageReadFunc read_func, BTreePageWriteFunc write_func);
+void b_tree_page_cache_free(BTreePageCache **cache_ptr);
+
+BTreeNode *b_tree_page_cache_fetch(BTreePageCache *cache, int RRN);
+void b_tree_page_cache_put(BTreePageCache *cache, int RRN, BTreeNode *node);
+void b_tree_page_cache_unpin(BTreePageCache *cache, BTreeNode *node);
+
+void b_tree_page_cache_flush(BTreePageCache *cache);
+
+pairIntInt b_tree_page_cache_get_stats(BTreePageCache *cache);
+
+#endif  //!__B_TREE_PAGE_CACHE__H__
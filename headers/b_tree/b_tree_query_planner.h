@@ -0,0 +1,21 @@
+#ifndef __B_TREE_QUERY_PLANNER__H__
+#define __B_TREE_QUERY_PLANNER__H__
+
+#include "registry_array.h"
+#include "registry_manager.h"
+#include "b_tree_secondary_index.h"
+
+/*
+    Planejador de consultas das funcionalidades de busca e remoção: para cada filtro de um vetor de filtros,
+    escolhe um campo com índice (ver b_tree_secondary_index.h) e obtém dele os RRNs candidatos. Os candidatos
+    de todos os filtros são unidos (sem repetições) e devem ser comparados com o vetor de filtros completo.
+    Se algum filtro não tiver índice utilizável, os candidatos são obtidos da cópia colunar do arquivo, se ela existir
+    (ver registry_column_store.h). Sem ela, ou se os candidatos forem muitos, a varredura completa é indicada.
+*/
+
+//Acima de 1/B_TREE_QUERY_PLANNER_SCAN_FRACTION dos registros como candidatos, a varredura sequencial é mais barata
+#define B_TREE_QUERY_PLANNER_SCAN_FRACTION 4
+
+int b_tree_query_planner_candidates(BTreeSecondaryIndexSet *indexes, RegistryManager *registry_manager, VirtualRegistryArray *filters, int **RRNs_ptr, int *pages_ptr);
+
+#endif  //!__B_TREE_QUERY_PLANNER__H__
@@ -0,0 +1,45 @@
+#ifndef __B_TREE_SECONDARY_INDEX__H__
+#define __B_TREE_SECONDARY_INDEX__H__
+
+#include "bool.h"
+#include "open_mode.h"
+#include "registry.h"
+#include "registry_mask.h"
+#include "registry_view.h"
+#include "registry_manager.h"
+
+/*
+    Índices secundários: uma árvore-B por campo do registro, guardada ao lado do arquivo de registros ("dados.bin" -> "dados.bin.estadoMae.idx" e "dados.bin.estadoMae.post").
+    Como vários registros podem ter o mesmo valor, a árvore guarda cada chave uma única vez e o seu valor (Pr)
+    aponta para uma lista de RRNs (posting list) em blocos encadeados no arquivo ".post".
+    As chaves de strings são prefixos (os primeiros bytes, preservando a ordem), portanto registros diferentes
+    podem ter a mesma chave: os RRNs obtidos são candidatos, que devem ser comparados com o filtro completo.
+*/
+
+#define B_TREE_SECONDARY_INDEX_SUFFIX ".idx"
+#define B_TREE_POSTINGS_SUFFIX ".post"
+
+//Tamanho de cada bloco do arquivo de posting lists e quantidade de RRNs por bloco (próximo bloco, quantidade e RRNs)
+#define B_TREE_POSTINGS_BLOCK_SIZE 64
+#define B_TREE_POSTINGS_BLOCK_RRNS ((B_TREE_POSTINGS_BLOCK_SIZE - 2 * (int) sizeof(int)) / (int) sizeof(int))
+
+typedef struct _b_tree_secondary_index BTreeSecondaryIndex;
+typedef struct _b_tree_secondary_index_set BTreeSecondaryIndexSet;
+
+bool b_tree_secondary_index_is_supported(RegistryFieldsMask field);
+int b_tree_secondary_index_key_of_view(RegistryFieldsMask field, RegistryView view);
+int b_tree_secondary_index_key_of_filter(RegistryFieldsMask field, VirtualRegistryFilter *filter);
+
+char *b_tree_secondary_index_filename(char *reg_filename, RegistryFieldsMask field);
+bool b_tree_secondary_index_build(char *reg_filename, RegistryManager *registry_manager, RegistryFieldsMask field);
+void b_tree_secondary_index_drop(char *reg_filename, RegistryFieldsMask field);
+void b_tree_secondary_index_drop_all(char *reg_filename);
+RegistryFieldsMask b_tree_secondary_index_list(char *reg_filename);
+
+int b_tree_secondary_index_search(BTreeSecondaryIndex *index, int key, int **RRNs_ptr, int *pages_ptr);
+
+BTreeSecondaryIndexSet *b_tree_secondary_index_set_open(char *reg_filename, RegistryManager *registry_manager, OPEN_MODE mode);
+void b_tree_secondary_index_set_free(BTreeSecondaryIndexSet **set_ptr);
+BTreeSecondaryIndex *b_tree_secondary_index_set_get(BTreeSecondaryIndexSet *set, RegistryFieldsMask field);
+
+#endif  //!__B_TREE_SECONDARY_INDEX__H__
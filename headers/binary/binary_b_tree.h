@@ -4,7 +4,22 @@
 #include <stdio.h>
 #include "b_tree_node.h"
 
-BTreeNode* binary_read_b_tree_node(FILE *file_ptr);
-void binary_write_b_tree_node(FILE *file_ptr, BTreeNode *node);
+BTreeNode* binary_read_b_tree_node(FILE *file_ptr, int order, int page_size);
+void binary_write_b_tree_node(FILE *file_ptr, BTreeNode *node, int page_size);
 
-#endif  //!__BINARY_B_TREE__H__
\ No newline at end of file
+BTreeNode* binary_read_b_plus_tree_node(FILE *file_ptr, int order, int page_size);
+void binary_write_b_plus_tree_node(FILE *file_ptr, BTreeNode *node, int page_size);
+
+//Páginas compactadas da árvore-B+ (B_TREE_FORMAT_PLUS_PACKED)
+BTreeNode* binary_read_packed_b_plus_tree_node(FILE *file_ptr, int order, int page_size);
+void binary_write_packed_b_plus_tree_node(FILE *file_ptr, BTreeNode *node, int page_size);
+int binary_packed_b_plus_tree_node_size(BTreeNode *node);
+int binary_packed_leaf_size(int n, unsigned int key_span, unsigned int value_span);
+int binary_packed_internal_size(int n, unsigned int key_span, unsigned int child_span);
+
+//Busca direto nas páginas compactadas, sem descompactá-las
+int binary_packed_page_search(const char *page, int key, bool *found);
+int binary_packed_page_get_nivel(const char *page);
+int binary_packed_page_get_pointer(const char *page, int position);
+
+#endif  //!__BINARY_B_TREE__H__
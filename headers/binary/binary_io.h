@@ -5,6 +5,9 @@
 
 #define REG_VARIABLE_FIELDS_TOTAL_SIZE 105
 
+//Caractere usado para preencher o espaço não utilizado (lixo) dos arquivos binários
+#define GARBAGE_CHAR '$'
+
 void binary_write_int(FILE *file, int num);
 int binary_read_int(FILE *file);
 
@@ -2,9 +2,32 @@
 #define __BINARY_REGISTRY__H__
 
 #include "registry.h"
+#include "binary_io.h"
+
+//Posição de cada campo relativa ao início do registro (os campos variáveis começam logo após os seus tamanhos)
+#define SLOT_CIDADEMAE_SIZE_OFFSET   0
+#define SLOT_CIDADEBEBE_SIZE_OFFSET  4
+#define SLOT_VARIABLE_FIELDS_OFFSET  8
+#define SLOT_IDNASCIMENTO_OFFSET     REG_VARIABLE_FIELDS_TOTAL_SIZE
+#define SLOT_IDADEMAE_OFFSET         (SLOT_IDNASCIMENTO_OFFSET + 4)
+#define SLOT_DATANASCIMENTO_OFFSET   (SLOT_IDADEMAE_OFFSET + 4)
+#define SLOT_SEXOBEBE_OFFSET         (SLOT_DATANASCIMENTO_OFFSET + 10)
+#define SLOT_ESTADOMAE_OFFSET        (SLOT_SEXOBEBE_OFFSET + 1)
+#define SLOT_ESTADOBEBE_OFFSET       (SLOT_ESTADOMAE_OFFSET + 2)
+
+//Quantidade de registros montados em memória antes de cada escrita em binary_write_registries()
+#define BINARY_WRITE_REGISTRIES_BATCH 64
 
 bool binary_update_registry(FILE *file, VirtualRegistry *updated_reg);
 bool binary_write_registry(FILE *file, VirtualRegistry *reg_data);
+bool binary_write_registries(FILE *file, VirtualRegistry **reg_arr, int count);
+void binary_encode_registry(char *slot, VirtualRegistry *reg_data);
 VirtualRegistry *binary_read_registry(FILE *file);
 
+bool binary_read_registry_slot(FILE *file, char *slot);
+bool binary_slot_is_removed(const char *slot);
+void binary_slot_cities_sizes(const char *slot, int *cidadeMae_size, int *cidadeBebe_size);
+VirtualRegistry *binary_decode_registry(const char *slot);
+bool binary_decode_registry_into(const char *slot, VirtualRegistry *reg_data);
+
 #endif  //!__BINARY_REGISTRY__H__
\ No newline at end of file
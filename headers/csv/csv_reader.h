@@ -5,11 +5,28 @@
 #include "registry_array.h"
 #include "open_mode.h"
 
+//Tamanho inicial dos blocos em que o arquivo csv é lido
+#define CSV_READER_BLOCK_SIZE (1 << 16)
+
+//Quantidade de registros codificados por vez na leitura em lote (funcionalidade 1)
+#define CSV_INGEST_BATCH_REGISTRIES 1024
+
+//Tamanho dos pedaços do arquivo processados por vez por cada thread da leitura paralela
+#define CSV_PARALLEL_CHUNK_SIZE (1 << 20)
+
+//Quantidade máxima de threads usadas quando a quantidade não é informada
+#define CSV_PARALLEL_MAX_THREADS 16
+
 typedef struct csv_reader_ CsvReader;
 
+//Função chamada (sempre na thread que iniciou a leitura e na ordem do arquivo) para cada lote de registros codificados
+typedef void (*CsvSlotsEmitFunc)(const char *slots, int count, void *context);
+
 CsvReader *csv_reader_create(void);
 OPEN_RESULT csv_reader_open(CsvReader *reader, char *csv_filename);
 VirtualRegistry *csv_reader_readline(CsvReader *reader);
+int csv_reader_read_registry_slots(CsvReader *reader, char *slots, int max_count);
+int csv_reader_parallel_read_registry_slots(CsvReader *reader, int thread_count, CsvSlotsEmitFunc emit, void *context);
 void csv_reader_close(CsvReader *reader);
 void csv_reader_free(CsvReader **reader_ptr);
 
@@ -7,6 +7,18 @@
 #define H_INCREASE -1
 #define H_DECREASE -2
 
+//Versões do formato do arquivo de índices, guardadas no primeiro byte após os headers da especificação
+#define B_TREE_FORMAT_LEGACY '$'    //Formato da especificação: ordem B_TREE_ORDER e páginas de NODE_SIZE bytes
+#define B_TREE_FORMAT_PAGED '2'     //Ordem e tamanho de página configuráveis, guardados logo após a versão
+#define B_TREE_FORMAT_PLUS '+'      //Árvore-B+ (ver b_plus_tree_manager.h), com ordem e tamanho de página guardados como no formato paginado
+#define B_TREE_FORMAT_PLUS_PACKED 'P'   //Árvore-B+ com páginas compactadas (ver binary_b_tree.c)
+
+//Indica se a versão é de um arquivo de árvore-B+ (gerenciado pelo BPlusTreeManager)
+#define B_TREE_FORMAT_IS_PLUS(version) ((version) == B_TREE_FORMAT_PLUS || (version) == B_TREE_FORMAT_PLUS_PACKED)
+
+//Marca, logo após a descrição do formato, de que o header guarda o início da lista de páginas livres (apenas após a primeira remoção)
+#define B_TREE_FREE_LIST_MARKER 'L'
+
 //Definição de valores para uso mascara de bits em b_tree_header.c
 typedef enum {
     BTHMASK_NONE = 0,
@@ -15,7 +27,8 @@ typedef enum {
     BTHMASK_NRONIVEIS = 4,
     BTHMASK_PROXRRN = 8,
     BTHMASK_NROCHAVES = 16,
-    BTHMASK_ALL = 31
+    BTHMASK_FREELIST = 32,
+    BTHMASK_ALL = 63
 } ChangedBTHeadersMask;
 
 typedef struct _b_tree_header BTreeHeader;
@@ -41,4 +54,13 @@ void b_tree_header_set_proxRRN (BTreeHeader *header, int new_value);
 int b_tree_header_get_nroChaves (BTreeHeader *header);
 void b_tree_header_set_nroChaves (BTreeHeader *header, int new_value);
 
+int b_tree_header_get_free_list_head (BTreeHeader *header);
+void b_tree_header_set_free_list_head (BTreeHeader *header, int new_value);
+
+char b_tree_header_get_version (BTreeHeader *header);
+int b_tree_header_get_order (BTreeHeader *header);
+int b_tree_header_get_page_size (BTreeHeader *header);
+bool b_tree_header_set_format (BTreeHeader *header, int order, int page_size);
+bool b_tree_header_set_plus_format (BTreeHeader *header, int order, int page_size, bool packed);
+
 #endif  //!__B_TREE_HEADER__H__
\ No newline at end of file
@@ -7,6 +7,10 @@
 #define H_INCREASE -1
 #define H_DECREASE -2
 
+//Marcador escrito no primeiro byte do lixo do header quando o arquivo possui lista de registros livres
+//(arquivos da especificação têm '$' nessa posição e continuam sem lista)
+#define REG_HEADER_FREE_LIST_MARKER 'F'
+
 //Definição de valores para uso mascara de bits em registry_header.c
 typedef enum {
     RHMASK_NONE = 0,
@@ -15,7 +19,8 @@ typedef enum {
     RHMASK_REGISTRIESCOUNT = 4,
     RHMASK_REMOVEDCOUNT = 8,
     RHMASK_UPDATEDCOUNT = 16,
-    RHMASK_ALL = 31
+    RHMASK_FREELIST = 32,
+    RHMASK_ALL = 63
 } ChangedRHeadersMask;
 
 typedef struct _reg_header RegistryHeader;
@@ -42,4 +47,9 @@ void reg_header_set_updated_count (RegistryHeader *header, int counter);
 int reg_header_get_next_RRN (RegistryHeader *header);
 void reg_header_set_next_RRN (RegistryHeader *header, int new_rrn);
 
+bool reg_header_has_free_list (RegistryHeader *header);
+void reg_header_enable_free_list (RegistryHeader *header);
+int reg_header_get_free_list_head (RegistryHeader *header);
+void reg_header_set_free_list_head (RegistryHeader *header, int RRN);
+
 #endif  //!__REGISTRY_HEADER__H__
\ No newline at end of file
@@ -36,6 +36,7 @@ typedef struct _virtual_registry VirtualRegistryUpdater;
 VirtualRegistry *virtual_registry_create_copy(VirtualRegistry *base);
 VirtualRegistry *virtual_registry_create();
 VirtualRegistry *virtual_registry_create_masked(RegistryFieldsMask compareFields);
+VirtualRegistry *virtual_registry_create_buffered();
 
 void virtual_registry_free(VirtualRegistry **reg_data_ptr);
 
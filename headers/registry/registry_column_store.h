@@ -0,0 +1,48 @@
+#ifndef __REGISTRY_COLUMN_STORE__H__
+#define __REGISTRY_COLUMN_STORE__H__
+
+#include <stdint.h>
+
+#include "bool.h"
+#include "registry_array.h"
+#include "registry_mask.h"
+#include "registry_view.h"
+
+//Sufixo do arquivo auxiliar com as colunas (ex.: "dados.bin" -> "dados.bin.cols")
+#define REGISTRY_COLUMN_STORE_SUFFIX ".cols"
+
+//Quantidade máxima de valores distintos em cada dicionário (os códigos têm 16 bits)
+#define REGISTRY_COLUMN_DICTIONARY_MAX 65535
+
+/*
+    Cópia colunar do arquivo de registros: um vetor contíguo por campo, indexado pelo RRN. Os campos de tamanho
+    fixo são guardados como estão (dataNascimento completada com '\0'), e as cidades e os estados são substituídos
+    por códigos de 16 bits em um dicionário (um para as cidades e outro para os estados). Os filtros e as agregações
+    leem apenas as colunas dos campos envolvidos, sem ler os REGISTRY_SIZE bytes de cada registro.
+    Guardada ao lado do arquivo de registros e identificada pelo header dele, assim como o RegistryLiveBitmap.
+*/
+typedef struct _registry_column_store RegistryColumnStore;
+
+//Valor de um grupo de uma agregação e a quantidade de registros nele
+typedef struct {
+    RegistryStringSlice text;   //Valor nos campos de texto (cidades, estados e dataNascimento)
+    int number;                 //Valor nos campos numéricos (idNascimento e idadeMae) e em sexoBebe
+    int count;
+} RegistryColumnGroup;
+
+RegistryColumnStore *registry_column_store_create(void);
+void registry_column_store_free(RegistryColumnStore **store_ptr);
+
+bool registry_column_store_set(RegistryColumnStore *store, int RRN, const char *slot);
+void registry_column_store_set_count(RegistryColumnStore *store, int RRN_count);
+int registry_column_store_get_count(RegistryColumnStore *store);
+bool registry_column_store_is_valid(RegistryColumnStore *store);
+
+int registry_column_store_filter(RegistryColumnStore *store, VirtualRegistryArray *filters, uint8_t *selection);
+int registry_column_store_select(RegistryColumnStore *store, VirtualRegistryArray *filters, int max_count, int **RRNs_ptr);
+int registry_column_store_count_by(RegistryColumnStore *store, const uint8_t *selection, RegistryFieldsMask field, RegistryColumnGroup **groups_ptr);
+
+bool registry_column_store_write(RegistryColumnStore *store, char *filename, int RRN_count, int registries_count, int removed_count, int updated_count);
+RegistryColumnStore *registry_column_store_read(char *filename, int RRN_count, int registries_count, int removed_count, int updated_count);
+
+#endif  //!__REGISTRY_COLUMN_STORE__H__
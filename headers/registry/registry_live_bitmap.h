@@ -0,0 +1,28 @@
+#ifndef __REGISTRY_LIVE_BITMAP__H__
+#define __REGISTRY_LIVE_BITMAP__H__
+
+#include "bool.h"
+
+//Sufixo do arquivo auxiliar com o mapa de registros existentes (ex.: "dados.bin" -> "dados.bin.live")
+#define REGISTRY_LIVE_BITMAP_SUFFIX ".live"
+
+/*
+    Mapa de bits com um bit por RRN do arquivo de registros (1 = existente, 0 = removido ou inexistente).
+    Guardado ao lado do arquivo de registros, permite saber se um registro foi removido sem lê-lo
+    e pular sequências de registros removidos nas varreduras.
+*/
+typedef struct _registry_live_bitmap RegistryLiveBitmap;
+
+RegistryLiveBitmap *registry_live_bitmap_create(void);
+void registry_live_bitmap_free(RegistryLiveBitmap **bitmap_ptr);
+
+void registry_live_bitmap_set(RegistryLiveBitmap *bitmap, int RRN, bool live);
+void registry_live_bitmap_set_range(RegistryLiveBitmap *bitmap, int first_RRN, int count);
+bool registry_live_bitmap_is_live(RegistryLiveBitmap *bitmap, int RRN);
+int registry_live_bitmap_next_live(RegistryLiveBitmap *bitmap, int RRN, int RRN_count);
+int registry_live_bitmap_count(RegistryLiveBitmap *bitmap, int RRN_count);
+
+bool registry_live_bitmap_write(RegistryLiveBitmap *bitmap, char *filename, int RRN_count, int registries_count, int removed_count);
+RegistryLiveBitmap *registry_live_bitmap_read(char *filename, int RRN_count, int registries_count, int removed_count);
+
+#endif  //!__REGISTRY_LIVE_BITMAP__H__
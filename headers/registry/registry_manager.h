@@ -7,12 +7,18 @@
 #include "registry.h"
 #include "registry_array.h"
 #include "registry_header.h"
+#include "registry_view.h"
+#include "registry_rrn_map.h"
+#include "registry_column_store.h"
 #include "open_mode.h"
 
 
 #define FRONT 1
 #define BACK -1
 
+//Quantidade máxima de funções chamadas a cada modificação de registro (ex.: índices secundários e índice primário)
+#define REGISTRY_MANAGER_MAX_CHANGE_CALLBACKS 4
+
 typedef struct _registry_manager RegistryManager;
 
 RegistryManager *registry_manager_create(void);
@@ -28,8 +34,19 @@ void registry_manager_update_at(RegistryManager *manager, int RRN, VirtualRegist
 void registry_manager_delete_current (RegistryManager *manager);
 
 //Typedef que simplifica o tipo function pointer usado como callback do registry manager (na funcão for_each_match e for_each)
+//OBS: o registro recebido é reaproveitado a cada chamada, portanto o callback deve copiá-lo se precisar guardá-lo
 typedef void (*RMForeachCallback)(RegistryManager *manager, VirtualRegistry *match_registry);
 
+//Callback das varreduras sem cópia (for_each_view_match e for_each_view). A visão só é válida durante a chamada e não deve ser usada para escrita
+typedef void (*RMViewCallback)(RegistryManager *manager, RegistryView view);
+
+//Callback das varreduras sem cópia que recebe um contexto (for_each_view_with_context)
+typedef void (*RMViewContextCallback)(RegistryManager *manager, RegistryView view, void *context);
+
+//Callback informado a cada modificação de registro: old_view é NULL na inserção e new_view é NULL na remoção.
+//As visões só são válidas durante a chamada
+typedef void (*RMChangeCallback)(RegistryManager *manager, int RRN, RegistryView *old_view, RegistryView *new_view, void *context);
+
 
 void registry_manager_write_headers_to_disk(RegistryManager *manager);
 void registry_manager_read_headers_from_disk(RegistryManager *manager);
@@ -42,22 +59,37 @@ bool registry_manager_is_file_consistent(RegistryManager *manager);
 
 void registry_manager_insert_arr_at_end(RegistryManager *manager, VirtualRegistry **reg_data_arr, int arr_size);
 int registry_manager_insert_at_end(RegistryManager *manager, VirtualRegistry *reg_data);
+void registry_manager_insert_slots_at_end(RegistryManager *manager, const char *slots, int count);
+bool registry_manager_enable_free_list(RegistryManager *manager);
+long registry_manager_compact_to(RegistryManager *manager, char *new_filename, RegistryRRNMap *map);
+bool registry_manager_replace_file(char *new_filename, char *bin_filename);
+bool registry_manager_add_change_callback(RegistryManager *manager, RMChangeCallback callback_func, void *context);
+void registry_manager_remove_change_callback(RegistryManager *manager, RMChangeCallback callback_func, void *context);
 
 int registry_manager_for_each_match(RegistryManager *manager, VirtualRegistryArray *match_conditions, RMForeachCallback callback_func);
+int registry_manager_for_each_match_at(RegistryManager *manager, const int *RRNs, int RRN_count, VirtualRegistryArray *match_conditions, RMForeachCallback callback_func);
+int registry_manager_for_each_view_match(RegistryManager *manager, VirtualRegistryArray *match_conditions, RMViewCallback callback_func);
+int registry_manager_parallel_for_each_view_match(RegistryManager *manager, VirtualRegistryArray *match_conditions, RMViewCallback callback_func, int thread_count);
 
 VirtualRegistryArray *registry_manager_fetch(RegistryManager *manager, VirtualRegistry *match_terms);
 VirtualRegistry *registry_manager_fetch_at(RegistryManager *manager, int RRN);
 VirtualRegistryArray *registry_manager_fetch_all(RegistryManager *manager);
 
 void registry_manager_remove_matches(RegistryManager *manager, VirtualRegistryArray *match_terms_arr);
+void registry_manager_remove_matches_at(RegistryManager *manager, const int *RRNs, int RRN_count, VirtualRegistryArray *match_terms_arr);
 void registry_manager_remove_at(RegistryManager *manager, int RRN);
 
 void registry_manager_update(RegistryManager *manager, VirtualRegistry *match_terms, VirtualRegistry *new_data);
 void registry_manager_update_at(RegistryManager *manager, int RRN, VirtualRegistry *new_data);
 
 void registry_manager_for_each(RegistryManager *manager, RMForeachCallback callback_func);
+void registry_manager_for_each_view(RegistryManager *manager, RMViewCallback callback_func);
+void registry_manager_for_each_view_with_context(RegistryManager *manager, RMViewContextCallback callback_func, void *context);
 bool registry_manager_is_empty(RegistryManager *manager);
 
 RegistryHeader *registry_manager_get_registry_header (RegistryManager *manager);
 
+RegistryColumnStore *registry_manager_get_column_store(RegistryManager *manager);
+bool registry_manager_build_column_store(RegistryManager *manager);
+
 #endif  //!__REGISTRY_MANAGER__H__
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef __REGISTRY_PARALLEL_SCAN__H__
+#define __REGISTRY_PARALLEL_SCAN__H__
+
+#include <stddef.h>
+
+#include "registry_predicate.h"
+#include "registry_view.h"
+
+//Quantidade de registros processados por vez por cada thread da varredura paralela
+#define REGISTRY_SCAN_CHUNK_REGISTRIES 4096
+
+//Quantidade máxima de threads usadas quando a quantidade não é informada
+#define REGISTRY_SCAN_MAX_THREADS 16
+
+//Função chamada (sempre na thread que iniciou a varredura e em ordem de RRN) para cada registro encontrado
+typedef void (*RegistryScanEmitFunc)(RegistryView view, void *context);
+
+/*
+    Arquivo de registros a ser varrido. Se map_base não for NULL, os registros são lidos do mapeamento,
+    senão cada thread lê seus registros de fd com pread() (sem compartilhar o cursor do arquivo)
+*/
+typedef struct {
+    int fd;
+    const char *map_base;
+    size_t map_size;
+    int reg_count;          //Quantidade de RRNs a serem varridos (registros + removidos)
+} RegistryScanSource;
+
+int registry_scan_default_thread_count(void);
+int registry_parallel_scan(RegistryScanSource source, RegistryPredicate *predicate, int thread_count, RegistryScanEmitFunc emit, void *context);
+
+#endif  //!__REGISTRY_PARALLEL_SCAN__H__
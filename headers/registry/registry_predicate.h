@@ -0,0 +1,15 @@
+#ifndef __REGISTRY_PREDICATE__H__
+#define __REGISTRY_PREDICATE__H__
+
+#include "bool.h"
+#include "registry.h"
+#include "registry_array.h"
+
+typedef struct _registry_predicate RegistryPredicate;
+
+RegistryPredicate *registry_predicate_compile(VirtualRegistryArray *filters);
+void registry_predicate_free(RegistryPredicate **predicate_ptr);
+
+bool registry_predicate_matches(RegistryPredicate *predicate, const char *slot);
+
+#endif  //!__REGISTRY_PREDICATE__H__
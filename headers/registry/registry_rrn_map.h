@@ -0,0 +1,20 @@
+#ifndef __REGISTRY_RRN_MAP__H__
+#define __REGISTRY_RRN_MAP__H__
+
+#include "bool.h"
+
+/*
+    Mapa RRN antigo -> RRN novo de uma compactação do arquivo de registros.
+    Como os registros mantêm sua ordem, o mapa guarda apenas um bit por registro antigo (existente ou removido)
+    e a quantidade de registros existentes antes de cada bloco de 64 bits (cerca de 1,5 bit por registro).
+*/
+typedef struct _registry_rrn_map RegistryRRNMap;
+
+RegistryRRNMap *registry_rrn_map_create(int RRN_count);
+void registry_rrn_map_free(RegistryRRNMap **map_ptr);
+
+void registry_rrn_map_set_live(RegistryRRNMap *map, int old_RRN);
+int registry_rrn_map_get(RegistryRRNMap *map, int old_RRN);
+int registry_rrn_map_get_live_count(RegistryRRNMap *map);
+
+#endif  //!__REGISTRY_RRN_MAP__H__
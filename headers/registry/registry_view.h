@@ -0,0 +1,46 @@
+#ifndef __REGISTRY_VIEW__H__
+#define __REGISTRY_VIEW__H__
+
+#include "bool.h"
+#include "registry.h"
+#include "registry_array.h"
+
+/*
+    Trecho de uma string dentro de um registro em memória. NÃO termina com '\0',
+    portanto deve ser usado sempre junto de seu tamanho (ex.: printf("%.*s", slice.size, slice.data))
+*/
+typedef struct {
+    const char *data;
+    int size;
+} RegistryStringSlice;
+
+/*
+    Visão (sem cópia) de um registro: aponta diretamente para os REGISTRY_SIZE bytes do registro
+    em um buffer de página ou no arquivo mapeado. Os campos são interpretados apenas quando acessados.
+    Assim como o VirtualRegistry, a struct é de acesso direto e pode ser passada por valor.
+    OBS: a visão só é válida enquanto o buffer apontado existir (durante o callback que a recebeu)
+*/
+typedef struct {
+    const char *slot;       //Início do registro em memória
+    int RRN;                //RRN do registro no arquivo
+} RegistryView;
+
+RegistryView registry_view_create(const char *slot, int RRN);
+
+bool registry_view_is_removed(RegistryView view);
+
+RegistryStringSlice registry_view_get_cidadeMae(RegistryView view);
+RegistryStringSlice registry_view_get_cidadeBebe(RegistryView view);
+int registry_view_get_idNascimento(RegistryView view);
+int registry_view_get_idadeMae(RegistryView view);
+RegistryStringSlice registry_view_get_dataNascimento(RegistryView view);
+char registry_view_get_sexoBebe(RegistryView view);
+RegistryStringSlice registry_view_get_estadoMae(RegistryView view);
+RegistryStringSlice registry_view_get_estadoBebe(RegistryView view);
+
+bool registry_view_matches(RegistryView view, VirtualRegistryFilter *filter);
+bool registry_view_matches_any(RegistryView view, VirtualRegistryArray *filters);
+
+void registry_view_print(RegistryView view);
+
+#endif  //!__REGISTRY_VIEW__H__
@@ -8,11 +8,16 @@
  *  READ -> abre em rb e não mexe em nenhum byte do arquivo
  *  CREATE -> abre em wb+, criando um novo arquivo, definindo os headers com valores padrão e preenchendo seu lixo (só é feito na criação). Também define o status como '0' até que se finalizem as operações
  *  MODIFY -> abre o arquivo em rb+ para que seja possível fazer atualizações, deleções, etc... Abre o arquivo como se fosse READ, mas define o status como '0'
+ *  READ_MMAP -> assim como READ, não mexe em nenhum byte do arquivo, mas mapeia o arquivo na memória (mmap), de modo que os registros
+ *      sejam acessados diretamente, sem fseek/fread (suportado apenas pelo RegistryManager; nos demais gerenciadores equivale a READ)
  */
 typedef enum {
-    READ = 0, CREATE = 1, MODIFY = 2
+    READ = 0, CREATE = 1, MODIFY = 2, READ_MMAP = 3
 } OPEN_MODE;
 
+//Indica se o modo de abertura impede escritas no arquivo
+#define OPEN_MODE_IS_READ_ONLY(mode) ((mode) == READ || (mode) == READ_MMAP)
+
 /**
  *  Enum que indica o resultado da abertura do arquivo
  *  OPEN_OK -> indica que não houve problema na abertura do arquivo
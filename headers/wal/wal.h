@@ -0,0 +1,39 @@
+#ifndef __WAL__H__
+#define __WAL__H__
+
+#include <stdio.h>
+
+#include "bool.h"
+
+//Sufixo do arquivo de log, criado ao lado do arquivo de dados (ex.: "dados.bin" -> "dados.bin.wal")
+#define WAL_FILE_SUFFIX ".wal"
+
+//Quantidade de operações agrupadas em cada confirmação (um único fsync por grupo)
+#define WAL_GROUP_COMMIT_OPERATIONS 256
+
+//Tamanho do log a partir do qual o arquivo de dados é sincronizado e o log é esvaziado (checkpoint)
+#define WAL_CHECKPOINT_BYTES (1L << 26)
+
+/*
+    Log de escrita antecipada (write-ahead) de um arquivo de dados aberto para modificação. As modificações são
+    agrupadas em lotes de até WAL_GROUP_COMMIT_OPERATIONS operações, e o gerenciador escreve por uma stream do log,
+    que guarda as escritas do lote na RAM (no-steal). Garantia de durabilidade:
+        - um lote não confirmado nunca chega ao arquivo de dados, portanto não precisa ser desfeito;
+        - na confirmação, as imagens finais e o registro de confirmação são sincronizados no log (um único fsync por
+          lote) e só então o lote é escrito no arquivo de dados; os lotes confirmados são refeitos na recuperação.
+    Uma queda antes da confirmação perde apenas as operações do lote aberto.
+    A stream entregue por wal_open() só deve ser posicionada com seeks absolutos (SEEK_SET/SEEK_END).
+*/
+typedef struct _write_ahead_log WriteAheadLog;
+
+bool wal_recover(char *data_filename, long status_offset, char consistent_status);
+bool wal_exists(char *data_filename);
+void wal_discard(char *data_filename);
+
+WriteAheadLog *wal_open(char *data_filename, FILE **data_file_ptr);
+void wal_close(WriteAheadLog **wal_ptr);
+
+bool wal_end_operations(WriteAheadLog *wal, int count);
+bool wal_commit(WriteAheadLog *wal);
+
+#endif  //!__WAL__H__
@@ -0,0 +1,1154 @@
+#include "b_plus_tree_manager.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "binary_b_tree.h"
+#include "b_tree_header.h"
+#include "b_tree_node.h"
+#include "b_tree_page_cache.h"
+#include "b_tree_bulk_loader.h"
+#include "wal.h"
+#include "debug.h"
+
+//Posições, entre os P's de uma folha em RAM, das ligações com a folha anterior e com a próxima
+#define LEAF_PREV 0
+#define LEAF_NEXT 1
+
+//Quantidade mínima de chaves em um nó que não seja a raiz, dada a ordem da árvore
+#define B_PLUS_TREE_MIN_KEYS(order) (((order)-1)/2)
+
+//Altura máxima considerada nas descidas (com no mínimo 3 filhos por nó, muito além de qualquer arquivo possível)
+#define B_PLUS_TREE_MAX_LEVELS 64
+
+//Posição usada pelo cursor para indicar o último item de uma folha (antes de a folha ser lida)
+#define CURSOR_LAST_POSITION INT_MAX
+
+/*
+	Struct que representa o gerenciador do arquivo de índices em árvore-B+. Assim como o BTreeManager,
+	guarda os headers, o modo de abertura, o cache de páginas e o log do arquivo.
+*/
+struct _b_plus_tree_manager {
+	BTreeHeader *header;
+	OPEN_MODE requested_mode;
+	FILE *bin_file;
+	BTreePageCache *page_cache;
+	int create_page_size;		//Tamanho de página usado ao criar um arquivo novo (modo CREATE)
+	bool create_packed;			//Indica se as páginas de um arquivo novo são compactadas (modo CREATE)
+	bool packed;				//Indica se as páginas do arquivo aberto são compactadas
+	char *page_buffer;			//Página lida pela busca direta nas páginas compactadas (ver _packed_search_for())
+	WriteAheadLog *wal;			//Log das modificações (apenas no modo MODIFY; NULL nos demais)
+};
+
+/*
+	Struct auxiliar da inserção: informa ao nó pai que um filho foi dividido
+*/
+typedef struct {
+	int key;	//Chave separadora entre o filho e o novo nó (-1 se não houve divisão)
+	int RRN;	//RRN do novo nó, à direita do separador (-1 se não houve divisão)
+} _split_answer;
+
+/*
+	Funcao que cria um gerenciador da arvore-B+, alocando memoria e definindo seus campos
+	Parametros: nenhum
+	Retorno:
+		BPlusTreeManager* . O gerenciador da arvore-B+.
+*/
+BPlusTreeManager *b_plus_tree_manager_create(void) {
+	//Tenta alocar memória
+	BPlusTreeManager *manager = malloc(sizeof(BPlusTreeManager));
+	if (manager == NULL) {
+		DP("ERROR: not enough memory for BPlusTreeManager @b_plus_tree_manager_create()\n");
+		return NULL;
+	}
+
+	//Define os valores iniciais
+	manager->header = NULL;
+	manager->bin_file = NULL;
+	manager->page_cache = NULL;
+	manager->create_page_size = NODE_SIZE;
+	manager->create_packed = false;
+	manager->packed = false;
+	manager->page_buffer = NULL;
+	manager->wal = NULL;
+	return manager;
+}
+
+/**
+ *  Retorna a maior ordem cujos nós de árvore-B+ cabem em uma página de um dado tamanho
+ *  Parâmetros:
+ *      int page_size -> tamanho da página
+ *  Retorno:
+ *      int -> a ordem (limitada a B_TREE_MAX_ORDER), ou -1 se nenhum nó couber na página
+ */
+int b_plus_tree_manager_order_for_page_size(int page_size) {
+	int order = page_size / B_PLUS_TREE_NODE_SIZE(0) - 1;
+	if (order > B_TREE_MAX_ORDER) order = B_TREE_MAX_ORDER;
+	return (order < B_TREE_MIN_ORDER) ? -1 : order;
+}
+
+/**
+ *  Retorna a maior ordem cujos nós de árvore-B+ compactados cabem em uma página de um dado tamanho. Um nó compactado
+ *  cheio normalmente não cabe na página (ele é dividido antes), mas metade dele sempre deve caber sem compressão
+ *  (ver B_PLUS_TREE_PACKED_NODE_SIZE), para que a divisão seja possível
+ *  Parâmetros:
+ *      int page_size -> tamanho da página
+ *  Retorno:
+ *      int -> a ordem (limitada a B_TREE_MAX_ORDER), ou -1 se nenhum nó couber na página
+ */
+int b_plus_tree_manager_packed_order_for_page_size(int page_size) {
+	int order = 2 * ((page_size - B_PLUS_TREE_PACKED_LEAF_HEADER_SIZE) / 8);
+	if (order > B_TREE_MAX_ORDER) order = B_TREE_MAX_ORDER;
+	return (order < B_TREE_MIN_ORDER) ? -1 : order;
+}
+
+/**
+ *  Define o tamanho das páginas dos arquivos que forem criados pelo gerenciador (modo CREATE). A ordem é a maior
+ *  cujos nós cabem na página. Por padrão, as páginas têm o tamanho dos nós da especificação (NODE_SIZE).
+ *  Parâmetros:
+ *      BPlusTreeManager *manager -> instância do gerenciador (antes da abertura do arquivo)
+ *      int page_size -> tamanho de cada página
+ *  Retorno:
+ *      bool -> true se o tamanho é válido
+ */
+bool b_plus_tree_manager_set_page_size(BPlusTreeManager *manager, int page_size) {
+	//Validação de parâmetros
+	if (manager == NULL || b_plus_tree_manager_order_for_page_size(page_size) == -1) {
+		DP("ERROR: (parameter) invalid parameters @b_plus_tree_manager_set_page_size()\n");
+		return false;
+	}
+
+	manager->create_page_size = page_size;
+	return true;
+}
+
+/**
+ *  Define se as páginas dos arquivos que forem criados pelo gerenciador (modo CREATE) são compactadas
+ *  (B_TREE_FORMAT_PLUS_PACKED, ver binary_b_tree.c). Páginas compactadas guardam mais itens, portanto
+ *  o índice ocupa menos páginas (no disco e no cache). Por padrão, as páginas não são compactadas.
+ *  Parâmetros:
+ *      BPlusTreeManager *manager -> instância do gerenciador (antes da abertura do arquivo)
+ *      bool packed -> indica se as páginas são compactadas
+ *  Retorno:
+ *      bool -> true se o formato é válido para o tamanho de página definido
+ */
+bool b_plus_tree_manager_set_packed(BPlusTreeManager *manager, bool packed) {
+	//Validação de parâmetros
+	if (manager == NULL || (packed && b_plus_tree_manager_packed_order_for_page_size(manager->create_page_size) == -1)) {
+		DP("ERROR: (parameter) invalid parameters @b_plus_tree_manager_set_packed()\n");
+		return false;
+	}
+
+	manager->create_packed = packed;
+	return true;
+}
+
+/*
+	Funcao que escreve os headers no arquivo (assim como b_tree_manager_write_headers_to_disk())
+	Parametros:
+		manager -> gerenciador com o arquivo aberto em modo que permita a escrita
+	Retorno: void
+*/
+static void _write_headers_to_disk(BPlusTreeManager *manager) {
+	if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
+		DP("ERROR: trying to write headers on a read-only BPlusTreeManager @_write_headers_to_disk()\n");
+		return;
+	}
+
+	if (manager->header == NULL || manager->bin_file == NULL) {
+		DP("ERROR: trying to write headers on a invalid BPlusTreeManager state @_write_headers_to_disk()\n");
+		return;
+	}
+
+	//O header ocupa a primeira página
+	b_tree_header_write_to_bin(manager->header, manager->bin_file);
+}
+
+/**
+ *  Abre ou cria um arquivo de árvore-B+, o qual será gerenciado pelo BPlusTreeManager. O status do arquivo, a recuperação
+ *  pelo log e os modos de abertura seguem o BTreeManager.
+ *  Parâmetros:
+ *      BPlusTreeManager *manager -> instância do gerenciador
+ *      char *bin_filename -> nome do arquivo (caminho completo)
+ *      OPEN_MODE mode -> READ, CREATE ou MODIFY, indicando o modo de abertura do arquivo
+ *  Retorno:
+ *      OPEN_RESULT -> resultado da abertura (ler a documentação de OPEN_RESULT em open_mode.h). Um arquivo que não seja
+ *          de árvore-B+ resulta em OPEN_FAILED
+ */
+OPEN_RESULT b_plus_tree_manager_open(BPlusTreeManager *manager, char *bin_filename, OPEN_MODE mode) {
+	//Validação de parâmetros
+	if (manager == NULL) return OPEN_INVALID_ARGUMENT;
+
+	if (bin_filename == NULL) {
+		DP("ERROR: (parameter) invalid null filename @b_plus_tree_manager_open()\n");
+		return OPEN_INVALID_ARGUMENT;
+	}
+
+	if (DEBUG && manager->bin_file != NULL) {
+		DP("WARNING: opening new file before closing file already opened! @b_plus_tree_manager_open()\n");
+		return OPEN_INVALID_ARGUMENT;
+	}
+
+	static char* mode_to_str[] = {"rb", "wb+", "rb+", "rb"};
+	manager->requested_mode = mode;
+
+	//Assim como na árvore-B, o log de um arquivo recriado é descartado, recuperado no modo MODIFY e, nos modos de leitura,
+	//torna o arquivo inconsistente
+	if (mode == CREATE) wal_discard(bin_filename);
+	else if (mode == MODIFY && !wal_recover(bin_filename, 0, '1')) return OPEN_FAILED;
+	else if (OPEN_MODE_IS_READ_ONLY(mode) && wal_exists(bin_filename)) return OPEN_INCONSISTENT;
+
+	manager->bin_file = fopen(bin_filename, mode_to_str[mode]);
+	if (manager->bin_file == NULL) return OPEN_FAILED;
+
+	manager->header = b_tree_header_create();
+	if (mode == CREATE) {
+		int order = manager->create_packed ? b_plus_tree_manager_packed_order_for_page_size(manager->create_page_size)
+			: b_plus_tree_manager_order_for_page_size(manager->create_page_size);
+		if (!b_tree_header_set_plus_format(manager->header, order, manager->create_page_size, manager->create_packed))
+			return OPEN_INVALID_ARGUMENT;
+		b_tree_header_write_to_bin(manager->header, manager->bin_file);
+	} else {
+		b_tree_header_read_from_bin(manager->header, manager->bin_file);
+		if (b_tree_header_get_status(manager->header) != '1') return OPEN_INCONSISTENT;
+		if (!B_TREE_FORMAT_IS_PLUS(b_tree_header_get_version(manager->header))) return OPEN_FAILED;
+
+		//As modificações passam a ser feitas pela stream do log, que é aberto antes do cache de páginas
+		if (mode == MODIFY) manager->wal = wal_open(bin_filename, &manager->bin_file);
+	}
+
+	//Cria o cache de páginas, com a disposição de página própria da árvore-B+ (compactada ou não)
+	manager->packed = b_tree_header_get_version(manager->header) == B_TREE_FORMAT_PLUS_PACKED;
+	manager->page_cache = b_tree_page_cache_create_with_codec(manager->bin_file, b_tree_header_get_order(manager->header),
+		b_tree_header_get_page_size(manager->header), B_TREE_PAGE_CACHE_CAPACITY,
+		manager->packed ? binary_read_packed_b_plus_tree_node : binary_read_b_plus_tree_node,
+		manager->packed ? binary_write_packed_b_plus_tree_node : binary_write_b_plus_tree_node);
+
+	if (mode == MODIFY) {
+		//O arquivo fica inconsistente até o fechamento
+		b_tree_header_set_status(manager->header, '0');
+		_write_headers_to_disk(manager);
+	}
+
+	return OPEN_OK;
+}
+
+/**
+ *  Fecha o arquivo, escrevendo as páginas modificadas e marcando-o como consistente (se ele foi aberto para escrita)
+ *  Parâmetros:
+ *      BPlusTreeManager *manager -> gerenciador que possui o arquivo aberto
+ *  Retorno: void
+ */
+void b_plus_tree_manager_close(BPlusTreeManager *manager) {
+	//Verifica se o manager já foi deletado ou se o arquivo já foi fechado
+	if (manager == NULL || manager->bin_file == NULL) return;
+
+	//Um arquivo que não foi aberto por completo (inconsistente ou de outro formato) não tem cache e não é alterado
+	bool opened = manager->page_cache != NULL;
+	b_tree_page_cache_free(&manager->page_cache);
+
+	if (!OPEN_MODE_IS_READ_ONLY(manager->requested_mode) && opened) {
+		b_tree_header_set_status(manager->header, '1');
+		_write_headers_to_disk(manager);
+
+		//Confirma as últimas modificações, sincroniza o arquivo e descarta o log
+		wal_close(&manager->wal);
+	}
+
+	b_tree_header_free(&manager->header);
+	free(manager->page_buffer);
+	manager->page_buffer = NULL;
+	fclose(manager->bin_file);
+	manager->bin_file = NULL;
+}
+
+/*
+	Funcao que desaloca a memoria de um gerenciador da arvore-B+, fechando antes o arquivo (se estiver aberto)
+	Parametros:
+		manager_ptr -> o endereco do gerenciador
+	Retorno:
+		nao ha retorno
+*/
+void b_plus_tree_manager_free(BPlusTreeManager **manager_ptr) {
+	//Validação de parâmetros
+	if (manager_ptr == NULL) {
+		DP("ERROR: invalid parameter @b_plus_tree_manager_free()\n");
+		return;
+	}
+	#define manager (*manager_ptr)
+
+	//Já foi liberado
+	if (manager == NULL) return;
+
+	b_plus_tree_manager_close(manager);
+	free(manager);
+	manager = NULL;
+	#undef manager
+}
+
+//Cria um node vazio na ordem do arquivo aberto (deve ser liberado com b_tree_node_free())
+static BTreeNode *_create_node(BPlusTreeManager *manager, int nivel) {
+	return b_tree_node_create_with_order(nivel, b_tree_header_get_order(manager->header));
+}
+
+//Obtém um node do cache de páginas (deve ser devolvido com _release_node())
+static BTreeNode *_read_node_at(BPlusTreeManager *manager, int RRN) {
+	return b_tree_page_cache_fetch(manager->page_cache, RRN);
+}
+
+//Devolve ao cache um node obtido por _read_node_at()
+static void _release_node(BPlusTreeManager *manager, BTreeNode *node) {
+	b_tree_page_cache_unpin(manager->page_cache, node);
+}
+
+//Escreve um node em um RRN dado (a escrita em disco é adiada pelo cache de páginas)
+static void _write_node_at(BPlusTreeManager *manager, int RRN, BTreeNode *node) {
+	b_tree_page_cache_put(manager->page_cache, RRN, node);
+}
+
+//Indica se um node cabe em uma página do arquivo (sempre verdadeiro se as páginas não forem compactadas)
+static bool _fits_in_page(BPlusTreeManager *manager, BTreeNode *node) {
+	return !manager->packed || binary_packed_b_plus_tree_node_size(node) <= b_tree_header_get_page_size(manager->header);
+}
+
+//Obtém o RRN de uma página nova, no fim do arquivo
+static int _allocate_node_RRN(BPlusTreeManager *manager) {
+	int RRN = b_tree_header_get_proxRRN(manager->header);
+	b_tree_header_set_proxRRN(manager->header, H_INCREASE);
+	return RRN;
+}
+
+/*
+	Contabiliza operações de modificação, confirmando o grupo no log quando ele estiver completo
+	(assim como na árvore-B, as páginas e os headers são escritos antes da confirmação)
+*/
+static void _end_operations(BPlusTreeManager *manager, int count) {
+	if (!wal_end_operations(manager->wal, count)) return;
+
+	b_tree_page_cache_flush(manager->page_cache);
+	_write_headers_to_disk(manager);
+	wal_commit(manager->wal);
+}
+
+/*
+	Obtém a posição do filho de um nó interno cuja subárvore contém uma chave.
+	Um separador é a primeira chave da subárvore à sua direita, portanto chaves iguais a ele seguem para a direita
+*/
+static int _child_position(BTreeNode *node, int key) {
+	bool found;
+	int position = b_tree_node_search(node, key, &found);
+	return found ? position+1 : position;
+}
+
+/*
+	Desce da raiz até a folha cuja faixa de chaves contém uma chave
+	Parametros:
+		manager -> o gerenciador da arvore-B+
+		key -> a chave (INT_MIN leva à primeira folha, INT_MAX à última)
+		pages_ptr -> se não for NULL, é incrementado com a quantidade de nós lidos
+	Retorno:
+		int. o RRN da folha, ou -1 se a árvore estiver vazia ou houver erro na leitura
+*/
+static int _find_leaf(BPlusTreeManager *manager, int key, int *pages_ptr) {
+	int RRN = b_tree_header_get_noRaiz(manager->header);
+
+	for (int level = 0; RRN != -1 && level < B_PLUS_TREE_MAX_LEVELS; level++) {
+		BTreeNode *node = _read_node_at(manager, RRN);
+		if (node == NULL) return -1;
+		if (pages_ptr != NULL) (*pages_ptr)++;
+
+		bool leaf = b_tree_node_get_nivel(node) == 1;
+		int child = leaf ? -1 : b_tree_node_get_P(node, _child_position(node, key));
+		_release_node(manager, node);
+
+		if (leaf) return RRN;
+		RRN = child;
+	}
+
+	return -1;
+}
+
+/*
+	Divide uma folha cheia (ou que não caberia mais na página compactada) ao inserir um novo item: a metade de cima vai para uma nova folha, à direita,
+	e a primeira chave da nova folha é copiada para o pai como separador. As ligações entre as folhas são atualizadas
+	Parametros:
+		manager -> o gerenciador da arvore-B+
+		leaf -> a folha cheia, obtida com _read_node_at() (é escrita, mas não é devolvida ao cache)
+		leafRRN -> RRN da folha
+		key, value -> o item inserido
+	Retorno:
+		_split_answer. O separador e o RRN da nova folha
+*/
+static _split_answer _split_leaf(BPlusTreeManager *manager, BTreeNode *leaf, int leafRRN, int key, int value) {
+	int keys[B_TREE_MAX_ORDER], values[B_TREE_MAX_ORDER];
+	int n = b_tree_node_get_n(leaf);
+
+	//Junta os itens da folha e o novo item, em ordem
+	int position = b_tree_node_search(leaf, key, NULL);
+	for (int i = 0, j = 0; i <= n; i++) {
+		if (i == position) {
+			keys[i] = key;
+			values[i] = value;
+		} else {
+			keys[i] = b_tree_node_get_C(leaf, j);
+			values[i] = b_tree_node_get_Pr(leaf, j);
+			j++;
+		}
+	}
+
+	int left_count = (n+1) / 2;
+	int rightRRN = _allocate_node_RRN(manager);
+	int nextRRN = b_tree_node_get_P(leaf, LEAF_NEXT);
+
+	BTreeNode *left = _create_node(manager, 1), *right = _create_node(manager, 1);
+	for (int i = 0; i <= n; i++) {
+		if (i < left_count) b_tree_node_set_item(left, keys[i], values[i], i);
+		else b_tree_node_set_item(right, keys[i], values[i], i - left_count);
+	}
+
+	b_tree_node_set_P(left, b_tree_node_get_P(leaf, LEAF_PREV), LEAF_PREV);
+	b_tree_node_set_P(left, rightRRN, LEAF_NEXT);
+	b_tree_node_set_P(right, leafRRN, LEAF_PREV);
+	b_tree_node_set_P(right, nextRRN, LEAF_NEXT);
+
+	b_tree_node_copy(leaf, left);
+	_write_node_at(manager, leafRRN, leaf);
+	_write_node_at(manager, rightRRN, right);
+	b_tree_node_free(left);
+	b_tree_node_free(right);
+
+	//A folha que vinha depois passa a ter a nova folha como anterior
+	if (nextRRN != -1) {
+		BTreeNode *next = _read_node_at(manager, nextRRN);
+		if (next != NULL) {
+			b_tree_node_set_P(next, rightRRN, LEAF_PREV);
+			_write_node_at(manager, nextRRN, next);
+			_release_node(manager, next);
+		}
+	}
+
+	_split_answer ans;
+	ans.key = keys[left_count];
+	ans.RRN = rightRRN;
+	return ans;
+}
+
+/*
+	Divide um nó interno cheio (ou que não caberia mais na página compactada) ao inserir um novo separador (e o filho à sua direita). O separador do meio
+	sobe para o pai (sem ficar em nenhum dos dois nós), como na árvore-B
+	Parametros:
+		manager -> o gerenciador da arvore-B+
+		node -> o nó cheio, obtido com _read_node_at() (é escrito, mas não é devolvido ao cache)
+		nodeRRN -> RRN do nó
+		key -> o separador inserido
+		childRRN -> o filho à direita do separador
+	Retorno:
+		_split_answer. O separador promovido e o RRN do novo nó
+*/
+static _split_answer _split_internal(BPlusTreeManager *manager, BTreeNode *node, int nodeRRN, int key, int childRRN) {
+	int keys[B_TREE_MAX_ORDER], P[B_TREE_MAX_ORDER+1];
+	int n = b_tree_node_get_n(node);
+
+	//Junta os separadores e os filhos do nó com o novo separador e o seu filho direito
+	int position = b_tree_node_search(node, key, NULL);
+	P[0] = b_tree_node_get_P(node, 0);
+	for (int i = 0, j = 0; i <= n; i++) {
+		if (i == position) {
+			keys[i] = key;
+			P[i+1] = childRRN;
+		} else {
+			keys[i] = b_tree_node_get_C(node, j);
+			P[i+1] = b_tree_node_get_P(node, j+1);
+			j++;
+		}
+	}
+
+	int middle = (n+1) / 2;
+	int nivel = b_tree_node_get_nivel(node);
+	BTreeNode *left = _create_node(manager, nivel), *right = _create_node(manager, nivel);
+
+	for (int i = 0; i < middle; i++)
+		b_tree_node_set_item(left, keys[i], -1, i);
+	for (int i = 0; i <= middle; i++)
+		b_tree_node_set_P(left, P[i], i);
+
+	for (int i = middle+1; i <= n; i++)
+		b_tree_node_set_item(right, keys[i], -1, i - (middle+1));
+	for (int i = middle+1; i <= n+1; i++)
+		b_tree_node_set_P(right, P[i], i - (middle+1));
+
+	_split_answer ans;
+	ans.key = keys[middle];
+	ans.RRN = _allocate_node_RRN(manager);
+
+	b_tree_node_copy(node, left);
+	_write_node_at(manager, nodeRRN, node);
+	_write_node_at(manager, ans.RRN, right);
+	b_tree_node_free(left);
+	b_tree_node_free(right);
+
+	return ans;
+}
+
+/*
+	Faz a inserção recursiva de um item na subárvore de um nó
+	Parametros:
+		manager -> o gerenciador da arvore-B+
+		nodeRRN -> o RRN do nó
+		key, value -> o item
+		inserted_ptr -> recebe false se a chave já existir na árvore
+	Retorno:
+		_split_answer. O separador e o novo nó, caso o nó tenha sido dividido (senão, valores -1)
+*/
+static _split_answer _recursive_insert(BPlusTreeManager *manager, int nodeRRN, int key, int value, bool *inserted_ptr) {
+	_split_answer ans;
+	ans.key = ans.RRN = -1;
+
+	BTreeNode *node = _read_node_at(manager, nodeRRN);
+	if (node == NULL) {
+		*inserted_ptr = false;
+		return ans;
+	}
+
+	int n = b_tree_node_get_n(node);
+	int order = b_tree_node_get_order(node);
+
+	if (b_tree_node_get_nivel(node) == 1) {
+		//Chaves repetidas não são inseridas
+		bool found;
+		b_tree_node_search(node, key, &found);
+		*inserted_ptr = !found;
+
+		bool fits = !found && n < order-1;
+		if (fits) {
+			//Em páginas compactadas, o item pode não caber mesmo com espaço no node: ele é desfeito e a folha é dividida
+			int position = b_tree_node_sorted_insert_item(node, key, value);
+			fits = _fits_in_page(manager, node);
+			if (fits) _write_node_at(manager, nodeRRN, node);
+			else b_tree_node_remove_item(node, position);
+		}
+
+		if (!found && !fits) ans = _split_leaf(manager, node, nodeRRN, key, value);
+
+		_release_node(manager, node);
+		return ans;
+	}
+
+	_split_answer child = _recursive_insert(manager, b_tree_node_get_P(node, _child_position(node, key)), key, value, inserted_ptr);
+
+	//O filho foi dividido: o separador é inserido no nó, que também pode precisar ser dividido
+	if (child.RRN != -1) {
+		bool fits = n < order-1;
+		if (fits) {
+			int position = b_tree_node_sorted_insert_item(node, child.key, -1);
+			b_tree_node_insert_P(node, child.RRN, position+1);
+			fits = _fits_in_page(manager, node);
+			if (fits) {
+				_write_node_at(manager, nodeRRN, node);
+			} else {
+				b_tree_node_remove_item(node, position);
+				b_tree_node_remove_P(node, position+1);
+			}
+		}
+
+		if (!fits) ans = _split_internal(manager, node, nodeRRN, child.key, child.RRN);
+	}
+
+	_release_node(manager, node);
+	return ans;
+}
+
+/**
+ *  Insere um par (chave, valor) na arvore-B+
+ *  Parâmetros:
+ *      BPlusTreeManager *manager -> gerenciador com o arquivo aberto em modo que permita escrita
+ *      int key -> a chave (não negativa)
+ *      int value -> o valor (RRN do registro)
+ *  Retorno:
+ *      bool -> true se o par foi inserido (false se a chave já existir ou em caso de erro)
+ */
+bool b_plus_tree_manager_insert(BPlusTreeManager *manager, int key, int value) {
+	if (manager == NULL || manager->bin_file == NULL || key < 0) {
+		DP("ERROR: invalid parameters @b_plus_tree_manager_insert()\n");
+		return false;
+	}
+
+	if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
+		DP("ERROR: BPlusTreeManager is in read-only mode @b_plus_tree_manager_insert()\n");
+		return false;
+	}
+
+	int rootRRN = b_tree_header_get_noRaiz(manager->header);
+
+	//Árvore vazia: a raiz é uma folha com o item
+	if (rootRRN == -1) {
+		BTreeNode *root = _create_node(manager, 1);
+		b_tree_node_sorted_insert_item(root, key, value);
+
+		rootRRN = _allocate_node_RRN(manager);
+		_write_node_at(manager, rootRRN, root);
+		b_tree_node_free(root);
+
+		b_tree_header_set_noRaiz(manager->header, rootRRN);
+		b_tree_header_set_nroNiveis(manager->header, 1);
+		b_tree_header_set_nroChaves(manager->header, H_INCREASE);
+		_end_operations(manager, 1);
+		return true;
+	}
+
+	bool inserted = false;
+	_split_answer ans = _recursive_insert(manager, rootRRN, key, value, &inserted);
+
+	//A raiz foi dividida: cria uma nova raiz com o separador e os dois nós
+	if (ans.RRN != -1) {
+		BTreeNode *root = _create_node(manager, b_tree_header_get_nroNiveis(manager->header) + 1);
+		b_tree_node_set_item(root, ans.key, -1, 0);
+		b_tree_node_set_P(root, rootRRN, 0);
+		b_tree_node_set_P(root, ans.RRN, 1);
+
+		int newRootRRN = _allocate_node_RRN(manager);
+		_write_node_at(manager, newRootRRN, root);
+		b_tree_node_free(root);
+
+		b_tree_header_set_noRaiz(manager->header, newRootRRN);
+		b_tree_header_set_nroNiveis(manager->header, H_INCREASE);
+	}
+
+	if (!inserted) return false;
+
+	b_tree_header_set_nroChaves(manager->header, H_INCREASE);
+	_end_operations(manager, 1);
+	return true;
+}
+
+/*
+	Busca uma chave direto nas páginas compactadas do disco, sem passar pelo cache nem descompactar os nós: cada página
+	do caminho é lida em um buffer e a chave é buscada nos campos compactados. Usada apenas no modo READ, em que o
+	cache não pode ter páginas mais novas que as do disco
+	Parametros:
+		manager -> o gerenciador da arvore-B+ (com páginas compactadas, aberto em modo READ)
+		key -> a chave buscada
+	Retorno:
+		pairIntInt. o mesmo de b_plus_tree_manager_search_for()
+*/
+static pairIntInt _packed_search_for(BPlusTreeManager *manager, int key) {
+	pairIntInt p;
+	p.first = -1;
+	p.second = 0;
+
+	int page_size = b_tree_header_get_page_size(manager->header);
+	if (manager->page_buffer == NULL) manager->page_buffer = malloc(page_size);
+	if (manager->page_buffer == NULL) {
+		DP("ERROR: not enough memory @_packed_search_for()\n");
+		return p;
+	}
+
+	int RRN = b_tree_header_get_noRaiz(manager->header);
+	for (int level = 0; RRN != -1 && level < B_PLUS_TREE_MAX_LEVELS; level++) {
+		//O header ocupa a primeira página
+		if (fseek(manager->bin_file, (long) (RRN+1) * page_size, SEEK_SET) != 0
+			|| fread(manager->page_buffer, page_size, 1, manager->bin_file) != 1) break;
+		p.second++;
+
+		bool found;
+		int position = binary_packed_page_search(manager->page_buffer, key, &found);
+		if (binary_packed_page_get_nivel(manager->page_buffer) == 1) {
+			if (found) p.first = binary_packed_page_get_pointer(manager->page_buffer, position);
+			break;
+		}
+
+		RRN = binary_packed_page_get_pointer(manager->page_buffer, found ? position+1 : position);
+	}
+
+	return p;
+}
+
+/**
+ *  Busca uma chave na arvore-B+. A busca sempre termina em uma folha (os nós internos não guardam valores).
+ *  Com páginas compactadas no modo READ, a busca é feita direto nas páginas, sem descompactá-las
+ *  Parâmetros:
+ *      BPlusTreeManager *manager -> gerenciador com o arquivo aberto
+ *      int key -> a chave buscada
+ *  Retorno:
+ *      pairIntInt -> first: o valor da chave (-1 se ela não existir); second: a quantidade de nós lidos
+ */
+pairIntInt b_plus_tree_manager_search_for(BPlusTreeManager *manager, int key) {
+	pairIntInt p;
+	p.first = p.second = -1;
+	if (manager == NULL || manager->header == NULL) return p;
+	if (manager->packed && OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) return _packed_search_for(manager, key);
+
+	p.second = 0;
+	int leafRRN = _find_leaf(manager, key, &p.second);
+	if (leafRRN == -1) return p;
+
+	BTreeNode *leaf = _read_node_at(manager, leafRRN);
+	if (leaf == NULL) return p;
+
+	bool found;
+	int position = b_tree_node_search(leaf, key, &found);
+	if (found) p.first = b_tree_node_get_Pr(leaf, position);
+	_release_node(manager, leaf);
+
+	return p;
+}
+
+/*
+	Constroi as folhas da arvore-B+ a partir de uma sequencia ordenada de itens, escrevendo-as sequencialmente a partir
+	de proxRRN e já ligadas entre si. As folhas são preenchidas por completo, exceto as duas ultimas, que dividem os
+	itens restantes para que nenhuma delas fique abaixo da ocupacao minima. A primeira chave de cada folha (exceto a
+	primeira) é enviada para 'separators'
+	Parametros:
+		manager -> o gerenciador da arvore-B+
+		source -> os itens, em ordem
+		count -> a quantidade de itens em 'source'
+		separators -> onde os separadores serão inseridos
+	Retorno:
+		int. a quantidade de folhas escritas
+*/
+static int _bulk_build_leaves(BPlusTreeManager *manager, BTreeBulkLoader *source, int count, BTreeBulkLoader *separators) {
+	int capacity = b_tree_header_get_order(manager->header) - 1;
+	int min_keys = B_PLUS_TREE_MIN_KEYS(capacity + 1);
+	int node_count = (count + capacity - 1) / capacity;
+
+	//Itens que sobram para as duas ultimas folhas
+	int remaining = count - (node_count-2) * capacity;
+	int second_last_size = (remaining - capacity >= min_keys) ? capacity : remaining - remaining/2;
+
+	pairIntInt item;
+	for (int i = 0; i < node_count; i++) {
+		int size = capacity;
+		if (node_count == 1) size = count;
+		else if (i == node_count-2) size = second_last_size;
+		else if (i == node_count-1) size = remaining - second_last_size;
+
+		BTreeNode *leaf = _create_node(manager, 1);
+		for (int j = 0; j < size && b_tree_bulk_loader_next(source, &item); j++)
+			b_tree_node_set_item(leaf, item.first, item.second, j);
+
+		//As folhas são consecutivas no arquivo
+		int RRN = b_tree_header_get_proxRRN(manager->header);
+		b_tree_node_set_P(leaf, (i > 0) ? RRN-1 : -1, LEAF_PREV);
+		b_tree_node_set_P(leaf, (i < node_count-1) ? RRN+1 : -1, LEAF_NEXT);
+		if (i > 0) b_tree_bulk_loader_add(separators, b_tree_node_get_C(leaf, 0), -1);
+
+		_write_node_at(manager, RRN, leaf);
+		b_tree_header_set_proxRRN(manager->header, H_INCREASE);
+		b_tree_node_free(leaf);
+	}
+
+	return node_count;
+}
+
+/*
+	Constroi um nivel de nós internos a partir dos separadores do nivel de baixo (mesma distribuição de
+	_bulk_build_level() da árvore-B): entre dois nós consecutivos, um separador sobe para o nivel de cima
+	Parametros:
+		manager -> o gerenciador da arvore-B+
+		source -> os separadores do nivel de baixo, em ordem
+		count -> a quantidade de separadores em 'source'
+		nivel -> o nivel dos nós construidos (>= 2)
+		first_child_RRN -> RRN do primeiro nó do nivel de baixo (os filhos são consecutivos)
+		separators -> onde os separadores promovidos serão inseridos
+	Retorno:
+		int. a quantidade de nós escritos no nivel
+*/
+static int _bulk_build_internal_level(BPlusTreeManager *manager, BTreeBulkLoader *source, int count, int nivel, int first_child_RRN, BTreeBulkLoader *separators) {
+	int order = b_tree_header_get_order(manager->header);
+	int node_count = (count + order) / order;
+	int keys_in_nodes = count - (node_count-1);
+
+	//Separadores que sobram para os dois ultimos nós
+	int remaining = keys_in_nodes - (node_count-2) * (order-1);
+	int second_last_size = (remaining - (order-1) >= B_PLUS_TREE_MIN_KEYS(order)) ? order-1 : remaining - remaining/2;
+
+	int child = first_child_RRN;
+	pairIntInt item;
+	for (int i = 0; i < node_count; i++) {
+		int size = order-1;
+		if (node_count == 1) size = count;
+		else if (i == node_count-2) size = second_last_size;
+		else if (i == node_count-1) size = remaining - second_last_size;
+
+		BTreeNode *node = _create_node(manager, nivel);
+		for (int j = 0; j < size && b_tree_bulk_loader_next(source, &item); j++)
+			b_tree_node_set_item(node, item.first, -1, j);
+		for (int j = 0; j <= size; j++)
+			b_tree_node_set_P(node, child++, j);
+
+		_write_node_at(manager, b_tree_header_get_proxRRN(manager->header), node);
+		b_tree_header_set_proxRRN(manager->header, H_INCREASE);
+		b_tree_node_free(node);
+
+		//Promove o separador entre este nó e o proximo
+		if (i < node_count-1 && b_tree_bulk_loader_next(source, &item))
+			b_tree_bulk_loader_add(separators, item.first, -1);
+	}
+
+	return node_count;
+}
+
+/*
+	Constroi as folhas compactadas da arvore-B+ (assim como _bulk_build_leaves()). Cada folha recebe itens enquanto
+	eles couberem na página compactada, portanto a quantidade de itens por folha depende das chaves e dos valores
+	Parametros:
+		manager -> o gerenciador da arvore-B+ (com páginas compactadas)
+		source -> os itens, em ordem
+		separators -> onde os separadores serão inseridos
+	Retorno:
+		int. a quantidade de folhas escritas
+*/
+static int _bulk_build_packed_leaves(BPlusTreeManager *manager, BTreeBulkLoader *source, BTreeBulkLoader *separators) {
+	int capacity = b_tree_header_get_order(manager->header) - 1;
+	int page_size = b_tree_header_get_page_size(manager->header);
+
+	pairIntInt item;
+	bool pending = b_tree_bulk_loader_next(source, &item);
+	int node_count = 0;
+
+	while (pending) {
+		BTreeNode *leaf = _create_node(manager, 1);
+		int first_key = item.first, min_value = item.second, max_value = item.second;
+
+		for (int j = 0; pending && j < capacity; j++) {
+			int min = (item.second < min_value) ? item.second : min_value;
+			int max = (item.second > max_value) ? item.second : max_value;
+			if (j > 0 && binary_packed_leaf_size(j+1, item.first - first_key, max - min) > page_size) break;
+
+			b_tree_node_set_item(leaf, item.first, item.second, j);
+			min_value = min;
+			max_value = max;
+			pending = b_tree_bulk_loader_next(source, &item);
+		}
+
+		//As folhas são consecutivas no arquivo
+		int RRN = b_tree_header_get_proxRRN(manager->header);
+		b_tree_node_set_P(leaf, (node_count > 0) ? RRN-1 : -1, LEAF_PREV);
+		b_tree_node_set_P(leaf, pending ? RRN+1 : -1, LEAF_NEXT);
+		if (node_count > 0) b_tree_bulk_loader_add(separators, b_tree_node_get_C(leaf, 0), -1);
+
+		_write_node_at(manager, RRN, leaf);
+		b_tree_header_set_proxRRN(manager->header, H_INCREASE);
+		b_tree_node_free(leaf);
+		node_count++;
+	}
+
+	return node_count;
+}
+
+/*
+	Constroi um nivel de nós internos compactados (assim como _bulk_build_internal_level()). Cada nó recebe separadores
+	e filhos enquanto eles couberem na página; um nó nunca fica com apenas um filho
+	Parametros:
+		manager -> o gerenciador da arvore-B+ (com páginas compactadas)
+		source -> os separadores do nivel de baixo, em ordem
+		count -> a quantidade de separadores em 'source'
+		nivel -> o nivel dos nós construidos (>= 2)
+		first_child_RRN -> RRN do primeiro nó do nivel de baixo (os filhos são consecutivos)
+		separators -> onde os separadores promovidos serão inseridos
+	Retorno:
+		int. a quantidade de nós escritos no nivel
+*/
+static int _bulk_build_packed_internal_level(BPlusTreeManager *manager, BTreeBulkLoader *source, int count, int nivel, int first_child_RRN, BTreeBulkLoader *separators) {
+	int capacity = b_tree_header_get_order(manager->header) - 1;
+	int page_size = b_tree_header_get_page_size(manager->header);
+	int child = first_child_RRN, last_child = first_child_RRN + count;
+
+	pairIntInt item;
+	bool pending = b_tree_bulk_loader_next(source, &item);
+	int node_count = 0;
+
+	while (child <= last_child) {
+		BTreeNode *node = _create_node(manager, nivel);
+		int node_first_child = child;
+		b_tree_node_set_P(node, child++, 0);
+
+		int n = 0;
+		while (pending && n < capacity) {
+			int first_key = (n > 0) ? b_tree_node_get_C(node, 0) : item.first;
+			if (n > 0 && binary_packed_internal_size(n+1, item.first - first_key, child - node_first_child) > page_size) break;
+
+			b_tree_node_set_item(node, item.first, -1, n);
+			b_tree_node_set_P(node, child++, ++n);
+			pending = b_tree_bulk_loader_next(source, &item);
+		}
+
+		//Promove o separador entre este nó e o proximo. Se sobrar apenas um filho, o último filho deste nó vai junto
+		//com ele para o próximo nó (o separador entre os dois é o promovido)
+		if (child == last_child && n > 1) {
+			b_tree_bulk_loader_add(separators, b_tree_node_get_C(node, n-1), -1);
+			b_tree_node_remove_item(node, n-1);
+			b_tree_node_set_P(node, -1, n);
+			child--;
+		} else if (child <= last_child && pending) {
+			b_tree_bulk_loader_add(separators, item.first, -1);
+			pending = b_tree_bulk_loader_next(source, &item);
+		}
+
+		_write_node_at(manager, b_tree_header_get_proxRRN(manager->header), node);
+		b_tree_header_set_proxRRN(manager->header, H_INCREASE);
+		b_tree_node_free(node);
+		node_count++;
+	}
+
+	return node_count;
+}
+
+/**
+ *  Constroi a arvore-B+ de baixo para cima a partir de todos os pares (chave, valor) de um BTreeBulkLoader:
+ *  primeiro as folhas, já encadeadas, e depois cada nivel de nós internos, de forma sequencial.
+ *  A arvore deve estar vazia (arquivo recem criado).
+ *  Parâmetros:
+ *      BPlusTreeManager *manager -> o gerenciador, aberto em modo que permita escrita
+ *      BTreeBulkLoader *loader -> o ordenador com os pares inseridos (é finalizado por esta funcao)
+ *  Retorno:
+ *      bool -> indica se a construcao foi bem sucedida
+ */
+bool b_plus_tree_manager_bulk_load(BPlusTreeManager *manager, BTreeBulkLoader *loader) {
+	if (manager == NULL || loader == NULL) {
+		DP("ERROR: invalid parameters @b_plus_tree_manager_bulk_load()\n");
+		return false;
+	}
+
+	if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode) || manager->bin_file == NULL) {
+		DP("ERROR: BPlusTreeManager is not opened for writing @b_plus_tree_manager_bulk_load()\n");
+		return false;
+	}
+
+	if (b_tree_header_get_noRaiz(manager->header) != -1) {
+		DP("ERROR: bulk load is only supported on an empty tree @b_plus_tree_manager_bulk_load()\n");
+		return false;
+	}
+
+	if (!b_tree_bulk_loader_finish(loader)) return false;
+
+	int count = b_tree_bulk_loader_get_count(loader);
+	if (count == 0) return true;
+	b_tree_header_set_nroChaves(manager->header, count);
+
+	//Os separadores são, no maximo, um a cada (order-1)/2 itens do nivel de baixo
+	int order = b_tree_header_get_order(manager->header);
+	int separators_capacity = count / B_PLUS_TREE_MIN_KEYS(order) + 1;
+	if (separators_capacity > B_TREE_BULK_LOAD_RUN_CAPACITY) separators_capacity = B_TREE_BULK_LOAD_RUN_CAPACITY;
+
+	BTreeBulkLoader *separators = b_tree_bulk_loader_create(separators_capacity);
+	if (separators == NULL) return false;
+
+	int level_first_RRN = b_tree_header_get_proxRRN(manager->header);
+	int node_count = manager->packed ? _bulk_build_packed_leaves(manager, loader, separators)
+		: _bulk_build_leaves(manager, loader, count, separators);
+	int nivel = 1;
+
+	//Cada nivel com mais de um nó recebe um nivel de nós internos acima dele
+	while (node_count > 1) {
+		if (!b_tree_bulk_loader_finish(separators)) {
+			b_tree_bulk_loader_free(&separators);
+			return false;
+		}
+
+		BTreeBulkLoader *source = separators;
+		separators = b_tree_bulk_loader_create(separators_capacity);
+		if (separators == NULL) {
+			b_tree_bulk_loader_free(&source);
+			return false;
+		}
+
+		int first_child_RRN = level_first_RRN;
+		level_first_RRN = b_tree_header_get_proxRRN(manager->header);
+		if (manager->packed) node_count = _bulk_build_packed_internal_level(manager, source, node_count-1, ++nivel, first_child_RRN, separators);
+		else node_count = _bulk_build_internal_level(manager, source, node_count-1, ++nivel, first_child_RRN, separators);
+		b_tree_bulk_loader_free(&source);
+	}
+
+	b_tree_bulk_loader_free(&separators);
+	b_tree_header_set_noRaiz(manager->header, level_first_RRN);
+	b_tree_header_set_nroNiveis(manager->header, nivel);
+	return true;
+}
+
+/*
+	Retorna as estatisticas do cache de paginas do gerenciador
+	Retorno:
+		pairIntInt. first -> acertos no cache, second -> faltas (nós lidos do disco)
+*/
+pairIntInt b_plus_tree_manager_get_cache_stats(BPlusTreeManager *manager) {
+	if (manager == NULL) {
+		pairIntInt p;
+		p.first = p.second = 0;
+		return p;
+	}
+
+	return b_tree_page_cache_get_stats(manager->page_cache);
+}
+
+BTreeHeader *b_plus_tree_manager_get_headers(BPlusTreeManager *manager) {
+	return (manager != NULL) ? manager->header : NULL;
+}
+
+/*
+	Struct que representa um cursor sobre as folhas da arvore-B+: a folha e a posição do item atual.
+	Diferente do cursor da árvore-B, não é preciso guardar o caminho desde a raiz, pois as folhas são encadeadas.
+*/
+struct _b_plus_tree_cursor {
+	BPlusTreeManager *manager;
+	int leafRRN;		//Folha do item atual (-1 indica cursor inválido)
+	int position;		//Posição do item atual na folha
+	int key, value;		//Item atual
+	int pages;			//Quantidade de nós visitados
+};
+
+/**
+ *  Cria um cursor para percorrer a arvore-B+ em ordem de chave. O cursor começa inválido e deve ser posicionado
+ *  com b_plus_tree_cursor_seek(), b_plus_tree_cursor_seek_first() ou b_plus_tree_cursor_seek_last().
+ *  OBS: a árvore não deve ser modificada enquanto o cursor estiver em uso
+ *  Parâmetros:
+ *      BPlusTreeManager *manager -> gerenciador com o arquivo de índices aberto
+ *  Retorno:
+ *      BPlusTreeCursor* -> o cursor, ou NULL em caso de erro
+ */
+BPlusTreeCursor *b_plus_tree_cursor_create(BPlusTreeManager *manager) {
+	if (manager == NULL || manager->header == NULL) {
+		DP("ERROR: invalid parameter @b_plus_tree_cursor_create()\n");
+		return NULL;
+	}
+
+	BPlusTreeCursor *cursor = calloc(1, sizeof(BPlusTreeCursor));
+	if (cursor == NULL) {
+		DP("ERROR: not enough memory @b_plus_tree_cursor_create()\n");
+		return NULL;
+	}
+
+	cursor->manager = manager;
+	cursor->leafRRN = -1;
+	return cursor;
+}
+
+void b_plus_tree_cursor_free(BPlusTreeCursor **cursor_ptr) {
+	if (cursor_ptr == NULL) return;
+	free(*cursor_ptr);
+	*cursor_ptr = NULL;
+}
+
+/*
+	Funcao (privada) que lê o item atual do cursor. Se a posição estiver além do fim (ou antes do início) da folha,
+	segue as ligações para a próxima folha (forward) ou para a anterior
+	Retorno:
+		bool. Indica se o cursor aponta para um item válido
+*/
+static bool _cursor_load(BPlusTreeCursor *cursor, bool forward) {
+	while (cursor->leafRRN != -1) {
+		BTreeNode *leaf = _read_node_at(cursor->manager, cursor->leafRRN);
+		if (leaf == NULL) break;
+
+		int n = b_tree_node_get_n(leaf);
+		if (cursor->position == CURSOR_LAST_POSITION) cursor->position = n-1;
+
+		if (cursor->position >= 0 && cursor->position < n) {
+			cursor->key = b_tree_node_get_C(leaf, cursor->position);
+			cursor->value = b_tree_node_get_Pr(leaf, cursor->position);
+			_release_node(cursor->manager, leaf);
+			return true;
+		}
+
+		cursor->leafRRN = b_tree_node_get_P(leaf, forward ? LEAF_NEXT : LEAF_PREV);
+		cursor->position = forward ? 0 : CURSOR_LAST_POSITION;
+		_release_node(cursor->manager, leaf);
+		if (cursor->leafRRN != -1) cursor->pages++;
+	}
+
+	cursor->leafRRN = -1;
+	return false;
+}
+
+/**
+ *  Posiciona o cursor no primeiro item com chave maior ou igual a uma chave dada
+ *  Parâmetros:
+ *      BPlusTreeCursor *cursor -> o cursor
+ *      int key -> a chave buscada
+ *  Retorno:
+ *      bool -> indica se existe tal item (senão, o cursor fica inválido)
+ */
+bool b_plus_tree_cursor_seek(BPlusTreeCursor *cursor, int key) {
+	if (cursor == NULL) return false;
+
+	cursor->leafRRN = _find_leaf(cursor->manager, key, &cursor->pages);
+	if (cursor->leafRRN == -1) return false;
+
+	BTreeNode *leaf = _read_node_at(cursor->manager, cursor->leafRRN);
+	if (leaf == NULL) {
+		cursor->leafRRN = -1;
+		return false;
+	}
+
+	//Se todas as chaves da folha forem menores, o item buscado é o primeiro da próxima folha
+	cursor->position = b_tree_node_search(leaf, key, NULL);
+	_release_node(cursor->manager, leaf);
+	return _cursor_load(cursor, true);
+}
+
+bool b_plus_tree_cursor_seek_first(BPlusTreeCursor *cursor) {
+	if (cursor == NULL) return false;
+	cursor->leafRRN = _find_leaf(cursor->manager, INT_MIN, &cursor->pages);
+	cursor->position = 0;
+	return _cursor_load(cursor, true);
+}
+
+bool b_plus_tree_cursor_seek_last(BPlusTreeCursor *cursor) {
+	if (cursor == NULL) return false;
+	cursor->leafRRN = _find_leaf(cursor->manager, INT_MAX, &cursor->pages);
+	cursor->position = CURSOR_LAST_POSITION;
+	return _cursor_load(cursor, false);
+}
+
+/**
+ *  Avança o cursor para o item seguinte, em ordem de chave (seguindo para a próxima folha ao fim da atual)
+ *  Parâmetros:
+ *      BPlusTreeCursor *cursor -> cursor válido
+ *  Retorno:
+ *      bool -> indica se existe o item seguinte (senão, o cursor fica inválido)
+ */
+bool b_plus_tree_cursor_next(BPlusTreeCursor *cursor) {
+	if (!b_plus_tree_cursor_is_valid(cursor)) return false;
+	cursor->position++;
+	return _cursor_load(cursor, true);
+}
+
+/**
+ *  Volta o cursor para o item anterior, em ordem de chave (seguindo para a folha anterior no início da atual)
+ *  Parâmetros:
+ *      BPlusTreeCursor *cursor -> cursor válido
+ *  Retorno:
+ *      bool -> indica se existe o item anterior (senão, o cursor fica inválido)
+ */
+bool b_plus_tree_cursor_prev(BPlusTreeCursor *cursor) {
+	if (!b_plus_tree_cursor_is_valid(cursor)) return false;
+	cursor->position--;
+	return _cursor_load(cursor, false);
+}
+
+bool b_plus_tree_cursor_is_valid(BPlusTreeCursor *cursor) {
+	return cursor != NULL && cursor->leafRRN != -1;
+}
+
+/**
+ *  Obtém o item atual do cursor
+ *  Parâmetros:
+ *      BPlusTreeCursor *cursor -> o cursor
+ *  Retorno:
+ *      pairIntInt -> first: chave (C), second: valor (Pr). Ambos -1 se o cursor for inválido
+ */
+pairIntInt b_plus_tree_cursor_get(BPlusTreeCursor *cursor) {
+	pairIntInt p;
+	p.first = p.second = -1;
+	if (!b_plus_tree_cursor_is_valid(cursor)) return p;
+
+	p.first = cursor->key;
+	p.second = cursor->value;
+	return p;
+}
+
+//Quantidade de nós visitados pelo cursor desde a sua criação
+int b_plus_tree_cursor_get_pages(BPlusTreeCursor *cursor) {
+	return (cursor != NULL) ? cursor->pages : -1;
+}
@@ -0,0 +1,278 @@
+#include "b_tree_bulk_loader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "debug.h"
+
+/*
+    Struct que representa o ordenador de pares (chave, valor) usado na construção da árvore-B de baixo para cima.
+    Os pares são acumulados em RAM (run); quando a run enche, ela é ordenada e despejada em um arquivo temporário.
+    Ao final, se houver apenas uma run, ela é lida diretamente da RAM. Caso contrário, as runs são intercaladas
+    (merge) em um único arquivo temporário ordenado.
+    Chaves repetidas são descartadas, mantendo o par de menor valor (o primeiro RRN, como na inserção comum).
+*/
+struct _b_tree_bulk_loader {
+    pairIntInt *run;        //Run atual, em RAM
+    int run_size;
+    int run_capacity;
+
+    FILE **run_files;       //Runs já ordenadas e despejadas no disco
+    int run_files_count;
+
+    FILE *merged_file;      //Resultado da intercalação das runs (NULL se tudo coube em RAM)
+    int count;              //Quantidade de pares únicos (definida em b_tree_bulk_loader_finish())
+    int read_pos;           //Posição atual da leitura dos pares ordenados
+    bool finished;
+};
+
+/*
+    Funcao que cria o ordenador de pares
+    Parametros:
+        run_capacity -> quantidade máxima de pares mantidos em RAM
+    Retorno:
+        BTreeBulkLoader* . o ordenador criado, ou NULL em caso de erro
+*/
+BTreeBulkLoader *b_tree_bulk_loader_create(int run_capacity) {
+    if (run_capacity <= 0) {
+        DP("ERROR: invalid run capacity @b_tree_bulk_loader_create()\n");
+        return NULL;
+    }
+
+    //Tenta alocar memória
+    BTreeBulkLoader *loader = malloc(sizeof(BTreeBulkLoader));
+    if (loader == NULL) {
+        DP("ERROR: not enough memory for BTreeBulkLoader @b_tree_bulk_loader_create()\n");
+        return NULL;
+    }
+
+    loader->run = malloc(sizeof(pairIntInt) * run_capacity);
+    if (loader->run == NULL) {
+        DP("ERROR: not enough memory for BTreeBulkLoader run @b_tree_bulk_loader_create()\n");
+        free(loader);
+        return NULL;
+    }
+
+    //Define os valores iniciais
+    loader->run_size = 0;
+    loader->run_capacity = run_capacity;
+    loader->run_files = NULL;
+    loader->run_files_count = 0;
+    loader->merged_file = NULL;
+    loader->count = 0;
+    loader->read_pos = 0;
+    loader->finished = false;
+    return loader;
+}
+
+//Função de comparação usada no qsort: ordena por chave e, em caso de empate, por valor
+static int _compare_pairs(const void *a, const void *b) {
+    const pairIntInt *p1 = a, *p2 = b;
+    if (p1->first != p2->first) return (p1->first < p2->first) ? -1 : 1;
+    if (p1->second != p2->second) return (p1->second < p2->second) ? -1 : 1;
+    return 0;
+}
+
+/*
+    Ordena a run atual e a despeja em um arquivo temporário
+    Retorno:
+        bool. indica se a operação foi bem sucedida
+*/
+static bool _spill_run(BTreeBulkLoader *loader) {
+    FILE **run_files = realloc(loader->run_files, sizeof(FILE*) * (loader->run_files_count + 1));
+    if (run_files == NULL) {
+        DP("ERROR: not enough memory for a new run @_spill_run()\n");
+        return false;
+    }
+    loader->run_files = run_files;
+
+    FILE *run_file = tmpfile();
+    if (run_file == NULL) {
+        DP("ERROR: unable to create temporary run file @_spill_run()\n");
+        return false;
+    }
+
+    qsort(loader->run, loader->run_size, sizeof(pairIntInt), _compare_pairs);
+    fwrite(loader->run, sizeof(pairIntInt), loader->run_size, run_file);
+    rewind(run_file);
+
+    loader->run_files[loader->run_files_count++] = run_file;
+    loader->run_size = 0;
+    return true;
+}
+
+/*
+    Adiciona um par (chave, valor) ao ordenador. Chaves negativas (inválidas) são ignoradas
+    Parametros:
+        loader -> o ordenador
+        key -> a chave (idNascimento)
+        value -> o valor (RRN do registro)
+    Retorno:
+        bool. indica se a operação foi bem sucedida
+*/
+bool b_tree_bulk_loader_add(BTreeBulkLoader *loader, int key, int value) {
+    if (loader == NULL || loader->finished) {
+        DP("ERROR: invalid BTreeBulkLoader state @b_tree_bulk_loader_add()\n");
+        return false;
+    }
+
+    if (key < 0) return true;
+
+    if (loader->run_size == loader->run_capacity && !_spill_run(loader))
+        return false;
+
+    loader->run[loader->run_size].first = key;
+    loader->run[loader->run_size].second = value;
+    loader->run_size++;
+    return true;
+}
+
+/*
+    Intercala todas as runs despejadas em um único arquivo ordenado e sem chaves repetidas
+    Retorno:
+        bool. indica se a operação foi bem sucedida
+*/
+static bool _merge_runs(BTreeBulkLoader *loader) {
+    loader->merged_file = tmpfile();
+    if (loader->merged_file == NULL) {
+        DP("ERROR: unable to create temporary merge file @_merge_runs()\n");
+        return false;
+    }
+
+    //Guarda o primeiro par ainda não intercalado de cada run
+    int runs = loader->run_files_count;
+    pairIntInt *heads = malloc(sizeof(pairIntInt) * runs);
+    bool *has_head = malloc(sizeof(bool) * runs);
+    if (heads == NULL || has_head == NULL) {
+        DP("ERROR: not enough memory to merge runs @_merge_runs()\n");
+        free(heads);
+        free(has_head);
+        return false;
+    }
+
+    for (int i = 0; i < runs; i++)
+        has_head[i] = fread(&heads[i], sizeof(pairIntInt), 1, loader->run_files[i]) == 1;
+
+    loader->count = 0;
+    int last_key = -1;
+    while (true) {
+        //Escolhe o menor par entre os primeiros de cada run
+        int min = -1;
+        for (int i = 0; i < runs; i++) {
+            if (has_head[i] && (min == -1 || _compare_pairs(&heads[i], &heads[min]) < 0))
+                min = i;
+        }
+        if (min == -1) break;
+
+        //Como os pares estão ordenados também por valor, o primeiro de cada chave é o de menor RRN
+        if (loader->count == 0 || heads[min].first != last_key) {
+            fwrite(&heads[min], sizeof(pairIntInt), 1, loader->merged_file);
+            last_key = heads[min].first;
+            loader->count++;
+        }
+
+        has_head[min] = fread(&heads[min], sizeof(pairIntInt), 1, loader->run_files[min]) == 1;
+    }
+
+    free(heads);
+    free(has_head);
+
+    //Os arquivos das runs não são mais necessários
+    for (int i = 0; i < runs; i++)
+        fclose(loader->run_files[i]);
+    free(loader->run_files);
+    loader->run_files = NULL;
+    loader->run_files_count = 0;
+
+    rewind(loader->merged_file);
+    return true;
+}
+
+/*
+    Finaliza a inserção de pares, ordenando-os e removendo chaves repetidas.
+    Após essa função, os pares podem ser lidos em ordem com b_tree_bulk_loader_next()
+    Parametros:
+        loader -> o ordenador
+    Retorno:
+        bool. indica se a operação foi bem sucedida
+*/
+bool b_tree_bulk_loader_finish(BTreeBulkLoader *loader) {
+    if (loader == NULL || loader->finished) {
+        DP("ERROR: invalid BTreeBulkLoader state @b_tree_bulk_loader_finish()\n");
+        return false;
+    }
+
+    loader->finished = true;
+    loader->read_pos = 0;
+
+    //Se houver runs no disco, a run atual também precisa ir para o disco para ser intercalada
+    if (loader->run_files_count > 0) {
+        if (loader->run_size > 0 && !_spill_run(loader)) return false;
+        return _merge_runs(loader);
+    }
+
+    //Tudo coube em RAM: ordena e remove repetidos na própria run
+    qsort(loader->run, loader->run_size, sizeof(pairIntInt), _compare_pairs);
+    loader->count = 0;
+    for (int i = 0; i < loader->run_size; i++) {
+        if (loader->count == 0 || loader->run[i].first != loader->run[loader->count-1].first)
+            loader->run[loader->count++] = loader->run[i];
+    }
+
+    return true;
+}
+
+//Retorna a quantidade de pares únicos (só é válida após b_tree_bulk_loader_finish())
+int b_tree_bulk_loader_get_count(BTreeBulkLoader *loader) {
+    if (loader == NULL || !loader->finished) return -1;
+    return loader->count;
+}
+
+/*
+    Obtém o próximo par em ordem crescente de chave
+    Parametros:
+        loader -> o ordenador (já finalizado)
+        pair -> onde o par lido será guardado
+    Retorno:
+        bool. false quando não houver mais pares
+*/
+bool b_tree_bulk_loader_next(BTreeBulkLoader *loader, pairIntInt *pair) {
+    if (loader == NULL || !loader->finished || pair == NULL) return false;
+    if (loader->read_pos >= loader->count) return false;
+
+    if (loader->merged_file != NULL) {
+        if (fread(pair, sizeof(pairIntInt), 1, loader->merged_file) != 1) return false;
+    } else {
+        *pair = loader->run[loader->read_pos];
+    }
+
+    loader->read_pos++;
+    return true;
+}
+
+/*
+    Funcao que desaloca a memoria do ordenador e fecha seus arquivos temporários
+    Parametros:
+        loader_ptr -> o endereco do ordenador
+*/
+void b_tree_bulk_loader_free(BTreeBulkLoader **loader_ptr) {
+    if (loader_ptr == NULL) {
+        DP("ERROR: invalid parameter @b_tree_bulk_loader_free()\n");
+        return;
+    }
+    #define loader (*loader_ptr)
+
+    //Já foi liberado
+    if (loader == NULL) return;
+
+    for (int i = 0; i < loader->run_files_count; i++)
+        fclose(loader->run_files[i]);
+    free(loader->run_files);
+
+    if (loader->merged_file != NULL) fclose(loader->merged_file);
+
+    free(loader->run);
+    free(loader);
+    loader = NULL;
+    #undef loader
+}
@@ -2,15 +2,24 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <unistd.h>
 
 #include "binary_io.h"
 #include "binary_b_tree.h"
 #include "b_tree_header.h"
 #include "b_tree_node.h"
+#include "b_tree_page_cache.h"
+#include "b_tree_bulk_loader.h"
+#include "wal.h"
 #include "string_utils.h"
 #include "debug.h"
 
-#define NODE_SIZE 72
+//Quantidade mínima de chaves em um nó que não seja a raiz, dada a ordem da árvore
+#define B_TREE_MIN_KEYS(order) (((order)-1)/2)
+
+//Altura máxima considerada nos percursos iterativos (com no mínimo 3 filhos por nó, muito além de qualquer arquivo possível)
+#define B_TREE_MAX_LEVELS 64
 
 /*
 	Struct auxiliar para a funcao recursiva de insercao na arvore-B.
@@ -25,13 +34,16 @@ struct _insert_answer {
 /*
 	Struct que representa o gerenciador do arquivo de índices, usada para
 	armazenar certas informações relacionadas ao arquivo, como os headers, 
-	modo de abertura e rrn atual.
+	modo de abertura e o cache de páginas (nós) do arquivo.
 */
 struct _b_tree_manager {
 	BTreeHeader *header;
 	OPEN_MODE requested_mode;
 	FILE *bin_file;
-	int currRRN;
+	BTreePageCache *page_cache;
+	int create_order;			//Ordem usada ao criar um arquivo novo (modo CREATE)
+	int create_page_size;		//Tamanho de página usado ao criar um arquivo novo (modo CREATE)
+	WriteAheadLog *wal;			//Log das modificações (apenas no modo MODIFY; NULL nos demais)
 };
 
 
@@ -52,10 +64,50 @@ BTreeManager *b_tree_manager_create(void) {
 	//Define os valores iniciais
 	manager -> header = NULL;
 	manager -> bin_file = NULL;
-	manager -> currRRN = -1;
+	manager -> page_cache = NULL;
+	manager -> create_order = B_TREE_ORDER;
+	manager -> create_page_size = NODE_SIZE;
+	manager -> wal = NULL;
 	return manager;
 }
 
+/**
+ *  Define o formato (ordem e tamanho de página) dos arquivos que forem criados pelo gerenciador (modo CREATE).
+ *  Arquivos existentes são sempre abertos no formato descrito em seus headers. Por padrão, o formato da especificação
+ *  (B_TREE_ORDER e NODE_SIZE) é usado. Páginas maiores que os nós são completadas com lixo, o que permite,
+ *  por exemplo, alinhar cada nó a uma página do sistema de arquivos.
+ *  Parâmetros:
+ *      BTreeManager *manager -> instância do gerenciador (antes da abertura do arquivo)
+ *      int order -> ordem dos nós (entre B_TREE_MIN_ORDER e B_TREE_MAX_ORDER)
+ *      int page_size -> tamanho de cada página (>= B_TREE_NODE_SIZE(order))
+ *  Retorno:
+ *      bool -> true se o formato é válido
+ */
+bool b_tree_manager_set_format(BTreeManager *manager, int order, int page_size) {
+	//Validação de parâmetros
+	if (manager == NULL || order < B_TREE_MIN_ORDER || order > B_TREE_MAX_ORDER || page_size < B_TREE_NODE_SIZE(order)) {
+		DP("ERROR: (parameter) invalid parameters @b_tree_manager_set_format()\n");
+		return false;
+	}
+
+	manager->create_order = order;
+	manager->create_page_size = page_size;
+	return true;
+}
+
+/**
+ *  Retorna a maior ordem cujos nós cabem em uma página de um dado tamanho
+ *  Parâmetros:
+ *      int page_size -> tamanho da página
+ *  Retorno:
+ *      int -> a ordem (limitada a B_TREE_MAX_ORDER), ou -1 se nenhum nó couber na página
+ */
+int b_tree_manager_order_for_page_size(int page_size) {
+	int order = page_size / B_TREE_NODE_SIZE(1);
+	if (order > B_TREE_MAX_ORDER) order = B_TREE_MAX_ORDER;
+	return (order < B_TREE_MIN_ORDER) ? -1 : order;
+}
+
 /**
  *  Abre ou cria um arquivo binário, o qual será gerenciado pelo BTreeManager.
  *  Parâmetros:
@@ -82,11 +134,18 @@ bool b_tree_manager_open(BTreeManager *manager, char* bin_filename, OPEN_MODE mo
 	}
 
     //Vetor de conversão do enum modo para a string que o representa (READ = rb, CREATE = )
-    static char* mode_to_str[] = {"rb", "wb+", "rb+"};
+    static char* mode_to_str[] = {"rb", "wb+", "rb+", "rb"};
 
     //Guarda o modo de abertura para uso em outras funções
     manager->requested_mode = mode;
 
+    //Um arquivo recriado não pode receber o log de um arquivo anterior. No modo MODIFY, se o arquivo não foi fechado
+    //corretamente e há um log, ele é recuperado antes da abertura (o status fica no primeiro byte do header). Os modos
+    //de leitura não alteram o arquivo: um arquivo com log é inconsistente
+    if (mode == CREATE) wal_discard(bin_filename);
+    else if (mode == MODIFY && !wal_recover(bin_filename, 0, '1')) return OPEN_FAILED;
+    else if (OPEN_MODE_IS_READ_ONLY(mode) && wal_exists(bin_filename)) return OPEN_INCONSISTENT;
+
     //Abre o arquivo binário no modo selecionado (ler os modos)
     manager->bin_file = fopen(bin_filename, mode_to_str[mode]);
 
@@ -95,19 +154,35 @@ bool b_tree_manager_open(BTreeManager *manager, char* bin_filename, OPEN_MODE mo
 
     //Inicializa os headers com valores padrão (ou será usado para a escrita de um novo arquivo, ou substituído pelos headers do arquivo existente)
     manager->header = b_tree_header_create();
-    
+
     //Se o modo for CREATE, ou seja, criar um novo arquivo, defina os headers com valores iniciais (RAM -> disco)
     if (mode == CREATE) {
+        b_tree_header_set_format(manager->header, manager->create_order, manager->create_page_size);
         b_tree_header_write_to_bin(manager->header, manager->bin_file);
     } else { 
         //Se for outro modo, ou seja, o arquivo já existe, atualize o headers (disco -> RAM) e certifique-se de que o arquivo está consistente e não vazio
         b_tree_header_read_from_bin(manager->header, manager->bin_file);
+
+		//As modificações (páginas e headers) passam a ser feitas pela stream do log, que é aberto antes do cache de páginas
+		//(se ele não puder ser criado, o arquivo é modificado sem log)
+		if (mode == MODIFY && b_tree_header_get_status(manager->header) == '1' && !B_TREE_FORMAT_IS_PLUS(b_tree_header_get_version(manager->header)))
+			manager->wal = wal_open(bin_filename, &manager->bin_file);
+    }
+
+	//Cria o cache de páginas, que fará todo o acesso aos nós do arquivo (no formato descrito pelos headers)
+	manager->page_cache = b_tree_page_cache_create(manager->bin_file, b_tree_header_get_order(manager->header),
+		b_tree_header_get_page_size(manager->header), B_TREE_PAGE_CACHE_CAPACITY);
+
+    if (mode != CREATE) {
         if (b_tree_header_get_status(manager->header) != '1') return OPEN_INCONSISTENT;
 
+		//Arquivos de árvore-B+ têm outro formato de página e são gerenciados pelo BPlusTreeManager
+		if (B_TREE_FORMAT_IS_PLUS(b_tree_header_get_version(manager->header))) return OPEN_FAILED;
+
         if (mode == MODIFY) { 
 			//Se houver intenção de modificar o arquivo, defina o status como inconsistente
             b_tree_header_set_status(manager->header, '0');
-            b_tree_header_write_to_bin(manager->header, manager->bin_file);
+            b_tree_manager_write_headers_to_disk(manager);
         }
     }
     
@@ -129,7 +204,7 @@ void b_tree_manager_write_headers_to_disk(BTreeManager *manager) {
     }
 
     //Valida o modo, impedindo tentativas de escrita no modo somente leitura
-    if (manager->requested_mode == READ) {
+    if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
         DP("ERROR: trying to write headers on a read-only BTreeManager @b_tree_manager_write_headers_to_disk()\n");
         return;
     }
@@ -140,7 +215,7 @@ void b_tree_manager_write_headers_to_disk(BTreeManager *manager) {
         return;
     }
 
-    //Escreve os headers no arquivo binário
+    //Escreve os headers no arquivo binário (o header ocupa a primeira página)
     b_tree_header_write_to_bin(manager->header, manager->bin_file);
 }
 
@@ -176,11 +251,17 @@ void b_tree_manager_close(BTreeManager *manager) {
     //Verifica se o manager já foi deletado ou se o arquivo já foi fechado
     if (manager == NULL || manager->bin_file == NULL) return;
     
-    if (manager->requested_mode != READ) {
+	//Escreve no disco os nós que foram modificados apenas em RAM e libera o cache
+	b_tree_page_cache_free(&manager->page_cache);
+
+    if (!OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
 		//Marca o arquivo como consistente. (OBS: não é necessário no caso da leitura, pois nenhuma modificação foi feita)
         b_tree_header_set_status(manager->header, '1');
 		//Salva os headers no disco
         b_tree_manager_write_headers_to_disk(manager);
+
+		//Confirma as últimas modificações, sincroniza o arquivo e descarta o log
+		wal_close(&manager->wal);
     }
 
 	//Limpa a memória dos headers na RAM
@@ -190,8 +271,6 @@ void b_tree_manager_close(BTreeManager *manager) {
     fclose(manager->bin_file);
 	//Marca qua não existe arquivo aberto
     manager->bin_file = NULL;
-
-	manager->currRRN = -1;
 }
 
 
@@ -218,7 +297,6 @@ void b_tree_manager_free(BTreeManager **manager_ptr) {
 
 	//Redefine os valores ao padrão inicial
 	manager -> bin_file = NULL;
-	manager -> currRRN = -1;
 	free(manager);
 	manager = NULL;
 	#undef manager
@@ -226,46 +304,20 @@ void b_tree_manager_free(BTreeManager **manager_ptr) {
 
 
 /*
-	Funcao para fazer seek no arquivo sendo gerenciado
-	Parametros:
-		manager -> o gerenciador que contem o arquivo onde sera feito o seek
-		RRN -> RRN para onde o ponteiro sera levado
-	Retorno: void
-*/
-static void _b_tree_manager_seek(BTreeManager *manager, int RRN) {
-	//Validação de parâmetros
-	if (manager == NULL) {
-		DP("ERROR: invalid parameter @_b_tree_manager_seek()");
-		return;
-	}
-	
-	if (RRN < 0) {
-		DP("ERROR: invalid given RRN @_b_tree_manager_seek()\n");
-	}
-
-	fseek(manager->bin_file, (RRN+1) * NODE_SIZE, SEEK_SET);
-	manager->currRRN = RRN;
-}
-
-/*
-	Funcao que le um node, precisa estar exatamente no comeco do node para funcionar
+	Funcao que cria um node vazio na ordem do arquivo aberto
 	Parametros:
-		manager -> o gerenciador de node que tera' um node lido em seu binario
+		manager -> o gerenciador da arvore-B
+		nivel -> o nivel do node na arvore
 	Retorno:
-		BTreeNode* -> O node lido
+		BTreeNode* -> O node criado (deve ser liberado com b_tree_node_free())
 */
-BTreeNode *_b_tree_manager_read_current(BTreeManager *manager) {
-	if (manager == NULL) {
-		DP("ERROR: invalid parameter @_b_tree_manager_read_current()\n");
-		return NULL;
-	}
-
-	manager->currRRN++;
-	return binary_read_b_tree_node(manager->bin_file);
+static BTreeNode *_create_node(BTreeManager *manager, int nivel) {
+	return b_tree_node_create_with_order(nivel, b_tree_header_get_order(manager->header));
 }
 
 /*
-	Funcao que le um node em um RRN dado
+	Funcao que le um node em um RRN dado. O node é obtido do cache de páginas (só há acesso ao disco se ele não estiver em RAM)
+	OBS: o node retornado pertence ao cache e deve ser devolvido com _release_node(), e não liberado com b_tree_node_free()
 	Parametros:
 		manager -> o gerenciador da arvore-B que tera' um nó lido em seu binario
 		RRN -> o RRN do node a ser lido
@@ -278,33 +330,24 @@ static BTreeNode *_read_node_at(BTreeManager *manager, int RRN) {
 		return NULL;
 	}
 	
-	_b_tree_manager_seek(manager, RRN);				//faz o seek do RRN
-	return _b_tree_manager_read_current(manager);	//le o nó e retorna
+	return b_tree_page_cache_fetch(manager->page_cache, RRN);
 }
 
 /*
-	Funcao que escreve um node onde o ponteiro esta. Precisa estar exatamente no
-	comeco de um RRN para ser eficiente
-	Paramentros:
-		manager -> o gerenciador de arvore-B que tera' um node escrito em seu binario
-		node -> o node que sera escrito
+	Devolve ao cache um node obtido por _read_node_at()
+	Parametros:
+		manager -> o gerenciador da arvore-B
+		node -> o node a ser devolvido
 	Retorno: void
 */
-static void _write_current_node(BTreeManager *manager, BTreeNode *node) {
-	if (manager == NULL || node == NULL) {
-		DP("ERROR: invalid parameter @_write_current_node()\n");
-		return;
-	}
-
-	binary_write_b_tree_node(manager->bin_file, node);		//escreve no binario
-	manager->currRRN++;
+static void _release_node(BTreeManager *manager, BTreeNode *node) {
+	b_tree_page_cache_unpin(manager->page_cache, node);
 }
 
-
 /*
-	Escreve um node em um RRN dado
+	Escreve um node em um RRN dado. A escrita em disco é adiada pelo cache de páginas
 	Paramentros:
-		manager -> o gerenciador de arvore-B que tera' um node lido em seu binario
+		manager -> o gerenciador de arvore-B que tera' um node escrito em seu binario
 		RRN -> RRN do local onde sera escrito o node
 		node -> o node que sera escrito
 	Retorno: void
@@ -315,8 +358,64 @@ static void _write_node_at(BTreeManager *manager, int RRN, BTreeNode *node) {
 		return;
 	}
 
-	_b_tree_manager_seek(manager, RRN);		//faz o seek
-	_write_current_node(manager, node);		//escreve no binario
+	b_tree_page_cache_put(manager->page_cache, RRN, node);
+}
+
+/*
+	Obtém o RRN de uma página para um node novo: a primeira página da lista de páginas livres (liberadas por remoções)
+	ou, se a lista estiver vazia, uma página nova no fim do arquivo
+	Parametros:
+		manager -> o gerenciador da arvore-B
+	Retorno:
+		int -> o RRN da página
+*/
+static int _allocate_node_RRN(BTreeManager *manager) {
+	int RRN = b_tree_header_get_free_list_head(manager->header);
+	if (RRN == -1) {
+		RRN = b_tree_header_get_proxRRN(manager->header);
+		b_tree_header_set_proxRRN(manager->header, H_INCREASE);
+		return RRN;
+	}
+
+	//Uma página livre guarda, no primeiro ponteiro, o RRN da próxima página livre
+	BTreeNode *free_node = _read_node_at(manager, RRN);
+	b_tree_header_set_free_list_head(manager->header, (free_node != NULL) ? b_tree_node_get_P(free_node, 0) : -1);
+	if (free_node != NULL) _release_node(manager, free_node);
+
+	return RRN;
+}
+
+/*
+	Devolve a página de um node removido da árvore para a lista de páginas livres. A página é marcada com nível 0
+	(nenhum node da árvore tem esse nível) e aponta para a página livre seguinte
+	Parametros:
+		manager -> o gerenciador da arvore-B
+		RRN -> o RRN da página (o node não deve estar em uso)
+	Retorno: void
+*/
+static void _free_node_RRN(BTreeManager *manager, int RRN) {
+	BTreeNode *free_node = _create_node(manager, 0);
+	b_tree_node_set_P(free_node, b_tree_header_get_free_list_head(manager->header), 0);
+	_write_node_at(manager, RRN, free_node);
+	b_tree_node_free(free_node);
+
+	b_tree_header_set_free_list_head(manager->header, RRN);
+}
+
+/*
+	Contabiliza operações de modificação, confirmando o grupo no log quando ele estiver completo.
+	Antes da confirmação, as páginas modificadas e os headers são escritos, para que o lote confirmado seja consistente
+	Parametros:
+		manager -> o gerenciador de arvore-B
+		count -> quantidade de operações feitas
+	Retorno: void
+*/
+static void _end_operations(BTreeManager *manager, int count) {
+	if (!wal_end_operations(manager->wal, count)) return;
+
+	b_tree_page_cache_flush(manager->page_cache);
+	b_tree_manager_write_headers_to_disk(manager);
+	wal_commit(manager->wal);
 }
 
 /*
@@ -350,6 +449,7 @@ insert_answer recursive_insert(BTreeManager *manager, int nodeRRN, int key, int
 	//caso b_tree_node_get_RRN_that_fits() retorne -2, significa que a chave ja existe na arvore.
 	//Assim, a funcao retorna valores nulos para nao haver insercao de chaves repetidas
 	if (nextRRN == -2) {
+		_release_node(manager, node);
 		ans.key = -1;
 		ans.value = -1;
 		ans.RRN = -1;
@@ -363,7 +463,7 @@ insert_answer recursive_insert(BTreeManager *manager, int nodeRRN, int key, int
 	//caso retorne valores validos, a promocao precisa ser feita
 	if (ans.key != -1) {
 		//caso os vetores de itens nao estejam cheios, insere o item no node, e atualiza a struct de retorno com valores nulos, pois nao ha necessidade de promocao
-		if (n < B_TREE_ORDER-1) {
+		if (n < b_tree_node_get_order(node)-1) {
 			int pos = b_tree_node_sorted_insert_item(node, ans.key, ans.value);
 			b_tree_node_insert_P(node, ans.RRN, pos+1);
 			ans.key = -1;
@@ -376,7 +476,7 @@ insert_answer recursive_insert(BTreeManager *manager, int nodeRRN, int key, int
 			//pega o primeiro item do node novo para promover, o item da direita, de acordo com a especificacao
 			ans.key = b_tree_node_get_C(new, 0);
 			ans.value = b_tree_node_get_Pr(new, 0);
-			ans.RRN = b_tree_header_get_proxRRN(manager->header);
+			ans.RRN = _allocate_node_RRN(manager);
 			
 			//remove o item que sera promovido
 			b_tree_node_remove_item(new, 0);
@@ -384,9 +484,6 @@ insert_answer recursive_insert(BTreeManager *manager, int nodeRRN, int key, int
 			//escreve o node novo
 			_write_node_at(manager, ans.RRN, new);
 
-			//incrementa o valor do proximo RRN no header
-			b_tree_header_set_proxRRN(manager->header, H_INCREASE);
-
 			//desaloca a memoria do node novo
 			b_tree_node_free(new);
 		}
@@ -394,8 +491,8 @@ insert_answer recursive_insert(BTreeManager *manager, int nodeRRN, int key, int
 		_write_node_at(manager, nodeRRN, node);
 	}
 
-	//desaloca a memoria no node
-	b_tree_node_free(node);
+	//devolve o node ao cache
+	_release_node(manager, node);
 	
 	return ans;
 }
@@ -419,13 +516,12 @@ void b_tree_manager_insert(BTreeManager *manager, int regIdNascimento, int regRR
 	
 	//caso a insercao recursiva retorne valores validos ate a essa funcao, significa que um novo no raiz precisa ser criado
 	if (ans.key != -1) {
-		int nextRRN = b_tree_header_get_proxRRN(manager->header);
+		int nextRRN = _allocate_node_RRN(manager);
 		b_tree_header_set_noRaiz(manager->header, nextRRN);
 		b_tree_header_set_nroNiveis(manager->header, H_INCREASE);
-		b_tree_header_set_proxRRN(manager->header, H_INCREASE);
 
 		//cria um novo no, para ser o no raiz
-		BTreeNode *new = b_tree_node_create(b_tree_header_get_nroNiveis(manager->header));
+		BTreeNode *new = _create_node(manager, b_tree_header_get_nroNiveis(manager->header));
 		//inserte o item no no' raiz
 		b_tree_node_sorted_insert_item(new, ans.key, ans.value);
 		//insere os Ps no no' raiz
@@ -438,10 +534,501 @@ void b_tree_manager_insert(BTreeManager *manager, int regIdNascimento, int regRR
 	}
 
 	b_tree_header_set_nroChaves(manager->header, H_INCREASE);
+	_end_operations(manager, 1);
 
 	return;
 }
 
+/*
+	Struct auxiliar da inserção em lote: um nó do caminho atual (raiz -> folha), mantido no cache entre inserções
+*/
+typedef struct {
+	int RRN;
+	BTreeNode *node;
+	int high;		//Todas as chaves da subárvore são menores que high (INT_MAX no caminho mais à direita)
+} _BatchPathEntry;
+
+//Função de comparação usada no qsort da inserção em lote: ordena por chave e, em caso de empate, por valor
+static int _compare_batch_items(const void *a, const void *b) {
+	const pairIntInt *p1 = a, *p2 = b;
+	if (p1->first != p2->first) return (p1->first < p2->first) ? -1 : 1;
+	if (p1->second != p2->second) return (p1->second < p2->second) ? -1 : 1;
+	return 0;
+}
+
+/*
+	Obtém a posição do ponteiro a ser seguido para uma chave (mesmo critério de b_tree_node_get_RRN_that_fits())
+	Retorno:
+		int. a posição do ponteiro, ou -1 caso a chave já pertença ao node
+*/
+static int _child_position(BTreeNode *node, int key) {
+	bool found;
+	int position = b_tree_node_search(node, key, &found);
+	return found ? -1 : position;
+}
+
+/*
+	Cria um novo nó raiz com um item e dois filhos (usado quando a raiz é dividida, ou a árvore está vazia)
+*/
+static void _grow_root(BTreeManager *manager, int key, int value, int left_RRN, int right_RRN) {
+	int rootRRN = _allocate_node_RRN(manager);
+	b_tree_header_set_noRaiz(manager->header, rootRRN);
+	b_tree_header_set_nroNiveis(manager->header, H_INCREASE);
+
+	BTreeNode *root = _create_node(manager, b_tree_header_get_nroNiveis(manager->header));
+	b_tree_node_sorted_insert_item(root, key, value);
+	b_tree_node_set_P(root, left_RRN, 0);
+	b_tree_node_set_P(root, right_RRN, 1);
+
+	_write_node_at(manager, rootRRN, root);
+	b_tree_node_free(root);
+}
+
+/**
+ *  Insere vários pares (chave, valor) na arvore-B em uma única passada ordenada.
+ *  Os pares são ordenados e o caminho raiz -> folha é mantido entre chaves vizinhas: a descida recomeça
+ *  apenas a partir do nó mais baixo do caminho cuja subárvore ainda contém a próxima chave. Os nós do caminho
+ *  ficam no cache de páginas e só são escritos no disco quando substituídos ou no fechamento do arquivo,
+ *  portanto cada página modificada é escrita uma única vez.
+ *  OBS: o formato da árvore resultante pode ser diferente do obtido com inserções uma a uma na ordem original
+ *  OBS: chaves repetidas (no lote ou já na árvore) são ignoradas, mantendo o par de menor valor do lote
+ *  Parâmetros:
+ *      BTreeManager *manager -> gerenciador com o arquivo aberto em modo que permita escrita
+ *      pairIntInt *items -> pares (first = chave, second = valor). O vetor é reordenado pela função
+ *      int count -> quantidade de pares
+ *  Retorno:
+ *      int -> quantidade de chaves inseridas, ou -1 em caso de erro
+ */
+int b_tree_manager_insert_batch(BTreeManager *manager, pairIntInt *items, int count) {
+	if (manager == NULL || manager->bin_file == NULL || (items == NULL && count > 0) || count < 0) {
+		DP("ERROR: invalid parameters @b_tree_manager_insert_batch()\n");
+		return -1;
+	}
+
+	if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
+		DP("ERROR: BTreeManager is in read-only mode @b_tree_manager_insert_batch()\n");
+		return -1;
+	}
+
+	qsort(items, count, sizeof(pairIntInt), _compare_batch_items);
+
+	//Caminho atual, da raiz (posição 0) até o nó mais baixo já visitado
+	_BatchPathEntry path[B_TREE_MAX_LEVELS];
+
+	int depth = 0, inserted = 0;
+	for (int i = 0; i < count; i++) {
+		int key = items[i].first, value = items[i].second;
+		if (key < 0 || (i > 0 && key == items[i-1].first)) continue;
+
+		//Árvore vazia: a primeira chave vira a raiz
+		if (b_tree_header_get_noRaiz(manager->header) == -1) {
+			_grow_root(manager, key, value, -1, -1);
+			b_tree_header_set_nroChaves(manager->header, H_INCREASE);
+			inserted++;
+			continue;
+		}
+
+		//Sobe no caminho até um nó cuja subárvore contém a chave (como as chaves são crescentes, basta o limite superior)
+		while (depth > 0 && key >= path[depth-1].high)
+			_release_node(manager, path[--depth].node);
+
+		if (depth == 0) {
+			path[0].RRN = b_tree_header_get_noRaiz(manager->header);
+			path[0].node = _read_node_at(manager, path[0].RRN);
+			path[0].high = INT_MAX;
+			depth = 1;
+		}
+
+		//Desce até a folha
+		bool duplicate = false;
+		while (true) {
+			_BatchPathEntry *top = &path[depth-1];
+			int pos = _child_position(top->node, key);
+			if (pos == -1) {
+				duplicate = true;
+				break;
+			}
+
+			int childRRN = b_tree_node_get_P(top->node, pos);
+			if (childRRN == -1) break;
+
+			int C = b_tree_node_get_C(top->node, pos);
+			path[depth].RRN = childRRN;
+			path[depth].node = _read_node_at(manager, childRRN);
+			path[depth].high = (pos < b_tree_node_get_order(top->node)-1 && C != -1) ? C : top->high;
+			depth++;
+		}
+		if (duplicate) continue;
+
+		//Insere na folha e propaga as divisões para cima pelo caminho (mesma lógica de recursive_insert())
+		int promoted_key = key, promoted_value = value, promoted_RRN = -1;
+		int level = depth-1;
+		for (; level >= 0; level--) {
+			BTreeNode *node = path[level].node;
+
+			if (b_tree_node_get_n(node) < b_tree_node_get_order(node)-1) {
+				int pos = b_tree_node_sorted_insert_item(node, promoted_key, promoted_value);
+				b_tree_node_insert_P(node, promoted_RRN, pos+1);
+				_write_node_at(manager, path[level].RRN, node);
+				break;
+			}
+
+			BTreeNode *new = b_tree_node_split_one_to_two(node, promoted_key, promoted_value, promoted_RRN);
+			promoted_key = b_tree_node_get_C(new, 0);
+			promoted_value = b_tree_node_get_Pr(new, 0);
+			promoted_RRN = _allocate_node_RRN(manager);
+			b_tree_node_remove_item(new, 0);
+
+			_write_node_at(manager, promoted_RRN, new);
+			b_tree_node_free(new);
+
+			_write_node_at(manager, path[level].RRN, node);
+		}
+
+		//A raiz foi dividida: cria uma nova raiz
+		if (level < 0) _grow_root(manager, promoted_key, promoted_value, path[0].RRN, promoted_RRN);
+
+		//Os nós divididos (abaixo de 'level') não servem mais como caminho; o nó que absorveu o item continua válido
+		int valid_depth = (level < 0) ? 0 : level+1;
+		while (depth > valid_depth)
+			_release_node(manager, path[--depth].node);
+
+		b_tree_header_set_nroChaves(manager->header, H_INCREASE);
+		inserted++;
+	}
+
+	while (depth > 0)
+		_release_node(manager, path[--depth].node);
+
+	_end_operations(manager, inserted);
+	return inserted;
+}
+
+/*
+	Constroi um nivel inteiro da arvore-B a partir de uma sequencia ordenada de itens, escrevendo os nós
+	sequencialmente a partir de proxRRN. Os nós são preenchidos por completo, exceto os dois ultimos, que
+	dividem os itens restantes para que nenhum deles fique abaixo da ocupacao minima.
+	Entre dois nós consecutivos, um item é promovido para o nivel de cima (enviado para 'separators')
+	Parametros:
+		manager -> o gerenciador de arvore-B
+		source -> os itens do nivel, em ordem
+		count -> a quantidade de itens em 'source'
+		nivel -> o nivel dos nós construidos (1 = folha)
+		first_child_RRN -> RRN do primeiro nó do nivel de baixo (os filhos são consecutivos), ou -1 para folhas
+		separators -> onde os itens promovidos serão inseridos
+	Retorno:
+		int. a quantidade de nós escritos no nivel
+*/
+static int _bulk_build_level(BTreeManager *manager, BTreeBulkLoader *source, int count, int nivel, int first_child_RRN, BTreeBulkLoader *separators) {
+	//Cada nó guarda até order-1 itens e, entre dois nós, um item é promovido
+	int order = b_tree_header_get_order(manager->header);
+	int node_count = (count + order) / order;
+	int keys_in_nodes = count - (node_count-1);
+
+	//Itens que sobram para os dois ultimos nós
+	int remaining = keys_in_nodes - (node_count-2) * (order-1);
+	int second_last_size = (remaining - (order-1) >= B_TREE_MIN_KEYS(order)) ? order-1 : remaining - remaining/2;
+
+	int child = first_child_RRN;
+	pairIntInt item;
+	for (int i = 0; i < node_count; i++) {
+		int size = order-1;
+		if (node_count == 1) size = count;
+		else if (i == node_count-2) size = second_last_size;
+		else if (i == node_count-1) size = remaining - second_last_size;
+
+		BTreeNode *node = _create_node(manager, nivel);
+		for (int j = 0; j < size && b_tree_bulk_loader_next(source, &item); j++)
+			b_tree_node_set_item(node, item.first, item.second, j);
+
+		//Os filhos de um nó são os proximos nós do nivel de baixo
+		if (first_child_RRN != -1) {
+			for (int j = 0; j <= size; j++)
+				b_tree_node_set_P(node, child++, j);
+		}
+
+		_write_node_at(manager, b_tree_header_get_proxRRN(manager->header), node);
+		b_tree_header_set_proxRRN(manager->header, H_INCREASE);
+		b_tree_node_free(node);
+
+		//Promove o item entre este nó e o proximo
+		if (i < node_count-1 && b_tree_bulk_loader_next(source, &item))
+			b_tree_bulk_loader_add(separators, item.first, item.second);
+	}
+
+	return node_count;
+}
+
+/*
+	Constroi a arvore-B de baixo para cima a partir de todos os pares (chave, valor) de um BTreeBulkLoader.
+	Os nós são escritos nivel a nivel (folhas primeiro), de forma sequencial, sem nenhuma busca na arvore.
+	A arvore deve estar vazia (arquivo recem criado).
+	Parametros:
+		manager -> o gerenciador de arvore-B, aberto em modo que permita escrita
+		loader -> o ordenador com os pares inseridos (é finalizado por esta funcao)
+	Retorno:
+		bool. indica se a construcao foi bem sucedida
+*/
+bool b_tree_manager_bulk_load(BTreeManager *manager, BTreeBulkLoader *loader) {
+	if (manager == NULL || loader == NULL) {
+		DP("ERROR: invalid parameters @b_tree_manager_bulk_load()\n");
+		return false;
+	}
+
+	if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode) || manager->bin_file == NULL) {
+		DP("ERROR: BTreeManager is not opened for writing @b_tree_manager_bulk_load()\n");
+		return false;
+	}
+
+	if (b_tree_header_get_noRaiz(manager->header) != -1) {
+		DP("ERROR: bulk load is only supported on an empty tree @b_tree_manager_bulk_load()\n");
+		return false;
+	}
+
+	if (!b_tree_bulk_loader_finish(loader)) return false;
+
+	int count = b_tree_bulk_loader_get_count(loader);
+	if (count == 0) return true;
+	b_tree_header_set_nroChaves(manager->header, count);
+
+	BTreeBulkLoader *source = loader;
+	int nivel = 1, first_child_RRN = -1;
+	while (true) {
+		int level_first_RRN = b_tree_header_get_proxRRN(manager->header);
+
+		//Os itens promovidos são, no maximo, um a cada order itens do nivel atual
+		int separators_capacity = count / b_tree_header_get_order(manager->header) + 1;
+		if (separators_capacity > B_TREE_BULK_LOAD_RUN_CAPACITY) separators_capacity = B_TREE_BULK_LOAD_RUN_CAPACITY;
+		BTreeBulkLoader *separators = b_tree_bulk_loader_create(separators_capacity);
+		if (separators == NULL) {
+			if (source != loader) b_tree_bulk_loader_free(&source);
+			return false;
+		}
+
+		int node_count = _bulk_build_level(manager, source, count, nivel, first_child_RRN, separators);
+		if (source != loader) b_tree_bulk_loader_free(&source);
+
+		//Se o nivel tiver apenas um nó, ele é a raiz
+		if (node_count == 1) {
+			b_tree_bulk_loader_free(&separators);
+			b_tree_header_set_noRaiz(manager->header, level_first_RRN);
+			b_tree_header_set_nroNiveis(manager->header, nivel);
+			return true;
+		}
+
+		//Os itens promovidos formam o proximo nivel
+		if (!b_tree_bulk_loader_finish(separators)) {
+			b_tree_bulk_loader_free(&separators);
+			return false;
+		}
+		source = separators;
+		count = node_count-1;
+		first_child_RRN = level_first_RRN;
+		nivel++;
+	}
+}
+
+/*
+	Corrige um filho com menos chaves que o mínimo (underflow), após uma remoção na sua subárvore. Se um irmão adjacente
+	tiver chaves sobrando, uma delas passa pelo pai para o filho (redistribuição); senão, o filho é concatenado com
+	o irmão e com a chave do pai que os separa (merge), e a página que sobra é devolvida à lista de páginas livres
+	Parametros:
+		manager -> o gerenciador de arvore-B
+		parent -> o node pai, obtido com _read_node_at() (é escrito, mas não é devolvido ao cache)
+		parentRRN -> RRN do node pai
+		position -> posição do ponteiro (P) do filho no pai
+	Retorno: void
+*/
+static void _fix_underflow(BTreeManager *manager, BTreeNode *parent, int parentRRN, int position) {
+	int min_keys = B_TREE_MIN_KEYS(b_tree_node_get_order(parent));
+	int parent_n = b_tree_node_get_n(parent);
+
+	int childRRN = b_tree_node_get_P(parent, position);
+	int leftRRN = (position > 0) ? b_tree_node_get_P(parent, position-1) : -1;
+	int rightRRN = (position < parent_n) ? b_tree_node_get_P(parent, position+1) : -1;
+
+	BTreeNode *child = _read_node_at(manager, childRRN);
+	BTreeNode *left = (leftRRN != -1) ? _read_node_at(manager, leftRRN) : NULL;
+	BTreeNode *right = (rightRRN != -1) ? _read_node_at(manager, rightRRN) : NULL;
+
+	if (left != NULL && b_tree_node_get_n(left) > min_keys) {
+		//Redistribuição com o irmão da esquerda: a chave do pai desce para o início do filho e a última do irmão sobe
+		int left_n = b_tree_node_get_n(left);
+		b_tree_node_sorted_insert_item(child, b_tree_node_get_C(parent, position-1), b_tree_node_get_Pr(parent, position-1));
+		b_tree_node_insert_P(child, b_tree_node_get_P(left, left_n), 0);
+
+		b_tree_node_set_item(parent, b_tree_node_get_C(left, left_n-1), b_tree_node_get_Pr(left, left_n-1), position-1);
+		b_tree_node_remove_item(left, left_n-1);
+		b_tree_node_set_P(left, -1, left_n);
+
+		_write_node_at(manager, leftRRN, left);
+		_write_node_at(manager, childRRN, child);
+	}
+	else if (right != NULL && b_tree_node_get_n(right) > min_keys) {
+		//Redistribuição com o irmão da direita: a chave do pai desce para o fim do filho e a primeira do irmão sobe
+		b_tree_node_sorted_insert_item(child, b_tree_node_get_C(parent, position), b_tree_node_get_Pr(parent, position));
+		b_tree_node_set_P(child, b_tree_node_get_P(right, 0), b_tree_node_get_n(child));
+
+		b_tree_node_set_item(parent, b_tree_node_get_C(right, 0), b_tree_node_get_Pr(right, 0), position);
+		b_tree_node_remove_item(right, 0);
+		b_tree_node_remove_P(right, 0);
+
+		_write_node_at(manager, rightRRN, right);
+		_write_node_at(manager, childRRN, child);
+	}
+	else {
+		//Merge: o node da direita (o filho ou o seu irmão da direita) é concatenado ao da esquerda
+		int separator = (left != NULL) ? position-1 : position;
+		BTreeNode *dest = (left != NULL) ? left : child;
+		BTreeNode *src = (left != NULL) ? child : right;
+		int destRRN = (left != NULL) ? leftRRN : childRRN;
+		int srcRRN = (left != NULL) ? childRRN : rightRRN;
+
+		int dest_n = b_tree_node_get_n(dest), src_n = b_tree_node_get_n(src);
+		b_tree_node_sorted_insert_item(dest, b_tree_node_get_C(parent, separator), b_tree_node_get_Pr(parent, separator));
+		for (int i = 0; i < src_n; i++)
+			b_tree_node_sorted_insert_item(dest, b_tree_node_get_C(src, i), b_tree_node_get_Pr(src, i));
+		for (int i = 0; i <= src_n; i++)
+			b_tree_node_set_P(dest, b_tree_node_get_P(src, i), dest_n+1 + i);
+
+		b_tree_node_remove_item(parent, separator);
+		b_tree_node_remove_P(parent, separator+1);
+
+		_write_node_at(manager, destRRN, dest);
+		_release_node(manager, src);
+		if (src == child) child = NULL;
+		else right = NULL;
+		_free_node_RRN(manager, srcRRN);
+	}
+
+	_write_node_at(manager, parentRRN, parent);
+
+	if (child != NULL) _release_node(manager, child);
+	if (left != NULL) _release_node(manager, left);
+	if (right != NULL) _release_node(manager, right);
+}
+
+/*
+	Remove o maior item de uma subárvore (o último item da folha mais à direita), usado para substituir
+	um item removido de um node interno pelo seu antecessor
+	Parametros:
+		manager -> o gerenciador de arvore-B
+		nodeRRN -> RRN da raiz da subárvore
+		key_ptr, value_ptr -> onde são guardados a chave e o valor removidos
+	Retorno:
+		bool. Indica se o node ficou com menos chaves que o mínimo (o pai deve corrigi-lo)
+*/
+static bool _recursive_delete_max(BTreeManager *manager, int nodeRRN, int *key_ptr, int *value_ptr) {
+	BTreeNode *node = _read_node_at(manager, nodeRRN);
+	int n = b_tree_node_get_n(node);
+	int childRRN = b_tree_node_get_P(node, n);
+
+	if (childRRN == -1) {
+		*key_ptr = b_tree_node_get_C(node, n-1);
+		*value_ptr = b_tree_node_get_Pr(node, n-1);
+		b_tree_node_remove_item(node, n-1);
+		_write_node_at(manager, nodeRRN, node);
+	}
+	else if (_recursive_delete_max(manager, childRRN, key_ptr, value_ptr)) {
+		_fix_underflow(manager, node, nodeRRN, n);
+	}
+
+	bool underflow = b_tree_node_get_n(node) < B_TREE_MIN_KEYS(b_tree_node_get_order(node));
+	_release_node(manager, node);
+	return underflow;
+}
+
+/*
+	Faz a remocao recursiva de uma chave em uma arvore-B. Chaves de nodes internos são substituídas pelo seu antecessor,
+	removido da folha. Na volta da recursão, cada pai corrige o filho que ficou com menos chaves que o mínimo
+	Parametros:
+		manager -> o gerenciador de arvore-B
+		nodeRRN -> o RRN do node atual
+		key -> a chave a ser removida
+		found_ptr -> onde é indicado se a chave foi encontrada
+	Retorno:
+		bool. Indica se o node ficou com menos chaves que o mínimo
+*/
+static bool _recursive_delete(BTreeManager *manager, int nodeRRN, int key, bool *found_ptr) {
+	if (nodeRRN == -1) return false;
+
+	BTreeNode *node = _read_node_at(manager, nodeRRN);
+	if (node == NULL) return false;
+
+	bool found;
+	int position = b_tree_node_search(node, key, &found);
+	int childRRN = b_tree_node_get_P(node, position);
+	bool child_underflow = false;
+
+	if (found) {
+		*found_ptr = true;
+		if (childRRN == -1) {
+			b_tree_node_remove_item(node, position);
+			_write_node_at(manager, nodeRRN, node);
+		} else {
+			int pred_key, pred_value;
+			child_underflow = _recursive_delete_max(manager, childRRN, &pred_key, &pred_value);
+			b_tree_node_set_item(node, pred_key, pred_value, position);
+			_write_node_at(manager, nodeRRN, node);
+		}
+	}
+	else if (key >= 0) {
+		child_underflow = _recursive_delete(manager, childRRN, key, found_ptr);
+	}
+
+	if (child_underflow) _fix_underflow(manager, node, nodeRRN, position);
+
+	bool underflow = b_tree_node_get_n(node) < B_TREE_MIN_KEYS(b_tree_node_get_order(node));
+	_release_node(manager, node);
+	return underflow;
+}
+
+/**
+ *  Remove uma chave (e o seu valor) da arvore-B, mantendo todos os nodes, exceto a raiz, com o mínimo de chaves
+ *  (por redistribuição ou merge). As páginas que deixam de ser usadas vão para a lista de páginas livres
+ *  do header, e são reaproveitadas pelas inserções seguintes.
+ *  Parâmetros:
+ *      BTreeManager *manager -> gerenciador com o arquivo aberto no modo MODIFY
+ *      int key -> a chave a ser removida
+ *  Retorno:
+ *      bool -> indica se a chave existia (e foi removida)
+ */
+bool b_tree_manager_delete(BTreeManager *manager, int key) {
+	if (manager == NULL || manager->bin_file == NULL) {
+		DP("ERROR: invalid parameter @b_tree_manager_delete()\n");
+		return false;
+	}
+
+	if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
+		DP("ERROR: BTreeManager is in read-only mode @b_tree_manager_delete()\n");
+		return false;
+	}
+
+	int rootRRN = b_tree_header_get_noRaiz(manager->header);
+	bool found = false;
+	_recursive_delete(manager, rootRRN, key, &found);
+	if (!found) return false;
+
+	//Se a raiz interna ficou sem chaves, o seu único filho se torna a raiz (a árvore diminui um nível).
+	//Uma raiz folha vazia é mantida, representando a árvore vazia
+	BTreeNode *root = _read_node_at(manager, rootRRN);
+	if (root != NULL) {
+		int childRRN = b_tree_node_get_P(root, 0);
+		bool shrink = b_tree_node_get_n(root) == 0 && childRRN != -1;
+		_release_node(manager, root);
+
+		if (shrink) {
+			b_tree_header_set_noRaiz(manager->header, childRRN);
+			b_tree_header_set_nroNiveis(manager->header, H_DECREASE);
+			_free_node_RRN(manager, rootRRN);
+		}
+	}
+
+	b_tree_header_set_nroChaves(manager->header, H_DECREASE);
+	_end_operations(manager, 1);
+	return true;
+}
+
 /*
 	Funcao de busca na arvore-B
 	Paramentros:
@@ -472,25 +1059,390 @@ pairIntInt b_tree_manager_search_for (BTreeManager *manager, int key) {
 		p.second++;
 		if (node == NULL)
 			break;
-		//pega o proximo RRN no caminho pela arvore onde a chave melhor se encaixaria.
-		nodeRRN = b_tree_node_get_RRN_that_fits(node, key);
-
-		//caso b_tree_node_get_RRN_that_fits() retorne -2, significa que a chave ja existe no node
-		if (nodeRRN == -2) {
-			//procura no node atual a chave, e a retorna
-			for (int i = 0; i < B_TREE_ORDER; i++) {
-				if (b_tree_node_get_C(node, i) == key) {
-					int ans = b_tree_node_get_Pr(node, i);
-					b_tree_node_free(node);
-					p.first = ans;
-					return p;
-				}
-			}
+		//procura a chave no node: se ela pertencer ao node, retorna seu valor
+		bool found;
+		int position = b_tree_node_search(node, key, &found);
+		if (found) {
+			p.first = b_tree_node_get_Pr(node, position);
+			_release_node(manager, node);
+			return p;
 		}
 
-		b_tree_node_free(node);
+		//senao, pega o proximo RRN no caminho pela arvore onde a chave melhor se encaixaria (chaves negativas nunca sao inseridas)
+		nodeRRN = (key < 0) ? -1 : b_tree_node_get_P(node, position);
+
+		_release_node(manager, node);
 	}
 
 	p.first = -1;
 	return p;
-}
\ No newline at end of file
+}
+
+/*
+	Retorna as estatisticas do cache de paginas do gerenciador
+	Parametros:
+		manager -> o gerenciador de arvore-B
+	Retorno:
+		pairIntInt. first -> acertos no cache, second -> faltas (nós lidos do disco)
+*/
+pairIntInt b_tree_manager_get_cache_stats(BTreeManager *manager) {
+	if (manager == NULL) {
+		pairIntInt p;
+		p.first = p.second = -1;
+		return p;
+	}
+
+	return b_tree_page_cache_get_stats(manager->page_cache);
+}
+
+/*
+	Funcao (privada) que escreve o status do header de um arquivo de índices fechado, sincronizando-o com o disco
+	Parametros:
+		bin_filename -> nome do arquivo de índices
+		status -> '0' (inconsistente) ou '1' (consistente)
+	Retorno:
+		bool. indica se o status foi escrito
+*/
+static bool _write_file_status(char *bin_filename, char status) {
+	if (bin_filename == NULL) return false;
+
+	FILE *bin_file = fopen(bin_filename, "rb+");
+	if (bin_file == NULL) return false;
+
+	BTreeHeader *header = b_tree_header_create();
+	b_tree_header_read_from_bin(header, bin_file);
+	b_tree_header_set_status(header, status);
+	b_tree_header_write_to_bin(header, bin_file);
+	b_tree_header_free(&header);
+
+	bool ok = fflush(bin_file) == 0 && fsync(fileno(bin_file)) == 0;
+	return (fclose(bin_file) == 0) && ok;
+}
+
+/**
+ *  Cria uma cópia do arquivo de índices com os valores (Pr) trocados por uma função de mapeamento, com a mesma ordem
+ *  e o mesmo tamanho de página. Usado, por exemplo, após a compactação do arquivo de registros (RRNs antigos -> novos).
+ *  Chaves cujo valor é mapeado para um número negativo (ex.: registros removidos) são descartadas: a árvore é percorrida
+ *  em ordem de chave e a cópia é construída de baixo para cima (bulk load) apenas com os pares restantes.
+ *  O arquivo atual não é alterado.
+ *  OBS: a cópia é escrita com status '0' (inconsistente) e sincronizada com o disco: ela só deve ser marcada como
+ *  consistente (b_tree_manager_mark_file_consistent) depois que o arquivo de registros correspondente estiver no lugar.
+ *  Parâmetros:
+ *      BTreeManager *manager -> gerenciador com o arquivo aberto (pode ser modo leitura)
+ *      char *new_filename -> nome da cópia a ser criada
+ *      BTreeValueMapFunc map_func -> função que recebe um valor e retorna o novo valor (negativo para descartar a chave)
+ *      void *context -> repassado para map_func
+ *  Retorno:
+ *      bool -> indica se a cópia foi escrita
+ */
+bool b_tree_manager_rewrite_values(BTreeManager *manager, char *new_filename, BTreeValueMapFunc map_func, void *context) {
+	if (manager == NULL || manager->bin_file == NULL || new_filename == NULL || map_func == NULL) {
+		DP("ERROR: invalid parameters @b_tree_manager_rewrite_values()\n");
+		return false;
+	}
+
+	int run_capacity = b_tree_header_get_nroChaves(manager->header) + 1;
+	if (run_capacity > B_TREE_BULK_LOAD_RUN_CAPACITY) run_capacity = B_TREE_BULK_LOAD_RUN_CAPACITY;
+
+	BTreeCursor *cursor = b_tree_cursor_create(manager);
+	BTreeBulkLoader *loader = b_tree_bulk_loader_create(run_capacity);
+	BTreeManager *copy = b_tree_manager_create();
+	bool ok = cursor != NULL && loader != NULL && copy != NULL;
+
+	//Os pares restantes são lidos em ordem de chave
+	for (bool valid = ok && b_tree_cursor_seek_first(cursor); ok && valid; valid = b_tree_cursor_next(cursor)) {
+		pairIntInt item = b_tree_cursor_get(cursor);
+		int value = map_func(item.second, context);
+		if (value >= 0) ok = b_tree_bulk_loader_add(loader, item.first, value);
+	}
+
+	ok = ok && b_tree_manager_set_format(copy, b_tree_header_get_order(manager->header), b_tree_header_get_page_size(manager->header))
+		&& b_tree_manager_open(copy, new_filename, CREATE) == OPEN_OK && b_tree_manager_bulk_load(copy, loader);
+
+	b_tree_cursor_free(&cursor);
+	b_tree_bulk_loader_free(&loader);
+	b_tree_manager_free(&copy);
+
+	//O fechamento marca a cópia como consistente: o status volta a ser '0' até que o arquivo de registros esteja no lugar
+	ok = ok && _write_file_status(new_filename, '0');
+
+	if (!ok) {
+		DP("ERROR: couldn't write the rewritten index @b_tree_manager_rewrite_values()\n");
+		remove(new_filename);
+	}
+
+	return ok;
+}
+
+/**
+ *  Marca um arquivo de índices fechado como consistente (status '1'), sincronizando-o com o disco
+ *  Parâmetros:
+ *      char *bin_filename -> nome do arquivo de índices
+ *  Retorno:
+ *      bool -> indica se o status foi escrito
+ */
+bool b_tree_manager_mark_file_consistent(char *bin_filename) {
+	return _write_file_status(bin_filename, '1');
+}
+
+
+
+/*
+	Struct que representa um cursor sobre a arvore-B: o caminho da raiz até o item atual.
+	Em cada nível é guardado o RRN do nó e uma posição: no topo, a posição do item atual; nos demais níveis,
+	a posição do filho (P) pelo qual o caminho desce (o item seguinte a essa subárvore tem a mesma posição).
+*/
+struct _b_tree_cursor {
+	BTreeManager *manager;
+	int depth;							//Quantidade de níveis do caminho (0 indica cursor inválido)
+	int RRNs[B_TREE_MAX_LEVELS];
+	int positions[B_TREE_MAX_LEVELS];
+	int key, value;						//Item atual
+	int pages;							//Quantidade de nós visitados
+};
+
+/**
+ *  Cria um cursor para percorrer a arvore-B em ordem de chave. O cursor começa inválido e deve ser posicionado
+ *  com b_tree_cursor_seek(), b_tree_cursor_seek_first() ou b_tree_cursor_seek_last().
+ *  OBS: a árvore não deve ser modificada enquanto o cursor estiver em uso
+ *  Parâmetros:
+ *      BTreeManager *manager -> gerenciador com o arquivo de índices aberto
+ *  Retorno:
+ *      BTreeCursor* -> o cursor, ou NULL em caso de erro
+ */
+BTreeCursor *b_tree_cursor_create(BTreeManager *manager) {
+	if (manager == NULL || manager->header == NULL) {
+		DP("ERROR: invalid parameter @b_tree_cursor_create()\n");
+		return NULL;
+	}
+
+	BTreeCursor *cursor = calloc(1, sizeof(BTreeCursor));
+	if (cursor == NULL) {
+		DP("ERROR: not enough memory @b_tree_cursor_create()\n");
+		return NULL;
+	}
+
+	cursor->manager = manager;
+	return cursor;
+}
+
+void b_tree_cursor_free(BTreeCursor **cursor_ptr) {
+	if (cursor_ptr == NULL) return;
+	free(*cursor_ptr);
+	*cursor_ptr = NULL;
+}
+
+/*
+	Funcao (privada) que lê o item atual (topo do caminho) do cursor
+	Retorno:
+		bool. Indica se o cursor aponta para um item válido
+*/
+static bool _cursor_load(BTreeCursor *cursor) {
+	if (cursor->depth <= 0) return false;
+
+	int top = cursor->depth - 1;
+	BTreeNode *node = _read_node_at(cursor->manager, cursor->RRNs[top]);
+	if (node == NULL || cursor->positions[top] < 0 || cursor->positions[top] >= b_tree_node_get_n(node)) {
+		if (node != NULL) _release_node(cursor->manager, node);
+		cursor->depth = 0;
+		return false;
+	}
+
+	cursor->key = b_tree_node_get_C(node, cursor->positions[top]);
+	cursor->value = b_tree_node_get_Pr(node, cursor->positions[top]);
+	_release_node(cursor->manager, node);
+	return true;
+}
+
+/*
+	Funcao (privada) que desce pelo caminho mais à esquerda (leftmost) ou mais à direita de uma subárvore,
+	deixando o cursor no seu primeiro (ou último) item
+*/
+static bool _cursor_descend(BTreeCursor *cursor, int RRN, bool leftmost) {
+	while (RRN != -1 && cursor->depth < B_TREE_MAX_LEVELS) {
+		BTreeNode *node = _read_node_at(cursor->manager, RRN);
+		if (node == NULL) break;
+		cursor->pages++;
+
+		int n = b_tree_node_get_n(node);
+		int position = leftmost ? 0 : n;
+		int child = b_tree_node_get_P(node, position);
+		_release_node(cursor->manager, node);
+
+		//Nas folhas, a posição é a do item (o último, se descendo pela direita)
+		if (child == -1 && !leftmost) position = n - 1;
+
+		cursor->RRNs[cursor->depth] = RRN;
+		cursor->positions[cursor->depth] = position;
+		cursor->depth++;
+		RRN = child;
+	}
+
+	return _cursor_load(cursor);
+}
+
+/*
+	Funcao (privada) que sobe pelo caminho após o fim (forward) ou antes do início de uma subárvore,
+	até o ancestral cujo item é o seguinte (ou o anterior)
+*/
+static bool _cursor_climb(BTreeCursor *cursor, bool forward) {
+	cursor->depth--;
+
+	while (cursor->depth > 0) {
+		int top = cursor->depth - 1;
+		BTreeNode *node = _read_node_at(cursor->manager, cursor->RRNs[top]);
+		if (node == NULL) break;
+		cursor->pages++;
+
+		int n = b_tree_node_get_n(node);
+		_release_node(cursor->manager, node);
+
+		if (forward && cursor->positions[top] < n) return _cursor_load(cursor);
+		if (!forward && cursor->positions[top] > 0) {
+			cursor->positions[top]--;
+			return _cursor_load(cursor);
+		}
+
+		cursor->depth--;
+	}
+
+	cursor->depth = 0;
+	return false;
+}
+
+/**
+ *  Posiciona o cursor no primeiro item com chave maior ou igual a uma chave dada
+ *  Parâmetros:
+ *      BTreeCursor *cursor -> o cursor
+ *      int key -> a chave buscada
+ *  Retorno:
+ *      bool -> indica se existe tal item (senão, o cursor fica inválido)
+ */
+bool b_tree_cursor_seek(BTreeCursor *cursor, int key) {
+	if (cursor == NULL) return false;
+	cursor->depth = 0;
+
+	//Desce sempre até a folha: com chaves repetidas, a primeira ocorrência pode estar na subárvore à esquerda
+	int RRN = b_tree_header_get_noRaiz(cursor->manager->header);
+	while (RRN != -1 && cursor->depth < B_TREE_MAX_LEVELS) {
+		BTreeNode *node = _read_node_at(cursor->manager, RRN);
+		if (node == NULL) {
+			cursor->depth = 0;
+			return false;
+		}
+		cursor->pages++;
+
+		int position = b_tree_node_search(node, key, NULL);
+		int child = b_tree_node_get_P(node, position);
+		int n = b_tree_node_get_n(node);
+		_release_node(cursor->manager, node);
+
+		cursor->RRNs[cursor->depth] = RRN;
+		cursor->positions[cursor->depth] = position;
+		cursor->depth++;
+
+		//Na folha, se todas as chaves forem menores, o item buscado é o do ancestral seguinte
+		if (child == -1) return (position < n) ? _cursor_load(cursor) : _cursor_climb(cursor, true);
+		RRN = child;
+	}
+
+	cursor->depth = 0;
+	return false;
+}
+
+bool b_tree_cursor_seek_first(BTreeCursor *cursor) {
+	if (cursor == NULL) return false;
+	cursor->depth = 0;
+	return _cursor_descend(cursor, b_tree_header_get_noRaiz(cursor->manager->header), true);
+}
+
+bool b_tree_cursor_seek_last(BTreeCursor *cursor) {
+	if (cursor == NULL) return false;
+	cursor->depth = 0;
+	return _cursor_descend(cursor, b_tree_header_get_noRaiz(cursor->manager->header), false);
+}
+
+/**
+ *  Avança o cursor para o item seguinte, em ordem de chave
+ *  Parâmetros:
+ *      BTreeCursor *cursor -> cursor válido
+ *  Retorno:
+ *      bool -> indica se existe o item seguinte (senão, o cursor fica inválido)
+ */
+bool b_tree_cursor_next(BTreeCursor *cursor) {
+	if (cursor == NULL || cursor->depth <= 0) return false;
+
+	int top = cursor->depth - 1;
+	BTreeNode *node = _read_node_at(cursor->manager, cursor->RRNs[top]);
+	if (node == NULL) {
+		cursor->depth = 0;
+		return false;
+	}
+
+	int n = b_tree_node_get_n(node);
+	int child = b_tree_node_get_P(node, cursor->positions[top] + 1);
+	_release_node(cursor->manager, node);
+
+	//O item seguinte é o primeiro da subárvore à direita do atual, se houver
+	cursor->positions[top]++;
+	if (child != -1) return _cursor_descend(cursor, child, true);
+
+	if (cursor->positions[top] < n) return _cursor_load(cursor);
+	return _cursor_climb(cursor, true);
+}
+
+/**
+ *  Volta o cursor para o item anterior, em ordem de chave
+ *  Parâmetros:
+ *      BTreeCursor *cursor -> cursor válido
+ *  Retorno:
+ *      bool -> indica se existe o item anterior (senão, o cursor fica inválido)
+ */
+bool b_tree_cursor_prev(BTreeCursor *cursor) {
+	if (cursor == NULL || cursor->depth <= 0) return false;
+
+	int top = cursor->depth - 1;
+	BTreeNode *node = _read_node_at(cursor->manager, cursor->RRNs[top]);
+	if (node == NULL) {
+		cursor->depth = 0;
+		return false;
+	}
+
+	int child = b_tree_node_get_P(node, cursor->positions[top]);
+	_release_node(cursor->manager, node);
+
+	//O item anterior é o último da subárvore à esquerda do atual, se houver
+	if (child != -1) return _cursor_descend(cursor, child, false);
+
+	if (cursor->positions[top] > 0) {
+		cursor->positions[top]--;
+		return _cursor_load(cursor);
+	}
+	return _cursor_climb(cursor, false);
+}
+
+bool b_tree_cursor_is_valid(BTreeCursor *cursor) {
+	return cursor != NULL && cursor->depth > 0;
+}
+
+/**
+ *  Obtém o item atual do cursor
+ *  Parâmetros:
+ *      BTreeCursor *cursor -> o cursor
+ *  Retorno:
+ *      pairIntInt -> first: chave (C), second: valor (Pr). Ambos -1 se o cursor for inválido
+ */
+pairIntInt b_tree_cursor_get(BTreeCursor *cursor) {
+	pairIntInt p;
+	p.first = p.second = -1;
+	if (!b_tree_cursor_is_valid(cursor)) return p;
+
+	p.first = cursor->key;
+	p.second = cursor->value;
+	return p;
+}
+
+//Quantidade de nós visitados pelo cursor desde a sua criação
+int b_tree_cursor_get_pages(BTreeCursor *cursor) {
+	return (cursor != NULL) ? cursor->pages : -1;
+}
@@ -2,6 +2,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//Até essa quantidade de chaves, a busca no nó compara todas as chaves (com SIMD, se disponível) em vez de fazer busca binária
+#define B_TREE_NODE_LINEAR_SEARCH_MAX 32
 
 /**
  *  Struct que define o TAD BTreeNode
@@ -11,34 +20,120 @@
 struct _b_tree_node {
     int nivel;              //Nível do nó na árvore (1 indica que é uma folha)
     int n;                  //Quantidade atual de chaves no nó    
-    int C[B_TREE_ORDER-1];  //Vetor de chaves (chaves não inseridas são representadas por -1)
-    int Pr[B_TREE_ORDER-1]; //Vetor de valores para cada chave (valores não inserido são -1)
-    int P[B_TREE_ORDER];    //Vetor de "pointers" para os filhos do nó (indocam o RRN do nó filho)
+    int order;              //Ordem do nó (definida pelo formato do arquivo de índices)
+    int *C;                 //Vetor de chaves, com order-1 posições (chaves não inseridas são representadas por -1)
+    int *Pr;                //Vetor de valores para cada chave, com order-1 posições (valores não inserido são -1)
+    int *P;                 //Vetor de "pointers" para os filhos do nó, com order posições (indocam o RRN do nó filho)
+    int values[];           //Espaço dos três vetores acima, alocado junto com o nó
 };
 
 
 /*
-    Essa funcao cria um node da btree.
+    Conta quantas chaves de um vetor ordenado são menores que key, ou seja, a posição em que key estaria no vetor.
+    Vetores pequenos são comparados por inteiro, 4 chaves por vez com SSE2, sem nenhum desvio dependente dos dados.
+    Vetores maiores usam uma busca binária sem desvios (o próximo intervalo é escolhido com um movimento condicional).
+    Parametros:
+        keys -> o vetor ordenado de chaves
+        n -> a quantidade de chaves no vetor
+        key -> a chave procurada
+    Retorno:
+        int. a quantidade de chaves menores que key
+*/
+static int _count_keys_less_than (const int *keys, int n, int key) {
+    if (n <= B_TREE_NODE_LINEAR_SEARCH_MAX) {
+#ifdef __SSE2__
+        __m128i needle = _mm_set1_epi32(key);
+        int count = 0, i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128i block = _mm_loadu_si128((const __m128i*) (keys + i));
+            count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(block, needle))));
+        }
+#else
+        int count = 0, i = 0;
+#endif
+        //chaves restantes (ou todas, sem SSE2)
+        for (; i < n; i++)
+            count += (keys[i] < key);
+        return count;
+    }
+
+    const int *base = keys;
+    while (n > 1) {
+        int half = n / 2;
+        base = (base[half-1] < key) ? base + half : base;
+        n -= half;
+    }
+    return (base - keys) + (base[0] < key);
+}
+
+/*
+    Busca uma chave entre os itens de um node. Rotina usada na busca, na insercao e no split da arvore.
+    Parametros:
+        node -> o node onde a chave sera procurada
+        key -> a chave procurada
+        found -> se nao for NULL, recebe true caso a chave pertenca ao node
+    Retorno:
+        int. a posicao da chave no node, caso ela pertenca a ele; senao, a posicao em que ela seria inserida
+        (que e' tambem a posicao do P a ser seguido na arvore). -1 caso haja erro na operacao
+*/
+int b_tree_node_search (BTreeNode *node, int key, bool *found) {
+    if (node == NULL)
+        return -1;
+
+    int position = _count_keys_less_than(node->C, node->n, key);
+    if (found != NULL) *found = (position < node->n && node->C[position] == key);
+
+    return position;
+}
+
+//Posicao apos todas as chaves menores ou iguais a key (itens com chaves repetidas sao inseridos apos os ja existentes)
+static int _insert_position (const int *keys, int n, int key) {
+    return (key == INT_MAX) ? n : _count_keys_less_than(keys, n, key+1);
+}
+
+/*
+    Essa funcao cria um node da btree com a ordem padrão (B_TREE_ORDER).
     Parametros:
         nivel -> o nivel do node na btree
     Retorno:
         BtreeNode* . O node criado.
 */
 BTreeNode* b_tree_node_create (int nivel) {
-    BTreeNode *bTreeNode = (BTreeNode*) malloc (sizeof(BTreeNode));
+    return b_tree_node_create_with_order(nivel, B_TREE_ORDER);
+}
+
+/*
+    Essa funcao cria um node da btree com uma ordem dada.
+    Parametros:
+        nivel -> o nivel do node na btree
+        order -> a ordem do node (quantidade máxima de filhos)
+    Retorno:
+        BtreeNode* . O node criado, ou NULL caso a ordem seja inválida.
+*/
+BTreeNode* b_tree_node_create_with_order (int nivel, int order) {
+    if (order < B_TREE_MIN_ORDER || order > B_TREE_MAX_ORDER)
+        return NULL;
+
+    //Os três vetores são alocados junto com o nó: (order-1) chaves, (order-1) valores e order filhos
+    BTreeNode *bTreeNode = (BTreeNode*) malloc (sizeof(BTreeNode) + sizeof(int) * (3*order - 2));
     if (bTreeNode == NULL)
         return NULL;
 
+    bTreeNode->order = order;
+    bTreeNode->C = bTreeNode->values;
+    bTreeNode->Pr = bTreeNode->C + (order-1);
+    bTreeNode->P = bTreeNode->Pr + (order-1);
+
     b_tree_node_set_nivel(bTreeNode, nivel);
     bTreeNode->n = 0;
 
     //preenche os vetores com -1
-    for (int i = 0; i < B_TREE_ORDER-1; i++) {
+    for (int i = 0; i < order-1; i++) {
         bTreeNode->C[i] = -1;
         bTreeNode->Pr[i] = -1;
     }
 
-    for (int i = 0; i < B_TREE_ORDER; i++) {
+    for (int i = 0; i < order; i++) {
         bTreeNode->P[i] = -1;
     }
 
@@ -59,6 +154,24 @@ void b_tree_node_free (BTreeNode *node) {
     return;
 }
 
+/*
+    Copia todo o conteudo de um node para outro ja alocado
+    Parametros:
+        dest -> o node que recebera' o conteudo
+        src -> o node a ser copiado
+*/
+void b_tree_node_copy (BTreeNode *dest, BTreeNode *src) {
+    if (dest == NULL || src == NULL || dest->order != src->order)
+        return;
+
+    //Os pointers dos vetores apontam para dentro de cada nó, portanto apenas os valores são copiados
+    dest->nivel = src->nivel;
+    dest->n = src->n;
+    memcpy(dest->values, src->values, sizeof(int) * (3*src->order - 2));
+
+    return;
+}
+
 //////SET FUNCTIONS//////
 /*
     Seta o nivel de um node
@@ -91,34 +204,16 @@ int b_tree_node_sorted_insert_item (BTreeNode *node, int C, int Pr) {
     if (C == -1)
         return -1;
 
-    if (node->n == B_TREE_ORDER-1)
+    if (node->n == node->order-1)
         return -1;
 
-    int pos = -1;
-
-    for (int i = 0; i < B_TREE_ORDER-1; i++) {
-        //se for uma posicao inutilizada, insere nessa posicao
-        if (node->C[i] == -1) {
-            node->C[i] = C;
-            node->Pr[i] = Pr;
-            pos = i;
-            break;
-        }
-
-        //se encontrar a posicao para inserir, move o restante do vetor para inserir
-        else if (node->C[i] > C) {
-            for (int j = B_TREE_ORDER-3; j >= i; j--) {
-                node->C[j+1] = node->C[j];
-                node->Pr[j+1] = node->Pr[j];
-            }
-
-            node->C[i] = C;
-            node->Pr[i] = Pr;
-            pos = i;
-            break;
-        }
-    }
+    //encontra a posicao para inserir e move o restante dos itens de uma so vez
+    int pos = _insert_position(node->C, node->n, C);
+    memmove(&node->C[pos+1], &node->C[pos], sizeof(int) * (node->n - pos));
+    memmove(&node->Pr[pos+1], &node->Pr[pos], sizeof(int) * (node->n - pos));
 
+    node->C[pos] = C;
+    node->Pr[pos] = Pr;
     node->n++;
 
     return pos;
@@ -137,7 +232,7 @@ void b_tree_node_set_item (BTreeNode *node, int C, int Pr, int position) {
     if (node == NULL)
         return;
 
-    if (position >= B_TREE_ORDER-1 || position < 0)
+    if (position >= node->order-1 || position < 0)
         return;
 
     if (node->C[position] == -1) node->n++; //aumenta o contador caso seja um item novo (o item anterior seja -1). caso esteja substituindo um item, nao aumenta o contador
@@ -159,9 +254,11 @@ void b_tree_node_insert_P (BTreeNode *node, int P, int position) {
     if (node == NULL)
         return;
 
-    for (int i = B_TREE_ORDER-2; i >= position; i--) {
-        node->P[i+1] = node->P[i]; 
-    }
+    if (position >= node->order || position < 0)
+        return;
+
+    //o ultimo P e' descartado
+    memmove(&node->P[position+1], &node->P[position], sizeof(int) * (node->order-1 - position));
 
     node->P[position] = P;
 
@@ -179,7 +276,7 @@ void b_tree_node_set_P (BTreeNode *node, int P, int position) {
     if (node == NULL)
         return;
 
-    if (position >= B_TREE_ORDER || position < 0)
+    if (position >= node->order || position < 0)
         return;
 
     node->P[position] = P;
@@ -216,6 +313,20 @@ int b_tree_node_get_n (BTreeNode *node) {
     return node->n;
 }
 
+/*
+    Retorna a ordem do node
+    Parametros:
+        node -> o node ser lido
+    Retorno:
+        int. a ordem do node (quantidade maxima de filhos)
+*/
+int b_tree_node_get_order (BTreeNode *node) {
+    if (node == NULL)
+        return -1;
+
+    return node->order;
+}
+
 /*
     Retorna o C do node dada uma posicao
     Parametros:
@@ -228,7 +339,7 @@ int b_tree_node_get_C (BTreeNode *node, int position) {
     if (node == NULL)
         return -1;
 
-    if (position >= B_TREE_ORDER-1 || position < 0)
+    if (position >= node->order-1 || position < 0)
         return -1;
 
     return node->C[position];
@@ -246,7 +357,7 @@ int b_tree_node_get_Pr (BTreeNode *node, int position) {
     if (node == NULL)
         return -1;
 
-    if (position >= B_TREE_ORDER-1 || position < 0)
+    if (position >= node->order-1 || position < 0)
         return -1;
 
     return node->Pr[position];
@@ -264,7 +375,7 @@ int b_tree_node_get_P (BTreeNode *node, int position) {
     if (node == NULL)
         return -1;
 
-    if (position >= B_TREE_ORDER || position < 0)
+    if (position >= node->order || position < 0)
         return -1;    
     
     return node->P[position];
@@ -281,18 +392,16 @@ void b_tree_node_remove_item (BTreeNode *node, int position) {
     if (node == NULL)
         return;
 
-    if (position >= B_TREE_ORDER-1 || position < 0)
+    if (position >= node->order-1 || position < 0)
         return;
         
     if (node->C[position] != -1) node->n--; //caso seja um node valido, diminui o contador de itens
 
-    for (int i = position; i < B_TREE_ORDER-1-1; i++) {
-        node->C[i] = node->C[i+1];
-        node->Pr[i] = node->Pr[i+1];
-    }
+    memmove(&node->C[position], &node->C[position+1], sizeof(int) * (node->order-2 - position));
+    memmove(&node->Pr[position], &node->Pr[position+1], sizeof(int) * (node->order-2 - position));
 
-    node->C[B_TREE_ORDER-2] = -1;
-    node->Pr[B_TREE_ORDER-2] = -1;
+    node->C[node->order-2] = -1;
+    node->Pr[node->order-2] = -1;
 
     return;
 }
@@ -307,14 +416,12 @@ void b_tree_node_remove_P (BTreeNode *node, int position) {
     if (node == NULL)
         return;
 
-    if (position >= B_TREE_ORDER || position < 0)
+    if (position >= node->order || position < 0)
         return;
 
-    for (int i = position; i < B_TREE_ORDER-1; i++) {
-        node->P[i] = node->P[i+1];
-    }
+    memmove(&node->P[position], &node->P[position+1], sizeof(int) * (node->order-1 - position));
 
-    node->P[B_TREE_ORDER-1] = -1;
+    node->P[node->order-1] = -1;
 
     return;
 }
@@ -333,32 +440,11 @@ int b_tree_node_get_RRN_that_fits (BTreeNode *node, int key) {
     if (node == NULL || key < 0)
         return -1;
 
-    int nodeRRN = 0;
-
-    //flag para verificar se foi encontrado um lugar para melhor encaminhar a chave antes de terminar o vetor de itens
-    bool enteredBeforeNodeEnd = false;
-    for (int i = 0; i < B_TREE_ORDER-1; i++) {
-        int C = b_tree_node_get_C(node, i);
-
-        if (C == -1 || key < C) {
-            nodeRRN = b_tree_node_get_P(node, i);
-            enteredBeforeNodeEnd = true;
-            break;
-        }
-
-        //se a chave pertender ao node, retorna -2
-        else if (key == C) {
-            nodeRRN = -2;
-            enteredBeforeNodeEnd = true;
-            break;
-        }  
-    }
-
-    //Se não tiver entrado ainda (já chegamos no fim do nó), força a entrada à direita
-    if (!enteredBeforeNodeEnd)
-        nodeRRN = b_tree_node_get_P(node, B_TREE_ORDER-1);
+    //se a chave pertencer ao node, retorna -2, senao retorna o P da posicao em que ela se encaixaria
+    bool found;
+    int position = b_tree_node_search(node, key, &found);
 
-    return nodeRRN;
+    return found ? -2 : b_tree_node_get_P(node, position);
 }
 
 /*
@@ -371,19 +457,12 @@ int b_tree_node_get_RRN_that_fits (BTreeNode *node, int key) {
         int. a posicao onde foi inserido
 */
 int insertion_sort_insert_in_array (int *arr, int size, int value) {
-    for (int i = 0; i < size-1; i++) {
-        if (value < arr[i]) {
-            for (int j = size-2; j >= i; j--) {
-                arr[j+1] = arr[j];
-            }
-
-            arr[i] = value;
-            return i;
-        }
-    }
+    //as size-1 primeiras posicoes ja estao ordenadas; o ultimo valor do vetor e' descartado
+    int position = _insert_position(arr, size-1, value);
+    memmove(&arr[position+1], &arr[position], sizeof(int) * (size-1 - position));
 
-    arr[size-1] = value;
-    return size-1;
+    arr[position] = value;
+    return position;
 }
 
 /*
@@ -398,64 +477,48 @@ int insertion_sort_insert_in_array (int *arr, int size, int value) {
         BTreeNode* . o node novo apos a divisao
 */
 BTreeNode *b_tree_node_split_one_to_two(BTreeNode *old, int C, int Pr, int P) {
-	BTreeNode *new = b_tree_node_create(b_tree_node_get_nivel(old)); //cria um node com o mesmo nivel do antigo
+    int order = old->order;
+	BTreeNode *new = b_tree_node_create_with_order(b_tree_node_get_nivel(old), order); //cria um node com o mesmo nivel do antigo
 
     //aloca os vetores para fazer as insercoes devidas de C, Pr, e P.
-    int *newC = (int*) malloc (sizeof(int) * B_TREE_ORDER);
-    int *newPr = (int*) malloc (sizeof(int) * B_TREE_ORDER);
-    int *newP = (int*) malloc (sizeof(int) * B_TREE_ORDER+1);
+    int *newC = (int*) malloc (sizeof(int) * order);
+    int *newPr = (int*) malloc (sizeof(int) * order);
+    int *newP = (int*) malloc (sizeof(int) * (order+1));
 
     //copia os valores do old
-    for (int i = 0; i < B_TREE_ORDER-1; i++) {
-        newC[i] = b_tree_node_get_C(old, i);
-        newPr[i] = b_tree_node_get_Pr(old, i);
-    }
-    for (int i = 0; i < B_TREE_ORDER; i++) {
-        newP[i] = b_tree_node_get_P(old, i);
-    }
+    memcpy(newC, old->C, sizeof(int) * (order-1));
+    memcpy(newPr, old->Pr, sizeof(int) * (order-1));
+    memcpy(newP, old->P, sizeof(int) * order);
     
     //insere C na posicao devida
-    int position = insertion_sort_insert_in_array(newC, B_TREE_ORDER, C);
+    int position = insertion_sort_insert_in_array(newC, order, C);
     //insere Pr no mesmo valor de posicao que C foi inserido
-    for (int i = B_TREE_ORDER-2; i >= position; i--) {
-        newPr[i+1] = newPr[i];
-    }
+    memmove(&newPr[position+1], &newPr[position], sizeof(int) * (order-1 - position));
     newPr[position] = Pr;
 
     //insere P na posicao+1 do valor onde P foi inserido, para facilitar de acordo com as especificacoes
-    for (int i = B_TREE_ORDER-1; i >= position+1; i--) {
-        newP[i+1] = newP[i];
-    }
+    memmove(&newP[position+2], &newP[position+1], sizeof(int) * (order-1 - position));
     newP[position+1] = P;
 
-    //seta os itens necessarios no node antigo
-    for (int i = 0; i < B_TREE_ORDER/2; i++) {
-        b_tree_node_set_item(old, newC[i], newPr[i], i);
-    }
-    //remove os itens desnecessarios do node antigo
-    for (int i = B_TREE_ORDER/2; i < B_TREE_ORDER-1; i++) {
-        b_tree_node_remove_item(old, B_TREE_ORDER/2);
+    //o node antigo fica com os order/2 primeiros itens (e seus order/2+1 RRNs); os demais posicoes voltam a ser nulas
+    int half = order/2;
+    memcpy(old->C, newC, sizeof(int) * half);
+    memcpy(old->Pr, newPr, sizeof(int) * half);
+    memcpy(old->P, newP, sizeof(int) * (half+1));
+    for (int i = half; i < order-1; i++) {
+        old->C[i] = -1;
+        old->Pr[i] = -1;
     }
-
-    //seta os itens no node novo (nao ha necessidade de remocao, pois o node e' novo e todos os seus valores ja eram nulos)
-    for (int i = B_TREE_ORDER/2; i < B_TREE_ORDER; i++) {
-        b_tree_node_sorted_insert_item(new, newC[i], newPr[i]);
+    for (int i = half+1; i < order; i++) {
+        old->P[i] = -1;
     }
+    old->n = half;
 
-    //seta os RRNs necessarios no node antigo 
-    for (int i = 0; i < B_TREE_ORDER/2+1; i++) {
-        b_tree_node_set_P(old, newP[i], i);
-    }
-    //remove os RRNS desncessarios do node antigo
-    for (int i = B_TREE_ORDER/2+1; i < B_TREE_ORDER; i++) {
-        b_tree_node_set_P(old, -1, i);
-    }
-    
-    //seta os RRNs no node novo
-    int start = B_TREE_ORDER/2+1;
-    for (int i = start; i < B_TREE_ORDER+1; i++) {
-        b_tree_node_set_P(new, newP[i], i-start);
-    }
+    //o node novo fica com os itens restantes (nao ha necessidade de remocao, pois o node e' novo e todos os seus valores ja eram nulos)
+    memcpy(new->C, &newC[half], sizeof(int) * (order - half));
+    memcpy(new->Pr, &newPr[half], sizeof(int) * (order - half));
+    memcpy(new->P, &newP[half+1], sizeof(int) * (order - half));
+    new->n = order - half;
 
     //desaloca a memoria dos vetores auxiliares
     free(newC);
@@ -0,0 +1,378 @@
+#include "b_tree_page_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "binary_b_tree.h"
+#include "b_tree_node.h"
+#include "debug.h"
+
+/*
+    Frame do buffer pool: guarda um nó já decodificado e as informações
+    usadas pelo algoritmo de substituição (CLOCK).
+*/
+typedef struct {
+    int RRN;                //RRN da página guardada no frame (-1 indica frame vazio)
+    BTreeNode *node;        //Nó decodificado (NULL enquanto o frame nunca tiver sido usado)
+    int pin_count;          //Quantidade de usuários que ainda estão usando o nó (frames fixados não podem ser substituídos)
+    bool dirty;             //Indica que o nó foi alterado em RAM e precisa ser escrito no disco
+    bool referenced;        //Bit de referência do algoritmo CLOCK
+    int next_in_bucket;     //Próximo frame na mesma lista da tabela hash (-1 indica fim da lista)
+} BTreePageFrame;
+
+/*
+    Struct que representa o buffer pool de páginas da árvore-B.
+    As páginas são localizadas por uma tabela hash (RRN -> frame) e substituídas pelo algoritmo CLOCK.
+    As escritas são adiadas (write-back) até que a página seja substituída ou o cache seja descarregado.
+*/
+struct _b_tree_page_cache {
+    FILE *bin_file;
+    int order;              //Ordem dos nós do arquivo
+    int page_size;          //Tamanho, em bytes, de cada página do arquivo
+    BTreePageFrame *frames;
+    int capacity;
+    int *buckets;           //Primeiro frame de cada lista da tabela hash (-1 indica lista vazia)
+    int bucket_count;
+    int clock_hand;         //Posição atual do ponteiro do CLOCK
+    int hits;
+    int misses;
+    BTreePageReadFunc read_func;    //Decodificação de uma página do disco
+    BTreePageWriteFunc write_func;  //Codificação de um nó em uma página do disco
+};
+
+//Função hash simples: o RRN já é bem distribuído
+static int _bucket_of(BTreePageCache *cache, int RRN) { return RRN % cache->bucket_count; }
+
+/*
+    Funcao que cria o buffer pool de páginas da árvore-B
+    Parametros:
+        bin_file -> arquivo de índices já aberto (a leitura e a escrita das páginas são feitas por ele)
+        order -> ordem dos nós do arquivo
+        page_size -> tamanho, em bytes, de cada página do arquivo (o header ocupa a primeira página)
+        capacity -> quantidade máxima de páginas em RAM
+    Retorno:
+        BTreePageCache* . O cache criado, ou NULL em caso de erro
+*/
+BTreePageCache *b_tree_page_cache_create(FILE *bin_file, int order, int page_size, int capacity) {
+    if (page_size < B_TREE_NODE_SIZE(order)) {
+        DP("ERROR: invalid parameters @b_tree_page_cache_create()\n");
+        return NULL;
+    }
+
+    return b_tree_page_cache_create_with_codec(bin_file, order, page_size, capacity, binary_read_b_tree_node, binary_write_b_tree_node);
+}
+
+/*
+    Funcao que cria o buffer pool de páginas com um formato de página próprio (usada, por exemplo, pela árvore-B+).
+    Os nós continuam representados em RAM por BTreeNode da ordem dada; apenas a sua disposição no disco muda.
+    Parametros:
+        bin_file, order, page_size, capacity -> assim como em b_tree_page_cache_create()
+        read_func -> função que lê uma página a partir da posição atual do arquivo
+        write_func -> função que escreve um nó (página inteira) na posição atual do arquivo
+    Retorno:
+        BTreePageCache* . O cache criado, ou NULL em caso de erro
+*/
+BTreePageCache *b_tree_page_cache_create_with_codec(FILE *bin_file, int order, int page_size, int capacity,
+    BTreePageReadFunc read_func, BTreePageWriteFunc write_func) {
+    if (bin_file == NULL || capacity <= 0 || page_size <= 0 || read_func == NULL || write_func == NULL) {
+        DP("ERROR: invalid parameters @b_tree_page_cache_create_with_codec()\n");
+        return NULL;
+    }
+
+    //Tenta alocar memória
+    BTreePageCache *cache = malloc(sizeof(BTreePageCache));
+    if (cache == NULL) {
+        DP("ERROR: not enough memory for BTreePageCache @b_tree_page_cache_create()\n");
+        return NULL;
+    }
+
+    cache->bin_file = bin_file;
+    cache->order = order;
+    cache->page_size = page_size;
+    cache->capacity = capacity;
+    cache->bucket_count = capacity * 2;
+    cache->frames = malloc(sizeof(BTreePageFrame) * capacity);
+    cache->buckets = malloc(sizeof(int) * cache->bucket_count);
+    if (cache->frames == NULL || cache->buckets == NULL) {
+        DP("ERROR: not enough memory for BTreePageCache frames @b_tree_page_cache_create()\n");
+        free(cache->frames);
+        free(cache->buckets);
+        free(cache);
+        return NULL;
+    }
+
+    //Define os valores iniciais (todos os frames vazios)
+    for (int i = 0; i < capacity; i++) {
+        cache->frames[i].RRN = -1;
+        cache->frames[i].node = NULL;
+        cache->frames[i].pin_count = 0;
+        cache->frames[i].dirty = false;
+        cache->frames[i].referenced = false;
+        cache->frames[i].next_in_bucket = -1;
+    }
+
+    for (int i = 0; i < cache->bucket_count; i++)
+        cache->buckets[i] = -1;
+
+    cache->clock_hand = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->read_func = read_func;
+    cache->write_func = write_func;
+    return cache;
+}
+
+/*
+    Escreve no disco o nó de um frame, caso ele tenha sido modificado
+    Parametros:
+        cache -> o cache que possui o frame
+        frame -> o frame a ser escrito
+*/
+static void _write_back(BTreePageCache *cache, BTreePageFrame *frame) {
+    if (!frame->dirty || frame->RRN == -1) return;
+
+    long offset = (long) (frame->RRN+1) * cache->page_size;
+    fseek(cache->bin_file, offset, SEEK_SET);
+    cache->write_func(cache->bin_file, frame->node, cache->page_size);
+    frame->dirty = false;
+}
+
+/*
+    Procura o frame que guarda um RRN
+    Retorno:
+        int. o índice do frame, ou -1 caso a página não esteja em RAM
+*/
+static int _find_frame(BTreePageCache *cache, int RRN) {
+    int i = cache->buckets[_bucket_of(cache, RRN)];
+    while (i != -1 && cache->frames[i].RRN != RRN)
+        i = cache->frames[i].next_in_bucket;
+    return i;
+}
+
+//Remove o frame da lista da tabela hash em que ele se encontra
+static void _unlink_frame(BTreePageCache *cache, int frame_index) {
+    int *link = &cache->buckets[_bucket_of(cache, cache->frames[frame_index].RRN)];
+    while (*link != frame_index)
+        link = &cache->frames[*link].next_in_bucket;
+    *link = cache->frames[frame_index].next_in_bucket;
+    cache->frames[frame_index].next_in_bucket = -1;
+}
+
+/*
+    Escolhe um frame para receber uma nova página, usando o algoritmo CLOCK.
+    Se a página do frame escolhido tiver sido modificada, ela é escrita no disco antes.
+    Parametros:
+        cache -> o cache
+        RRN -> o RRN da página que ocupará o frame
+    Retorno:
+        int. o índice do frame escolhido (já associado ao RRN), ou -1 se todos os frames estiverem fixados
+*/
+static int _claim_frame(BTreePageCache *cache, int RRN) {
+    int victim = -1;
+
+    //Cada frame é visitado no máximo duas vezes: na primeira volta o bit de referência é zerado
+    for (int steps = 0; steps < 2 * cache->capacity; steps++) {
+        BTreePageFrame *frame = &cache->frames[cache->clock_hand];
+        int current = cache->clock_hand;
+        cache->clock_hand = (cache->clock_hand + 1) % cache->capacity;
+
+        if (frame->pin_count > 0) continue;
+        if (frame->referenced) {
+            frame->referenced = false;
+            continue;
+        }
+
+        victim = current;
+        break;
+    }
+
+    if (victim == -1) {
+        DP("ERROR: all BTreePageCache frames are pinned @_claim_frame()\n");
+        return -1;
+    }
+
+    //Libera o frame, salvando a página antiga se necessário
+    BTreePageFrame *frame = &cache->frames[victim];
+    if (frame->RRN != -1) {
+        _write_back(cache, frame);
+        _unlink_frame(cache, victim);
+    }
+
+    //Associa o frame ao novo RRN
+    int bucket = _bucket_of(cache, RRN);
+    frame->RRN = RRN;
+    frame->next_in_bucket = cache->buckets[bucket];
+    cache->buckets[bucket] = victim;
+    return victim;
+}
+
+/*
+    Obtém o nó em um RRN dado, lendo-o do disco apenas se ele não estiver em RAM.
+    O nó retornado fica fixado (pinned) até que b_tree_page_cache_unpin() seja chamada,
+    e NÃO deve ser liberado por quem o recebeu.
+    Parametros:
+        cache -> o cache de páginas
+        RRN -> o RRN do nó desejado
+    Retorno:
+        BTreeNode* . o nó no RRN, ou NULL em caso de erro
+*/
+BTreeNode *b_tree_page_cache_fetch(BTreePageCache *cache, int RRN) {
+    if (cache == NULL || RRN < 0) {
+        DP("ERROR: invalid parameters @b_tree_page_cache_fetch()\n");
+        return NULL;
+    }
+
+    //Página já está em RAM
+    int frame_index = _find_frame(cache, RRN);
+    if (frame_index != -1) {
+        cache->hits++;
+    } else {
+        cache->misses++;
+
+        frame_index = _claim_frame(cache, RRN);
+        if (frame_index == -1) return NULL;
+
+        //Lê o nó do disco para o frame
+        BTreePageFrame *frame = &cache->frames[frame_index];
+        fseek(cache->bin_file, (long) (RRN+1) * cache->page_size, SEEK_SET);
+        b_tree_node_free(frame->node);
+        frame->node = cache->read_func(cache->bin_file, cache->order, cache->page_size);
+        frame->dirty = false;
+
+        //Se a leitura falhar, o frame é liberado para que o RRN não fique associado a um frame sem nó
+        if (frame->node == NULL) {
+            _unlink_frame(cache, frame_index);
+            frame->RRN = -1;
+            frame->referenced = false;
+            return NULL;
+        }
+    }
+
+    BTreePageFrame *frame = &cache->frames[frame_index];
+    frame->pin_count++;
+    frame->referenced = true;
+    return frame->node;
+}
+
+/*
+    Escreve um nó em um RRN dado. A escrita no disco é adiada até que a página seja substituída ou o cache seja descarregado.
+    Se o nó informado for o próprio nó do frame (obtido por b_tree_page_cache_fetch()), apenas marca a página como modificada,
+    caso contrário, o conteúdo do nó é copiado (e quem chamou a função continua responsável por liberá-lo).
+    Parametros:
+        cache -> o cache de páginas
+        RRN -> o RRN onde o nó será escrito
+        node -> o nó a ser escrito
+*/
+void b_tree_page_cache_put(BTreePageCache *cache, int RRN, BTreeNode *node) {
+    if (cache == NULL || node == NULL || RRN < 0) {
+        DP("ERROR: invalid parameters @b_tree_page_cache_put()\n");
+        return;
+    }
+
+    int frame_index = _find_frame(cache, RRN);
+    if (frame_index == -1) {
+        frame_index = _claim_frame(cache, RRN);
+
+        //Sem frames disponíveis: escreve diretamente no disco
+        if (frame_index == -1) {
+            long offset = (long) (RRN+1) * cache->page_size;
+            fseek(cache->bin_file, offset, SEEK_SET);
+            cache->write_func(cache->bin_file, node, cache->page_size);
+            return;
+        }
+    }
+
+    BTreePageFrame *frame = &cache->frames[frame_index];
+    if (frame->node != node) {
+        if (frame->node == NULL) frame->node = b_tree_node_create_with_order(b_tree_node_get_nivel(node), cache->order);
+        b_tree_node_copy(frame->node, node);
+    }
+
+    frame->dirty = true;
+    frame->referenced = true;
+}
+
+/*
+    Libera (unpin) um nó obtido por b_tree_page_cache_fetch(), permitindo que ele seja substituído
+    Parametros:
+        cache -> o cache de páginas
+        node -> o nó obtido anteriormente
+*/
+void b_tree_page_cache_unpin(BTreePageCache *cache, BTreeNode *node) {
+    if (cache == NULL || node == NULL) return;
+
+    for (int i = 0; i < cache->capacity; i++) {
+        if (cache->frames[i].node == node && cache->frames[i].RRN != -1) {
+            if (cache->frames[i].pin_count > 0) cache->frames[i].pin_count--;
+            return;
+        }
+    }
+
+    DP("WARNING: trying to unpin a node that is not cached @b_tree_page_cache_unpin()\n");
+}
+
+/*
+    Escreve no disco todas as páginas modificadas que ainda estão em RAM
+    Parametros:
+        cache -> o cache de páginas
+*/
+void b_tree_page_cache_flush(BTreePageCache *cache) {
+    if (cache == NULL) return;
+
+    //Escreve em ordem de RRN para que o arquivo seja percorrido sequencialmente
+    int last_RRN = -1;
+    while (true) {
+        int next = -1;
+        for (int i = 0; i < cache->capacity; i++) {
+            BTreePageFrame *frame = &cache->frames[i];
+            if (frame->dirty && frame->RRN > last_RRN && (next == -1 || frame->RRN < cache->frames[next].RRN))
+                next = i;
+        }
+
+        if (next == -1) break;
+        last_RRN = cache->frames[next].RRN;
+        _write_back(cache, &cache->frames[next]);
+    }
+}
+
+/*
+    Retorna as estatísticas de uso do cache
+    Parametros:
+        cache -> o cache de páginas
+    Retorno:
+        pairIntInt. first -> quantidade de acertos (páginas já em RAM), second -> quantidade de faltas (leituras do disco)
+*/
+pairIntInt b_tree_page_cache_get_stats(BTreePageCache *cache) {
+    pairIntInt stats;
+    stats.first = (cache == NULL) ? 0 : cache->hits;
+    stats.second = (cache == NULL) ? 0 : cache->misses;
+    return stats;
+}
+
+/*
+    Funcao que desaloca a memoria do cache, escrevendo antes as páginas modificadas.
+    Essa funcao NAO fecha o arquivo de índices.
+    Parametros:
+        cache_ptr -> o endereco do cache
+*/
+void b_tree_page_cache_free(BTreePageCache **cache_ptr) {
+    if (cache_ptr == NULL) {
+        DP("ERROR: invalid parameter @b_tree_page_cache_free()\n");
+        return;
+    }
+    #define cache (*cache_ptr)
+
+    //Já foi liberado
+    if (cache == NULL) return;
+
+    b_tree_page_cache_flush(cache);
+
+    for (int i = 0; i < cache->capacity; i++)
+        b_tree_node_free(cache->frames[i].node);
+
+    free(cache->frames);
+    free(cache->buckets);
+    free(cache);
+    cache = NULL;
+    #undef cache
+}
@@ -0,0 +1,161 @@
+#include "b_tree_query_planner.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "registry_header.h"
+#include "registry_column_store.h"
+#include "debug.h"
+
+/*
+    Ordem de preferência dos campos indexados de um filtro, do que se espera ser o mais seletivo (idNascimento é único)
+    ao menos seletivo (sexoBebe tem apenas três valores possíveis)
+*/
+static const RegistryFieldsMask _ACCESS_PATH_PREFERENCE[] = {
+    MASK_IDNASCIMENTO, MASK_DATANASCIMENTO, MASK_CIDADEMAE, MASK_CIDADEBEBE,
+    MASK_IDADEMAE, MASK_ESTADOMAE, MASK_ESTADOBEBE, MASK_SEXOBEBE
+};
+#define ACCESS_PATH_COUNT ((int) (sizeof(_ACCESS_PATH_PREFERENCE) / sizeof(_ACCESS_PATH_PREFERENCE[0])))
+
+/*
+    Funcao (privada) que escolhe o caminho de acesso de um filtro: o campo preferido dentre os que estão no filtro e têm índice
+    Parametros:
+        indexes -> índices abertos
+        filter -> filtro
+        field_ptr -> onde será guardado o campo escolhido
+    Retorno:
+        BTreeSecondaryIndex* -> o índice escolhido, ou NULL se o filtro deve ser resolvido com varredura
+*/
+static BTreeSecondaryIndex *_access_path(BTreeSecondaryIndexSet *indexes, VirtualRegistryFilter *filter, RegistryFieldsMask *field_ptr) {
+    RegistryFieldsMask filter_fields = virtual_registry_get_fieldmask(filter);
+
+    for (int i = 0; i < ACCESS_PATH_COUNT; i++) {
+        RegistryFieldsMask field = _ACCESS_PATH_PREFERENCE[i];
+        if (!(filter_fields & field)) continue;
+
+        BTreeSecondaryIndex *index = b_tree_secondary_index_set_get(indexes, field);
+        if (index != NULL) {
+            *field_ptr = field;
+            return index;
+        }
+    }
+
+    return NULL;
+}
+
+static int _compare_ints(const void *a, const void *b) {
+    int i1 = *(const int *) a, i2 = *(const int *) b;
+    return (i1 > i2) - (i1 < i2);
+}
+
+/*
+    Funcao (privada) usada quando os índices não servem: se houver uma cópia colunar do arquivo (ver registry_column_store.h),
+    os candidatos são obtidos dela, lendo apenas as colunas dos campos dos filtros
+    Retorno:
+        int. quantidade de candidatos, ou -1 se não houver cópia colunar ou se os candidatos forem muitos
+*/
+static int _column_candidates(RegistryManager *registry_manager, VirtualRegistryArray *filters, int **RRNs_ptr) {
+    RegistryColumnStore *columns = registry_manager_get_column_store(registry_manager);
+    if (columns == NULL) return -1;
+
+    RegistryHeader *reg_header = registry_manager_get_registry_header(registry_manager);
+    int max_candidates = reg_header_get_registries_count(reg_header) / B_TREE_QUERY_PLANNER_SCAN_FRACTION;
+    return registry_column_store_select(columns, filters, max_candidates, RRNs_ptr);
+}
+
+/**
+ *  Planeja a busca de um vetor de filtros (um registro condiz com o vetor se condisser com um dos filtros), obtendo
+ *  pelos índices os RRNs candidatos. Cada filtro usa o índice de um dos seus campos e os candidatos são unidos.
+ *  Sem índices utilizáveis, os candidatos vêm da cópia colunar do arquivo, se ela existir.
+ *  Parâmetros:
+ *      BTreeSecondaryIndexSet *indexes -> índices abertos sobre o arquivo de registros (pode ser NULL)
+ *      RegistryManager *registry_manager -> gerenciador com o arquivo de registros aberto
+ *      VirtualRegistryArray *filters -> vetor de filtros
+ *      int **RRNs_ptr -> onde será guardado o vetor de candidatos, em ordem crescente e sem repetições (deve ser liberado)
+ *      int *pages_ptr -> se não for NULL, recebe a quantidade de páginas dos índices acessadas
+ *  Retorno:
+ *      int -> quantidade de candidatos, ou -1 se a busca deve ser feita com uma varredura completa do arquivo
+ */
+int b_tree_query_planner_candidates(BTreeSecondaryIndexSet *indexes, RegistryManager *registry_manager, VirtualRegistryArray *filters, int **RRNs_ptr, int *pages_ptr) {
+    if (RRNs_ptr == NULL) {
+        DP("ERROR: invalid parameters @b_tree_query_planner_candidates()\n");
+        return -1;
+    }
+
+    *RRNs_ptr = NULL;
+    if (pages_ptr != NULL) *pages_ptr = 0;
+    if (registry_manager == NULL || filters == NULL || filters->size <= 0) return -1;
+    if (indexes == NULL) return _column_candidates(registry_manager, filters, RRNs_ptr);
+
+    //Todos os filtros devem ter um índice, senão uma varredura é necessária de qualquer forma
+    BTreeSecondaryIndex **paths = malloc(filters->size * sizeof(BTreeSecondaryIndex *));
+    RegistryFieldsMask *fields = malloc(filters->size * sizeof(RegistryFieldsMask));
+    if (paths == NULL || fields == NULL) {
+        DP("ERROR: not enough memory @b_tree_query_planner_candidates()\n");
+        free(paths);
+        free(fields);
+        return -1;
+    }
+
+    bool indexed = true;
+    for (int i = 0; indexed && i < filters->size; i++) {
+        paths[i] = _access_path(indexes, filters->data_arr[i], &fields[i]);
+        indexed = paths[i] != NULL;
+    }
+
+    RegistryHeader *reg_header = registry_manager_get_registry_header(registry_manager);
+    int max_candidates = reg_header_get_registries_count(reg_header) / B_TREE_QUERY_PLANNER_SCAN_FRACTION;
+
+    int *candidates = NULL;
+    int count = 0, pages = 0;
+    for (int i = 0; indexed && i < filters->size; i++) {
+        int *RRNs, filter_pages = 0;
+        int key = b_tree_secondary_index_key_of_filter(fields[i], filters->data_arr[i]);
+        int filter_count = b_tree_secondary_index_search(paths[i], key, &RRNs, &filter_pages);
+        pages += filter_pages;
+
+        //Erro na leitura do índice ou candidatos demais: desiste e indica a varredura
+        if (filter_count < 0 || count + filter_count > max_candidates) {
+            free(RRNs);
+            indexed = false;
+            break;
+        }
+
+        if (filter_count == 0) continue;
+
+        int *merged = realloc(candidates, (count + filter_count) * sizeof(int));
+        if (merged == NULL) {
+            DP("ERROR: not enough memory @b_tree_query_planner_candidates()\n");
+            free(RRNs);
+            indexed = false;
+            break;
+        }
+        candidates = merged;
+        memcpy(candidates + count, RRNs, filter_count * sizeof(int));
+        count += filter_count;
+        free(RRNs);
+    }
+
+    free(paths);
+    free(fields);
+    if (pages_ptr != NULL) *pages_ptr = pages;
+
+    if (!indexed) {
+        free(candidates);
+        return _column_candidates(registry_manager, filters, RRNs_ptr);
+    }
+
+    //Os candidatos de cada filtro já estão ordenados, mas um mesmo RRN pode ter vindo de filtros diferentes
+    if (filters->size > 1 && count > 1) {
+        qsort(candidates, count, sizeof(int), _compare_ints);
+
+        int unique = 1;
+        for (int i = 1; i < count; i++)
+            if (candidates[i] != candidates[unique - 1]) candidates[unique++] = candidates[i];
+        count = unique;
+    }
+
+    *RRNs_ptr = candidates;
+    return count;
+}
@@ -0,0 +1,727 @@
+#include "b_tree_secondary_index.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "b_tree_manager.h"
+#include "b_tree_bulk_loader.h"
+#include "registry_header.h"
+#include "wal.h"
+#include "debug.h"
+
+//Identifica o arquivo de posting lists (o header ocupa o primeiro bloco)
+#define POSTINGS_MAGIC "PST1"
+
+//Quantidade de campos do registro (um índice secundário possível por campo)
+#define SECONDARY_INDEX_FIELDS 8
+
+/*
+    Bloco de uma posting list. Os blocos de uma mesma chave são encadeados a partir do bloco apontado pela árvore-B
+*/
+typedef struct {
+    int next;                                   //Próximo bloco da lista (-1 indica fim da lista)
+    int count;                                  //Quantidade de RRNs usados no bloco
+    int RRNs[B_TREE_POSTINGS_BLOCK_RRNS];
+} _PostingBlock;
+
+/*
+    Struct que representa um índice secundário aberto: a árvore-B (chave -> primeiro bloco) e o arquivo de posting lists
+*/
+struct _b_tree_secondary_index {
+    RegistryFieldsMask field;
+    OPEN_MODE mode;
+    BTreeManager *tree;
+    FILE *postings_file;
+    WriteAheadLog *wal;         //Log das modificações do arquivo de posting lists (apenas no modo MODIFY)
+    int block_count;            //Quantidade de blocos do arquivo, incluindo o header
+};
+
+/*
+    Conjunto dos índices secundários de um arquivo de registros. No modo MODIFY, o conjunto recebe as modificações
+    feitas pelo RegistryManager (callback de modificações) e atualiza todos os índices
+*/
+struct _b_tree_secondary_index_set {
+    RegistryManager *registry_manager;
+    BTreeSecondaryIndex *indexes[SECONDARY_INDEX_FIELDS];   //Um por bit da máscara de campos (NULL se não houver)
+};
+
+//Posição de um campo no vetor de índices do conjunto (bit da máscara)
+static int _field_position(RegistryFieldsMask field) { return __builtin_ctz(field); }
+
+//Nome do campo usado nos nomes dos arquivos do índice
+static char *_field_name(RegistryFieldsMask field) {
+    switch (field) {
+        case MASK_CIDADEMAE: return "cidadeMae";
+        case MASK_CIDADEBEBE: return "cidadeBebe";
+        case MASK_IDNASCIMENTO: return "idNascimento";
+        case MASK_IDADEMAE: return "idadeMae";
+        case MASK_DATANASCIMENTO: return "dataNascimento";
+        case MASK_SEXOBEBE: return "sexoBebe";
+        case MASK_ESTADOMAE: return "estadoMae";
+        case MASK_ESTADOBEBE: return "estadoBebe";
+        default: return NULL;
+    }
+}
+
+/**
+ *  Indica se um campo pode ter índice secundário (apenas um campo por índice). O idNascimento também pode:
+ *  diferente do índice primário (funcionalidade 8), cujo arquivo é escolhido pelo usuário, este acompanha o arquivo
+ *  de registros e é atualizado a cada modificação, podendo ser usado pelo planejador de consultas
+ *  Parâmetros:
+ *      RegistryFieldsMask field -> máscara com um único campo
+ *  Retorno:
+ *      bool -> true se o campo pode ser indexado
+ */
+bool b_tree_secondary_index_is_supported(RegistryFieldsMask field) {
+    return _field_name(field) != NULL;
+}
+
+//Monta o nome de um arquivo do índice (ex.: "dados.bin" + estadoMae + ".idx" -> "dados.bin.estadoMae.idx")
+static char *_index_filename(char *reg_filename, RegistryFieldsMask field, char *suffix) {
+    char *field_name = _field_name(field);
+    char *filename = malloc(strlen(reg_filename) + 1 + strlen(field_name) + strlen(suffix) + 1);
+    if (filename == NULL) return NULL;
+
+    sprintf(filename, "%s.%s%s", reg_filename, field_name, suffix);
+    return filename;
+}
+
+
+/**
+ *  Obtém o nome do arquivo da árvore-B do índice secundário de um campo
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      RegistryFieldsMask field -> campo indexado
+ *  Retorno:
+ *      char* -> nome do arquivo (deve ser liberado), ou NULL se o campo não puder ser indexado
+ */
+char *b_tree_secondary_index_filename(char *reg_filename, RegistryFieldsMask field) {
+    if (reg_filename == NULL || !b_tree_secondary_index_is_supported(field)) return NULL;
+    return _index_filename(reg_filename, field, B_TREE_SECONDARY_INDEX_SUFFIX);
+}
+
+
+/*
+    Chaves. A árvore-B só aceita chaves não negativas, portanto todos os valores são levados para [0, INT_MAX].
+    Valores nulos ficam com a chave 0 (e podem colidir com outros valores: os candidatos são sempre verificados).
+*/
+
+//Chave de um campo inteiro: o valor deslocado em 1 (nulo = -1 -> 0)
+static int _int_key(int value) {
+    if (value < 0) return 0;
+    return (value == INT_MAX) ? INT_MAX : value + 1;
+}
+
+//Chave de uma string: os 4 primeiros bytes em ordem big-endian, sem o último bit (preserva a ordem lexicográfica dos prefixos)
+static int _string_key(const char *data, int size) {
+    unsigned int prefix = 0;
+    for (int i = 0; i < 4; i++)
+        prefix = (prefix << 8) | ((i < size) ? (unsigned char) data[i] : 0);
+    return (int) (prefix >> 1);
+}
+
+//Chave de uma data: AAAAMMDD (as datas fora do formato AAAA-MM-DD usam a chave de string)
+static int _date_key(const char *data, int size) {
+    static const int digit_positions[] = {0, 1, 2, 3, 5, 6, 8, 9};
+    if (size != 10 || data[4] != '-' || data[7] != '-') return _string_key(data, size);
+
+    int key = 0;
+    for (int i = 0; i < 8; i++) {
+        char c = data[digit_positions[i]];
+        if (c < '0' || c > '9') return _string_key(data, size);
+        key = key * 10 + (c - '0');
+    }
+    return key;
+}
+
+//Chave de um campo a partir do seu valor (strings como trecho, inteiros e caractere diretamente)
+static int _key_of(RegistryFieldsMask field, const char *data, int size, int int_value) {
+    switch (field) {
+        case MASK_IDNASCIMENTO:
+        case MASK_IDADEMAE: return _int_key(int_value);
+        case MASK_SEXOBEBE: return (unsigned char) int_value;
+        case MASK_DATANASCIMENTO: return _date_key(data, size);
+        default: return _string_key(data, size);
+    }
+}
+
+/**
+ *  Calcula a chave de um campo de um registro em memória
+ *  Parâmetros:
+ *      RegistryFieldsMask field -> campo indexado
+ *      RegistryView view -> visão do registro
+ *  Retorno:
+ *      int -> chave (não negativa)
+ */
+int b_tree_secondary_index_key_of_view(RegistryFieldsMask field, RegistryView view) {
+    RegistryStringSlice slice = {NULL, 0};
+    int int_value = 0;
+
+    switch (field) {
+        case MASK_CIDADEMAE: slice = registry_view_get_cidadeMae(view); break;
+        case MASK_CIDADEBEBE: slice = registry_view_get_cidadeBebe(view); break;
+        case MASK_IDNASCIMENTO: int_value = registry_view_get_idNascimento(view); break;
+        case MASK_IDADEMAE: int_value = registry_view_get_idadeMae(view); break;
+        case MASK_DATANASCIMENTO: slice = registry_view_get_dataNascimento(view); break;
+        case MASK_SEXOBEBE: int_value = registry_view_get_sexoBebe(view); break;
+        case MASK_ESTADOMAE: slice = registry_view_get_estadoMae(view); break;
+        case MASK_ESTADOBEBE: slice = registry_view_get_estadoBebe(view); break;
+        default: break;
+    }
+
+    return _key_of(field, slice.data, slice.size, int_value);
+}
+
+/**
+ *  Calcula a chave de um campo de um filtro (mesma chave que um registro com o mesmo valor teria)
+ *  Parâmetros:
+ *      RegistryFieldsMask field -> campo indexado
+ *      VirtualRegistryFilter *filter -> filtro com o valor do campo
+ *  Retorno:
+ *      int -> chave (não negativa)
+ */
+int b_tree_secondary_index_key_of_filter(RegistryFieldsMask field, VirtualRegistryFilter *filter) {
+    char *str = NULL;
+    int int_value = 0;
+
+    switch (field) {
+        case MASK_CIDADEMAE: str = filter->cidadeMae; break;
+        case MASK_CIDADEBEBE: str = filter->cidadeBebe; break;
+        case MASK_IDNASCIMENTO: int_value = filter->idNascimento; break;
+        case MASK_IDADEMAE: int_value = filter->idadeMae; break;
+        case MASK_DATANASCIMENTO: str = filter->dataNascimento; break;
+        case MASK_SEXOBEBE: int_value = filter->sexoBebe; break;
+        case MASK_ESTADOMAE: str = filter->estadoMae; break;
+        case MASK_ESTADOBEBE: str = filter->estadoBebe; break;
+        default: break;
+    }
+
+    return _key_of(field, str, (str != NULL) ? strlen(str) : 0, int_value);
+}
+
+
+/*
+    Funcao (privada) que escreve o header do arquivo de posting lists (primeiro bloco)
+    Parametros:
+        index -> o índice
+        status -> '0' (inconsistente) ou '1'
+        stamp -> próximo RRN e quantidades de registros, de removidos e de atualizados do arquivo de registros correspondente
+*/
+static void _write_postings_header(BTreeSecondaryIndex *index, char status, const int stamp[4]) {
+    char header[B_TREE_POSTINGS_BLOCK_SIZE];
+    memset(header, '$', sizeof(header));
+
+    header[0] = status;
+    memcpy(header + 1, POSTINGS_MAGIC, 4);
+    int fields[6] = {index->field, index->block_count, stamp[0], stamp[1], stamp[2], stamp[3]};
+    memcpy(header + 5, fields, sizeof(fields));
+
+    fseek(index->postings_file, 0, SEEK_SET);
+    fwrite(header, sizeof(header), 1, index->postings_file);
+}
+
+//Obtém o carimbo (próximo RRN e contadores) do header de um arquivo de registros
+static void _registry_stamp(RegistryHeader *reg_header, int stamp[4]) {
+    stamp[0] = reg_header_get_next_RRN(reg_header);
+    stamp[1] = reg_header_get_registries_count(reg_header);
+    stamp[2] = reg_header_get_removed_count(reg_header);
+    stamp[3] = reg_header_get_updated_count(reg_header);
+}
+
+static bool _read_block(BTreeSecondaryIndex *index, int block_id, _PostingBlock *block) {
+    if (block_id <= 0 || block_id >= index->block_count) return false;
+    fseek(index->postings_file, (long) block_id * B_TREE_POSTINGS_BLOCK_SIZE, SEEK_SET);
+    return fread(block, sizeof(_PostingBlock), 1, index->postings_file) == 1;
+}
+
+static void _write_block(BTreeSecondaryIndex *index, int block_id, _PostingBlock *block) {
+    fseek(index->postings_file, (long) block_id * B_TREE_POSTINGS_BLOCK_SIZE, SEEK_SET);
+    fwrite(block, sizeof(_PostingBlock), 1, index->postings_file);
+}
+
+//Contabiliza uma modificação, confirmando o grupo no log (com o header atualizado) quando ele estiver completo
+static void _end_operation(BTreeSecondaryIndex *index) {
+    static const int modifying_stamp[4] = {-1, -1, -1, -1};
+    if (!wal_end_operations(index->wal, 1)) return;
+
+    _write_postings_header(index, '0', modifying_stamp);
+    wal_commit(index->wal);
+}
+
+/*
+    Funcao (privada) que adiciona um RRN à posting list de uma chave (criando a lista, se a chave for nova).
+    O primeiro bloco da lista nunca muda, portanto a árvore-B só é alterada quando a chave é nova:
+    quando o primeiro bloco enche, seu conteúdo é movido para um bloco novo, encadeado logo após ele
+*/
+static void _add(BTreeSecondaryIndex *index, int key, int RRN) {
+    _PostingBlock head;
+    int head_id = b_tree_manager_search_for(index->tree, key).first;
+
+    if (head_id == -1 || !_read_block(index, head_id, &head)) {
+        head.next = -1;
+        head.count = 1;
+        head.RRNs[0] = RRN;
+        head_id = index->block_count++;
+        _write_block(index, head_id, &head);
+        b_tree_manager_insert(index->tree, key, head_id);
+        _end_operation(index);
+        return;
+    }
+
+    if (head.count == B_TREE_POSTINGS_BLOCK_RRNS) {
+        int moved_id = index->block_count++;
+        _write_block(index, moved_id, &head);
+        head.next = moved_id;
+        head.count = 0;
+    }
+
+    head.RRNs[head.count++] = RRN;
+    _write_block(index, head_id, &head);
+    _end_operation(index);
+}
+
+/*
+    Funcao (privada) que retira um RRN da posting list de uma chave. O último RRN do bloco ocupa o lugar do retirado.
+    Blocos que ficam vazios continuam na lista (e a chave continua na árvore-B)
+*/
+static void _remove(BTreeSecondaryIndex *index, int key, int RRN) {
+    _PostingBlock block;
+    int block_id = b_tree_manager_search_for(index->tree, key).first;
+
+    while (block_id != -1 && _read_block(index, block_id, &block)) {
+        for (int i = 0; i < block.count; i++) {
+            if (block.RRNs[i] != RRN) continue;
+
+            block.RRNs[i] = block.RRNs[--block.count];
+            _write_block(index, block_id, &block);
+            _end_operation(index);
+            return;
+        }
+        block_id = block.next;
+    }
+
+    DP("WARNING: RRN %d not found in the posting list of key %d @_remove()\n", RRN, key);
+}
+
+//Ordena RRNs em ordem crescente (qsort)
+static int _compare_ints(const void *a, const void *b) {
+    int i1 = *(const int *) a, i2 = *(const int *) b;
+    return (i1 > i2) - (i1 < i2);
+}
+
+/**
+ *  Busca os RRNs candidatos de uma chave: os registros cujo campo indexado tem a chave informada
+ *  (os candidatos devem ser comparados com o valor buscado, pois chaves de strings são prefixos).
+ *  Parâmetros:
+ *      BTreeSecondaryIndex *index -> índice aberto
+ *      int key -> chave (ver b_tree_secondary_index_key_of_filter())
+ *      int **RRNs_ptr -> onde será guardado o vetor de RRNs, em ordem crescente (deve ser liberado; NULL se não houver)
+ *      int *pages_ptr -> se não for NULL, recebe a quantidade de páginas da árvore-B e de blocos lidos
+ *  Retorno:
+ *      int -> quantidade de RRNs, ou -1 em caso de erro
+ */
+int b_tree_secondary_index_search(BTreeSecondaryIndex *index, int key, int **RRNs_ptr, int *pages_ptr) {
+    if (index == NULL || RRNs_ptr == NULL) {
+        DP("ERROR: invalid parameters @b_tree_secondary_index_search()\n");
+        return -1;
+    }
+
+    *RRNs_ptr = NULL;
+    pairIntInt found = b_tree_manager_search_for(index->tree, key);
+    int pages = found.second;
+
+    int count = 0, capacity = 0;
+    int block_id = found.first;
+    _PostingBlock block;
+    while (block_id != -1 && _read_block(index, block_id, &block)) {
+        pages++;
+
+        if (count + block.count > capacity) {
+            capacity = 2 * (count + block.count);
+            int *RRNs = realloc(*RRNs_ptr, capacity * sizeof(int));
+            if (RRNs == NULL) {
+                DP("ERROR: not enough memory @b_tree_secondary_index_search()\n");
+                free(*RRNs_ptr);
+                *RRNs_ptr = NULL;
+                return -1;
+            }
+            *RRNs_ptr = RRNs;
+        }
+
+        //O bloco inicial de uma chave continua na árvore mesmo depois que todos os seus RRNs são removidos
+        if (block.count > 0) memcpy(*RRNs_ptr + count, block.RRNs, block.count * sizeof(int));
+        count += block.count;
+        block_id = block.next;
+    }
+
+    //Em ordem de RRN, a leitura dos registros candidatos no arquivo de dados é sequencial
+    if (count > 1) qsort(*RRNs_ptr, count, sizeof(int), _compare_ints);
+
+    if (pages_ptr != NULL) *pages_ptr = pages;
+    return count;
+}
+
+
+/*
+    Funcao (privada) que fecha um índice, gravando no header o carimbo do arquivo de registros no estado atual
+    (modo MODIFY), e libera sua memória
+*/
+static void _close(BTreeSecondaryIndex **index_ptr, RegistryHeader *reg_header) {
+    BTreeSecondaryIndex *index = *index_ptr;
+    if (index == NULL) return;
+
+    if (index->mode == MODIFY && index->postings_file != NULL) {
+        int stamp[4];
+        _registry_stamp(reg_header, stamp);
+        _write_postings_header(index, '1', stamp);
+        wal_close(&index->wal);
+    }
+
+    if (index->postings_file != NULL) fclose(index->postings_file);
+    b_tree_manager_free(&index->tree);
+    free(index);
+    *index_ptr = NULL;
+}
+
+/*
+    Funcao (privada) que abre o índice secundário de um campo, se ele existir e corresponder ao estado atual
+    do arquivo de registros (o carimbo do header deve ser igual aos headers do arquivo de registros)
+    Parametros:
+        reg_filename -> nome do arquivo de registros
+        field -> campo indexado
+        mode -> READ ou MODIFY
+        reg_header -> header do arquivo de registros, já aberto
+        stale_ptr -> recebe true se o índice existe mas está desatualizado ou corrompido
+    Retorno:
+        BTreeSecondaryIndex* . o índice aberto, ou NULL se ele não existir ou estiver desatualizado
+*/
+static BTreeSecondaryIndex *_open(char *reg_filename, RegistryFieldsMask field, OPEN_MODE mode, RegistryHeader *reg_header, bool *stale_ptr) {
+    *stale_ptr = false;
+
+    char *postings_filename = _index_filename(reg_filename, field, B_TREE_POSTINGS_SUFFIX);
+    char *tree_filename = _index_filename(reg_filename, field, B_TREE_SECONDARY_INDEX_SUFFIX);
+    BTreeSecondaryIndex *index = calloc(1, sizeof(BTreeSecondaryIndex));
+    if (postings_filename == NULL || tree_filename == NULL || index == NULL) {
+        DP("ERROR: not enough memory @b_tree_secondary_index_open()\n");
+        free(postings_filename);
+        free(tree_filename);
+        free(index);
+        return NULL;
+    }
+
+    index->field = field;
+    index->mode = (mode == MODIFY) ? MODIFY : READ;
+
+    //Como nos demais arquivos, um log deixado por uma modificação interrompida é recuperado antes da abertura para
+    //modificação; na leitura, o índice com log (ou cuja recuperação falhou) é tratado como desatualizado
+    bool recovered = (index->mode == MODIFY) ? wal_recover(postings_filename, 0, '1') : !wal_exists(postings_filename);
+    if (recovered) index->postings_file = fopen(postings_filename, (index->mode == MODIFY) ? "rb+" : "rb");
+    else *stale_ptr = true;
+
+    //Valida o header: status, identificação, campo e carimbo do arquivo de registros
+    bool valid = false;
+    if (index->postings_file != NULL) {
+        char header[B_TREE_POSTINGS_BLOCK_SIZE];
+        int fields[6], stamp[4];
+        _registry_stamp(reg_header, stamp);
+
+        valid = fread(header, sizeof(header), 1, index->postings_file) == 1;
+        if (valid) memcpy(fields, header + 5, sizeof(fields));
+        valid = valid && header[0] == '1' && memcmp(header + 1, POSTINGS_MAGIC, 4) == 0 && fields[0] == (int) field
+            && memcmp(fields + 2, stamp, sizeof(stamp)) == 0;
+        if (valid) index->block_count = fields[1];
+
+        index->tree = b_tree_manager_create();
+        valid = valid && b_tree_manager_open(index->tree, tree_filename, index->mode) == OPEN_OK;
+        *stale_ptr = !valid;
+    }
+
+    if (valid && index->mode == MODIFY) {
+        //Até o fechamento, o carimbo fica inválido: se o processo for interrompido, o índice não corresponderá a nenhum arquivo
+        static const int modifying_stamp[4] = {-1, -1, -1, -1};
+        _write_postings_header(index, '0', modifying_stamp);
+        fflush(index->postings_file);
+        index->wal = wal_open(postings_filename, &index->postings_file);
+    }
+
+    free(postings_filename);
+    free(tree_filename);
+
+    if (!valid) {
+        index->mode = READ;
+        _close(&index, reg_header);
+        return NULL;
+    }
+
+    return index;
+}
+
+
+/**
+ *  Remove os arquivos do índice secundário de um campo (se existirem)
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      RegistryFieldsMask field -> campo indexado
+ *  Retorno: void
+ */
+void b_tree_secondary_index_drop(char *reg_filename, RegistryFieldsMask field) {
+    if (reg_filename == NULL || !b_tree_secondary_index_is_supported(field)) return;
+
+    char *suffixes[] = {B_TREE_POSTINGS_SUFFIX, B_TREE_SECONDARY_INDEX_SUFFIX};
+    for (int i = 0; i < 2; i++) {
+        char *filename = _index_filename(reg_filename, field, suffixes[i]);
+        if (filename == NULL) continue;
+
+        wal_discard(filename);
+        remove(filename);
+        free(filename);
+    }
+}
+
+/**
+ *  Remove os arquivos de todos os índices secundários de um arquivo de registros (por exemplo, quando ele é recriado)
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *  Retorno: void
+ */
+void b_tree_secondary_index_drop_all(char *reg_filename) {
+    RegistryFieldsMask fields = b_tree_secondary_index_list(reg_filename);
+    for (int i = 0; i < SECONDARY_INDEX_FIELDS; i++)
+        if (fields & (1 << i)) b_tree_secondary_index_drop(reg_filename, 1 << i);
+}
+
+/**
+ *  Obtém os campos que possuem índice secundário (arquivos existentes, sem verificar se estão atualizados)
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *  Retorno:
+ *      RegistryFieldsMask -> máscara com os campos indexados
+ */
+RegistryFieldsMask b_tree_secondary_index_list(char *reg_filename) {
+    RegistryFieldsMask fields = MASK_NONE;
+    if (reg_filename == NULL) return fields;
+
+    for (int i = 0; i < SECONDARY_INDEX_FIELDS; i++) {
+        RegistryFieldsMask field = 1 << i;
+        if (!b_tree_secondary_index_is_supported(field)) continue;
+
+        char *filename = _index_filename(reg_filename, field, B_TREE_POSTINGS_SUFFIX);
+        FILE *file = (filename != NULL) ? fopen(filename, "rb") : NULL;
+        if (file != NULL) {
+            fields |= field;
+            fclose(file);
+        }
+        free(filename);
+    }
+
+    return fields;
+}
+
+//Pares (chave, RRN) coletados na construção do índice
+typedef struct {
+    RegistryFieldsMask field;
+    pairIntInt *pairs;
+    int count;
+    int capacity;
+} _BuildContext;
+
+//Callback da varredura da construção: guarda o par (chave, RRN) de cada registro
+static void _collect_pair(RegistryManager *manager, RegistryView view, void *context) {
+    _BuildContext *build = context;
+    if (build->count == build->capacity) return;
+
+    build->pairs[build->count].first = b_tree_secondary_index_key_of_view(build->field, view);
+    build->pairs[build->count].second = view.RRN;
+    build->count++;
+}
+
+//Par (chave, RRN) usado na construção do índice
+static int _compare_pairs(const void *a, const void *b) {
+    const pairIntInt *p1 = a, *p2 = b;
+    if (p1->first != p2->first) return (p1->first < p2->first) ? -1 : 1;
+    return (p1->second > p2->second) - (p1->second < p2->second);
+}
+
+/**
+ *  Cria (ou recria) o índice secundário de um campo a partir de todos os registros do arquivo.
+ *  Os pares (chave, RRN) são ordenados em RAM; as posting lists são escritas em sequência e a árvore-B é
+ *  construída de baixo para cima (bulk load), com uma chave por valor distinto.
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      RegistryManager *registry_manager -> gerenciador com o arquivo de registros aberto (pode ser modo leitura)
+ *      RegistryFieldsMask field -> campo a ser indexado
+ *  Retorno:
+ *      bool -> indica se o índice foi criado
+ */
+bool b_tree_secondary_index_build(char *reg_filename, RegistryManager *registry_manager, RegistryFieldsMask field) {
+    if (reg_filename == NULL || registry_manager == NULL || !b_tree_secondary_index_is_supported(field)) {
+        DP("ERROR: invalid parameters @b_tree_secondary_index_build()\n");
+        return false;
+    }
+
+    b_tree_secondary_index_drop(reg_filename, field);
+
+    //Coleta os pares (chave, RRN) de todos os registros
+    RegistryHeader *reg_header = registry_manager_get_registry_header(registry_manager);
+    int pairs_count = 0, pairs_capacity = reg_header_get_registries_count(reg_header) + 1;
+    pairIntInt *pairs = malloc(pairs_capacity * sizeof(pairIntInt));
+    if (pairs == NULL) {
+        DP("ERROR: not enough memory @b_tree_secondary_index_build()\n");
+        return false;
+    }
+
+    _BuildContext build = {field, pairs, 0, pairs_capacity};
+    registry_manager_for_each_view_with_context(registry_manager, _collect_pair, &build);
+    pairs_count = build.count;
+    qsort(pairs, pairs_count, sizeof(pairIntInt), _compare_pairs);
+
+    char *postings_filename = _index_filename(reg_filename, field, B_TREE_POSTINGS_SUFFIX);
+    char *tree_filename = _index_filename(reg_filename, field, B_TREE_SECONDARY_INDEX_SUFFIX);
+    BTreeSecondaryIndex index = {field, CREATE, NULL, NULL, NULL, 1};
+    index.postings_file = (postings_filename != NULL) ? fopen(postings_filename, "wb") : NULL;
+    BTreeBulkLoader *loader = b_tree_bulk_loader_create(B_TREE_BULK_LOAD_RUN_CAPACITY);
+
+    bool success = index.postings_file != NULL && loader != NULL;
+    if (success) {
+        //O header é escrito como inconsistente até que a árvore-B também esteja pronta
+        int stamp[4];
+        _registry_stamp(reg_header, stamp);
+        _write_postings_header(&index, '0', stamp);
+
+        //Cada chave ocupa blocos consecutivos, encadeados em ordem
+        for (int first = 0; first < pairs_count; ) {
+            int last = first;
+            while (last < pairs_count && pairs[last].first == pairs[first].first) last++;
+
+            b_tree_bulk_loader_add(loader, pairs[first].first, index.block_count);
+            for (int i = first; i < last; i += B_TREE_POSTINGS_BLOCK_RRNS) {
+                _PostingBlock block;
+                block.count = (last - i < B_TREE_POSTINGS_BLOCK_RRNS) ? last - i : B_TREE_POSTINGS_BLOCK_RRNS;
+                block.next = (i + block.count < last) ? index.block_count + 1 : -1;
+                for (int j = 0; j < block.count; j++) block.RRNs[j] = pairs[i + j].second;
+                _write_block(&index, index.block_count++, &block);
+            }
+            first = last;
+        }
+
+        BTreeManager *tree = b_tree_manager_create();
+        success = tree != NULL && b_tree_manager_open(tree, tree_filename, CREATE) == OPEN_OK && b_tree_manager_bulk_load(tree, loader);
+        b_tree_manager_free(&tree);
+
+        if (success) _write_postings_header(&index, '1', stamp);
+    }
+
+    if (index.postings_file != NULL) success = (fclose(index.postings_file) == 0) && success;
+    b_tree_bulk_loader_free(&loader);
+    free(pairs);
+    free(postings_filename);
+    free(tree_filename);
+
+    if (!success) {
+        DP("ERROR: couldn't build secondary index @b_tree_secondary_index_build()\n");
+        b_tree_secondary_index_drop(reg_filename, field);
+    }
+    return success;
+}
+
+
+//Callback de modificações do RegistryManager: atualiza as chaves que mudaram em todos os índices do conjunto
+static void _on_registry_change(RegistryManager *manager, int RRN, RegistryView *old_view, RegistryView *new_view, void *context) {
+    BTreeSecondaryIndexSet *set = context;
+
+    for (int i = 0; i < SECONDARY_INDEX_FIELDS; i++) {
+        BTreeSecondaryIndex *index = set->indexes[i];
+        if (index == NULL) continue;
+
+        int old_key = (old_view != NULL) ? b_tree_secondary_index_key_of_view(index->field, *old_view) : -1;
+        int new_key = (new_view != NULL) ? b_tree_secondary_index_key_of_view(index->field, *new_view) : -1;
+        if (old_key == new_key) continue;
+
+        if (old_view != NULL) _remove(index, old_key, RRN);
+        if (new_view != NULL) _add(index, new_key, RRN);
+    }
+}
+
+/**
+ *  Abre todos os índices secundários de um arquivo de registros. Índices desatualizados (modificados por outro programa,
+ *  ou interrompidos no meio de uma modificação) são ignorados e, no modo MODIFY, removidos.
+ *  No modo MODIFY, o conjunto passa a receber as modificações do RegistryManager e a manter os índices atualizados.
+ *  OBS: o conjunto deve ser liberado antes do RegistryManager (b_tree_secondary_index_set_free())
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      RegistryManager *registry_manager -> gerenciador com o arquivo de registros aberto
+ *      OPEN_MODE mode -> READ, READ_MMAP ou MODIFY
+ *  Retorno:
+ *      BTreeSecondaryIndexSet* -> o conjunto (possivelmente vazio), ou NULL em caso de erro
+ */
+BTreeSecondaryIndexSet *b_tree_secondary_index_set_open(char *reg_filename, RegistryManager *registry_manager, OPEN_MODE mode) {
+    if (reg_filename == NULL || registry_manager == NULL || mode == CREATE) {
+        DP("ERROR: invalid parameters @b_tree_secondary_index_set_open()\n");
+        return NULL;
+    }
+
+    BTreeSecondaryIndexSet *set = calloc(1, sizeof(BTreeSecondaryIndexSet));
+    if (set == NULL) {
+        DP("ERROR: not enough memory @b_tree_secondary_index_set_open()\n");
+        return NULL;
+    }
+    set->registry_manager = registry_manager;
+
+    RegistryFieldsMask fields = b_tree_secondary_index_list(reg_filename);
+    RegistryHeader *reg_header = registry_manager_get_registry_header(registry_manager);
+    bool any = false;
+
+    for (int i = 0; i < SECONDARY_INDEX_FIELDS; i++) {
+        RegistryFieldsMask field = 1 << i;
+        if (!(fields & field)) continue;
+
+        bool stale;
+        set->indexes[i] = _open(reg_filename, field, mode, reg_header, &stale);
+        any = any || set->indexes[i] != NULL;
+
+        if (stale) {
+            DP("WARNING: ignoring stale secondary index on %s @b_tree_secondary_index_set_open()\n", _field_name(field));
+            if (mode == MODIFY) b_tree_secondary_index_drop(reg_filename, field);
+        }
+    }
+
+    if (mode == MODIFY && any) registry_manager_add_change_callback(registry_manager, _on_registry_change, set);
+    return set;
+}
+
+/**
+ *  Fecha todos os índices do conjunto e libera sua memória. No modo MODIFY, os índices são marcados como
+ *  correspondentes ao estado atual do arquivo de registros, portanto o conjunto deve ser liberado depois
+ *  da última modificação e antes do RegistryManager
+ *  Parâmetros:
+ *      BTreeSecondaryIndexSet **set_ptr -> referência ao conjunto
+ *  Retorno: void
+ */
+void b_tree_secondary_index_set_free(BTreeSecondaryIndexSet **set_ptr) {
+    if (set_ptr == NULL || *set_ptr == NULL) return;
+    BTreeSecondaryIndexSet *set = *set_ptr;
+
+    registry_manager_remove_change_callback(set->registry_manager, _on_registry_change, set);
+
+    RegistryHeader *reg_header = registry_manager_get_registry_header(set->registry_manager);
+    for (int i = 0; i < SECONDARY_INDEX_FIELDS; i++)
+        _close(&set->indexes[i], reg_header);
+
+    free(set);
+    *set_ptr = NULL;
+}
+
+/**
+ *  Obtém o índice secundário de um campo
+ *  Parâmetros:
+ *      BTreeSecondaryIndexSet *set -> conjunto aberto
+ *      RegistryFieldsMask field -> campo
+ *  Retorno:
+ *      BTreeSecondaryIndex* -> o índice, ou NULL se o campo não tiver índice (atualizado)
+ */
+BTreeSecondaryIndex *b_tree_secondary_index_set_get(BTreeSecondaryIndexSet *set, RegistryFieldsMask field) {
+    if (set == NULL || field == MASK_NONE || (field & (field - 1)) != 0 || field > MASK_ALL) return NULL;
+    return set->indexes[_field_position(field)];
+}
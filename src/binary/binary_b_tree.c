@@ -1,73 +1,544 @@
 #include "binary_b_tree.h"
 #include "binary_io.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "debug.h"
 
+//Lê o int de uma posição do buffer de uma página (no mesmo formato de binary_read_int)
+static int _page_int(const char *page, int index) {
+    int value;
+    memcpy(&value, page + index * sizeof(int), sizeof(int));
+    return value;
+}
+
+//Escreve um int em uma posição do buffer de uma página (no mesmo formato de binary_write_int)
+static void _set_page_int(char *page, int index, int value) {
+    memcpy(page + index * sizeof(int), &value, sizeof(int));
+}
 
 /*
-    Le um node de arvore-B no disco a partir da posicao atual do cursor
+    Le um node de arvore-B no disco a partir da posicao atual do cursor.
+    A pagina inteira e' lida de uma so vez e interpretada em memoria.
     Parametros:
         file_ptr -> o ponteiro do arquivo para ler
+        order -> a ordem dos nodes do arquivo
+        page_size -> o tamanho, em bytes, de cada pagina do arquivo (>= B_TREE_NODE_SIZE(order))
     Retorno:
         BTreeNode*. o node que foi lido
 */
-BTreeNode *binary_read_b_tree_node (FILE *file_ptr) {
-    if (file_ptr == NULL)
+BTreeNode *binary_read_b_tree_node (FILE *file_ptr, int order, int page_size) {
+    if (file_ptr == NULL || page_size < B_TREE_NODE_SIZE(order))
         return NULL;
 
-    int nivel = binary_read_int(file_ptr);
-    binary_read_int(file_ptr);
-    int C, Pr, P;
+    char *page = malloc(page_size);
+    if (page == NULL)
+        return NULL;
 
-    //cria o node
-    BTreeNode *node = b_tree_node_create(nivel);
+    if (fread(page, page_size, 1, file_ptr) != 1) {
+        free(page);
+        return NULL;
+    }
+
+    //cria o node (o N e' recalculado a medida que os itens sao inseridos)
+    BTreeNode *node = b_tree_node_create_with_order(_page_int(page, 0), order);
 
-    if (node == NULL)
+    if (node == NULL) {
+        free(page);
         return NULL;
+    }
 
-    //le os itens (C e Pr)
-    for (int i = 0; i < B_TREE_ORDER-1; i++) {
-        C = binary_read_int(file_ptr);
-        Pr = binary_read_int(file_ptr);
-        b_tree_node_sorted_insert_item(node, C, Pr);
+    //le os itens (C e Pr), que estao ordenados no disco
+    for (int i = 0; i < order-1; i++) {
+        int C = _page_int(page, 2 + 2*i);
+        if (C != -1) b_tree_node_set_item(node, C, _page_int(page, 3 + 2*i), i);
     }
 
     //le os P's
-    for (int i = 0; i < B_TREE_ORDER; i++) {
-        P = binary_read_int(file_ptr);
-        b_tree_node_set_P(node, P, i);
+    int P_start = 2 + 2*(order-1);
+    for (int i = 0; i < order; i++) {
+        b_tree_node_set_P(node, _page_int(page, P_start + i), i);
     }
 
+    free(page);
     return node;
 }
 
 /*
-    Escreve um node no disco na posicao atual do cursor
+    Escreve um node no disco na posicao atual do cursor.
+    A pagina e' montada em memoria (completando com lixo apos os campos do node) e escrita de uma so vez.
     Parametros:
         file_ptr -> o ponteiro do arquivo onde sera' escrito
         node -> o node que sera escrito
+        page_size -> o tamanho, em bytes, de cada pagina do arquivo (>= B_TREE_NODE_SIZE da ordem do node)
 */
-void binary_write_b_tree_node (FILE *file_ptr, BTreeNode *node) {
-    if (file_ptr == NULL || node == NULL) {
+void binary_write_b_tree_node (FILE *file_ptr, BTreeNode *node, int page_size) {
+    int order = b_tree_node_get_order(node);
+    if (file_ptr == NULL || node == NULL || page_size < B_TREE_NODE_SIZE(order)) {
         DP("ERROR: invalid parameters @binary_write_b_tree_node()");
         return;
     }
 
-    //escreve o nivel
-    binary_write_int(file_ptr, b_tree_node_get_nivel(node));
-    //escreve o N
-    binary_write_int(file_ptr, b_tree_node_get_n(node));
-    
+    char *page = malloc(page_size);
+    if (page == NULL) {
+        DP("ERROR: not enough memory for node page @binary_write_b_tree_node()\n");
+        return;
+    }
+
+    //escreve o nivel e o N
+    _set_page_int(page, 0, b_tree_node_get_nivel(node));
+    _set_page_int(page, 1, b_tree_node_get_n(node));
+
     //escreve os itens
-    for (int i = 0; i < B_TREE_ORDER-1; i++) {
-        binary_write_int(file_ptr, b_tree_node_get_C(node, i));
-        binary_write_int(file_ptr, b_tree_node_get_Pr(node, i));
+    for (int i = 0; i < order-1; i++) {
+        _set_page_int(page, 2 + 2*i, b_tree_node_get_C(node, i));
+        _set_page_int(page, 3 + 2*i, b_tree_node_get_Pr(node, i));
     }
 
     //escreve os P's
-    for (int i = 0; i < B_TREE_ORDER; i++) {
-        binary_write_int(file_ptr, b_tree_node_get_P(node, i));      
+    int P_start = 2 + 2*(order-1);
+    for (int i = 0; i < order; i++) {
+        _set_page_int(page, P_start + i, b_tree_node_get_P(node, i));
     }
 
+    //completa a pagina com lixo
+    int node_size = B_TREE_NODE_SIZE(order);
+    memset(page + node_size, GARBAGE_CHAR, page_size - node_size);
+
+    fwrite(page, page_size, 1, file_ptr);
+    free(page);
+
     return;
-}   
\ No newline at end of file
+}
+
+/*
+    Le um node de arvore-B+ no disco a partir da posicao atual do cursor.
+    As folhas (nivel 1) guardam nivel, n, a folha anterior, a proxima folha e (order-1) pares (C, Pr); em RAM, a folha
+    anterior e a proxima ficam em P[0] e P[1]. Os demais nós guardam nivel, n, (order-1) chaves C e order P's (sem Pr).
+    Parametros:
+        file_ptr -> o ponteiro do arquivo para ler
+        order -> a ordem dos nodes do arquivo
+        page_size -> o tamanho, em bytes, de cada pagina do arquivo (>= B_PLUS_TREE_NODE_SIZE(order))
+    Retorno:
+        BTreeNode*. o node que foi lido
+*/
+BTreeNode *binary_read_b_plus_tree_node (FILE *file_ptr, int order, int page_size) {
+    if (file_ptr == NULL || page_size < B_PLUS_TREE_NODE_SIZE(order))
+        return NULL;
+
+    char *page = malloc(page_size);
+    if (page == NULL)
+        return NULL;
+
+    if (fread(page, page_size, 1, file_ptr) != 1) {
+        free(page);
+        return NULL;
+    }
+
+    int nivel = _page_int(page, 0), n = _page_int(page, 1);
+    BTreeNode *node = b_tree_node_create_with_order(nivel, order);
+
+    if (node == NULL || n < 0 || n > order-1) {
+        b_tree_node_free(node);
+        free(page);
+        return NULL;
+    }
+
+    if (nivel == 1) {
+        //folha: ligacoes com as vizinhas e os itens
+        b_tree_node_set_P(node, _page_int(page, 2), 0);
+        b_tree_node_set_P(node, _page_int(page, 3), 1);
+        for (int i = 0; i < n; i++)
+            b_tree_node_set_item(node, _page_int(page, 4 + 2*i), _page_int(page, 5 + 2*i), i);
+    } else {
+        //nó interno (ou página livre): apenas chaves e P's
+        for (int i = 0; i < n; i++)
+            b_tree_node_set_item(node, _page_int(page, 2 + i), -1, i);
+        for (int i = 0; i < order; i++)
+            b_tree_node_set_P(node, _page_int(page, 2 + (order-1) + i), i);
+    }
+
+    free(page);
+    return node;
+}
+
+/*
+    Escreve um node de arvore-B+ no disco na posicao atual do cursor (no formato descrito em binary_read_b_plus_tree_node()).
+    Parametros:
+        file_ptr -> o ponteiro do arquivo onde sera' escrito
+        node -> o node que sera escrito
+        page_size -> o tamanho, em bytes, de cada pagina do arquivo (>= B_PLUS_TREE_NODE_SIZE da ordem do node)
+*/
+void binary_write_b_plus_tree_node (FILE *file_ptr, BTreeNode *node, int page_size) {
+    int order = b_tree_node_get_order(node);
+    if (file_ptr == NULL || node == NULL || page_size < B_PLUS_TREE_NODE_SIZE(order)) {
+        DP("ERROR: invalid parameters @binary_write_b_plus_tree_node()");
+        return;
+    }
+
+    char *page = malloc(page_size);
+    if (page == NULL) {
+        DP("ERROR: not enough memory for node page @binary_write_b_plus_tree_node()\n");
+        return;
+    }
+
+    //escreve o nivel e o N
+    _set_page_int(page, 0, b_tree_node_get_nivel(node));
+    _set_page_int(page, 1, b_tree_node_get_n(node));
+
+    int node_size;
+    if (b_tree_node_get_nivel(node) == 1) {
+        _set_page_int(page, 2, b_tree_node_get_P(node, 0));
+        _set_page_int(page, 3, b_tree_node_get_P(node, 1));
+        for (int i = 0; i < order-1; i++) {
+            _set_page_int(page, 4 + 2*i, b_tree_node_get_C(node, i));
+            _set_page_int(page, 5 + 2*i, b_tree_node_get_Pr(node, i));
+        }
+        node_size = (4 + 2*(order-1)) * sizeof(int);
+    } else {
+        for (int i = 0; i < order-1; i++)
+            _set_page_int(page, 2 + i, b_tree_node_get_C(node, i));
+        for (int i = 0; i < order; i++)
+            _set_page_int(page, 2 + (order-1) + i, b_tree_node_get_P(node, i));
+        node_size = (2 + (order-1) + order) * sizeof(int);
+    }
+
+    //completa a pagina com lixo
+    memset(page + node_size, GARBAGE_CHAR, page_size - node_size);
+
+    fwrite(page, page_size, 1, file_ptr);
+    free(page);
+}
+
+/*
+    Paginas compactadas da arvore-B+ (B_TREE_FORMAT_PLUS_PACKED). As chaves de um node estao em ordem, e os RRNs de um
+    mesmo node costumam ser proximos, entao cada sequencia e' guardada por referencia (frame of reference): a menor chave
+    (ou o menor RRN) vai no cabecalho e cada item guarda apenas a diferenca para ela, com a quantidade de bits da maior
+    diferenca. Os campos de tamanho fixo permitem ler o i-esimo item direto da pagina, sem descompactar as demais.
+    Folha:      nivel, n, folha anterior, proxima folha, chave base, valor base (ints), bits da chave, bits do valor (bytes),
+                n chaves e n valores (Pr) em bits
+    Nó interno: nivel, n, chave base, filho base (ints), bits da chave, bits do filho (bytes), n chaves e n+1 filhos em bits
+    Os bits de cada campo sao guardados do menos significativo ao mais significativo, em sequencia.
+*/
+
+//Visão de uma pagina compactada: o cabecalho ja interpretado e o inicio dos campos em bits
+typedef struct {
+    int nivel, n;
+    int key_base, key_bits;
+    int ptr_base, ptr_bits;     //valores (Pr) nas folhas, filhos (P) nos nós internos
+    const unsigned char *data;
+} _packed_page;
+
+//Quantidade de bits necessaria para guardar um valor sem sinal
+static int _bit_width(unsigned int value) {
+    int bits = 0;
+    while (value != 0) {
+        bits++;
+        value >>= 1;
+    }
+    return bits;
+}
+
+//Lê um campo de 'bits' bits (no maximo 32) que comeca em um dado bit de uma sequencia
+static unsigned int _get_bits(const unsigned char *data, long bit_offset, int bits) {
+    if (bits == 0) return 0;
+
+    const unsigned char *byte = data + (bit_offset >> 3);
+    int shift = bit_offset & 7;
+    int bytes = (shift + bits + 7) >> 3;
+
+    unsigned long long word = 0;
+    for (int i = 0; i < bytes; i++)
+        word |= (unsigned long long) byte[i] << (8*i);
+
+    return (unsigned int) ((word >> shift) & ((1ULL << bits) - 1));
+}
+
+//Escreve um campo de 'bits' bits em um dado bit de uma sequencia (os bits do campo devem estar zerados)
+static void _put_bits(unsigned char *data, long bit_offset, int bits, unsigned int value) {
+    if (bits == 0) return;
+
+    unsigned char *byte = data + (bit_offset >> 3);
+    int shift = bit_offset & 7;
+    int bytes = (shift + bits + 7) >> 3;
+
+    unsigned long long word = (unsigned long long) value << shift;
+    for (int i = 0; i < bytes; i++)
+        byte[i] |= (unsigned char) (word >> (8*i));
+}
+
+//Interpreta o cabecalho de uma pagina compactada
+static void _packed_page_open(const char *page, _packed_page *packed) {
+    packed->nivel = _page_int(page, 0);
+    packed->n = _page_int(page, 1);
+
+    int header_ints = (packed->nivel == 1) ? 6 : 4;
+    packed->key_base = _page_int(page, header_ints - 2);
+    packed->ptr_base = _page_int(page, header_ints - 1);
+    packed->key_bits = (unsigned char) page[header_ints * sizeof(int)];
+    packed->ptr_bits = (unsigned char) page[header_ints * sizeof(int) + 1];
+    packed->data = (const unsigned char *) page + header_ints * sizeof(int) + 2;
+}
+
+static int _packed_key(const _packed_page *packed, int position) {
+    return packed->key_base + (int) _get_bits(packed->data, (long) position * packed->key_bits, packed->key_bits);
+}
+
+static int _packed_ptr(const _packed_page *packed, int position) {
+    long start = (long) packed->n * packed->key_bits;
+    return packed->ptr_base + (int) _get_bits(packed->data, start + (long) position * packed->ptr_bits, packed->ptr_bits);
+}
+
+/*
+    Tamanho, em bytes, de uma folha compactada
+    Parametros:
+        n -> quantidade de itens
+        key_span -> diferenca entre a maior e a menor chave
+        value_span -> diferenca entre o maior e o menor valor (Pr)
+*/
+int binary_packed_leaf_size (int n, unsigned int key_span, unsigned int value_span) {
+    long bits = (long) n * (_bit_width(key_span) + _bit_width(value_span));
+    return B_PLUS_TREE_PACKED_LEAF_HEADER_SIZE + (int) ((bits + 7) / 8);
+}
+
+/*
+    Tamanho, em bytes, de um nó interno compactado
+    Parametros:
+        n -> quantidade de chaves (o nó tem n+1 filhos)
+        key_span -> diferenca entre a maior e a menor chave
+        child_span -> diferenca entre o maior e o menor RRN dos filhos
+*/
+int binary_packed_internal_size (int n, unsigned int key_span, unsigned int child_span) {
+    long bits = (long) n * _bit_width(key_span) + (long) (n+1) * _bit_width(child_span);
+    return B_PLUS_TREE_PACKED_INTERNAL_HEADER_SIZE + (int) ((bits + 7) / 8);
+}
+
+//Menor e maior valor de uma sequencia de ints (vazia: 0 e 0)
+static void _min_max(const int *values, int count, int *min_ptr, int *max_ptr) {
+    *min_ptr = *max_ptr = (count > 0) ? values[0] : 0;
+    for (int i = 1; i < count; i++) {
+        if (values[i] < *min_ptr) *min_ptr = values[i];
+        if (values[i] > *max_ptr) *max_ptr = values[i];
+    }
+}
+
+/*
+    Separa as chaves e os ponteiros (Pr das folhas, P dos nós internos) de um node em vetores,
+    obtendo as bases e as larguras em bits da compactacao
+*/
+static int _packed_fields(BTreeNode *node, int *keys, int *ptrs, int *key_base, int *key_bits, int *ptr_base, int *ptr_bits) {
+    int n = b_tree_node_get_n(node);
+    bool leaf = b_tree_node_get_nivel(node) == 1;
+    int ptr_count = leaf ? n : n+1;
+
+    for (int i = 0; i < n; i++) {
+        keys[i] = b_tree_node_get_C(node, i);
+        if (leaf) ptrs[i] = b_tree_node_get_Pr(node, i);
+    }
+    if (!leaf)
+        for (int i = 0; i < ptr_count; i++) ptrs[i] = b_tree_node_get_P(node, i);
+
+    int key_max, ptr_max;
+    _min_max(keys, n, key_base, &key_max);
+    _min_max(ptrs, ptr_count, ptr_base, &ptr_max);
+    *key_bits = _bit_width((unsigned int) key_max - (unsigned int) *key_base);
+    *ptr_bits = _bit_width((unsigned int) ptr_max - (unsigned int) *ptr_base);
+    return ptr_count;
+}
+
+/*
+    Tamanho, em bytes, que um node de arvore-B+ ocupa compactado (para decidir se ele ainda cabe na pagina)
+    Parametros:
+        node -> o node
+    Retorno:
+        int. o tamanho, ou -1 se o node for invalido
+*/
+int binary_packed_b_plus_tree_node_size (BTreeNode *node) {
+    if (node == NULL) return -1;
+
+    int order = b_tree_node_get_order(node);
+    int *keys = malloc(order * sizeof(int)), *ptrs = malloc((order+1) * sizeof(int));
+    if (keys == NULL || ptrs == NULL) {
+        free(keys);
+        free(ptrs);
+        return -1;
+    }
+
+    int key_base, key_bits, ptr_base, ptr_bits;
+    int ptr_count = _packed_fields(node, keys, ptrs, &key_base, &key_bits, &ptr_base, &ptr_bits);
+    int n = b_tree_node_get_n(node);
+    bool leaf = b_tree_node_get_nivel(node) == 1;
+    free(keys);
+    free(ptrs);
+
+    long bits = (long) n * key_bits + (long) ptr_count * ptr_bits;
+    int header_size = leaf ? B_PLUS_TREE_PACKED_LEAF_HEADER_SIZE : B_PLUS_TREE_PACKED_INTERNAL_HEADER_SIZE;
+    return header_size + (int) ((bits + 7) / 8);
+}
+
+/*
+    Le um node de arvore-B+ compactado no disco a partir da posicao atual do cursor (formato descrito acima)
+    Parametros:
+        file_ptr -> o ponteiro do arquivo para ler
+        order -> a ordem dos nodes do arquivo
+        page_size -> o tamanho, em bytes, de cada pagina do arquivo (>= B_PLUS_TREE_PACKED_NODE_SIZE(order))
+    Retorno:
+        BTreeNode*. o node que foi lido
+*/
+BTreeNode *binary_read_packed_b_plus_tree_node (FILE *file_ptr, int order, int page_size) {
+    if (file_ptr == NULL || page_size < B_PLUS_TREE_PACKED_NODE_SIZE(order))
+        return NULL;
+
+    char *page = malloc(page_size);
+    if (page == NULL)
+        return NULL;
+
+    if (fread(page, page_size, 1, file_ptr) != 1) {
+        free(page);
+        return NULL;
+    }
+
+    _packed_page packed;
+    _packed_page_open(page, &packed);
+    BTreeNode *node = b_tree_node_create_with_order(packed.nivel, order);
+
+    if (node == NULL || packed.n < 0 || packed.n > order-1 || packed.key_bits > 32 || packed.ptr_bits > 32) {
+        b_tree_node_free(node);
+        free(page);
+        return NULL;
+    }
+
+    bool leaf = packed.nivel == 1;
+    if (leaf) {
+        b_tree_node_set_P(node, _page_int(page, 2), 0);
+        b_tree_node_set_P(node, _page_int(page, 3), 1);
+    }
+
+    for (int i = 0; i < packed.n; i++)
+        b_tree_node_set_item(node, _packed_key(&packed, i), leaf ? _packed_ptr(&packed, i) : -1, i);
+    if (!leaf)
+        for (int i = 0; i <= packed.n; i++) b_tree_node_set_P(node, _packed_ptr(&packed, i), i);
+
+    free(page);
+    return node;
+}
+
+/*
+    Escreve um node de arvore-B+ compactado no disco na posicao atual do cursor (formato descrito acima).
+    O node deve caber na pagina (ver binary_packed_b_plus_tree_node_size())
+    Parametros:
+        file_ptr -> o ponteiro do arquivo onde sera' escrito
+        node -> o node que sera escrito
+        page_size -> o tamanho, em bytes, de cada pagina do arquivo
+*/
+void binary_write_packed_b_plus_tree_node (FILE *file_ptr, BTreeNode *node, int page_size) {
+    int order = b_tree_node_get_order(node);
+    if (file_ptr == NULL || node == NULL || page_size < B_PLUS_TREE_PACKED_NODE_SIZE(order)) {
+        DP("ERROR: invalid parameters @binary_write_packed_b_plus_tree_node()");
+        return;
+    }
+
+    char *page = calloc(page_size, 1);
+    int *keys = malloc(order * sizeof(int)), *ptrs = malloc((order+1) * sizeof(int));
+    if (page == NULL || keys == NULL || ptrs == NULL) {
+        DP("ERROR: not enough memory for node page @binary_write_packed_b_plus_tree_node()\n");
+        free(page);
+        free(keys);
+        free(ptrs);
+        return;
+    }
+
+    int n = b_tree_node_get_n(node);
+    bool leaf = b_tree_node_get_nivel(node) == 1;
+    int key_base, key_bits, ptr_base, ptr_bits;
+    int ptr_count = _packed_fields(node, keys, ptrs, &key_base, &key_bits, &ptr_base, &ptr_bits);
+
+    //cabecalho da pagina
+    int header_ints = leaf ? 6 : 4;
+    _set_page_int(page, 0, b_tree_node_get_nivel(node));
+    _set_page_int(page, 1, n);
+    if (leaf) {
+        _set_page_int(page, 2, b_tree_node_get_P(node, 0));
+        _set_page_int(page, 3, b_tree_node_get_P(node, 1));
+    }
+    _set_page_int(page, header_ints - 2, key_base);
+    _set_page_int(page, header_ints - 1, ptr_base);
+    page[header_ints * sizeof(int)] = (char) key_bits;
+    page[header_ints * sizeof(int) + 1] = (char) ptr_bits;
+
+    int header_size = header_ints * sizeof(int) + 2;
+    long bits = (long) n * key_bits + (long) ptr_count * ptr_bits;
+    int node_size = header_size + (int) ((bits + 7) / 8);
+    if (node_size > page_size) {
+        DP("ERROR: node does not fit in the page @binary_write_packed_b_plus_tree_node()\n");
+        free(page);
+        free(keys);
+        free(ptrs);
+        return;
+    }
+
+    //diferencas para as bases, em sequencia: primeiro as chaves, depois os ponteiros
+    unsigned char *data = (unsigned char *) page + header_size;
+    for (int i = 0; i < n; i++)
+        _put_bits(data, (long) i * key_bits, key_bits, (unsigned int) keys[i] - (unsigned int) key_base);
+    for (int i = 0; i < ptr_count; i++)
+        _put_bits(data, (long) n * key_bits + (long) i * ptr_bits, ptr_bits, (unsigned int) ptrs[i] - (unsigned int) ptr_base);
+
+    //completa a pagina com lixo
+    memset(page + node_size, GARBAGE_CHAR, page_size - node_size);
+
+    fwrite(page, page_size, 1, file_ptr);
+    free(page);
+    free(keys);
+    free(ptrs);
+}
+
+/*
+    Busca uma chave direto em uma pagina compactada (lida do disco), sem descompactar o node: a busca binaria
+    compara a diferenca da chave para a base com os campos de cada item.
+    Parametros:
+        page -> a pagina compactada
+        key -> a chave buscada
+        found -> se nao for NULL, indica se a chave foi encontrada
+    Retorno:
+        int. a posicao da primeira chave maior ou igual a buscada (n se todas forem menores)
+*/
+int binary_packed_page_search (const char *page, int key, bool *found) {
+    _packed_page packed;
+    _packed_page_open(page, &packed);
+
+    int low = 0, high = packed.n;
+    if (key >= packed.key_base) {
+        unsigned int delta = (unsigned int) key - (unsigned int) packed.key_base;
+        while (low < high) {
+            int middle = (low + high) / 2;
+            if (_get_bits(packed.data, (long) middle * packed.key_bits, packed.key_bits) < delta) low = middle + 1;
+            else high = middle;
+        }
+    } else {
+        high = 0;
+    }
+
+    if (found != NULL) *found = low < packed.n && _packed_key(&packed, low) == key;
+    return low;
+}
+
+//Nivel do node guardado em uma pagina compactada
+int binary_packed_page_get_nivel (const char *page) {
+    return _page_int(page, 0);
+}
+
+/*
+    Obtém, de uma pagina compactada, o ponteiro de uma posicao: o valor (Pr) do item, nas folhas, ou o filho (P), nos nós internos
+    Retorno:
+        int. o ponteiro, ou -1 se a posicao nao existir
+*/
+int binary_packed_page_get_pointer (const char *page, int position) {
+    _packed_page packed;
+    _packed_page_open(page, &packed);
+
+    int ptr_count = (packed.nivel == 1) ? packed.n : packed.n+1;
+    if (position < 0 || position >= ptr_count) return -1;
+    return _packed_ptr(&packed, position);
+}
@@ -8,7 +8,6 @@
 #include "debug.h"
 
 #define INF 1e9+5
-#define GARBAGE_CHAR '$'
 
 
 /**
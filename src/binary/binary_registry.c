@@ -87,11 +87,11 @@ bool binary_update_registry(FILE *file, VirtualRegistryUpdater *updated_reg) {
 
     /*
         Verifica se a atualização ocupou todo o espaço dos campos variáveis ou se sobrou lixo anterior.
-        Em caso de ter ocupado, fseek não é necessário para o primeiro campo estático.
+        Em caso de ter ocupado (e de cidadeBebe ter sido escrita), fseek não é necessário para o primeiro campo estático.
         Se nãp tiver sido totalmente ocupado, é necessário realizar um fseek para o primeiro registro estático, 
         uma vez que o cursor ainda não o atingiu.
     */
-    bool shouldFseekForFirstStatic = cidadeBebeNewSize + cidadeMaeNewSize == REG_VARIABLE_FIELDS_TOTAL_SIZE;
+    bool variableFieldsFilled = offsets[2] + cidadeMaeNewSize + cidadeBebeNewSize == REG_VARIABLE_FIELDS_TOTAL_SIZE;
 
     //Código otimizado para o uso mínimo de fseeks, usando máscara de bits para decidir quais campos precisam ser atualizados
     /*
@@ -137,7 +137,7 @@ bool binary_update_registry(FILE *file, VirtualRegistryUpdater *updated_reg) {
     else shouldFseek = true;
 
     if ((updated_reg->fieldMask & MASK_IDNASCIMENTO) && old_reg->idNascimento != updated_reg->idNascimento) {
-        if (shouldFseekForFirstStatic) fseek(file, registry_seek_start + offsets[4], SEEK_SET);
+        if (shouldFseek || !variableFieldsFilled) fseek(file, registry_seek_start + offsets[4], SEEK_SET);
         binary_write_int(file, updated_reg->idNascimento);
         shouldFseek = false;
     }
@@ -189,11 +189,13 @@ bool binary_update_registry(FILE *file, VirtualRegistryUpdater *updated_reg) {
 
 /**
  *  Função de baixo nível que escreve um registro no disco
+ *  A imagem completa do registro (com o lixo) é montada em memória e escrita de uma só vez.
  *  OBS: o cursor deve estar posicionado corretamente antes de chamar esta função
  *  Parâmetros:
  *      FILE *file -> stream do arquivo binário com modo que permita escrita
  *      VirtualRegistry *reg_data -> registro a ser escrito
- *  Retorno: void
+ *  Retorno: 
+ *      bool -> indica se o registro inteiro foi escrito
  */
 bool binary_write_registry(FILE *file, VirtualRegistry *reg_data) {
     if (file == NULL || reg_data == NULL) {
@@ -201,78 +203,254 @@ bool binary_write_registry(FILE *file, VirtualRegistry *reg_data) {
         return false;
     }
 
-    int cidadeMae_size, cidadeBebe_size;
-    char *garbage_str;
+    char slot[REGISTRY_SIZE];
+    binary_encode_registry(slot, reg_data);
+
+    return fwrite(slot, REGISTRY_SIZE, 1, file) == 1;
+}
+
+/**
+ *  Versão vetorizada de binary_write_registry(): escreve registros consecutivos no disco, montando as imagens
+ *  em um buffer de BINARY_WRITE_REGISTRIES_BATCH registros e fazendo uma única escrita por lote.
+ *  OBS: o cursor deve estar posicionado corretamente antes de chamar esta função
+ *  Parâmetros:
+ *      FILE *file -> stream do arquivo binário com modo que permita escrita
+ *      VirtualRegistry **reg_arr -> vetor de registros a serem escritos, na ordem
+ *      int count -> quantidade de registros
+ *  Retorno: 
+ *      bool -> indica se todos os registros foram escritos
+ */
+bool binary_write_registries(FILE *file, VirtualRegistry **reg_arr, int count) {
+    if (file == NULL || (reg_arr == NULL && count > 0) || count < 0) {
+        DP("ERROR: invalid parameters @binary_write_registries()\n");
+        return false;
+    }
+
+    char batch[BINARY_WRITE_REGISTRIES_BATCH * REGISTRY_SIZE];
+
+    for (int written = 0; written < count; ) {
+        int batch_count = count - written;
+        if (batch_count > BINARY_WRITE_REGISTRIES_BATCH) batch_count = BINARY_WRITE_REGISTRIES_BATCH;
+
+        for (int i = 0; i < batch_count; i++) {
+            if (reg_arr[written + i] == NULL) {
+                DP("ERROR: NULL registry in array @binary_write_registries()\n");
+                return false;
+            }
+            binary_encode_registry(batch + i * REGISTRY_SIZE, reg_arr[written + i]);
+        }
+
+        if (fwrite(batch, REGISTRY_SIZE, batch_count, file) != (size_t) batch_count)
+            return false;
+
+        written += batch_count;
+    }
+
+    return true;
+}
 
-    cidadeMae_size = strlen(reg_data->cidadeMae);
-    cidadeBebe_size = strlen(reg_data->cidadeBebe);
-    garbage_str = generate_garbage(calculate_variable_fields_garbage(cidadeMae_size+cidadeBebe_size));
+
+//Escreve um int em uma posição do registro em memória (mesma representação usada por binary_write_int)
+static void _set_slot_int(char *slot, int offset, int num) {
+    memcpy(slot + offset, &num, sizeof(int));
+}
+
+/*
+    Escreve um campo de tamanho fixo no registro em memória, no mesmo formato de static_value_fill_with_garbage():
+    o valor (truncado, se necessário) completado com lixo ou, se vazio (ou nulo), '\0' seguido de lixo
+*/
+static void _set_slot_fixed_string(char *slot, int offset, int width, const char *value) {
+    int size = (value == NULL) ? 0 : strnlen(value, width);
+
+    memcpy(slot + offset, value, size);
+    memset(slot + offset + size, GARBAGE_CHAR, width - size);
+    if (size == 0) slot[offset] = '\0';
+}
+
+/**
+ *  Monta em memória a imagem completa (REGISTRY_SIZE bytes) de um registro, exatamente como ela seria escrita no disco
+ *  após registry_prepare_for_write() e binary_write_registry(), mas sem alterar o registro nem alocar memória.
+ *  Valores inválidos são trocados pelos valores padrão e cidades que não cabem no espaço dos campos variáveis são truncadas.
+ *  Parâmetros:
+ *      char *slot -> destino com, no mínimo, REGISTRY_SIZE bytes
+ *      VirtualRegistry *reg_data -> registro a ser codificado (campos de texto nulos são tratados como vazios)
+ *  Retorno: void
+ */
+void binary_encode_registry(char *slot, VirtualRegistry *reg_data) {
+    int max_size = REG_VARIABLE_FIELDS_TOTAL_SIZE - SLOT_VARIABLE_FIELDS_OFFSET;
 
     //Campos variáveis com tamanho
-    binary_write_int(file, cidadeMae_size);
-    binary_write_int(file, cidadeBebe_size);
-    binary_write_string(file, reg_data->cidadeMae, cidadeMae_size);
-    binary_write_string(file, reg_data->cidadeBebe, cidadeBebe_size);
+    int cidadeMae_size = (reg_data->cidadeMae == NULL) ? 0 : strnlen(reg_data->cidadeMae, max_size);
+    int cidadeBebe_size = (reg_data->cidadeBebe == NULL) ? 0 : strnlen(reg_data->cidadeBebe, max_size - cidadeMae_size);
+
+    _set_slot_int(slot, SLOT_CIDADEMAE_SIZE_OFFSET, cidadeMae_size);
+    _set_slot_int(slot, SLOT_CIDADEBEBE_SIZE_OFFSET, cidadeBebe_size);
+    memcpy(slot + SLOT_VARIABLE_FIELDS_OFFSET, reg_data->cidadeMae, cidadeMae_size);
+    memcpy(slot + SLOT_VARIABLE_FIELDS_OFFSET + cidadeMae_size, reg_data->cidadeBebe, cidadeBebe_size);
 
     //Lixo
-    binary_write_string(file, garbage_str, (int) strlen(garbage_str));
-    free(garbage_str);
-    
+    int used = SLOT_VARIABLE_FIELDS_OFFSET + cidadeMae_size + cidadeBebe_size;
+    memset(slot + used, GARBAGE_CHAR, REG_VARIABLE_FIELDS_TOTAL_SIZE - used);
+
     //Campos estáticos
-    binary_write_int(file, reg_data->idNascimento);
-    binary_write_int(file, reg_data->idadeMae);
-    binary_write_string(file, reg_data->dataNascimento, 10);
-    binary_write_char(file, reg_data->sexoBebe);
-    binary_write_string(file, reg_data->estadoMae, 2);
-    binary_write_string(file, reg_data->estadoBebe, 2);
+    _set_slot_int(slot, SLOT_IDNASCIMENTO_OFFSET, (reg_data->idNascimento < -1) ? -1 : reg_data->idNascimento);
+    _set_slot_int(slot, SLOT_IDADEMAE_OFFSET, (reg_data->idadeMae <= 0) ? -1 : reg_data->idadeMae);
+    _set_slot_fixed_string(slot, SLOT_DATANASCIMENTO_OFFSET, 10, reg_data->dataNascimento);
+    slot[SLOT_SEXOBEBE_OFFSET] = (reg_data->sexoBebe < '0' || reg_data->sexoBebe > '2') ? '0' : reg_data->sexoBebe;
+    _set_slot_fixed_string(slot, SLOT_ESTADOMAE_OFFSET, 2, reg_data->estadoMae);
+    _set_slot_fixed_string(slot, SLOT_ESTADOBEBE_OFFSET, 2, reg_data->estadoBebe);
+}
 
-    return true;
+//Lê um int de uma posição do registro em memória (mesma representação usada por binary_write_int)
+static int _slot_int(const char *slot, int offset) {
+    int num;
+    memcpy(&num, slot + offset, sizeof(int));
+    return num;
+}
+
+/*
+    Obtém o tamanho das cidades de um registro em memória, corrigindo valores corrompidos
+    para que a leitura nunca ultrapasse o espaço dos campos variáveis
+*/
+void binary_slot_cities_sizes(const char *slot, int *cidadeMae_size, int *cidadeBebe_size) {
+    int max_size = REG_VARIABLE_FIELDS_TOTAL_SIZE - SLOT_VARIABLE_FIELDS_OFFSET;
+
+    *cidadeMae_size = _slot_int(slot, SLOT_CIDADEMAE_SIZE_OFFSET);
+    *cidadeBebe_size = _slot_int(slot, SLOT_CIDADEBEBE_SIZE_OFFSET);
+
+    if (*cidadeMae_size < 0 || *cidadeMae_size > max_size) *cidadeMae_size = 0;
+    if (*cidadeBebe_size < 0 || *cidadeBebe_size > max_size - *cidadeMae_size) *cidadeBebe_size = 0;
 }
 
+//Copia uma string de tamanho fixo do registro em memória para um novo char* (com '\0' ao fim)
+static char *_slot_string(const char *slot, int offset, int size) {
+    char *str = malloc(sizeof(char) * (size + 1));
+    if (str == NULL) return NULL;
+
+    memcpy(str, slot + offset, size);
+    str[size] = '\0';
+    return str;
+}
+
+//Copia uma string de tamanho fixo do registro em memória para um char* já alocado com, no mínimo, size+1 chars
+static void _slot_string_into(const char *slot, int offset, int size, char *dest) {
+    memcpy(dest, slot + offset, size);
+    dest[size] = '\0';
+}
 
 /**
- *  Função de baixo nível que lê um registro do disco
+ *  Função de baixo nível que lê o espaço inteiro de um registro (REGISTRY_SIZE bytes) do disco,
+ *  com uma única leitura, para que seus campos sejam interpretados depois a partir da memória.
  *  OBS: o cursor deve estar posicionado corretamente antes de chamar esta função
  *  Parâmetros:
  *      FILE *file -> stream do arquivo binário
+ *      char *slot -> buffer com pelo menos REGISTRY_SIZE bytes, onde o registro será guardado
  *  Retorno: 
- *      VirtualRegistry* -> registro lido, ou NULL se o registro estiver deletado
+ *      bool -> indica se o registro inteiro foi lido
  */
-VirtualRegistry *binary_read_registry(FILE *file) {
-    int cidadeMae_size, cidadeBebe_size, garbage_size;
-
-    cidadeMae_size = binary_read_int(file);
-    
-    if (cidadeMae_size == -1) {
-        //Pula o registro atual
-        fseek(file, REGISTRY_SIZE-sizeof(int), SEEK_CUR);
-        return NULL;
+bool binary_read_registry_slot(FILE *file, char *slot) {
+    if (file == NULL || slot == NULL) {
+        DP("ERROR: invalid parameters @binary_read_registry_slot()\n");
+        return false;
     }
 
-    cidadeBebe_size = binary_read_int(file);
-    garbage_size = calculate_variable_fields_garbage(cidadeMae_size+cidadeBebe_size);
+    return fread(slot, sizeof(char), REGISTRY_SIZE, file) == REGISTRY_SIZE;
+}
+
+/**
+ *  Verifica se o registro em memória está marcado como removido
+ *  Parâmetros:
+ *      char *slot -> registro lido por binary_read_registry_slot()
+ *  Retorno: 
+ *      bool -> true se o registro estiver removido
+ */
+bool binary_slot_is_removed(const char *slot) {
+    return _slot_int(slot, SLOT_CIDADEMAE_SIZE_OFFSET) == -1;
+}
+
+/**
+ *  Interpreta os campos de um registro já lido para a memória, criando um novo VirtualRegistry
+ *  Parâmetros:
+ *      char *slot -> registro lido por binary_read_registry_slot()
+ *  Retorno: 
+ *      VirtualRegistry* -> registro interpretado, ou NULL se o registro estiver deletado
+ */
+VirtualRegistry *binary_decode_registry(const char *slot) {
+    if (slot == NULL || binary_slot_is_removed(slot)) return NULL;
 
     //Tenta alocar um registro na RAM
     VirtualRegistry *reg_data = virtual_registry_create();
     if (reg_data == NULL) {
-        DP("ERROR: unable to create VirtualRegistry @binary_read_registry()");
+        DP("ERROR: unable to create VirtualRegistry @binary_decode_registry()");
         return NULL;
     }
 
+    int cidadeMae_size, cidadeBebe_size;
+    binary_slot_cities_sizes(slot, &cidadeMae_size, &cidadeBebe_size);
+
     //Campos variáveis
-    reg_data -> cidadeMae = binary_read_string(file, cidadeMae_size);
-    reg_data -> cidadeBebe = binary_read_string(file, cidadeBebe_size);
+    reg_data->cidadeMae = _slot_string(slot, SLOT_VARIABLE_FIELDS_OFFSET, cidadeMae_size);
+    reg_data->cidadeBebe = _slot_string(slot, SLOT_VARIABLE_FIELDS_OFFSET + cidadeMae_size, cidadeBebe_size);
 
-    //Ignora o lixo
-    fseek(file, garbage_size, SEEK_CUR);
-    
     //Campos estáticos
-    reg_data->idNascimento = binary_read_int(file);
-    reg_data->idadeMae = binary_read_int(file);
-    reg_data->dataNascimento = binary_read_string(file, 10);
-    reg_data->sexoBebe = binary_read_char(file);
-    reg_data->estadoMae = binary_read_string(file, 2);
-    reg_data->estadoBebe = binary_read_string(file, 2);
+    reg_data->idNascimento = _slot_int(slot, SLOT_IDNASCIMENTO_OFFSET);
+    reg_data->idadeMae = _slot_int(slot, SLOT_IDADEMAE_OFFSET);
+    reg_data->dataNascimento = _slot_string(slot, SLOT_DATANASCIMENTO_OFFSET, 10);
+    reg_data->sexoBebe = slot[SLOT_SEXOBEBE_OFFSET];
+    reg_data->estadoMae = _slot_string(slot, SLOT_ESTADOMAE_OFFSET, 2);
+    reg_data->estadoBebe = _slot_string(slot, SLOT_ESTADOBEBE_OFFSET, 2);
 
     return reg_data;
-}
\ No newline at end of file
+}
+
+/**
+ *  Interpreta os campos de um registro já lido para a memória, preenchendo um VirtualRegistry
+ *  já existente, sem nenhuma alocação. Usado em varreduras, em que o mesmo registro é reaproveitado
+ *  para todos os registros do arquivo.
+ *  Parâmetros:
+ *      char *slot -> registro lido por binary_read_registry_slot()
+ *      VirtualRegistry *reg_data -> registro criado com virtual_registry_create_buffered() (seus buffers são reaproveitados)
+ *  Retorno: 
+ *      bool -> false se o registro estiver deletado (nesse caso reg_data não é alterado)
+ */
+bool binary_decode_registry_into(const char *slot, VirtualRegistry *reg_data) {
+    if (slot == NULL || reg_data == NULL) {
+        DP("ERROR: invalid parameters @binary_decode_registry_into()\n");
+        return false;
+    }
+
+    if (binary_slot_is_removed(slot)) return false;
+
+    int cidadeMae_size, cidadeBebe_size;
+    binary_slot_cities_sizes(slot, &cidadeMae_size, &cidadeBebe_size);
+
+    //Campos variáveis
+    _slot_string_into(slot, SLOT_VARIABLE_FIELDS_OFFSET, cidadeMae_size, reg_data->cidadeMae);
+    _slot_string_into(slot, SLOT_VARIABLE_FIELDS_OFFSET + cidadeMae_size, cidadeBebe_size, reg_data->cidadeBebe);
+
+    //Campos estáticos
+    reg_data->idNascimento = _slot_int(slot, SLOT_IDNASCIMENTO_OFFSET);
+    reg_data->idadeMae = _slot_int(slot, SLOT_IDADEMAE_OFFSET);
+    _slot_string_into(slot, SLOT_DATANASCIMENTO_OFFSET, 10, reg_data->dataNascimento);
+    reg_data->sexoBebe = slot[SLOT_SEXOBEBE_OFFSET];
+    _slot_string_into(slot, SLOT_ESTADOMAE_OFFSET, 2, reg_data->estadoMae);
+    _slot_string_into(slot, SLOT_ESTADOBEBE_OFFSET, 2, reg_data->estadoBebe);
+
+    return true;
+}
+
+/**
+ *  Função de baixo nível que lê um registro do disco (com uma única leitura do registro inteiro)
+ *  OBS: o cursor deve estar posicionado corretamente antes de chamar esta função
+ *  Parâmetros:
+ *      FILE *file -> stream do arquivo binário
+ *  Retorno: 
+ *      VirtualRegistry* -> registro lido, ou NULL se o registro estiver deletado
+ */
+VirtualRegistry *binary_read_registry(FILE *file) {
+    char slot[REGISTRY_SIZE];
+
+    if (!binary_read_registry_slot(file, slot)) return NULL;
+
+    return binary_decode_registry(slot);
+}
@@ -4,7 +4,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
+#include "binary_registry.h"
 #include "registry_linked_list.h"
 #include "string_utils.h"
 #include "open_mode.h"
@@ -16,6 +21,11 @@ typedef struct csv_reader_ CsvReader;
 //Representa o TAD CsvReader
 struct csv_reader_ {
     FILE *csv_file;
+    char *block;            //Bloco lido do arquivo, onde as linhas são interpretadas sem cópia (com um byte extra para o '\0' da última linha)
+    int block_capacity;
+    int start;              //Início dos dados do bloco ainda não consumidos
+    int end;                //Fim dos dados lidos para o bloco
+    bool eof;
 };
 
 
@@ -27,10 +37,142 @@ struct csv_reader_ {
  */
 CsvReader *csv_reader_create(void) {
     CsvReader *reader = malloc(sizeof(CsvReader));
+    if (reader == NULL) return NULL;
+
     reader -> csv_file = NULL;
+    reader -> block = NULL;
+    reader -> block_capacity = 0;
+    reader -> start = reader -> end = 0;
+    reader -> eof = false;
     return reader;
 }
 
+/*
+    Lê o próximo bloco do arquivo, mantendo no início do buffer os dados ainda não consumidos.
+    Se uma única linha ocupar o bloco inteiro, o bloco é aumentado.
+    Retorno:
+        bool. false se não houver mais nada a ser lido
+*/
+static bool _fill_block(CsvReader *reader) {
+    if (reader->eof) return false;
+
+    //Move os dados não consumidos para o início do bloco
+    memmove(reader->block, reader->block + reader->start, reader->end - reader->start);
+    reader->end -= reader->start;
+    reader->start = 0;
+
+    if (reader->end == reader->block_capacity) {
+        char *bigger = realloc(reader->block, 2 * reader->block_capacity + 1);
+        if (bigger == NULL) {
+            DP("ERROR: not enough memory for a csv line @_fill_block()\n");
+            reader->eof = true;
+            return false;
+        }
+        reader->block = bigger;
+        reader->block_capacity *= 2;
+    }
+
+    size_t read_bytes = fread(reader->block + reader->end, sizeof(char), reader->block_capacity - reader->end, reader->csv_file);
+    if (read_bytes == 0) {
+        reader->eof = true;
+        return false;
+    }
+
+    reader->end += read_bytes;
+    return true;
+}
+
+//Retorna o próximo caractere do arquivo sem consumi-lo, ou EOF
+static int _peek_char(CsvReader *reader) {
+    if (reader->start == reader->end && !_fill_block(reader)) return EOF;
+    return (unsigned char) reader->block[reader->start];
+}
+
+/*
+    Obtém a próxima linha do arquivo, diretamente no bloco (o '\n' é substituído por '\0')
+    Retorno:
+        char* -> a linha, válida até a próxima leitura, ou NULL ao fim do arquivo
+*/
+static char *_next_line(CsvReader *reader) {
+    //Quantidade de caracteres, a partir de start, em que já se sabe não haver '\n'
+    int searched = 0;
+
+    while (true) {
+        char *newline = memchr(reader->block + reader->start + searched, '\n', reader->end - reader->start - searched);
+        if (newline != NULL) {
+            char *line = reader->block + reader->start;
+            *newline = '\0';
+            reader->start = newline - reader->block + 1;
+            return line;
+        }
+
+        searched = reader->end - reader->start;
+        if (!_fill_block(reader)) break;
+    }
+
+    //Última linha, sem '\n' ao fim
+    if (reader->start == reader->end) return NULL;
+
+    char *line = reader->block + reader->start;
+    reader->block[reader->end] = '\0';
+    reader->start = reader->end;
+    return line;
+}
+
+/*
+    Obtém o próximo campo de uma linha, que termina em ',' ou '\r' (mesmo critério de _csv_registry_token()).
+    Ao fim da linha, os campos seguintes são vazios.
+    Parametros:
+        cursor -> posição atual na linha, atualizada para o início do próximo campo
+    Retorno:
+        char* -> o campo, terminado em '\0' (aponta para a própria linha)
+*/
+static char *_next_field(char **cursor) {
+    char *field = *cursor;
+    char *delimiter = field + strcspn(field, ",\r");
+
+    if (*delimiter != '\0') {
+        *delimiter = '\0';
+        *cursor = delimiter + 1;
+    } else {
+        *cursor = delimiter;
+    }
+
+    return field;
+}
+
+/*
+    Interpreta uma linha do CSV, sem cópias: os campos de texto do registro apontam para a própria linha
+    Parametros:
+        line -> a linha (é modificada)
+        registry -> onde os campos serão guardados
+*/
+static void _parse_line(char *line, VirtualRegistry *registry) {
+    char *cursor = line;
+
+    registry->cidadeMae = _next_field(&cursor);
+    registry->cidadeBebe = _next_field(&cursor);
+
+    //Se o id não for informado, mantenha o valor padrão (-1)
+    char *token = _next_field(&cursor);
+    registry->idNascimento = is_string_empty(token) ? DEFAULT_IDNASC : atoi(token);
+
+    //Se a idade não for informada ou for 0, mantenha o valor padrão (-1)
+    token = _next_field(&cursor);
+    registry->idadeMae = (!is_string_empty(token) && strcmp(token, "0") != 0) ? atoi(token) : DEFAULT_IDADEMAE;
+    if (registry->idadeMae == 0)
+        registry->idadeMae = -1;
+
+    registry->dataNascimento = _next_field(&cursor);
+
+    //Se sexo não for informado ou se for um valor inválido (diferente de 0, 1 e 2), mantenha o valor 0 (ignorado)
+    token = _next_field(&cursor);
+    registry->sexoBebe = (strlen(token) == 1 && (token[0] == '1' || token[0] == '2')) ? token[0] : DEFAULT_SEXOBEBE;
+
+    registry->estadoMae = _next_field(&cursor);
+    registry->estadoBebe = _next_field(&cursor);
+}
+
 /**
  *  Abre um arquivo csv, o qual será lido pelo CsvReader.
  *  Parâmetros:
@@ -53,62 +195,403 @@ OPEN_RESULT csv_reader_open(CsvReader *reader, char *csv_filename) {
         return OPEN_FAILED;
     }
 
-    //Ignora os headers (primeira linha)
-    fscanf(reader->csv_file, "%*[^\n]\n");
+    //O arquivo é lido em blocos grandes, sem o buffer da stream
+    setvbuf(reader->csv_file, NULL, _IONBF, 0);
+    reader->block = malloc(CSV_READER_BLOCK_SIZE + 1);
+    if (reader->block == NULL) {
+        DP("ERROR: not enough memory for csv block @csv_reader_open()\n");
+        csv_reader_close(reader);
+        return OPEN_FAILED;
+    }
+    reader->block_capacity = CSV_READER_BLOCK_SIZE;
+    reader->start = reader->end = 0;
+    reader->eof = false;
+
+    //Ignora os headers (primeira linha), assim como fscanf(file, "%*[^\n]\n"): se a linha não for vazia, ela é ignorada
+    //junto com todos os espaços em branco que a seguirem
+    if (_peek_char(reader) != '\n') {
+        int c;
+        while ((c = _peek_char(reader)) != EOF && c != '\n') reader->start++;
+        while ((c = _peek_char(reader)) != EOF && isspace(c)) reader->start++;
+    }
 
     return OPEN_OK;
 }
 
 /**
  *  Lê uma linha completa do CSV
- *  OBS: a linha deve ter, no máximo, 1024 caracteres. Demais caracteres serão ignorados
  *  Parâmetros: 
- *      FILE *file_stream -> stream de um arquivo com leitura ativada
+ *      CsvReader *reader -> leitor com o arquivo aberto
  *  Retorno:
  *      VirtualRegistry* -> pointer para struct com informações lidas do registro
  */
 VirtualRegistry *csv_reader_readline(CsvReader *reader) {
-    //Buffer para leitura com fgets
-    static char buf[1025];
-
     //Se EOF, retorna NULL para enviar a mensagem para quem estiver usando esta função
-    if (fgets(buf, 1024, reader->csv_file) == NULL) return NULL;
+    char *line = _next_line(reader);
+    if (line == NULL) return NULL;
+
+    VirtualRegistry parsed;
+    _parse_line(line, &parsed);
 
     //Inicializa o registro com valores padrões
     VirtualRegistry *registry = virtual_registry_create();
 
-    //OBS: strdups são necessários pois o token retornado aponta para uma região do buffer, que é estático (ou seja, vai ser liberado ao fim da função)
-    registry->cidadeMae = strdup(_csv_registry_token(buf));
-    registry->cidadeBebe = strdup(_csv_registry_token(NULL));
+    //OBS: strdups são necessários pois os campos apontam para o bloco, que será sobrescrito nas próximas leituras
+    registry->cidadeMae = strdup(parsed.cidadeMae);
+    registry->cidadeBebe = strdup(parsed.cidadeBebe);
+    registry->idNascimento = parsed.idNascimento;
+    registry->idadeMae = parsed.idadeMae;
+    registry->dataNascimento = strdup(parsed.dataNascimento);
+    registry->sexoBebe = parsed.sexoBebe;
+    registry->estadoMae = strdup(parsed.estadoMae);
+    registry->estadoBebe = strdup(parsed.estadoBebe);
 
-    //Variável para armazenamento temporário do token (necessária devido às checagens de string vazia abaixo)
-    char *token = _csv_registry_token(NULL);
+    return registry;
+}
 
-    //Se a idade não for informada ou for 0, mantenha o valor padrão (-1)
-    if (!is_string_empty(token)) 
-        registry->idNascimento = atoi(token);
+/**
+ *  Lê as próximas linhas do CSV, codificando cada uma diretamente na imagem do registro (REGISTRY_SIZE bytes)
+ *  que seria escrita no arquivo binário, sem alocar nenhum registro intermediário.
+ *  Parâmetros: 
+ *      CsvReader *reader -> leitor com o arquivo aberto
+ *      char *slots -> destino das imagens, com espaço para max_count registros
+ *      int max_count -> quantidade máxima de linhas a serem lidas
+ *  Retorno:
+ *      int -> quantidade de registros codificados (0 ao fim do arquivo)
+ */
+int csv_reader_read_registry_slots(CsvReader *reader, char *slots, int max_count) {
+    if (reader == NULL || reader->csv_file == NULL || slots == NULL) {
+        DP("ERROR: invalid parameters @csv_reader_read_registry_slots()\n");
+        return 0;
+    }
 
-    //Se a idade não for informada ou for 0, mantenha o valor padrão (-1)
-    token = _csv_registry_token(NULL);
-    if (!is_string_empty(token) && strcmp(token, "0") != 0)
-        registry->idadeMae = atoi(token);
-    if (registry->idadeMae == 0)
-        registry->idadeMae = -1;
+    int count = 0;
+    char *line;
+    while (count < max_count && (line = _next_line(reader)) != NULL) {
+        VirtualRegistry parsed;
+        _parse_line(line, &parsed);
+        binary_encode_registry(slots + (size_t) count * REGISTRY_SIZE, &parsed);
+        count++;
+    }
 
-    registry->dataNascimento = strdup(_csv_registry_token(NULL));
+    return count;
+}
 
-    //Se sexo não for informado ou se for um valor inválido, mantenha o valor 0 (ignorado)
-    token = _csv_registry_token(NULL);
-    if (!is_string_empty(token) && strlen(token) == 1) {
-        //Evitar valores indesejados (valores diferentes de 0, 1 e 2)
-        if (token[0] == '1' || token[0] == '2')
-            registry->sexoBebe = token[0];
+/*
+    Espaço onde uma thread guarda um pedaço (chunk) do arquivo e os registros codificados a partir dele, até que sejam emitidos
+*/
+typedef struct {
+    int chunk;              //Pedaço guardado no espaço (-1 se nenhum)
+    bool done;              //Indica que o pedaço já foi processado e pode ser emitido
+    bool failed;            //Indica que não houve memória (ou leitura) suficiente para processar o pedaço
+    char *text;             //Texto do pedaço (mais o início da linha anterior e o fim da sua última linha)
+    size_t text_capacity;
+    char *records;          //Imagens dos registros codificados
+    int record_capacity;
+    int count;              //Quantidade de registros codificados
+} CsvChunkSlot;
+
+/*
+    Estado compartilhado da leitura paralela. O arquivo (após os headers) é dividido em pedaços de CSV_PARALLEL_CHUNK_SIZE bytes,
+    e cada linha pertence ao pedaço em que ela começa. As threads pegam os pedaços em ordem crescente, e a thread principal
+    os emite também em ordem. Como há apenas "window" espaços, uma thread que estiver muito à frente espera a emissão.
+*/
+typedef struct {
+    int fd;
+    off_t data_start;               //Posição do arquivo em que começa a primeira linha de dados
+    off_t file_size;
+
+    pthread_mutex_t lock;
+    pthread_cond_t chunk_done;      //Sinalizado quando um pedaço termina de ser processado
+    pthread_cond_t slot_free;       //Sinalizado quando um pedaço é emitido (liberando seu espaço)
+
+    int chunk_count;
+    int next_chunk;                 //Próximo pedaço a ser pego por uma thread
+    int next_emit;                  //Próximo pedaço a ser emitido
+    int window;
+    CsvChunkSlot *slots;            //O pedaço i usa o espaço i % window
+} CsvParallelIngest;
+
+//Retorna a quantidade de threads usada por padrão (uma por processador, com um máximo)
+static int _default_thread_count(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return 1;
+    if (cpus > CSV_PARALLEL_MAX_THREADS) return CSV_PARALLEL_MAX_THREADS;
+    return (int) cpus;
+}
+
+//Garante que o texto do espaço comporte, no mínimo, size bytes (mais o '\0' final)
+static bool _reserve_text(CsvChunkSlot *slot, size_t size) {
+    if (size + 1 <= slot->text_capacity) return true;
+
+    size_t capacity = (slot->text_capacity == 0) ? size + 1 : slot->text_capacity;
+    while (capacity < size + 1) capacity *= 2;
+
+    char *text = realloc(slot->text, capacity);
+    if (text == NULL) return false;
+
+    slot->text = text;
+    slot->text_capacity = capacity;
+    return true;
+}
+
+//Lê exatamente size bytes (ou até o fim do arquivo) a partir de offset, retornando a quantidade lida
+static size_t _pread_full(int fd, char *dest, size_t size, off_t offset) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t read_bytes = pread(fd, dest + total, size - total, offset + total);
+        if (read_bytes <= 0) break;
+        total += read_bytes;
     }
+    return total;
+}
 
-    registry->estadoMae = strdup(_csv_registry_token(NULL));
-    registry->estadoBebe = strdup(_csv_registry_token(NULL));
+//Codifica uma linha no próximo registro do espaço, aumentando o vetor de registros se necessário
+static bool _encode_chunk_line(CsvChunkSlot *slot, char *line) {
+    if (slot->count == slot->record_capacity) {
+        int capacity = (slot->record_capacity == 0) ? CSV_INGEST_BATCH_REGISTRIES : 2 * slot->record_capacity;
+        char *records = realloc(slot->records, (size_t) capacity * REGISTRY_SIZE);
+        if (records == NULL) return false;
 
-    return registry;
+        slot->records = records;
+        slot->record_capacity = capacity;
+    }
+
+    VirtualRegistry parsed;
+    _parse_line(line, &parsed);
+    binary_encode_registry(slot->records + (size_t) slot->count * REGISTRY_SIZE, &parsed);
+    slot->count++;
+    return true;
+}
+
+/*
+    Lê, interpreta e codifica as linhas que começam em um pedaço do arquivo
+    Parametros:
+        ingest -> estado da leitura
+        chunk -> índice do pedaço
+        slot -> espaço onde o resultado será guardado
+*/
+static void _ingest_chunk(CsvParallelIngest *ingest, int chunk, CsvChunkSlot *slot) {
+    off_t chunk_start = ingest->data_start + (off_t) chunk * CSV_PARALLEL_CHUNK_SIZE;
+    off_t chunk_end = chunk_start + CSV_PARALLEL_CHUNK_SIZE;
+    if (chunk_end > ingest->file_size) chunk_end = ingest->file_size;
+
+    slot->count = 0;
+    slot->failed = false;
+
+    //Lê também o byte anterior ao pedaço, que indica se uma linha começa exatamente no início do pedaço
+    off_t read_start = (chunk == 0) ? chunk_start : chunk_start - 1;
+    size_t size = chunk_end - read_start;
+    if (!_reserve_text(slot, size) || _pread_full(ingest->fd, slot->text, size, read_start) != size) {
+        slot->failed = true;
+        return;
+    }
+
+    //Continua a leitura até o fim da última linha que começa no pedaço
+    size_t searched = size - 1;
+    while (slot->text[size-1] != '\n' && read_start + (off_t) size < ingest->file_size) {
+        size_t piece = CSV_READER_BLOCK_SIZE;
+        if (!_reserve_text(slot, size + piece)) {
+            slot->failed = true;
+            return;
+        }
+
+        size_t read_bytes = _pread_full(ingest->fd, slot->text + size, piece, read_start + size);
+        if (read_bytes == 0) break;
+        size += read_bytes;
+
+        if (memchr(slot->text + searched, '\n', size - searched) != NULL) break;
+        searched = size;
+    }
+    slot->text[size] = '\0';
+
+    //Primeira linha que começa no pedaço (a linha em andamento pertence ao pedaço anterior)
+    size_t position = 0, local_end = chunk_end - read_start;
+    if (chunk > 0) {
+        char *newline = memchr(slot->text, '\n', size);
+        position = (newline == NULL) ? size : (size_t) (newline - slot->text) + 1;
+    }
+
+    //Mesmo critério de _next_line(): cada '\n' termina uma linha, e o texto restante ao fim do arquivo também é uma linha
+    while (position < local_end) {
+        char *line = slot->text + position;
+        char *newline = memchr(line, '\n', size - position);
+        if (newline != NULL) {
+            *newline = '\0';
+            position = (newline - slot->text) + 1;
+        } else {
+            position = size;
+        }
+
+        if (!_encode_chunk_line(slot, line)) {
+            slot->failed = true;
+            return;
+        }
+    }
+}
+
+//Função executada por cada thread: processa pedaços até que não haja mais nenhum
+static void *_ingest_worker(void *arg) {
+    CsvParallelIngest *ingest = arg;
+
+    pthread_mutex_lock(&ingest->lock);
+    while (ingest->next_chunk < ingest->chunk_count) {
+        int chunk = ingest->next_chunk++;
+
+        //Espera o espaço do pedaço ser liberado
+        while (chunk >= ingest->next_emit + ingest->window)
+            pthread_cond_wait(&ingest->slot_free, &ingest->lock);
+
+        CsvChunkSlot *slot = &ingest->slots[chunk % ingest->window];
+        slot->chunk = chunk;
+        pthread_mutex_unlock(&ingest->lock);
+
+        _ingest_chunk(ingest, chunk, slot);
+
+        pthread_mutex_lock(&ingest->lock);
+        slot->done = true;
+        pthread_cond_broadcast(&ingest->chunk_done);
+    }
+    pthread_mutex_unlock(&ingest->lock);
+
+    return NULL;
+}
+
+//Lê o restante do arquivo sequencialmente, emitindo lotes de até CSV_INGEST_BATCH_REGISTRIES registros
+static int _read_all_registry_slots(CsvReader *reader, CsvSlotsEmitFunc emit, void *context) {
+    char *slots = malloc((size_t) CSV_INGEST_BATCH_REGISTRIES * REGISTRY_SIZE);
+    if (slots == NULL) {
+        DP("ERROR: not enough memory for registry slots @_read_all_registry_slots()\n");
+        return -1;
+    }
+
+    int total = 0, count;
+    while ((count = csv_reader_read_registry_slots(reader, slots, CSV_INGEST_BATCH_REGISTRIES)) > 0) {
+        emit(slots, count, context);
+        total += count;
+    }
+
+    free(slots);
+    return total;
+}
+
+/**
+ *  Lê todas as linhas restantes do CSV com várias threads: o arquivo é dividido em pedaços, cujas linhas são
+ *  interpretadas e codificadas nas imagens dos registros (assim como em csv_reader_read_registry_slots()) de forma independente.
+ *  Os registros são emitidos na thread que chamou a função, na ordem do arquivo, portanto o resultado é
+ *  idêntico ao da leitura sequencial. Arquivos pequenos (um único pedaço) são lidos sequencialmente.
+ *  Parâmetros:
+ *      CsvReader *reader -> leitor com o arquivo aberto (os headers já foram ignorados na abertura)
+ *      int thread_count -> quantidade de threads (<= 0 usa uma por processador)
+ *      CsvSlotsEmitFunc emit -> função chamada para cada lote de registros (as imagens só são válidas durante a chamada)
+ *      void *context -> valor repassado para a função emit
+ *  Retorno:
+ *      int -> quantidade de registros lidos, ou -1 em caso de erro (os registros anteriores ao erro já foram emitidos)
+ */
+int csv_reader_parallel_read_registry_slots(CsvReader *reader, int thread_count, CsvSlotsEmitFunc emit, void *context) {
+    if (reader == NULL || reader->csv_file == NULL || emit == NULL) {
+        DP("ERROR: invalid parameters @csv_reader_parallel_read_registry_slots()\n");
+        return -1;
+    }
+
+    if (thread_count <= 0) thread_count = _default_thread_count();
+
+    //O arquivo é lido sem buffer da stream, portanto a posição dos dados ainda não consumidos é a posição do arquivo menos o que está no bloco
+    CsvParallelIngest ingest;
+    struct stat file_stat;
+    ingest.fd = fileno(reader->csv_file);
+    long file_position = ftell(reader->csv_file);
+    if (thread_count == 1 || file_position < 0 || fstat(ingest.fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+        return _read_all_registry_slots(reader, emit, context);
+
+    ingest.data_start = file_position - (reader->end - reader->start);
+    ingest.file_size = file_stat.st_size;
+    ingest.chunk_count = (ingest.file_size - ingest.data_start + CSV_PARALLEL_CHUNK_SIZE - 1) / CSV_PARALLEL_CHUNK_SIZE;
+    if (ingest.chunk_count <= 1)
+        return _read_all_registry_slots(reader, emit, context);
+
+    ingest.next_chunk = 0;
+    ingest.next_emit = 0;
+    if (thread_count > ingest.chunk_count) thread_count = ingest.chunk_count;
+
+    //Dois espaços por thread: enquanto um pedaço espera ser emitido, a thread já pode processar o próximo
+    ingest.window = 2 * thread_count;
+    ingest.slots = calloc(ingest.window, sizeof(CsvChunkSlot));
+    pthread_t *threads = malloc(sizeof(pthread_t) * thread_count);
+    if (ingest.slots == NULL || threads == NULL) {
+        free(ingest.slots);
+        free(threads);
+        return _read_all_registry_slots(reader, emit, context);
+    }
+
+    for (int i = 0; i < ingest.window; i++)
+        ingest.slots[i].chunk = -1;
+
+    pthread_mutex_init(&ingest.lock, NULL);
+    pthread_cond_init(&ingest.chunk_done, NULL);
+    pthread_cond_init(&ingest.slot_free, NULL);
+
+    int started = 0;
+    for (; started < thread_count; started++) {
+        if (pthread_create(&threads[started], NULL, _ingest_worker, &ingest) != 0) break;
+    }
+
+    //Sem nenhuma thread, a própria thread principal processa os pedaços
+    bool sequential = (started == 0);
+    if (sequential) DP("WARNING: couldn't start csv threads, reading sequentially @csv_reader_parallel_read_registry_slots()\n");
+
+    int total = 0;
+    bool failed = false;
+    for (int chunk = 0; chunk < ingest.chunk_count; chunk++) {
+        CsvChunkSlot *slot = &ingest.slots[chunk % ingest.window];
+
+        if (sequential) {
+            slot->chunk = chunk;
+            _ingest_chunk(&ingest, chunk, slot);
+        } else {
+            //Espera o pedaço ser processado
+            pthread_mutex_lock(&ingest.lock);
+            while (!slot->done || slot->chunk != chunk)
+                pthread_cond_wait(&ingest.chunk_done, &ingest.lock);
+            pthread_mutex_unlock(&ingest.lock);
+        }
+
+        //Após uma falha, nenhum outro pedaço é emitido (mas as threads ainda terminam os seus)
+        if (!failed && slot->failed) {
+            DP("ERROR: couldn't process csv chunk @csv_reader_parallel_read_registry_slots()\n");
+            failed = true;
+        }
+        if (!failed && slot->count > 0) {
+            emit(slot->records, slot->count, context);
+            total += slot->count;
+        }
+
+        //Libera o espaço para o pedaço chunk + window
+        pthread_mutex_lock(&ingest.lock);
+        slot->done = false;
+        ingest.next_emit++;
+        pthread_cond_broadcast(&ingest.slot_free);
+        pthread_mutex_unlock(&ingest.lock);
+    }
+
+    for (int i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+
+    pthread_cond_destroy(&ingest.slot_free);
+    pthread_cond_destroy(&ingest.chunk_done);
+    pthread_mutex_destroy(&ingest.lock);
+    for (int i = 0; i < ingest.window; i++) {
+        free(ingest.slots[i].text);
+        free(ingest.slots[i].records);
+    }
+    free(ingest.slots);
+    free(threads);
+
+    //Todo o arquivo foi consumido
+    reader->start = reader->end = 0;
+    reader->eof = true;
+
+    return failed ? -1 : total;
 }
 
 /**
@@ -121,8 +604,10 @@ void csv_reader_close(CsvReader *reader) {
     //Verifica se o reader já foi deletado ou se o arquivo já foi fechado
     if (reader == NULL || reader->csv_file == NULL) return;
 
-    //fecha o arquivo
+    //fecha o arquivo e libera o bloco de leitura
     fclose(reader->csv_file);
+    free(reader->block);
+    reader->block = NULL;
 
 	//Marca qua não existe arquivo aberto
     reader->csv_file = NULL;
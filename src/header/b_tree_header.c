@@ -3,9 +3,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "binary_io.h"
+#include "b_tree_node.h"
 #include "debug.h"
 
-#define HEADER_GARBAGE_SIZE 55
+//Bytes ocupados pelos headers da especificação (status, noRaiz, nroNiveis, proxRRN e nroChaves)
+#define HEADER_FIELDS_SIZE (sizeof(char) + 4 * sizeof(int))
+
+//Bytes ocupados pela descrição do formato (versão, ordem e tamanho de página), guardada no início do lixo
+#define HEADER_FORMAT_SIZE (sizeof(char) + 2 * sizeof(int))
+
+//Indica se a versão guarda a descrição do formato (ordem e tamanho de página) logo após a versão
+#define HEADER_HAS_FORMAT(version) ((version) == B_TREE_FORMAT_PAGED || B_TREE_FORMAT_IS_PLUS(version))
+
+//Offset da marca da lista de páginas livres: após o '$' do formato da especificação, ou após a descrição do formato
+#define HEADER_FREE_LIST_OFFSET(version) (HEADER_FIELDS_SIZE + (HEADER_HAS_FORMAT(version) ? HEADER_FORMAT_SIZE : sizeof(char)))
 
 /**
  *  Struct encapsulada por um TAD que representa os headers do arquivo na RAM.
@@ -22,6 +33,10 @@ struct _b_tree_header {
     int nroNiveis;
     int proxRRN;
     int nroChaves;
+    char version;   //Versão do formato: B_TREE_FORMAT_LEGACY (o lixo da especificação), B_TREE_FORMAT_PAGED, B_TREE_FORMAT_PLUS ou B_TREE_FORMAT_PLUS_PACKED
+    int order;      //Ordem dos nós do arquivo
+    int page_size;  //Tamanho, em bytes, de cada página do arquivo (o header ocupa a primeira página)
+    int free_list_head; //RRN da primeira página livre (-1 se não houver)
 };
 
 /**
@@ -44,6 +59,12 @@ BTreeHeader *b_tree_header_create(void) {
     header->proxRRN = 0;
     header->nroChaves = 0;
 
+    //Por padrão os arquivos seguem o formato da especificação
+    header->version = B_TREE_FORMAT_LEGACY;
+    header->order = B_TREE_ORDER;
+    header->page_size = NODE_SIZE;
+    header->free_list_head = -1;
+
     //Marca que, em um momento oportuno, todos os headers devem ser escritos (supondo que é um arquivo novo, por enquanto)
     header->changedMask = BTHMASK_ALL;
 
@@ -152,14 +173,30 @@ void b_tree_header_write_to_bin(BTreeHeader *header, FILE *file) {
         shouldFseek = false;
     } else shouldFseek = true;
 
-    //Se for necessário escreve o lixo após os headers
+    //Se for necessário escreve o lixo após os headers (no formato paginado, precedido pela descrição do formato)
     if (shouldWriteGarbage) {
         if (shouldFseek) fseek(file, offsets[5], SEEK_SET);
-        char *garbage = generate_garbage(HEADER_GARBAGE_SIZE);
-        binary_write_string(file, garbage, HEADER_GARBAGE_SIZE);
+
+        int garbage_size = header->page_size - HEADER_FIELDS_SIZE;
+        if (HEADER_HAS_FORMAT(header->version)) {
+            binary_write_char(file, header->version);
+            binary_write_int(file, header->order);
+            binary_write_int(file, header->page_size);
+            garbage_size -= HEADER_FORMAT_SIZE;
+        }
+
+        char *garbage = generate_garbage(garbage_size);
+        binary_write_string(file, garbage, garbage_size);
         free(garbage);
     }
 
+    //A lista de páginas livres só é escrita depois que existir (arquivos sem remoções mantêm o lixo da especificação)
+    if ((header->changedMask & BTHMASK_FREELIST) && (header->free_list_head != -1 || !shouldWriteGarbage)) {
+        fseek(file, HEADER_FREE_LIST_OFFSET(header->version), SEEK_SET);
+        binary_write_char(file, B_TREE_FREE_LIST_MARKER);
+        binary_write_int(file, header->free_list_head);
+    }
+
     //Visto que os dados foram escritos no disco, eles se tornam atualizados
     header->changedMask = BTHMASK_NONE;
 }
@@ -193,6 +230,31 @@ void b_tree_header_read_from_bin(BTreeHeader *header, FILE *bin_file) {
     header->proxRRN = binary_read_int(bin_file);
     header->nroChaves = binary_read_int(bin_file);
 
+    //No formato da especificação o lixo começa logo após os headers; caso contrário, o formato está descrito ali
+    header->version = binary_read_char(bin_file);
+    if (HEADER_HAS_FORMAT(header->version)) {
+        header->order = binary_read_int(bin_file);
+        header->page_size = binary_read_int(bin_file);
+    }
+
+    //O tamanho mínimo da página depende do tipo de nó guardado nela
+    int node_size = B_TREE_NODE_SIZE(header->order);
+    if (header->version == B_TREE_FORMAT_PLUS) node_size = B_PLUS_TREE_NODE_SIZE(header->order);
+    else if (header->version == B_TREE_FORMAT_PLUS_PACKED) node_size = B_PLUS_TREE_PACKED_NODE_SIZE(header->order);
+    if (!HEADER_HAS_FORMAT(header->version) || header->order < B_TREE_MIN_ORDER || header->order > B_TREE_MAX_ORDER
+        || header->page_size < node_size) {
+        if (HEADER_HAS_FORMAT(header->version))
+            DP("WARNING: invalid B-tree format in header, assuming the legacy format @b_tree_header_read_from_bin()\n");
+
+        header->version = B_TREE_FORMAT_LEGACY;
+        header->order = B_TREE_ORDER;
+        header->page_size = NODE_SIZE;
+    }
+
+    fseek(bin_file, HEADER_FREE_LIST_OFFSET(header->version), SEEK_SET);
+    header->free_list_head = -1;
+    if (binary_read_char(bin_file) == B_TREE_FREE_LIST_MARKER) header->free_list_head = binary_read_int(bin_file);
+
     //Indica que nenhum header precisa ser escrito, pois todos foram atualizados
     header->changedMask = BTHMASK_NONE;
 }
@@ -340,4 +402,124 @@ void b_tree_header_set_nroChaves (BTreeHeader *header, int new_value) {
 
     //Marca que o header precisará ser escrito em um momento oportuno.
     header->changedMask |= BTHMASK_NROCHAVES;
-}
\ No newline at end of file
+}
+
+/*
+	Simples função get, retorna o valor encapsulado (free_list_head)
+    Parâmetros:
+        BTreeHeader *header -> pointer para a struct referida.
+    Retorno:
+        int -> o RRN da primeira página livre (liberada por remoções), ou -1 se não houver
+*/
+int b_tree_header_get_free_list_head (BTreeHeader *header) { return header->free_list_head; }
+
+/*
+	Simples função set, altera o valor encapsulado (free_list_head)
+    Parâmetros:
+        BTreeHeader *header -> pointer para a struct referida.
+        int new_value -> RRN da primeira página livre (-1 se não houver)
+    Retorno: void
+*/
+void b_tree_header_set_free_list_head (BTreeHeader *header, int new_value) {
+    header->free_list_head = new_value;
+    header->changedMask |= BTHMASK_FREELIST;
+}
+
+/*
+	Simples função get, retorna o valor encapsulado (version)
+    Parâmetros:
+        BTreeHeader *header -> pointer para a struct referida.
+    Retorno:
+        char -> a versão do formato do arquivo (B_TREE_FORMAT_LEGACY, B_TREE_FORMAT_PAGED, B_TREE_FORMAT_PLUS ou B_TREE_FORMAT_PLUS_PACKED)
+*/
+char b_tree_header_get_version (BTreeHeader *header) { return header->version; }
+
+/*
+	Simples função get, retorna o valor encapsulado (order)
+    Parâmetros:
+        BTreeHeader *header -> pointer para a struct referida.
+    Retorno:
+        int -> a ordem dos nós do arquivo
+*/
+int b_tree_header_get_order (BTreeHeader *header) { return header->order; }
+
+/*
+	Simples função get, retorna o valor encapsulado (page_size)
+    Parâmetros:
+        BTreeHeader *header -> pointer para a struct referida.
+    Retorno:
+        int -> o tamanho, em bytes, de cada página (nó) do arquivo
+*/
+int b_tree_header_get_page_size (BTreeHeader *header) { return header->page_size; }
+
+/**
+ *  Define o formato (ordem e tamanho de página) de um arquivo novo. Deve ser chamada antes que os headers sejam
+ *  escritos pela primeira vez, visto que o formato de um arquivo existente não pode ser alterado.
+ *  A ordem e o tamanho de página da especificação (B_TREE_ORDER e NODE_SIZE) mantêm o formato original.
+ *  Parâmetros:
+ *      BTreeHeader *header -> header de um arquivo que ainda não foi escrito
+ *      int order -> ordem dos nós (entre B_TREE_MIN_ORDER e B_TREE_MAX_ORDER)
+ *      int page_size -> tamanho de cada página (>= B_TREE_NODE_SIZE(order))
+ *  Retorno:
+ *      bool -> true se o formato foi definido
+ */
+bool b_tree_header_set_format(BTreeHeader *header, int order, int page_size) {
+    //Validação de parâmetros
+    if (header == NULL) {
+        DP("ERROR: (parameter) invalid null header @b_tree_header_set_format()\n");
+        return false;
+    }
+
+    if (header->status != -1) {
+        DP("ERROR: format of an existing file can't be changed @b_tree_header_set_format()\n");
+        return false;
+    }
+
+    if (order < B_TREE_MIN_ORDER || order > B_TREE_MAX_ORDER || page_size < B_TREE_NODE_SIZE(order)
+        || page_size < (int) (HEADER_FIELDS_SIZE + HEADER_FORMAT_SIZE)) {
+        DP("ERROR: (parameter) invalid order or page size @b_tree_header_set_format()\n");
+        return false;
+    }
+
+    bool legacy = (order == B_TREE_ORDER && page_size == NODE_SIZE);
+    header->version = legacy ? B_TREE_FORMAT_LEGACY : B_TREE_FORMAT_PAGED;
+    header->order = order;
+    header->page_size = page_size;
+    return true;
+}
+
+/**
+ *  Define o formato de um arquivo novo de árvore-B+ (B_TREE_FORMAT_PLUS ou B_TREE_FORMAT_PLUS_PACKED). Assim como
+ *  b_tree_header_set_format(), deve ser chamada antes que os headers sejam escritos pela primeira vez.
+ *  Parâmetros:
+ *      BTreeHeader *header -> header de um arquivo que ainda não foi escrito
+ *      int order -> ordem dos nós internos (entre B_TREE_MIN_ORDER e B_TREE_MAX_ORDER); as folhas guardam até order-1 chaves
+ *      int page_size -> tamanho de cada página (>= B_PLUS_TREE_NODE_SIZE(order), ou B_PLUS_TREE_PACKED_NODE_SIZE(order) se compactada)
+ *      bool packed -> indica se as páginas são compactadas
+ *  Retorno:
+ *      bool -> true se o formato foi definido
+ */
+bool b_tree_header_set_plus_format(BTreeHeader *header, int order, int page_size, bool packed) {
+    //Validação de parâmetros
+    if (header == NULL) {
+        DP("ERROR: (parameter) invalid null header @b_tree_header_set_plus_format()\n");
+        return false;
+    }
+
+    if (header->status != -1) {
+        DP("ERROR: format of an existing file can't be changed @b_tree_header_set_plus_format()\n");
+        return false;
+    }
+
+    int node_size = packed ? B_PLUS_TREE_PACKED_NODE_SIZE(order) : B_PLUS_TREE_NODE_SIZE(order);
+    if (order < B_TREE_MIN_ORDER || order > B_TREE_MAX_ORDER || page_size < node_size
+        || page_size < (int) (HEADER_FIELDS_SIZE + HEADER_FORMAT_SIZE)) {
+        DP("ERROR: (parameter) invalid order or page size @b_tree_header_set_plus_format()\n");
+        return false;
+    }
+
+    header->version = packed ? B_TREE_FORMAT_PLUS_PACKED : B_TREE_FORMAT_PLUS;
+    header->order = order;
+    header->page_size = page_size;
+    return true;
+}
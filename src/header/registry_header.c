@@ -22,6 +22,8 @@ struct _reg_header {
     int registries_count;
     int removed_count;
     int updated_count;
+    bool free_list_enabled;     //Indica que os registros removidos formam uma lista encadeada, reaproveitada nas inserções
+    int free_list_head;         //RRN do primeiro registro livre (-1 indica lista vazia)
 };
 
 /**
@@ -43,6 +45,8 @@ RegistryHeader *reg_header_create(void) {
     header->registries_count = 0;
     header->removed_count = 0;
     header->updated_count = 0;
+    header->free_list_enabled = false;
+    header->free_list_head = -1;
 
     //Marca que, em um momento oportuno, todos os headers devem ser escritos (supondo que é um arquivo novo, por enquanto)
     header->changedMask = RHMASK_ALL;
@@ -160,6 +164,13 @@ void reg_header_write_to_bin(RegistryHeader *header, FILE *file) {
         free(garbage);
     }
 
+    //A lista de registros livres fica no início do lixo (marcador + RRN do primeiro registro livre), apenas nos arquivos que a possuem
+    if ((header->changedMask & RHMASK_FREELIST) && header->free_list_enabled) {
+        fseek(file, offsets[5], SEEK_SET);
+        binary_write_char(file, REG_HEADER_FREE_LIST_MARKER);
+        binary_write_int(file, header->free_list_head);
+    }
+
     //Visto que os dados foram escritos no disco, eles se tornam atualizados
     header->changedMask = RHMASK_NONE;
 }
@@ -193,6 +204,10 @@ void reg_header_read_from_bin(RegistryHeader *header, FILE *bin_file) {
     header->removed_count = binary_read_int(bin_file);
     header->updated_count = binary_read_int(bin_file);
 
+    //Arquivos sem o marcador (como os da especificação) não possuem lista de registros livres
+    header->free_list_enabled = (binary_read_char(bin_file) == REG_HEADER_FREE_LIST_MARKER);
+    header->free_list_head = header->free_list_enabled ? binary_read_int(bin_file) : -1;
+
     //Indica que nenhum header precisa ser escrito, pois todos foram atualizados
     header->changedMask = RHMASK_NONE;
 }
@@ -341,3 +356,63 @@ void reg_header_set_updated_count (RegistryHeader *header, int new_value) {
     //Marca que o header precisará ser escrito em um momento oportuno.
     header->changedMask |= RHMASK_UPDATEDCOUNT;
 }
+
+/*
+	Simples função get, indica se o arquivo possui lista de registros livres
+    Parâmetros:
+        RegistryHeader *header -> pointer para a struct referida.
+    Retorno:
+        bool -> true se os registros removidos são encadeados e reaproveitados nas inserções
+*/
+bool reg_header_has_free_list (RegistryHeader *header) { return header->free_list_enabled; }
+
+/*
+	Ativa a lista de registros livres (inicialmente vazia). Os registros já removidos devem ser encadeados por quem a ativou.
+    OBS: não escreve no disco, apenas altera seu valor na RAM e indica que o header deve ser escrito
+    em um momento oportuno.
+    Parâmetros:
+        RegistryHeader *header -> pointer para a struct referida.
+    Retorno: void
+*/
+void reg_header_enable_free_list (RegistryHeader *header) {
+    if (header == NULL) {
+        DP("ERROR: (parameter) invalid null header @reg_header_enable_free_list()\n");
+        return;
+    }
+
+    header->free_list_enabled = true;
+    header->free_list_head = -1;
+
+    //Marca que o header precisará ser escrito em um momento oportuno.
+    header->changedMask |= RHMASK_FREELIST;
+}
+
+/*
+	Simples função get, retorna o valor encapsulado (free_list_head)
+    Parâmetros:
+        RegistryHeader *header -> pointer para a struct referida.
+    Retorno:
+        int -> RRN do primeiro registro livre, ou -1 se a lista estiver vazia (ou não existir)
+*/
+int reg_header_get_free_list_head (RegistryHeader *header) { return header->free_list_head; }
+
+/*
+	Simples função set, define o valor encapsulado (free_list_head).
+    OBS: não escreve no disco, apenas altera seu valor na RAM e indica que o header deve ser escrito
+    em um momento oportuno.
+    Parâmetros:
+        RegistryHeader *header -> pointer para a struct referida.
+        int RRN -> RRN do primeiro registro livre, ou -1 para lista vazia
+    Retorno: void
+*/
+void reg_header_set_free_list_head (RegistryHeader *header, int RRN) {
+    if (header == NULL || !header->free_list_enabled) {
+        DP("ERROR: header has no free list @reg_header_set_free_list_head()\n");
+        return;
+    }
+
+    header->free_list_head = RRN;
+
+    //Marca que o header precisará ser escrito em um momento oportuno.
+    header->changedMask |= RHMASK_FREELIST;
+}
@@ -14,13 +14,17 @@
 
 #include "registry_manager.h"
 #include "b_tree_manager.h"
+#include "b_plus_tree_manager.h"
 #include "b_tree_node.h"
+#include "b_tree_secondary_index.h"
+#include "b_tree_query_planner.h"
 
 #include "csv_reader.h"
 
 #include "registry.h"
 #include "registry_linked_list.h"
 #include "registry_header.h"
+#include "registry_rrn_map.h"
 
 #include "string_utils.h"
 #include "bool.h"
@@ -38,10 +42,19 @@ typedef struct _Funcionalidade10callbackInfo
     int idNascimento, RRN;
     ////
 
+    //Usados apenas na funcionalidade12: pares (idNascimento, RRN) acumulados para a inserção em lote
+    pairIntInt *batch;
+    int batch_size, batch_capacity;
+
     //Função a ser executada após a inserção de cada registro
     void (*callback)(struct _Funcionalidade10callbackInfo *info);
 } Funcionalidade10callbackInfo;
 
+//Função usada pela funcionalidade 1 para escrever cada lote de registros lidos do csv ao fim do arquivo binário
+static void _CsvEmit_insert_slots(const char *slots, int count, void *context) {
+    registry_manager_insert_slots_at_end((RegistryManager*) context, slots, count);
+}
+
 /**
  *  Funcionalidade 1: Gerar arquivo binário a partir de CSV
  *  Parâmetros:
@@ -70,6 +83,9 @@ static bool funcionalidade1(char *csv_filename, char *bin_filename) {
         return false;
     }
 
+    //Índices secundários de um arquivo anterior com o mesmo nome não correspondem ao arquivo novo
+    b_tree_secondary_index_drop_all(bin_filename);
+
     //Análogo ao RegistryManager
     CsvReader *csv_reader = csv_reader_create();
     if (registry_manager == NULL) {
@@ -87,24 +103,30 @@ static bool funcionalidade1(char *csv_filename, char *bin_filename) {
         return false;
     }
     
-    //Lê linha a linha do csv, escrevendo-a no binário até que o csv acabe
-    VirtualRegistry *registry = NULL;
-    while ((registry = csv_reader_readline(csv_reader)) != NULL) {
-        registry_manager_insert_at_end(registry_manager, registry);
-        virtual_registry_free(&registry);
-    }
+    //Lê o csv em lotes (em paralelo, se houver mais de um processador), escrevendo cada lote no binário com uma única escrita, na ordem do csv
+    int count = csv_reader_parallel_read_registry_slots(csv_reader, 0, _CsvEmit_insert_slots, registry_manager);
 
     //Define o status como "1", fecha o arquivo e desaloca a memoria
     registry_manager_free(&registry_manager);
     csv_reader_free(&csv_reader);
 
+    if (count < 0) {
+        DP("ERROR: couldn't read the whole csv file @funcionalidade1()\n");
+        return false;
+    }
+
     return true;
 
 }
 
-//Função de callback usada nas funcionalidades 2 e 3. é enviada ao RegistryManager para ser usada como callback de funções internas. Nesse caso o callback simplesmente printa o registro
-static void _DMForeachCallback_print_register(RegistryManager *manager, VirtualRegistry *registry) {
-    virtual_registry_print(registry);
+//Função de callback usada nas funcionalidades 2 e 3. é enviada ao RegistryManager para ser usada como callback de funções internas. Nesse caso o callback simplesmente printa o registro (diretamente da página lida do disco, sem cópia)
+static void _DMViewCallback_print_register(RegistryManager *manager, RegistryView view) {
+    registry_view_print(view);
+}
+
+//Equivalente ao callback acima, usado quando a funcionalidade 3 lê apenas os candidatos obtidos pelos índices
+static void _DMForeachCallback_print_register(RegistryManager *manager, VirtualRegistry *reg) {
+    virtual_registry_print(reg);
 }
 
 /* 
@@ -128,7 +150,7 @@ static bool funcionalidade2(char *bin_filename) {
     }
 
     //Abre o arquivo para leitura, caso a abertura não seja bem sucedida, exibe mensagem com o erro e interrompe o fluxo
-    OPEN_RESULT open_result = registry_manager_open(registry_manager, bin_filename, READ);
+    OPEN_RESULT open_result = registry_manager_open(registry_manager, bin_filename, READ_MMAP);
     if (open_result != OPEN_OK) {
         registry_manager_free(&registry_manager);
         open_result_print_message(open_result);
@@ -139,7 +161,7 @@ static bool funcionalidade2(char *bin_filename) {
     if (registry_manager_is_empty(registry_manager)) printf("Registro inexistente.\n");
 
     //Senão, exibe todos os registros (usando o callback definido anteriormente)
-    else registry_manager_for_each(registry_manager, _DMForeachCallback_print_register);
+    else registry_manager_parallel_for_each_view_match(registry_manager, NULL, _DMViewCallback_print_register, 0);
 
     //Deleta o RegistryManager, fechando o arquivo e liberando a memoria
     registry_manager_free(&registry_manager);
@@ -167,7 +189,7 @@ static bool funcionalidade3 (char *bin_filename) {
     }
     
     //Abre o arquivo para leitura, caso a abertura não seja bem sucedida, exibe mensagem com o erro e interrompe o fluxo
-    OPEN_RESULT open_result = registry_manager_open(registry_manager, bin_filename, READ);
+    OPEN_RESULT open_result = registry_manager_open(registry_manager, bin_filename, READ_MMAP);
     if (open_result != OPEN_OK) {
         open_result_print_message(open_result);
 
@@ -190,14 +212,23 @@ static bool funcionalidade3 (char *bin_filename) {
         return false;
     }
 
+    //Se houver índices que cubram o filtro, apenas os registros candidatos são lidos (em ordem de RRN, como na varredura)
+    BTreeSecondaryIndexSet *secondary_indexes = b_tree_secondary_index_set_open(bin_filename, registry_manager, READ);
+    int *candidate_RRNs = NULL;
+    int candidate_count = b_tree_query_planner_candidates(secondary_indexes, registry_manager, reg_search_terms, &candidate_RRNs, NULL);
+
     //Execute o callback definido anteriormente na main.c para printar todos os registros que satisfizerem a condição informada pelo usuário
-    int foundRegistersCount = registry_manager_for_each_match(registry_manager, reg_search_terms, _DMForeachCallback_print_register);
+    int foundRegistersCount;
+    if (candidate_count >= 0) foundRegistersCount = registry_manager_for_each_match_at(registry_manager, candidate_RRNs, candidate_count, reg_search_terms, _DMForeachCallback_print_register);
+    else foundRegistersCount = registry_manager_parallel_for_each_view_match(registry_manager, reg_search_terms, _DMViewCallback_print_register, 0);
 
     //Se não houver registros, exibe mensagem conforme especificação do trabalho
     if (foundRegistersCount == 0) printf("Registro Inexistente.\n");
 
     //Desaloca toda a memoria utilizada e fecha o arquivo (efeito colateral de deletar o RegistryManager)
+    free(candidate_RRNs);
     virtual_registry_array_delete(&reg_search_terms);
+    b_tree_secondary_index_set_free(&secondary_indexes);
     registry_manager_free(&registry_manager);
     return true;
 }
@@ -235,7 +266,7 @@ static bool funcionalidade4 (char *bin_filename, char *RRN_str) {
     }
     
     //Abre o arquivo para leitura, caso a abertura não seja bem sucedida, exibe mensagem com o erro e interrompe o fluxo
-    OPEN_RESULT open_result = registry_manager_open(registry_manager, bin_filename, READ);
+    OPEN_RESULT open_result = registry_manager_open(registry_manager, bin_filename, READ_MMAP);
     if (open_result != OPEN_OK) {
         registry_manager_free(&registry_manager);
         open_result_print_message(open_result);
@@ -265,14 +296,25 @@ static bool funcionalidade4 (char *bin_filename, char *RRN_str) {
     return true;
 }
 
+//Usado pela funcionalidade 19: a cada registro removido, remove do índice primário a chave que aponta para ele
+static void _RMChange_remove_b_tree_key(RegistryManager *manager, int RRN, RegistryView *old_view, RegistryView *new_view, void *context) {
+    BTreeManager *btman = (BTreeManager*) context;
+    if (old_view == NULL || new_view != NULL) return;
+
+    //Com idNascimento repetido, o índice aponta para apenas um dos registros: a chave só é removida junto com ele
+    int idNascimento = registry_view_get_idNascimento(*old_view);
+    if (b_tree_manager_search_for(btman, idNascimento).first == RRN) b_tree_manager_delete(btman, idNascimento);
+}
+
 /*
     Funcionalidade 5: deleta registros baseados em filtros dados pelo usuario
     Parâmetros:
         char *bin_filename -> nome do arquivo binario
         char *n_str -> string contendo a quantidade (int) de filtros
+        BTreeManager *btman -> índice primário aberto no modo MODIFY, atualizado a cada remoção (se NULL, é ignorado)
     Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
 */
-static bool funcionalidade5 (char *bin_filename, char *n_str) {
+static bool funcionalidade5 (char *bin_filename, char *n_str, BTreeManager *btman) {
     //Validação de parâmetros
     if (bin_filename == NULL) {
         DP("ERROR: invalid filename @funcionalidade5()\n");
@@ -351,11 +393,21 @@ static bool funcionalidade5 (char *bin_filename, char *n_str) {
     //Libera a memória da lista lidada sem apagar os seus itens pelo mesmo motivo acima
     registry_linked_list_delete(&list, false);
 
-    //Remove os registros que contiverem as informações especificadas (remove os que derem match)
-    registry_manager_remove_matches(registry_manager, reg_arr);
+    //Os índices secundários (se houver) e o primário (se informado) são atualizados a cada remoção
+    BTreeSecondaryIndexSet *secondary_indexes = b_tree_secondary_index_set_open(bin_filename, registry_manager, MODIFY);
+    if (btman != NULL) registry_manager_add_change_callback(registry_manager, _RMChange_remove_b_tree_key, btman);
+
+    //Remove os registros que contiverem as informações especificadas (remove os que derem match).
+    //Se os índices cobrirem todos os filtros, apenas os candidatos obtidos por eles são lidos
+    int *candidate_RRNs = NULL;
+    int candidate_count = b_tree_query_planner_candidates(secondary_indexes, registry_manager, reg_arr, &candidate_RRNs, NULL);
+    if (candidate_count >= 0) registry_manager_remove_matches_at(registry_manager, candidate_RRNs, candidate_count, reg_arr);
+    else registry_manager_remove_matches(registry_manager, reg_arr);
+    free(candidate_RRNs);
 
     //desaloca toda a memoria, fecha o arquivo e seta o status como consistente
     virtual_registry_array_delete(&reg_arr);
+    b_tree_secondary_index_set_free(&secondary_indexes);
     registry_manager_free(&registry_manager);
 
     return true;
@@ -396,6 +448,9 @@ static bool funcionalidade6 (char *bin_filename, char *n_str, Funcionalidade10ca
         return false;
     }
 
+    //Os índices secundários (se houver) são atualizados a cada inserção
+    BTreeSecondaryIndexSet *secondary_indexes = b_tree_secondary_index_set_open(bin_filename, registry_manager, MODIFY);
+
     static char *campos[] = {"cidadeMae","cidadeBebe","idNascimento","idadeMae","dataNascimento","sexoBebe","estadoMae","estadoBebe"}; 
 
     int n = atoi(n_str);
@@ -420,18 +475,89 @@ static bool funcionalidade6 (char *bin_filename, char *n_str, Funcionalidade10ca
         }
     }
 
+    b_tree_secondary_index_set_free(&secondary_indexes);
     registry_manager_free(&registry_manager);    
     return true;
 }
 
+/**
+ *  Alterações de chave do índice primário acumuladas durante as atualizações da funcionalidade 20 (pares idNascimento, RRN),
+ *  aplicadas de uma só vez ao fim: primeiro as remoções e depois as inserções, em lote
+ */
+typedef struct {
+    BTreeManager *btman;
+    pairIntInt *removed, *inserted;
+    int removed_count, inserted_count;
+    int removed_capacity, inserted_capacity;
+} BTreeKeyChanges;
+
+//Adiciona um par a um dos vetores de BTreeKeyChanges, aumentando-o se necessário
+static void _append_key_change(pairIntInt **arr, int *count, int *capacity, int key, int RRN) {
+    if (*count == *capacity) {
+        int new_capacity = (*capacity == 0) ? 64 : 2 * (*capacity);
+        pairIntInt *new_arr = realloc(*arr, sizeof(pairIntInt) * new_capacity);
+        if (new_arr == NULL) {
+            DP("ERROR: not enough memory for key changes @_append_key_change()\n");
+            return;
+        }
+
+        *arr = new_arr;
+        *capacity = new_capacity;
+    }
+
+    (*arr)[*count].first = key;
+    (*arr)[*count].second = RRN;
+    (*count)++;
+}
+
+//Usado pela funcionalidade 20: acumula as alterações de idNascimento de cada registro modificado
+static void _RMChange_collect_b_tree_keys(RegistryManager *manager, int RRN, RegistryView *old_view, RegistryView *new_view, void *context) {
+    BTreeKeyChanges *changes = (BTreeKeyChanges*) context;
+    int old_key = (old_view != NULL) ? registry_view_get_idNascimento(*old_view) : -1;
+    int new_key = (new_view != NULL) ? registry_view_get_idNascimento(*new_view) : -1;
+    if (old_view != NULL && new_view != NULL && old_key == new_key) return;
+
+    if (old_view != NULL) {
+        //Uma chave inserida anteriormente no mesmo lote (o registro foi atualizado mais de uma vez) apenas deixa de ser inserida
+        bool pending = false;
+        for (int i = 0; !pending && i < changes->inserted_count; i++) {
+            if (changes->inserted[i].first != old_key || changes->inserted[i].second != RRN) continue;
+            changes->inserted[i] = changes->inserted[--changes->inserted_count];
+            pending = true;
+        }
+
+        if (!pending) _append_key_change(&changes->removed, &changes->removed_count, &changes->removed_capacity, old_key, RRN);
+    }
+
+    if (new_view != NULL) _append_key_change(&changes->inserted, &changes->inserted_count, &changes->inserted_capacity, new_key, RRN);
+}
+
+//Aplica ao índice primário as alterações acumuladas e libera os vetores
+static void _apply_b_tree_key_changes(BTreeKeyChanges *changes) {
+    //Com idNascimento repetido, o índice aponta para apenas um dos registros: a chave só é removida junto com ele
+    for (int i = 0; i < changes->removed_count; i++) {
+        pairIntInt p = changes->removed[i];
+        if (b_tree_manager_search_for(changes->btman, p.first).first == p.second) b_tree_manager_delete(changes->btman, p.first);
+    }
+
+    if (changes->inserted_count > 0) b_tree_manager_insert_batch(changes->btman, changes->inserted, changes->inserted_count);
+
+    free(changes->removed);
+    free(changes->inserted);
+    changes->removed = changes->inserted = NULL;
+    changes->removed_count = changes->inserted_count = 0;
+    changes->removed_capacity = changes->inserted_capacity = 0;
+}
+
 /*
     Funcionalidade 7: Atualizar um registro pelo seu RRN
     Parâmetros:
         char *bin_filename -> nome do arquivo binario
         char *n_str -> string contendo a quantidade (int) de registros a serem atualizados
+        BTreeManager *btman -> índice primário aberto no modo MODIFY, atualizado quando um idNascimento muda (se NULL, é ignorado)
     Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
 */
-static bool funcionalidade7 (char *bin_filename, char *n_str) {
+static bool funcionalidade7 (char *bin_filename, char *n_str, BTreeManager *btman) {
     //Validação de parâmetros
     if (bin_filename == NULL) {
         DP("ERROR: invalid filename @funcionalidade7()\n");
@@ -461,6 +587,12 @@ static bool funcionalidade7 (char *bin_filename, char *n_str) {
 
     int n = atoi(n_str);
 
+    //Os índices secundários (se houver) são atualizados quando um campo indexado muda.
+    //As alterações de chave do índice primário (se informado) são acumuladas e aplicadas em lote após as atualizações
+    BTreeSecondaryIndexSet *secondary_indexes = b_tree_secondary_index_set_open(bin_filename, registry_manager, MODIFY);
+    BTreeKeyChanges key_changes = { btman, NULL, NULL, 0, 0, 0, 0 };
+    if (btman != NULL) registry_manager_add_change_callback(registry_manager, _RMChange_collect_b_tree_keys, &key_changes);
+
     VirtualRegistryUpdater *reg_updater = NULL;
     int RRN;
     //Atualiza n registros
@@ -480,7 +612,13 @@ static bool funcionalidade7 (char *bin_filename, char *n_str) {
         virtual_registry_free(&reg_updater);
     }
 
+    if (btman != NULL) {
+        registry_manager_remove_change_callback(registry_manager, _RMChange_collect_b_tree_keys, &key_changes);
+        _apply_b_tree_key_changes(&key_changes);
+    }
+
     //Libera o RegistryManager e fecha o arquivo
+    b_tree_secondary_index_set_free(&secondary_indexes);
     registry_manager_free(&registry_manager);
 
     return true;
@@ -511,7 +649,7 @@ static bool funcionalidade8 (char *reg_bin_filename, char *b_tree_filename) {
     }
 
     //Abre o arquivo de registros para leitura, caso a abertura não seja bem sucedida, exibe mensagem com o erro e interrompe o fluxo
-    OPEN_RESULT open_result = registry_manager_open(registry_manager, reg_bin_filename, READ);
+    OPEN_RESULT open_result = registry_manager_open(registry_manager, reg_bin_filename, READ_MMAP);
     if (open_result != OPEN_OK) {
         registry_manager_free(&registry_manager);
         open_result_print_message(open_result);
@@ -557,6 +695,384 @@ static bool funcionalidade8 (char *reg_bin_filename, char *b_tree_filename) {
     return true;
 }
 
+/*
+    Funcao (privada) usada pelas funcionalidades que constroem o índice primário por bulk load (11, 13 e 21):
+    coleta os pares (idNascimento, RRN) de todos os registros não removidos em um ordenador
+    Parametros:
+        reg_bin_filename -> nome do arquivo de registros já existente
+    Retorno:
+        BTreeBulkLoader* -> o ordenador com os pares (deve ser liberado), ou NULL em caso de erro (a mensagem de erro já foi exibida)
+*/
+static BTreeBulkLoader *_collect_primary_keys (char *reg_bin_filename) {
+    //Cria um RegistryManager para ler todos os registros em disco
+    RegistryManager *registry_manager = registry_manager_create();
+    if (registry_manager == NULL) {
+        DP("ERROR: couldn't create RegistryManager @_collect_primary_keys()\n");
+        return NULL;
+    }
+
+    //Abre o arquivo de registros para leitura, caso a abertura não seja bem sucedida, exibe mensagem com o erro e interrompe o fluxo
+    OPEN_RESULT open_result = registry_manager_open(registry_manager, reg_bin_filename, READ_MMAP);
+    if (open_result != OPEN_OK) {
+        registry_manager_free(&registry_manager);
+        open_result_print_message(open_result);
+        return NULL;
+    }
+
+    //Cria o ordenador que receberá os pares (idNascimento, RRN)
+    BTreeBulkLoader *loader = b_tree_bulk_loader_create(B_TREE_BULK_LOAD_RUN_CAPACITY);
+    if (loader == NULL) {
+        DP("ERROR: couldn't create BTreeBulkLoader @_collect_primary_keys()\n");
+        registry_manager_free(&registry_manager);
+        return NULL;
+    }
+
+    //Obtém os headers do arquivo de registros que já está em RAM para fazer o loop
+    RegistryHeader *reg_header = registry_manager_get_registry_header(registry_manager);
+    int registryCount = reg_header_get_registries_count(reg_header);
+    int RRN = -1;
+
+    //Coleta os pares de todos os registros não removidos
+    for (int i = 0; i < registryCount; i++) {
+        RRN++;
+        VirtualRegistry *reg = registry_manager_fetch_at(registry_manager, RRN);
+        if (reg == NULL) {
+            i--;
+            continue;
+        }
+        b_tree_bulk_loader_add(loader, reg->idNascimento, RRN);
+        virtual_registry_free(&reg);
+    }
+
+    registry_manager_free(&registry_manager);
+    return loader;
+}
+
+/**
+ *  Funcionalidade 11: cria um novo índice de arvore-b a partir do arquivo de registros,
+ *  assim como a funcionalidade 8, mas construindo a árvore de baixo para cima (bulk load):
+ *  os pares (idNascimento, RRN) são ordenados (externamente, se não couberem na RAM) e os nós
+ *  são escritos totalmente preenchidos e de forma sequencial, sem buscas nem splits.
+ *  OBS: a árvore gerada é válida, mas sua disposição no arquivo é diferente da gerada pela funcionalidade 8.
+ *  Parâmetros:
+ *      char *reg_bin_filename -> nome do arquivo de registros já existente
+ *      char *b_tree_filename -> nome do arquivo de indices a ser criado
+ *      int page_size -> tamanho das páginas do índice (NODE_SIZE mantém o formato da especificação)
+ *  Retorno:
+ *      bool -> indica se a funcionalidade foi executada com sucesso. 
+ */
+static bool funcionalidade11 (char *reg_bin_filename, char *b_tree_filename, int page_size) {
+    //Validação de parâmetros
+    if (reg_bin_filename == NULL || b_tree_filename == NULL) {
+        DP("ERROR: invalid filename @funcionalidade11()\n");
+        return false;
+    }
+
+    BTreeBulkLoader *loader = _collect_primary_keys(reg_bin_filename);
+    if (loader == NULL) return false;
+
+    //Cria um BTreeManager para gerenciar a btree em disco
+    BTreeManager *b_tree_manager = b_tree_manager_create();
+    if (b_tree_manager == NULL) {
+        DP("ERROR: couldn't create BTreeManager @funcionalidade11()\n");
+        b_tree_bulk_loader_free(&loader);
+        return false;
+    }
+
+    //Com páginas maiores que as da especificação, usa a maior ordem cujos nós cabem em uma página
+    int order = (page_size == NODE_SIZE) ? B_TREE_ORDER : b_tree_manager_order_for_page_size(page_size);
+    if (!b_tree_manager_set_format(b_tree_manager, order, page_size)) {
+        b_tree_manager_free(&b_tree_manager);
+        b_tree_bulk_loader_free(&loader);
+        return false;
+    }
+
+    //Tenta criar um novo arquivo de índices, se ocorrer algum erro, exibir como na especificação
+    OPEN_RESULT open_result = b_tree_manager_open(b_tree_manager, b_tree_filename, CREATE);
+    if (open_result != OPEN_OK) {
+        open_result_print_message(open_result);
+        b_tree_manager_free(&b_tree_manager);
+        b_tree_bulk_loader_free(&loader);
+        return false;
+    }
+
+    //Constrói a árvore com todos os pares coletados
+    bool success = b_tree_manager_bulk_load(b_tree_manager, loader);
+
+    b_tree_bulk_loader_free(&loader);
+    b_tree_manager_free(&b_tree_manager);
+
+    return success;
+}
+
+/**
+ *  Funcionalidade 13: assim como a funcionalidade 11, cria um novo índice de arvore-b por bulk load,
+ *  mas com páginas de tamanho configurável (por exemplo, 4096 bytes, o tamanho de uma página do sistema).
+ *  Cada página guarda um nó da maior ordem que couber nela, o que reduz a altura da árvore e,
+ *  portanto, a quantidade de acessos a disco por busca. O índice gerado pode ser usado pelas funcionalidades 9, 10 e 12.
+ *  Parâmetros:
+ *      char *reg_bin_filename -> nome do arquivo de registros já existente
+ *      char *b_tree_filename -> nome do arquivo de indices a ser criado
+ *      char *page_size_str -> tamanho das páginas, em bytes
+ *  Retorno:
+ *      bool -> indica se a funcionalidade foi executada com sucesso. 
+ */
+static bool funcionalidade13 (char *reg_bin_filename, char *b_tree_filename, char *page_size_str) {
+    //Validação de parâmetros
+    if (page_size_str == NULL) {
+        DP("ERROR: invalid page size @funcionalidade13()\n");
+        return false;
+    }
+
+    //A página deve comportar ao menos um nó da menor ordem aceita
+    int page_size = atoi(page_size_str);
+    if (b_tree_manager_order_for_page_size(page_size) == -1) {
+        printf("Falha no processamento do arquivo.\n");
+        return false;
+    }
+
+    return funcionalidade11(reg_bin_filename, b_tree_filename, page_size);
+}
+
+/**
+ *  Funcionalidade 14: ativa a lista de registros livres de um arquivo de registros.
+ *  Os registros já removidos são encadeados e, a partir de então, as remoções (funcionalidade 5) entram na lista
+ *  e as inserções (funcionalidades 6, 10 e 12) reaproveitam os registros removidos antes de aumentar o arquivo,
+ *  de modo que o tamanho do arquivo e as varreduras acompanhem a quantidade de registros existentes.
+ *  Parâmetros:
+ *      char *bin_filename -> nome do arquivo de registros
+ *  Retorno:
+ *      bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade14 (char *bin_filename) {
+    //Validação de parâmetros
+    if (bin_filename == NULL) {
+        DP("ERROR: invalid filename @funcionalidade14()\n");
+        return false;
+    }
+
+    RegistryManager *registry_manager = registry_manager_create();
+    if (registry_manager == NULL) {
+        DP("ERROR: unable to create RegistryManager @funcionalidade14\n");
+        return false;
+    }
+
+    //Abre o arquivo para escrita, caso a abertura não seja bem sucedida, exibe mensagem com o erro e interrompe o fluxo
+    OPEN_RESULT open_result = registry_manager_open(registry_manager, bin_filename, MODIFY);
+    if (open_result != OPEN_OK) {
+        registry_manager_free(&registry_manager);
+        open_result_print_message(open_result);
+        return false;
+    }
+
+    bool success = registry_manager_enable_free_list(registry_manager);
+    if (!success) printf("Falha no processamento do arquivo.\n");
+
+    registry_manager_free(&registry_manager);
+    return success;
+}
+
+/**
+ *  Mapeia um RRN antigo do arquivo de registros para o RRN após a compactação (usado como callback na reescrita do índice).
+ *  Registros removidos são mapeados para -1, e suas chaves são descartadas do índice.
+ */
+static int compaction_map_RRN (int old_RRN, void *context) {
+    return registry_rrn_map_get((RegistryRRNMap *) context, old_RRN);
+}
+
+//Monta o nome do arquivo temporário escrito pela compactação (ex.: "dados.bin" -> "dados.bin.compact")
+static char *compaction_filename (char *filename) {
+    char *tmp_filename = malloc(strlen(filename) + strlen(".compact") + 1);
+    if (tmp_filename == NULL) return NULL;
+
+    strcpy(tmp_filename, filename);
+    strcat(tmp_filename, ".compact");
+    return tmp_filename;
+}
+
+/**
+ *  Funcionalidade 15: compacta o arquivo de registros, descartando os registros removidos, e reescreve os RRNs
+ *  do arquivo de índices de acordo. Os arquivos novos são escritos ao lado dos atuais (sufixo ".compact") e só então
+ *  substituem os originais (rename), de forma que uma falha no meio do processo não altera os arquivos atuais.
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      char *b_tree_filename -> nome do arquivo de índices
+ *  Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade15 (char *reg_filename, char *b_tree_filename) {
+    //Validação de parâmetros
+    if (reg_filename == NULL || b_tree_filename == NULL) {
+        DP("ERROR: invalid filename @funcionalidade15()\n");
+        return false;
+    }
+
+    BTreeManager *btman = b_tree_manager_create();
+    RegistryManager *regman = registry_manager_create();
+    if (btman == NULL || regman == NULL) {
+        DP("ERROR: couldn't allocate memory for the managers @funcionalidade15()\n");
+        b_tree_manager_free(&btman);
+        registry_manager_free(&regman);
+        return false;
+    }
+
+    //Tenta abrir o arquivo de índices e o arquivo de registros, exibindo as mensagens de erro de acordo
+    OPEN_RESULT o_res = b_tree_manager_open(btman, b_tree_filename, READ);
+    if (o_res == OPEN_OK) o_res = registry_manager_open(regman, reg_filename, READ_MMAP);
+    if (o_res != OPEN_OK) {
+        open_result_print_message(o_res);
+        b_tree_manager_free(&btman);
+        registry_manager_free(&regman);
+        return false;
+    }
+
+    char *reg_tmp_filename = compaction_filename(reg_filename);
+    char *b_tree_tmp_filename = compaction_filename(b_tree_filename);
+
+    //Copia os registros existentes e, com o mapa de RRNs gerado, reescreve os valores do índice
+    RegistryRRNMap *map = registry_rrn_map_create(reg_header_get_next_RRN(registry_manager_get_registry_header(regman)));
+    long reclaimed = registry_manager_compact_to(regman, reg_tmp_filename, map);
+    bool success = reclaimed >= 0 && b_tree_manager_rewrite_values(btman, b_tree_tmp_filename, compaction_map_RRN, map);
+    if (reclaimed >= 0 && !success) remove(reg_tmp_filename);
+
+    registry_rrn_map_free(&map);
+    b_tree_manager_free(&btman);
+    registry_manager_free(&regman);
+
+    //Troca os arquivos. O índice novo continua com status '0' até que o arquivo de registros correspondente esteja no lugar
+    if (success) success = rename(b_tree_tmp_filename, b_tree_filename) == 0;
+    if (success) success = registry_manager_replace_file(reg_tmp_filename, reg_filename);
+    if (success) success = b_tree_manager_mark_file_consistent(b_tree_filename);
+
+    //Os índices secundários guardam RRNs antigos: são reconstruídos a partir do arquivo compactado
+    RegistryFieldsMask secondary_fields = b_tree_secondary_index_list(reg_filename);
+    if (success && secondary_fields != MASK_NONE) {
+        regman = registry_manager_create();
+        success = regman != NULL && registry_manager_open(regman, reg_filename, READ_MMAP) == OPEN_OK;
+        for (int i = 0; success && i < 8; i++)
+            if (secondary_fields & (1 << i)) success = b_tree_secondary_index_build(reg_filename, regman, 1 << i);
+        registry_manager_free(&regman);
+    }
+
+    free(reg_tmp_filename);
+    free(b_tree_tmp_filename);
+
+    if (!success) {
+        printf("Falha no processamento do arquivo.\n");
+        return false;
+    }
+
+    printf("Bytes recuperados: %ld\n", reclaimed);
+    return true;
+}
+
+/**
+ *  Funcionalidade 16: cria (ou recria) um índice secundário sobre um campo que não é a chave (ex.: estadoMae),
+ *  com os arquivos "<arquivo de registros>.<campo>.idx" (árvore-B) e "<arquivo de registros>.<campo>.post" (listas de RRNs).
+ *  A partir de então, o índice é atualizado pelas funcionalidades 5, 6, 7 e 10.
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      char *field_name -> nome do campo a ser indexado
+ *  Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade16 (char *reg_filename, char *field_name) {
+    //Validação de parâmetros
+    if (reg_filename == NULL || field_name == NULL) {
+        DP("ERROR: invalid parameters @funcionalidade16()\n");
+        return false;
+    }
+
+    RegistryFieldsMask field = registry_mask_from_field_name(field_name);
+    if (!b_tree_secondary_index_is_supported(field)) {
+        DP("ERROR: field '%s' can't have a secondary index @funcionalidade16()\n", field_name);
+        printf("Falha no processamento do arquivo.\n");
+        return false;
+    }
+
+    RegistryManager *registry_manager = registry_manager_create();
+    if (registry_manager == NULL) {
+        DP("ERROR: unable to create RegistryManager @funcionalidade16\n");
+        return false;
+    }
+
+    OPEN_RESULT open_result = registry_manager_open(registry_manager, reg_filename, READ_MMAP);
+    if (open_result != OPEN_OK) {
+        registry_manager_free(&registry_manager);
+        open_result_print_message(open_result);
+        return false;
+    }
+
+    bool success = b_tree_secondary_index_build(reg_filename, registry_manager, field);
+    if (!success) printf("Falha no processamento do arquivo.\n");
+
+    registry_manager_free(&registry_manager);
+    return success;
+}
+
+/**
+ *  Funcionalidade 17: assim como a funcionalidade 3, exibe os registros que satisfazem um filtro, mas busca os candidatos
+ *  no índice secundário de um dos campos do filtro (ao invés de percorrer todo o arquivo). Os candidatos são lidos
+ *  em ordem de RRN e comparados com o filtro completo. Ao fim, exibe a quantidade de páginas dos índices acessadas.
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros (o filtro é lido da entrada, como na funcionalidade 3)
+ *  Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade17 (char *reg_filename) {
+    //Validação de parâmetros
+    if (reg_filename == NULL) {
+        DP("ERROR: invalid filename @funcionalidade17()\n");
+        return false;
+    }
+
+    RegistryManager *registry_manager = registry_manager_create();
+    if (registry_manager == NULL) {
+        DP("ERROR: unable to create RegistryManager @funcionalidade17\n");
+        return false;
+    }
+
+    OPEN_RESULT open_result = registry_manager_open(registry_manager, reg_filename, READ_MMAP);
+    if (open_result != OPEN_OK) {
+        registry_manager_free(&registry_manager);
+        open_result_print_message(open_result);
+        return false;
+    }
+
+    VirtualRegistryFilter *filter = virtual_registry_create_from_input(false);
+    BTreeSecondaryIndexSet *secondary_indexes = b_tree_secondary_index_set_open(reg_filename, registry_manager, READ);
+
+    //Usa o índice do primeiro campo do filtro que tiver um
+    BTreeSecondaryIndex *index = NULL;
+    RegistryFieldsMask field = MASK_NONE;
+    for (int i = 0; filter != NULL && index == NULL && i < 8; i++) {
+        field = 1 << i;
+        if (virtual_registry_get_fieldmask(filter) & field) index = b_tree_secondary_index_set_get(secondary_indexes, field);
+    }
+
+    int *RRNs = NULL, pages = 0;
+    int count = (index != NULL) ? b_tree_secondary_index_search(index, b_tree_secondary_index_key_of_filter(field, filter), &RRNs, &pages) : -1;
+    if (count < 0) {
+        printf("Falha no processamento do arquivo.\n");
+    } else {
+        int found = 0;
+        for (int i = 0; i < count; i++) {
+            VirtualRegistry *reg = registry_manager_fetch_at(registry_manager, RRNs[i]);
+            if (reg != NULL && virtual_registry_compare(reg, filter)) {
+                virtual_registry_print(reg);
+                found++;
+            }
+            virtual_registry_free(&reg);
+        }
+
+        if (found == 0) printf("Registro Inexistente.\n");
+        printf("Quantidade de paginas dos indices acessadas: %d\n", pages);
+    }
+
+    free(RRNs);
+    virtual_registry_free(&filter);
+    b_tree_secondary_index_set_free(&secondary_indexes);
+    registry_manager_free(&registry_manager);
+    return count >= 0;
+}
+
 /**
  *  Funcionalidade 9: busca um registro por seu RRN e o exibe na tela.
  *  a busca é feita em um arquivo de índices de registros (árvore-B).
@@ -614,7 +1130,7 @@ static bool funcionalidade9 (char *reg_filename, char *b_tree_filename, char *se
         return false;
     }
 
-    o_res = registry_manager_open(regman, reg_filename, READ);
+    o_res = registry_manager_open(regman, reg_filename, READ_MMAP);
     if (o_res != OPEN_OK) {
         open_result_print_message(o_res);
         b_tree_manager_free(&btman);
@@ -646,8 +1162,379 @@ static bool funcionalidade9 (char *reg_filename, char *b_tree_filename, char *se
     return true;
 }
 
-//Callback usado pela funcionalidade 10 para indicar para a funcionalidade6 o que deve ser feito após cada inserção
-static void insertInBtreeCallback (Funcionalidade10callbackInfo *info) {
+//Quantidade de itens da árvore-B lidos por lote na funcionalidade 18 (os registros de cada lote são lidos em ordem de RRN)
+#define RANGE_BATCH_SIZE 512
+
+//Ordena os itens de um lote da funcionalidade 18 por RRN (first)
+static int _compare_batch_RRNs (const void *a, const void *b) {
+    int RRN1 = ((const pairIntInt *) a)->first, RRN2 = ((const pairIntInt *) b)->first;
+    return (RRN1 > RRN2) - (RRN1 < RRN2);
+}
+
+/*
+    Funcao (privada) usada pelas buscas por intervalo (funcionalidades 18 e 22): lê os registros de um lote
+    em ordem de RRN (acesso sequencial ao arquivo de dados) e os exibe em ordem de chave
+    Parametros:
+        regman -> gerenciador com o arquivo de registros aberto
+        batch -> itens do lote (first: RRN, second: posição em ordem de chave), reordenados pela função
+        registries -> vetor auxiliar com espaço para count registros
+        count -> quantidade de itens do lote
+    Retorno:
+        int -> quantidade de registros exibidos
+*/
+static int _print_range_batch (RegistryManager *regman, pairIntInt *batch, VirtualRegistry **registries, int count) {
+    //Lê os registros em ordem de RRN, guardando cada um na posição do seu item
+    qsort(batch, count, sizeof(pairIntInt), _compare_batch_RRNs);
+    for (int i = 0; i < count; i++)
+        registries[batch[i].second] = registry_manager_fetch_at(regman, batch[i].first);
+
+    //Exibe os registros em ordem de chave (itens que apontam para registros removidos são ignorados)
+    int printed = 0;
+    for (int i = 0; i < count; i++) {
+        if (registries[i] != NULL) {
+            virtual_registry_print(registries[i]);
+            printed++;
+        }
+        virtual_registry_free(&registries[i]);
+    }
+
+    return printed;
+}
+
+/**
+ *  Funcionalidade 18: busca por intervalo no índice primário. Exibe, em ordem de idNascimento, os registros
+ *  com idNascimento no intervalo [min, max]. Os itens da árvore-B são percorridos com um cursor e, a cada lote,
+ *  os registros são lidos em ordem de RRN (acesso sequencial ao arquivo de dados) e exibidos em ordem de chave.
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      char *b_tree_filename -> nome do arquivo de índices
+ *      char *min_str, char *max_str -> limites (int) do intervalo, inclusivos
+ *  Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade18 (char *reg_filename, char *b_tree_filename, char *min_str, char *max_str) {
+    //Validação de parâmetros
+    if (reg_filename == NULL || b_tree_filename == NULL || min_str == NULL || max_str == NULL) {
+        DP("Invalid arguments @funcionalidade18()\n");
+        return false;
+    }
+
+    int min = atoi(min_str), max = atoi(max_str);
+
+    BTreeManager *btman = b_tree_manager_create();
+    RegistryManager *regman = registry_manager_create();
+    if (btman == NULL || regman == NULL) {
+        DP("ERROR: couldn't allocate memory for managers @funcionalidade18()\n");
+        b_tree_manager_free(&btman);
+        registry_manager_free(&regman);
+        return false;
+    }
+
+    //Tenta abrir o arquivo de índices e o arquivo de registros, exibindo as mensagens de erro de acordo
+    OPEN_RESULT o_res = b_tree_manager_open(btman, b_tree_filename, READ);
+    if (o_res == OPEN_OK) o_res = registry_manager_open(regman, reg_filename, READ_MMAP);
+    if (o_res != OPEN_OK) {
+        open_result_print_message(o_res);
+        b_tree_manager_free(&btman);
+        registry_manager_free(&regman);
+        return false;
+    }
+
+    BTreeCursor *cursor = b_tree_cursor_create(btman);
+    pairIntInt *batch = malloc(RANGE_BATCH_SIZE * sizeof(pairIntInt));
+    VirtualRegistry **registries = malloc(RANGE_BATCH_SIZE * sizeof(VirtualRegistry *));
+    if (cursor == NULL || batch == NULL || registries == NULL) {
+        DP("ERROR: not enough memory @funcionalidade18()\n");
+        b_tree_cursor_free(&cursor);
+        free(batch);
+        free(registries);
+        b_tree_manager_free(&btman);
+        registry_manager_free(&regman);
+        return false;
+    }
+
+    int found = 0;
+    bool valid = b_tree_cursor_seek(cursor, min);
+    while (valid && b_tree_cursor_get(cursor).first <= max) {
+        //Lê o próximo lote de itens do intervalo (first: RRN, second: posição em ordem de chave)
+        int count = 0;
+        while (valid && count < RANGE_BATCH_SIZE && b_tree_cursor_get(cursor).first <= max) {
+            batch[count].first = b_tree_cursor_get(cursor).second;
+            batch[count].second = count;
+            count++;
+            valid = b_tree_cursor_next(cursor);
+        }
+
+        found += _print_range_batch(regman, batch, registries, count);
+    }
+
+    if (found == 0) printf("Registro inexistente.\n");
+    printf("Quantidade de paginas da arvore-B acessadas: %d\n", b_tree_cursor_get_pages(cursor));
+
+    b_tree_cursor_free(&cursor);
+    free(batch);
+    free(registries);
+    b_tree_manager_free(&btman);
+    registry_manager_free(&regman);
+    return true;
+}
+
+/**
+ *  Funcionalidade 21: cria um índice primário em árvore-B+ (ver b_plus_tree_manager.h) a partir do arquivo de registros,
+ *  por bulk load, assim como a funcionalidade 13. As folhas guardam os pares (idNascimento, RRN) e são encadeadas,
+ *  e os nós internos guardam apenas separadores, o que aumenta a quantidade de filhos por página.
+ *  A funcionalidade 23 cria o mesmo índice com páginas compactadas. O índice gerado é usado pela funcionalidade 22.
+ *  Parâmetros:
+ *      char *reg_bin_filename -> nome do arquivo de registros já existente
+ *      char *b_plus_tree_filename -> nome do arquivo de indices a ser criado
+ *      char *page_size_str -> tamanho das páginas, em bytes
+ *      bool packed -> indica se as páginas são compactadas (funcionalidade 23)
+ *  Retorno:
+ *      bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade21 (char *reg_bin_filename, char *b_plus_tree_filename, char *page_size_str, bool packed) {
+    //Validação de parâmetros
+    if (reg_bin_filename == NULL || b_plus_tree_filename == NULL || page_size_str == NULL) {
+        DP("ERROR: invalid parameters @funcionalidade21()\n");
+        return false;
+    }
+
+    //A página deve comportar ao menos um nó da menor ordem aceita
+    int page_size = atoi(page_size_str);
+    int order = packed ? b_plus_tree_manager_packed_order_for_page_size(page_size) : b_plus_tree_manager_order_for_page_size(page_size);
+    if (order == -1) {
+        printf("Falha no processamento do arquivo.\n");
+        return false;
+    }
+
+    BTreeBulkLoader *loader = _collect_primary_keys(reg_bin_filename);
+    if (loader == NULL) return false;
+
+    BPlusTreeManager *manager = b_plus_tree_manager_create();
+    if (manager == NULL || !b_plus_tree_manager_set_page_size(manager, page_size) || !b_plus_tree_manager_set_packed(manager, packed)) {
+        DP("ERROR: couldn't create BPlusTreeManager @funcionalidade21()\n");
+        b_plus_tree_manager_free(&manager);
+        b_tree_bulk_loader_free(&loader);
+        return false;
+    }
+
+    //Tenta criar um novo arquivo de índices, se ocorrer algum erro, exibir como na especificação
+    OPEN_RESULT open_result = b_plus_tree_manager_open(manager, b_plus_tree_filename, CREATE);
+    if (open_result != OPEN_OK) {
+        open_result_print_message(open_result);
+        b_plus_tree_manager_free(&manager);
+        b_tree_bulk_loader_free(&loader);
+        return false;
+    }
+
+    bool success = b_plus_tree_manager_bulk_load(manager, loader);
+
+    b_tree_bulk_loader_free(&loader);
+    b_plus_tree_manager_free(&manager);
+    return success;
+}
+
+/**
+ *  Funcionalidade 22: busca por intervalo no índice primário em árvore-B+ (criado pela funcionalidade 21 ou 23), com a mesma
+ *  saída da funcionalidade 18. Após a descida até a primeira folha do intervalo, os itens são lidos seguindo as
+ *  ligações entre as folhas, sem voltar aos nós internos. Um intervalo de uma só chave é uma busca pontual, que nas
+ *  páginas compactadas é feita sem descompactá-las.
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      char *b_plus_tree_filename -> nome do arquivo de índices
+ *      char *min_str, char *max_str -> limites (int) do intervalo, inclusivos
+ *  Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade22 (char *reg_filename, char *b_plus_tree_filename, char *min_str, char *max_str) {
+    //Validação de parâmetros
+    if (reg_filename == NULL || b_plus_tree_filename == NULL || min_str == NULL || max_str == NULL) {
+        DP("Invalid arguments @funcionalidade22()\n");
+        return false;
+    }
+
+    int min = atoi(min_str), max = atoi(max_str);
+
+    BPlusTreeManager *bpman = b_plus_tree_manager_create();
+    RegistryManager *regman = registry_manager_create();
+    if (bpman == NULL || regman == NULL) {
+        DP("ERROR: couldn't allocate memory for managers @funcionalidade22()\n");
+        b_plus_tree_manager_free(&bpman);
+        registry_manager_free(&regman);
+        return false;
+    }
+
+    //Tenta abrir o arquivo de índices e o arquivo de registros, exibindo as mensagens de erro de acordo
+    OPEN_RESULT o_res = b_plus_tree_manager_open(bpman, b_plus_tree_filename, READ);
+    if (o_res == OPEN_OK) o_res = registry_manager_open(regman, reg_filename, READ_MMAP);
+    if (o_res != OPEN_OK) {
+        open_result_print_message(o_res);
+        b_plus_tree_manager_free(&bpman);
+        registry_manager_free(&regman);
+        return false;
+    }
+
+    BPlusTreeCursor *cursor = b_plus_tree_cursor_create(bpman);
+    pairIntInt *batch = malloc(RANGE_BATCH_SIZE * sizeof(pairIntInt));
+    VirtualRegistry **registries = malloc(RANGE_BATCH_SIZE * sizeof(VirtualRegistry *));
+    if (cursor == NULL || batch == NULL || registries == NULL) {
+        DP("ERROR: not enough memory @funcionalidade22()\n");
+        b_plus_tree_cursor_free(&cursor);
+        free(batch);
+        free(registries);
+        b_plus_tree_manager_free(&bpman);
+        registry_manager_free(&regman);
+        return false;
+    }
+
+    int found = 0, pages = 0;
+    bool valid = false;
+    if (min == max) {
+        pairIntInt p = b_plus_tree_manager_search_for(bpman, min);
+        pages = p.second;
+        if (p.first != -1) {
+            batch[0].first = p.first;
+            batch[0].second = 0;
+            found = _print_range_batch(regman, batch, registries, 1);
+        }
+    } else {
+        valid = b_plus_tree_cursor_seek(cursor, min);
+    }
+
+    while (valid && b_plus_tree_cursor_get(cursor).first <= max) {
+        //Lê o próximo lote de itens do intervalo (first: RRN, second: posição em ordem de chave)
+        int count = 0;
+        while (valid && count < RANGE_BATCH_SIZE && b_plus_tree_cursor_get(cursor).first <= max) {
+            batch[count].first = b_plus_tree_cursor_get(cursor).second;
+            batch[count].second = count;
+            count++;
+            valid = b_plus_tree_cursor_next(cursor);
+        }
+
+        found += _print_range_batch(regman, batch, registries, count);
+    }
+
+    if (found == 0) printf("Registro inexistente.\n");
+    printf("Quantidade de paginas da arvore-B acessadas: %d\n", pages + b_plus_tree_cursor_get_pages(cursor));
+
+    b_plus_tree_cursor_free(&cursor);
+    free(batch);
+    free(registries);
+    b_plus_tree_manager_free(&bpman);
+    registry_manager_free(&regman);
+    return true;
+}
+
+/**
+ *  Funcionalidade 24: constrói (ou reconstrói) a cópia colunar do arquivo de registros, "<arquivo de registros>.cols"
+ *  (ver registry_column_store.h). A partir de então, ela é mantida pelas funcionalidades que modificam o arquivo e
+ *  usada pelas buscas sem índice (funcionalidades 3 e 5) e pela funcionalidade 25.
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *  Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade24 (char *reg_filename) {
+    //Validação de parâmetros
+    if (reg_filename == NULL) {
+        DP("ERROR: invalid parameters @funcionalidade24()\n");
+        return false;
+    }
+
+    RegistryManager *registry_manager = registry_manager_create();
+    if (registry_manager == NULL) {
+        DP("ERROR: unable to create RegistryManager @funcionalidade24\n");
+        return false;
+    }
+
+    OPEN_RESULT open_result = registry_manager_open(registry_manager, reg_filename, READ_MMAP);
+    if (open_result != OPEN_OK) {
+        registry_manager_free(&registry_manager);
+        open_result_print_message(open_result);
+        return false;
+    }
+
+    bool success = registry_manager_build_column_store(registry_manager);
+    if (!success) printf("Falha no processamento do arquivo.\n");
+
+    registry_manager_free(&registry_manager);
+    return success;
+}
+
+/**
+ *  Funcionalidade 25: conta os registros que satisfazem um filtro (lido da entrada, como na funcionalidade 3) por valor
+ *  de um campo, exibindo uma linha "<valor>: <quantidade>" por valor, em ordem crescente. Usa a cópia colunar do
+ *  arquivo, lendo apenas as colunas dos campos do filtro e do campo agrupado (se ela não existir, é construída antes).
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      char *field_name -> nome do campo agrupado
+ *  Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade25 (char *reg_filename, char *field_name) {
+    //Validação de parâmetros
+    if (reg_filename == NULL || field_name == NULL) {
+        DP("ERROR: invalid parameters @funcionalidade25()\n");
+        return false;
+    }
+
+    RegistryFieldsMask field = registry_mask_from_field_name(field_name);
+    if (field == MASK_NONE) {
+        printf("Falha no processamento do arquivo.\n");
+        return false;
+    }
+
+    RegistryManager *registry_manager = registry_manager_create();
+    if (registry_manager == NULL) {
+        DP("ERROR: unable to create RegistryManager @funcionalidade25\n");
+        return false;
+    }
+
+    OPEN_RESULT open_result = registry_manager_open(registry_manager, reg_filename, READ_MMAP);
+    if (open_result != OPEN_OK) {
+        registry_manager_free(&registry_manager);
+        open_result_print_message(open_result);
+        return false;
+    }
+
+    //Lê o filtro (campos não informados são ignorados) e o coloca em um vetor unitário
+    VirtualRegistry *search_sample_registry = virtual_registry_create_from_input(false);
+    VirtualRegistryArray *reg_search_terms = (search_sample_registry != NULL) ? virtual_registry_array_create_unique(search_sample_registry) : NULL;
+    if (reg_search_terms == NULL) {
+        DP("ERROR: couldn't get registry filters from user @funcionalidade25\n");
+        registry_manager_free(&registry_manager);
+        return false;
+    }
+
+    RegistryColumnStore *columns = registry_manager_get_column_store(registry_manager);
+    if (columns == NULL && registry_manager_build_column_store(registry_manager)) columns = registry_manager_get_column_store(registry_manager);
+
+    uint8_t *selection = (columns != NULL) ? malloc(registry_column_store_get_count(columns) + 1) : NULL;
+    RegistryColumnGroup *groups = NULL;
+    int group_count = -1;
+    if (selection != NULL && registry_column_store_filter(columns, reg_search_terms, selection) >= 0)
+        group_count = registry_column_store_count_by(columns, selection, field, &groups);
+
+    if (group_count < 0) printf("Falha no processamento do arquivo.\n");
+    else if (group_count == 0) printf("Registro Inexistente.\n");
+
+    for (int i = 0; i < group_count; i++) {
+        if (field == MASK_SEXOBEBE) printf("%s", parse_sexoBebe_for_print((char) groups[i].number));
+        else if (field & (MASK_IDNASCIMENTO | MASK_IDADEMAE)) {
+            if (groups[i].number == -1) printf("-");
+            else printf("%d", groups[i].number);
+        } else {
+            if (groups[i].text.size == 0) printf("-");
+            else printf("%.*s", groups[i].text.size, groups[i].text.data);
+        }
+        printf(": %d\n", groups[i].count);
+    }
+
+    free(groups);
+    free(selection);
+    virtual_registry_array_delete(&reg_search_terms);
+    registry_manager_free(&registry_manager);
+    return group_count >= 0;
+}
+
+//Callback usado pela funcionalidade 10 para indicar para a funcionalidade6 o que deve ser feito após cada inserção
+static void insertInBtreeCallback (Funcionalidade10callbackInfo *info) {
     b_tree_manager_insert(info->btman, info->idNascimento, info->RRN);
 }
 
@@ -685,6 +1572,9 @@ static bool funcionalidade10(char *reg_filename, char *b_tree_filename, char *n_
     //Valores inválidos (não são utilizados)
     extensionInfo.idNascimento = -1;
     extensionInfo.RRN = -1;
+    extensionInfo.batch = NULL;
+    extensionInfo.batch_size = 0;
+    extensionInfo.batch_capacity = 0;
 
     //Chama a funcionalidade 6 (inserir no arquivo de registros), passando um callback (a cada inserção, o callback é chamado)
     bool success = funcionalidade6(reg_filename, n_str, &extensionInfo);
@@ -693,6 +1583,128 @@ static bool funcionalidade10(char *reg_filename, char *b_tree_filename, char *n_
 }
 
 
+/**
+ *  Funcionalidade 19: assim como a funcionalidade 10 estende a 6, executa a funcionalidade 5 (remoção) removendo também
+ *  do índice primário as chaves dos registros removidos, na mesma passagem pelo arquivo de registros
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      char *b_tree_filename -> nome do arquivo de índices
+ *      char *n_str -> string contendo a quantidade (int) de filtros
+ *  Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade19(char *reg_filename, char *b_tree_filename, char *n_str) {
+    BTreeManager *btman = b_tree_manager_create();
+    if (btman == NULL) {
+        DP("ERROR: couldn't allocate memory for BTreeManager @funcionalidade19()\n");
+        return false;
+    }
+
+    OPEN_RESULT o_res = b_tree_manager_open(btman, b_tree_filename, MODIFY);
+    if (o_res != OPEN_OK) {
+        open_result_print_message(o_res);
+        b_tree_manager_free(&btman);
+        return false;
+    }
+
+    bool success = funcionalidade5(reg_filename, n_str, btman);
+    b_tree_manager_free(&btman);
+    return success;
+}
+
+/**
+ *  Funcionalidade 20: executa a funcionalidade 7 (atualização) mantendo o índice primário: as chaves cujo idNascimento
+ *  mudou são removidas e as novas são inseridas, em lote, ao fim das atualizações (sem reconstruir o índice)
+ *  Parâmetros:
+ *      char *reg_filename -> nome do arquivo de registros
+ *      char *b_tree_filename -> nome do arquivo de índices
+ *      char *n_str -> string contendo a quantidade (int) de registros a serem atualizados
+ *  Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade20(char *reg_filename, char *b_tree_filename, char *n_str) {
+    BTreeManager *btman = b_tree_manager_create();
+    if (btman == NULL) {
+        DP("ERROR: couldn't allocate memory for BTreeManager @funcionalidade20()\n");
+        return false;
+    }
+
+    OPEN_RESULT o_res = b_tree_manager_open(btman, b_tree_filename, MODIFY);
+    if (o_res != OPEN_OK) {
+        open_result_print_message(o_res);
+        b_tree_manager_free(&btman);
+        return false;
+    }
+
+    bool success = funcionalidade7(reg_filename, n_str, btman);
+    b_tree_manager_free(&btman);
+    return success;
+}
+
+//Callback usado pela funcionalidade 12: apenas acumula o par (idNascimento, RRN), que será inserido no índice depois, em lote
+static void appendToBatchCallback (Funcionalidade10callbackInfo *info) {
+    if (info->batch_size == info->batch_capacity) {
+        int new_capacity = (info->batch_capacity == 0) ? 64 : 2 * info->batch_capacity;
+        pairIntInt *new_batch = realloc(info->batch, sizeof(pairIntInt) * new_capacity);
+        if (new_batch == NULL) {
+            DP("ERROR: not enough memory for insertion batch @appendToBatchCallback()\n");
+            return;
+        }
+
+        info->batch = new_batch;
+        info->batch_capacity = new_capacity;
+    }
+
+    info->batch[info->batch_size].first = info->idNascimento;
+    info->batch[info->batch_size].second = info->RRN;
+    info->batch_size++;
+}
+
+/**
+ *  Funcionalidade 12: igual à funcionalidade 10, mas as chaves dos registros inseridos são acumuladas e
+ *  inseridas no índice de uma só vez (b_tree_manager_insert_batch), em ordem crescente, compartilhando
+ *  a descida na árvore entre chaves vizinhas.
+ *  OBS: o índice resultante é válido, mas seu formato pode ser diferente do gerado pela funcionalidade 10
+ *  Parâmetros:
+ *    char *reg_filename -> nome do arquivo de registros.
+ *    char *b_tree_filename -> nome do arquivo de índices.
+ *    char *n_str -> quantidade de registros a serem inseridos
+ *  Retorno: bool -> indica se a funcionalidade foi executada com sucesso.
+ */
+static bool funcionalidade12(char *reg_filename, char *b_tree_filename, char *n_str) {
+    //Tenta criar um gerenciador da btree
+    BTreeManager *btman = b_tree_manager_create();
+    if (btman == NULL) {
+        DP("ERROR: couldn't allocate memory for BTreeManager\n");
+        return false;
+    }
+
+    //Tenta abrir o arquivo de índices, se não conseguir, exibe mensagem correspondente
+    OPEN_RESULT o_res = b_tree_manager_open(btman, b_tree_filename, MODIFY);
+    if (o_res != OPEN_OK) {
+        open_result_print_message(o_res);
+        b_tree_manager_free(&btman);
+        return false;
+    }
+
+    //A cada inserção no arquivo de registros, o par (idNascimento, RRN) é apenas acumulado
+    Funcionalidade10callbackInfo extensionInfo;
+    extensionInfo.btman = btman;
+    extensionInfo.callback = appendToBatchCallback;
+    extensionInfo.idNascimento = -1;
+    extensionInfo.RRN = -1;
+    extensionInfo.batch = NULL;
+    extensionInfo.batch_size = 0;
+    extensionInfo.batch_capacity = 0;
+
+    bool success = funcionalidade6(reg_filename, n_str, &extensionInfo);
+
+    //Insere todas as chaves no índice em uma única passada
+    if (success) b_tree_manager_insert_batch(btman, extensionInfo.batch, extensionInfo.batch_size);
+
+    free(extensionInfo.batch);
+    b_tree_manager_free(&btman);
+    return success;
+}
+
 /**
  *  Inicializa um vetor de parâmetros lidos do stdin
  *  Parâmetros:
@@ -793,7 +1805,7 @@ int main(void) {
 
         case 5: {
             params = prompt_params(2);
-            bool success = funcionalidade5(params[0], params[1]);
+            bool success = funcionalidade5(params[0], params[1], NULL);
             if (success) binarioNaTela(params[0]);
             free_params(&params, 2);
             break;
@@ -809,7 +1821,7 @@ int main(void) {
         
         case 7: {
             params = prompt_params(2);
-            bool success = funcionalidade7(params[0], params[1]);
+            bool success = funcionalidade7(params[0], params[1], NULL);
             if (success) binarioNaTela(params[0]);
             free_params(&params, 2);
             break;
@@ -838,6 +1850,134 @@ int main(void) {
             break;
         }
 
+        case 11: {
+            params = prompt_params(2);
+            bool success = funcionalidade11(params[0], params[1], NODE_SIZE);
+            if (success) binarioNaTela(params[1]);
+            free_params(&params, 2);
+            break;
+        }
+
+        case 12: {
+            params = prompt_params(3);
+            bool success = funcionalidade12(params[0], params[1], params[2]);
+            if (success) binarioNaTela(params[1]);
+            free_params(&params, 3);
+            break;
+        }
+
+        case 13: {
+            params = prompt_params(3);
+            bool success = funcionalidade13(params[0], params[1], params[2]);
+            if (success) binarioNaTela(params[1]);
+            free_params(&params, 3);
+            break;
+        }
+
+        case 14: {
+            params = prompt_params(1);
+            bool success = funcionalidade14(params[0]);
+            if (success) binarioNaTela(params[0]);
+            free_params(&params, 1);
+            break;
+        }
+
+        case 15: {
+            params = prompt_params(2);
+            bool success = funcionalidade15(params[0], params[1]);
+            if (success) {
+                binarioNaTela(params[0]);
+                binarioNaTela(params[1]);
+            }
+            free_params(&params, 2);
+            break;
+        }
+
+        case 16: {
+            params = prompt_params(2);
+            bool success = funcionalidade16(params[0], params[1]);
+            if (success) {
+                char *index_filename = b_tree_secondary_index_filename(params[0], registry_mask_from_field_name(params[1]));
+                binarioNaTela(index_filename);
+                free(index_filename);
+            }
+            free_params(&params, 2);
+            break;
+        }
+
+        case 17: {
+            params = prompt_params(1);
+            funcionalidade17(params[0]);
+            free_params(&params, 1);
+            break;
+        }
+
+        case 18: {
+            params = prompt_params(4);
+            funcionalidade18(params[0], params[1], params[2], params[3]);
+            free_params(&params, 4);
+            break;
+        }
+
+        case 19: {
+            params = prompt_params(3);
+            bool success = funcionalidade19(params[0], params[1], params[2]);
+            if (success) {
+                binarioNaTela(params[0]);
+                binarioNaTela(params[1]);
+            }
+            free_params(&params, 3);
+            break;
+        }
+
+        case 20: {
+            params = prompt_params(3);
+            bool success = funcionalidade20(params[0], params[1], params[2]);
+            if (success) {
+                binarioNaTela(params[0]);
+                binarioNaTela(params[1]);
+            }
+            free_params(&params, 3);
+            break;
+        }
+
+        case 21: {
+            params = prompt_params(3);
+            bool success = funcionalidade21(params[0], params[1], params[2], false);
+            if (success) binarioNaTela(params[1]);
+            free_params(&params, 3);
+            break;
+        }
+
+        case 22: {
+            params = prompt_params(4);
+            funcionalidade22(params[0], params[1], params[2], params[3]);
+            free_params(&params, 4);
+            break;
+        }
+
+        case 23: {
+            params = prompt_params(3);
+            bool success = funcionalidade21(params[0], params[1], params[2], true);
+            if (success) binarioNaTela(params[1]);
+            free_params(&params, 3);
+            break;
+        }
+
+        case 24: {
+            params = prompt_params(1);
+            funcionalidade24(params[0]);
+            free_params(&params, 1);
+            break;
+        }
+
+        case 25: {
+            params = prompt_params(2);
+            funcionalidade25(params[0], params[1]);
+            free_params(&params, 2);
+            break;
+        }
+
         default:
             printf("Funcionalidade %c não implementada.\n", funcionalidade_code);
             break;
@@ -2,6 +2,7 @@
 #include "string_utils.h"
 #include "registry_utils.h"
 #include "binary_registry.h"
+#include "binary_io.h"
 
 
 #include <stdlib.h>
@@ -76,6 +77,38 @@ VirtualRegistry *virtual_registry_create_masked(RegistryFieldsMask mask) {
     return reg_data;
 }
 
+/**
+ *  Funçao que aloca um registro cheio cujos campos de texto já possuem espaço para o maior valor possível.
+ *  Usado como destino de binary_decode_registry_into(), que reaproveita esses buffers a cada registro lido,
+ *  evitando alocações durante varreduras do arquivo.
+ *  OBS: os campos de texto não devem ser substituídos (ex.: por registry_prepare_for_write()), senão o tamanho dos buffers deixa de ser garantido.
+ *  Parametros:
+ *      nao há parametros
+ *  Retorno:
+ *      VirtualRegistry* -> Um ponteiro da struct criada, ou NULL em caso de erro
+ */
+VirtualRegistry *virtual_registry_create_buffered() {
+    VirtualRegistry *reg_data = virtual_registry_create();
+    if (reg_data == NULL) return NULL;
+
+    //Os campos variáveis dividem o espaço restante do registro, após seus tamanhos (2 ints)
+    int max_city_size = REG_VARIABLE_FIELDS_TOTAL_SIZE - 2 * sizeof(int);
+
+    reg_data->cidadeMae = calloc(max_city_size + 1, sizeof(char));
+    reg_data->cidadeBebe = calloc(max_city_size + 1, sizeof(char));
+    reg_data->dataNascimento = calloc(10 + 1, sizeof(char));
+    reg_data->estadoMae = calloc(2 + 1, sizeof(char));
+    reg_data->estadoBebe = calloc(2 + 1, sizeof(char));
+
+    if (reg_data->cidadeMae == NULL || reg_data->cidadeBebe == NULL || reg_data->dataNascimento == NULL || reg_data->estadoMae == NULL || reg_data->estadoBebe == NULL) {
+        DP("ERROR: Insuficient memory on virtual_registry_create_buffered()\n");
+        virtual_registry_free(&reg_data);
+        return NULL;
+    }
+
+    return reg_data;
+}
+
 /*
     Funcao para desalocar a memoria da struct
     Parametros:
@@ -0,0 +1,783 @@
+#include "registry_column_store.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary_registry.h"
+#include "debug.h"
+
+//Identifica o arquivo auxiliar (seguido pelo próximo RRN e pelas quantidades de registros, de removidos e de atualizados
+//do arquivo de registros)
+#define COLUMN_STORE_MAGIC "RCS2"
+
+//Tamanho da coluna de dataNascimento, por registro
+#define DATANASCIMENTO_SIZE 10
+
+/*
+    Dicionário de strings: cada valor distinto recebe um código (a sua posição), e a tabela de dispersão
+    (endereçamento aberto) encontra o código de um valor
+*/
+typedef struct {
+    char *pool;             //Bytes de todos os valores, em sequência
+    int pool_size, pool_capacity;
+    int *offsets, *sizes;   //Início de cada valor em pool e o seu tamanho
+    int count, capacity;
+    int *table;             //código+1 de cada posição da tabela (0 = posição vazia)
+    int table_size;         //Potência de 2
+} _dictionary;
+
+/*
+    Struct que representa as colunas. Os vetores crescem conforme registros são definidos além da capacidade atual
+*/
+struct _registry_column_store {
+    int count;              //Quantidade de linhas (RRNs) das colunas
+    int capacity;
+    bool valid;             //false se algum dicionário transbordou (as colunas deixam de corresponder ao arquivo)
+
+    uint8_t *live;          //1 se o registro existe, 0 se foi removido
+    int *idNascimento;
+    int *idadeMae;
+    char *dataNascimento;   //DATANASCIMENTO_SIZE bytes por registro, completados com '\0'
+    char *sexoBebe;
+    uint16_t *cidadeMae, *cidadeBebe;   //Códigos no dicionário de cidades
+    uint16_t *estadoMae, *estadoBebe;   //Códigos no dicionário de estados
+
+    _dictionary cities, states;
+};
+
+//Hash FNV-1a de um valor
+static unsigned int _hash(const char *data, int size) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < size; i++) {
+        hash ^= (unsigned char) data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void _dictionary_free(_dictionary *dict) {
+    free(dict->pool);
+    free(dict->offsets);
+    free(dict->sizes);
+    free(dict->table);
+    memset(dict, 0, sizeof(_dictionary));
+}
+
+//Insere um código na tabela de dispersão (que deve ter espaço livre)
+static void _dictionary_place(_dictionary *dict, int code) {
+    unsigned int mask = dict->table_size - 1;
+    unsigned int slot = _hash(dict->pool + dict->offsets[code], dict->sizes[code]) & mask;
+    while (dict->table[slot] != 0) slot = (slot + 1) & mask;
+    dict->table[slot] = code + 1;
+}
+
+//Refaz a tabela de dispersão com um tamanho dado (mantendo a ocupação abaixo da metade)
+static bool _dictionary_rehash(_dictionary *dict, int table_size) {
+    int *table = calloc(table_size, sizeof(int));
+    if (table == NULL) return false;
+
+    free(dict->table);
+    dict->table = table;
+    dict->table_size = table_size;
+    for (int code = 0; code < dict->count; code++) _dictionary_place(dict, code);
+    return true;
+}
+
+/*
+    Funcao (privada) que busca o código de um valor no dicionário
+    Retorno:
+        int. o código, ou -1 se o valor não estiver no dicionário
+*/
+static int _dictionary_find(_dictionary *dict, const char *data, int size) {
+    if (dict->table_size == 0) return -1;
+
+    unsigned int mask = dict->table_size - 1;
+    unsigned int slot = _hash(data, size) & mask;
+    while (dict->table[slot] != 0) {
+        int code = dict->table[slot] - 1;
+        if (dict->sizes[code] == size && memcmp(dict->pool + dict->offsets[code], data, size) == 0) return code;
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+/*
+    Funcao (privada) que adiciona um valor ao fim do dicionário, sem verificar se ele já existe
+    Retorno:
+        int. o código do valor, ou -1 se o dicionário estiver cheio ou faltar memória
+*/
+static int _dictionary_append(_dictionary *dict, const char *data, int size) {
+    if (dict->count >= REGISTRY_COLUMN_DICTIONARY_MAX) return -1;
+
+    if (dict->count == dict->capacity) {
+        int capacity = (dict->capacity > 0) ? dict->capacity * 2 : 64;
+        int *offsets = realloc(dict->offsets, capacity * sizeof(int));
+        if (offsets != NULL) dict->offsets = offsets;
+        int *sizes = realloc(dict->sizes, capacity * sizeof(int));
+        if (sizes != NULL) dict->sizes = sizes;
+        if (offsets == NULL || sizes == NULL) return -1;
+        dict->capacity = capacity;
+    }
+
+    if (dict->pool_size + size > dict->pool_capacity) {
+        int capacity = (dict->pool_capacity > 0) ? dict->pool_capacity : 1024;
+        while (capacity < dict->pool_size + size) capacity *= 2;
+        char *pool = realloc(dict->pool, capacity);
+        if (pool == NULL) return -1;
+        dict->pool = pool;
+        dict->pool_capacity = capacity;
+    }
+
+    if (2 * (dict->count + 1) > dict->table_size && !_dictionary_rehash(dict, (dict->table_size > 0) ? dict->table_size * 2 : 128))
+        return -1;
+
+    int code = dict->count++;
+    if (size > 0) memcpy(dict->pool + dict->pool_size, data, size);
+    dict->offsets[code] = dict->pool_size;
+    dict->sizes[code] = size;
+    dict->pool_size += size;
+    _dictionary_place(dict, code);
+    return code;
+}
+
+//Obtém o código de um valor, adicionando-o ao dicionário se necessário (-1 se não houver espaço)
+static int _dictionary_code(_dictionary *dict, RegistryStringSlice value) {
+    int code = _dictionary_find(dict, value.data, value.size);
+    return (code != -1) ? code : _dictionary_append(dict, value.data, value.size);
+}
+
+//Obtém o valor de um código do dicionário
+static RegistryStringSlice _dictionary_value(_dictionary *dict, int code) {
+    RegistryStringSlice slice;
+    slice.data = dict->pool + dict->offsets[code];
+    slice.size = dict->sizes[code];
+    return slice;
+}
+
+/*
+    Funcao que cria colunas vazias (nenhum registro)
+    Parametros: nenhum
+    Retorno:
+        RegistryColumnStore* . As colunas criadas, ou NULL em caso de erro
+*/
+RegistryColumnStore *registry_column_store_create(void) {
+    RegistryColumnStore *store = calloc(1, sizeof(RegistryColumnStore));
+    if (store == NULL) {
+        DP("ERROR: not enough memory for RegistryColumnStore @registry_column_store_create()\n");
+        return NULL;
+    }
+
+    store->valid = true;
+    return store;
+}
+
+/*
+    Funcao que desaloca a memoria das colunas
+    Parametros:
+        store_ptr -> o endereco das colunas
+*/
+void registry_column_store_free(RegistryColumnStore **store_ptr) {
+    if (store_ptr == NULL || *store_ptr == NULL) return;
+    RegistryColumnStore *store = *store_ptr;
+
+    free(store->live);
+    free(store->idNascimento);
+    free(store->idadeMae);
+    free(store->dataNascimento);
+    free(store->sexoBebe);
+    free(store->cidadeMae);
+    free(store->cidadeBebe);
+    free(store->estadoMae);
+    free(store->estadoBebe);
+    _dictionary_free(&store->cities);
+    _dictionary_free(&store->states);
+
+    free(store);
+    *store_ptr = NULL;
+}
+
+//Realoca uma coluna para uma nova capacidade (a coluna original é mantida em caso de erro)
+static bool _grow_column(void **column_ptr, int capacity, size_t element_size) {
+    void *column = realloc(*column_ptr, capacity * element_size);
+    if (column == NULL) return false;
+    *column_ptr = column;
+    return true;
+}
+
+/*
+    Funcao (privada) que garante espaço para row_count linhas (as novas linhas são de registros removidos)
+    Retorno:
+        bool -> indica se há espaço
+*/
+static bool _reserve(RegistryColumnStore *store, int row_count) {
+    if (row_count <= store->capacity) return true;
+
+    int capacity = (store->capacity > 0) ? store->capacity : 1024;
+    while (capacity < row_count) capacity *= 2;
+
+    bool ok = _grow_column((void **) &store->live, capacity, sizeof(uint8_t))
+        && _grow_column((void **) &store->idNascimento, capacity, sizeof(int))
+        && _grow_column((void **) &store->idadeMae, capacity, sizeof(int))
+        && _grow_column((void **) &store->dataNascimento, capacity, DATANASCIMENTO_SIZE)
+        && _grow_column((void **) &store->sexoBebe, capacity, sizeof(char))
+        && _grow_column((void **) &store->cidadeMae, capacity, sizeof(uint16_t))
+        && _grow_column((void **) &store->cidadeBebe, capacity, sizeof(uint16_t))
+        && _grow_column((void **) &store->estadoMae, capacity, sizeof(uint16_t))
+        && _grow_column((void **) &store->estadoBebe, capacity, sizeof(uint16_t));
+    if (!ok) {
+        DP("ERROR: not enough memory @registry_column_store_reserve()\n");
+        return false;
+    }
+
+    store->capacity = capacity;
+    return true;
+}
+
+/*
+    Define a quantidade de linhas das colunas (o próximo RRN do arquivo). Linhas novas são de registros removidos
+    Parametros:
+        store -> as colunas
+        RRN_count -> quantidade de RRNs do arquivo de registros
+*/
+void registry_column_store_set_count(RegistryColumnStore *store, int RRN_count) {
+    if (store == NULL || RRN_count < 0 || !_reserve(store, RRN_count)) return;
+
+    //As linhas novas são zeradas (os códigos 0 mantêm as agregações dentro dos dicionários)
+    if (RRN_count > store->count) {
+        int from = store->count, rows = RRN_count - store->count;
+        memset(store->live + from, 0, rows);
+        memset(store->idNascimento + from, 0, rows * sizeof(int));
+        memset(store->idadeMae + from, 0, rows * sizeof(int));
+        memset(store->dataNascimento + (size_t) from * DATANASCIMENTO_SIZE, 0, (size_t) rows * DATANASCIMENTO_SIZE);
+        memset(store->sexoBebe + from, 0, rows);
+        memset(store->cidadeMae + from, 0, rows * sizeof(uint16_t));
+        memset(store->cidadeBebe + from, 0, rows * sizeof(uint16_t));
+        memset(store->estadoMae + from, 0, rows * sizeof(uint16_t));
+        memset(store->estadoBebe + from, 0, rows * sizeof(uint16_t));
+    }
+    store->count = RRN_count;
+}
+
+/*
+    Copia um registro para as colunas (usado na construção e a cada modificação do arquivo)
+    Parametros:
+        store -> as colunas
+        RRN -> RRN do registro
+        slot -> os REGISTRY_SIZE bytes do registro em memória (NULL ou removido indica que o registro não existe mais)
+    Retorno:
+        bool -> false se o registro não pôde ser guardado (as colunas deixam de ser válidas)
+*/
+bool registry_column_store_set(RegistryColumnStore *store, int RRN, const char *slot) {
+    if (store == NULL || RRN < 0 || !store->valid) return false;
+
+    if (RRN >= store->count) {
+        registry_column_store_set_count(store, RRN + 1);
+        if (RRN >= store->count) {
+            store->valid = false;
+            return false;
+        }
+    }
+
+    if (slot == NULL || binary_slot_is_removed(slot)) {
+        store->live[RRN] = 0;
+        return true;
+    }
+
+    RegistryView view = registry_view_create(slot, RRN);
+    int cidadeMae = _dictionary_code(&store->cities, registry_view_get_cidadeMae(view));
+    int cidadeBebe = _dictionary_code(&store->cities, registry_view_get_cidadeBebe(view));
+    int estadoMae = _dictionary_code(&store->states, registry_view_get_estadoMae(view));
+    int estadoBebe = _dictionary_code(&store->states, registry_view_get_estadoBebe(view));
+    if (cidadeMae == -1 || cidadeBebe == -1 || estadoMae == -1 || estadoBebe == -1) {
+        DP("WARNING: column dictionary is full, column store is no longer valid @registry_column_store_set()\n");
+        store->valid = false;
+        return false;
+    }
+
+    RegistryStringSlice dataNascimento = registry_view_get_dataNascimento(view);
+    char *date = store->dataNascimento + (size_t) RRN * DATANASCIMENTO_SIZE;
+    memset(date, '\0', DATANASCIMENTO_SIZE);
+    memcpy(date, dataNascimento.data, dataNascimento.size);
+
+    store->live[RRN] = 1;
+    store->idNascimento[RRN] = registry_view_get_idNascimento(view);
+    store->idadeMae[RRN] = registry_view_get_idadeMae(view);
+    store->sexoBebe[RRN] = registry_view_get_sexoBebe(view);
+    store->cidadeMae[RRN] = (uint16_t) cidadeMae;
+    store->cidadeBebe[RRN] = (uint16_t) cidadeBebe;
+    store->estadoMae[RRN] = (uint16_t) estadoMae;
+    store->estadoBebe[RRN] = (uint16_t) estadoBebe;
+    return true;
+}
+
+//Quantidade de linhas (RRNs) das colunas
+int registry_column_store_get_count(RegistryColumnStore *store) {
+    return (store != NULL) ? store->count : 0;
+}
+
+//Indica se as colunas correspondem ao arquivo (false se algum registro não pôde ser guardado)
+bool registry_column_store_is_valid(RegistryColumnStore *store) {
+    return store != NULL && store->valid;
+}
+
+/*
+    Kernels dos filtros: cada um percorre uma única coluna contígua e desmarca, na seleção, as linhas cujo valor
+    é diferente do buscado. Os laços não têm desvios, o que permite que o compilador os vetorize
+*/
+static void _kernel_eq_int(const int *column, int value, uint8_t *selection, int count) {
+    for (int i = 0; i < count; i++) selection[i] &= (uint8_t) (column[i] == value);
+}
+
+static void _kernel_eq_char(const char *column, char value, uint8_t *selection, int count) {
+    for (int i = 0; i < count; i++) selection[i] &= (uint8_t) (column[i] == value);
+}
+
+static void _kernel_eq_code(const uint16_t *column, int code, uint8_t *selection, int count) {
+    if (code < 0) {
+        memset(selection, 0, count);
+        return;
+    }
+
+    uint16_t value = (uint16_t) code;
+    for (int i = 0; i < count; i++) selection[i] &= (uint8_t) (column[i] == value);
+}
+
+static void _kernel_eq_fixed(const char *column, int width, const char *value, uint8_t *selection, int count) {
+    for (int i = 0; i < count; i++) selection[i] &= (uint8_t) (memcmp(column + (size_t) i * width, value, width) == 0);
+}
+
+//Código de um valor de filtro em um dicionário (-1 se o valor for nulo ou não estiver no dicionário: nenhum registro o tem)
+static int _filter_code(_dictionary *dict, const char *value) {
+    return (value != NULL) ? _dictionary_find(dict, value, strlen(value)) : -1;
+}
+
+/*
+    Funcao (privada) que aplica um filtro sobre uma seleção, lendo apenas as colunas dos campos do filtro.
+    Segue a mesma semântica de registry_view_matches()
+*/
+static void _apply_filter(RegistryColumnStore *store, VirtualRegistryFilter *filter, uint8_t *selection) {
+    if (filter == NULL) return;
+
+    RegistryFieldsMask mask = filter->fieldMask;
+    int count = store->count;
+
+    if (mask & MASK_IDNASCIMENTO) _kernel_eq_int(store->idNascimento, filter->idNascimento, selection, count);
+    if (mask & MASK_IDADEMAE) _kernel_eq_int(store->idadeMae, filter->idadeMae, selection, count);
+    if (mask & MASK_SEXOBEBE) _kernel_eq_char(store->sexoBebe, filter->sexoBebe, selection, count);
+    if (mask & MASK_ESTADOMAE) _kernel_eq_code(store->estadoMae, _filter_code(&store->states, filter->estadoMae), selection, count);
+    if (mask & MASK_ESTADOBEBE) _kernel_eq_code(store->estadoBebe, _filter_code(&store->states, filter->estadoBebe), selection, count);
+    if (mask & MASK_CIDADEMAE) _kernel_eq_code(store->cidadeMae, _filter_code(&store->cities, filter->cidadeMae), selection, count);
+    if (mask & MASK_CIDADEBEBE) _kernel_eq_code(store->cidadeBebe, _filter_code(&store->cities, filter->cidadeBebe), selection, count);
+
+    if (mask & MASK_DATANASCIMENTO) {
+        //O valor é completado com '\0' como na coluna; um valor maior que o campo não existe em nenhum registro
+        char date[DATANASCIMENTO_SIZE] = {0};
+        int size = (filter->dataNascimento != NULL) ? strlen(filter->dataNascimento) : DATANASCIMENTO_SIZE + 1;
+        if (size > DATANASCIMENTO_SIZE) memset(selection, 0, count);
+        else {
+            memcpy(date, filter->dataNascimento, size);
+            _kernel_eq_fixed(store->dataNascimento, DATANASCIMENTO_SIZE, date, selection, count);
+        }
+    }
+}
+
+/**
+ *  Marca os registros que satisfazem um vetor de filtros (ao menos um dos filtros), como registry_view_matches_any(),
+ *  lendo apenas as colunas dos campos dos filtros
+ *  Parâmetros:
+ *      RegistryColumnStore *store -> as colunas
+ *      VirtualRegistryArray *filters -> vetor de filtros (NULL indica que todos os registros existentes são aceitos)
+ *      uint8_t *selection -> vetor com registry_column_store_get_count() posições, que recebe 1 nos registros aceitos e 0 nos demais
+ *  Retorno:
+ *      int -> quantidade de registros aceitos, ou -1 em caso de erro
+ */
+int registry_column_store_filter(RegistryColumnStore *store, VirtualRegistryArray *filters, uint8_t *selection) {
+    if (store == NULL || !store->valid || selection == NULL) return -1;
+
+    int count = store->count;
+    if (filters == NULL || filters->size == 1) {
+        memcpy(selection, store->live, count);
+        if (filters != NULL) _apply_filter(store, filters->data_arr[0], selection);
+    } else {
+        //Cada filtro é aplicado sobre os registros existentes e os resultados são unidos
+        uint8_t *match = malloc(count > 0 ? count : 1);
+        if (match == NULL) {
+            DP("ERROR: not enough memory @registry_column_store_filter()\n");
+            return -1;
+        }
+
+        memset(selection, 0, count);
+        for (int f = 0; f < filters->size; f++) {
+            memcpy(match, store->live, count);
+            _apply_filter(store, filters->data_arr[f], match);
+            for (int i = 0; i < count; i++) selection[i] |= match[i];
+        }
+        free(match);
+    }
+
+    int selected = 0;
+    for (int i = 0; i < count; i++) selected += selection[i];
+    return selected;
+}
+
+/**
+ *  Obtém os RRNs dos registros que satisfazem um vetor de filtros (ver registry_column_store_filter())
+ *  Parâmetros:
+ *      RegistryColumnStore *store -> as colunas
+ *      VirtualRegistryArray *filters -> vetor de filtros
+ *      int max_count -> quantidade máxima de RRNs (negativa para não haver limite)
+ *      int **RRNs_ptr -> onde será guardado o vetor de RRNs, em ordem crescente (deve ser liberado)
+ *  Retorno:
+ *      int -> quantidade de RRNs, ou -1 em caso de erro ou se ela passar de max_count (nesse caso, nenhum vetor é guardado)
+ */
+int registry_column_store_select(RegistryColumnStore *store, VirtualRegistryArray *filters, int max_count, int **RRNs_ptr) {
+    if (RRNs_ptr == NULL) return -1;
+    *RRNs_ptr = NULL;
+    if (store == NULL || !store->valid) return -1;
+
+    uint8_t *selection = malloc(store->count > 0 ? store->count : 1);
+    if (selection == NULL) {
+        DP("ERROR: not enough memory @registry_column_store_select()\n");
+        return -1;
+    }
+
+    int selected = registry_column_store_filter(store, filters, selection);
+    if (selected < 0 || (max_count >= 0 && selected > max_count)) {
+        free(selection);
+        return -1;
+    }
+
+    int *RRNs = malloc((selected > 0 ? selected : 1) * sizeof(int));
+    if (RRNs == NULL) {
+        DP("ERROR: not enough memory @registry_column_store_select()\n");
+        free(selection);
+        return -1;
+    }
+
+    for (int i = 0, j = 0; i < store->count; i++)
+        if (selection[i]) RRNs[j++] = i;
+
+    free(selection);
+    *RRNs_ptr = RRNs;
+    return selected;
+}
+
+//Compara dois grupos pelo texto (bytes e, em seguida, tamanho)
+static int _compare_groups_text(const void *a, const void *b) {
+    const RegistryColumnGroup *g1 = a, *g2 = b;
+    int size = (g1->text.size < g2->text.size) ? g1->text.size : g2->text.size;
+    int cmp = memcmp(g1->text.data, g2->text.data, size);
+    if (cmp != 0) return cmp;
+    return (g1->text.size > g2->text.size) - (g1->text.size < g2->text.size);
+}
+
+static int _compare_ints(const void *a, const void *b) {
+    int i1 = *(const int *) a, i2 = *(const int *) b;
+    return (i1 > i2) - (i1 < i2);
+}
+
+//Data de nascimento de um registro selecionado, com a linha da coluna de onde ela veio
+typedef struct {
+    char date[DATANASCIMENTO_SIZE];
+    int row;
+} _DatedRow;
+
+//Ordena por data e, entre datas iguais, pela linha (a primeira linha de cada valor vem antes)
+static int _compare_dated_rows(const void *a, const void *b) {
+    const _DatedRow *d1 = a, *d2 = b;
+    int cmp = memcmp(d1->date, d2->date, DATANASCIMENTO_SIZE);
+    if (cmp != 0) return cmp;
+    return (d1->row > d2->row) - (d1->row < d2->row);
+}
+
+/*
+    Funcao (privada) que agrupa uma coluna de códigos: conta os registros selecionados de cada código do dicionário
+*/
+static int _count_by_code(const uint16_t *column, _dictionary *dict, const uint8_t *selection, int count, RegistryColumnGroup *groups) {
+    int *counts = calloc(dict->count > 0 ? dict->count : 1, sizeof(int));
+    if (counts == NULL) return -1;
+
+    for (int i = 0; i < count; i++) counts[column[i]] += selection[i];
+
+    int group_count = 0;
+    for (int code = 0; code < dict->count; code++) {
+        if (counts[code] == 0) continue;
+        groups[group_count].text = _dictionary_value(dict, code);
+        groups[group_count].number = -1;
+        groups[group_count].count = counts[code];
+        group_count++;
+    }
+
+    free(counts);
+    qsort(groups, group_count, sizeof(RegistryColumnGroup), _compare_groups_text);
+    return group_count;
+}
+
+/*
+    Funcao (privada) que agrupa uma coluna de ints: os valores selecionados são ordenados e contados em sequência
+*/
+static int _count_by_int(const int *column, const uint8_t *selection, int count, int selected, RegistryColumnGroup *groups) {
+    int *values = malloc((selected > 0 ? selected : 1) * sizeof(int));
+    if (values == NULL) return -1;
+
+    for (int i = 0, j = 0; i < count; i++)
+        if (selection[i]) values[j++] = column[i];
+    qsort(values, selected, sizeof(int), _compare_ints);
+
+    int group_count = 0;
+    for (int i = 0; i < selected; i++) {
+        if (i == 0 || values[i] != values[i-1]) {
+            groups[group_count].text.data = NULL;
+            groups[group_count].text.size = 0;
+            groups[group_count].number = values[i];
+            groups[group_count].count = 0;
+            group_count++;
+        }
+        groups[group_count-1].count++;
+    }
+
+    free(values);
+    return group_count;
+}
+
+/*
+    Funcao (privada) que agrupa a coluna de dataNascimento. Os textos dos grupos apontam para a coluna
+*/
+static int _count_by_date(RegistryColumnStore *store, const uint8_t *selection, int selected, RegistryColumnGroup *groups) {
+    _DatedRow *dates = malloc((selected > 0 ? selected : 1) * sizeof(_DatedRow));
+    if (dates == NULL) return -1;
+
+    for (int i = 0, j = 0; i < store->count; i++) {
+        if (!selection[i]) continue;
+        memcpy(dates[j].date, store->dataNascimento + (size_t) i * DATANASCIMENTO_SIZE, DATANASCIMENTO_SIZE);
+        dates[j++].row = i;
+    }
+    qsort(dates, selected, sizeof(_DatedRow), _compare_dated_rows);
+
+    //Os textos apontam para a primeira linha da coluna com cada valor (o vetor ordenado é liberado)
+    int group_count = 0;
+    for (int i = 0; i < selected; i++) {
+        if (i == 0 || memcmp(dates[i].date, dates[i-1].date, DATANASCIMENTO_SIZE) != 0) {
+            RegistryColumnGroup *group = &groups[group_count++];
+            group->text.data = store->dataNascimento + (size_t) dates[i].row * DATANASCIMENTO_SIZE;
+            group->text.size = 0;
+            while (group->text.size < DATANASCIMENTO_SIZE && group->text.data[group->text.size] != '\0') group->text.size++;
+            group->number = -1;
+            group->count = 0;
+        }
+        groups[group_count-1].count++;
+    }
+
+    free(dates);
+    return group_count;
+}
+
+/**
+ *  Conta os registros selecionados por valor de um campo (como um GROUP BY com COUNT), lendo apenas a coluna do campo.
+ *  Os grupos ficam em ordem crescente de valor (texto ou número)
+ *  Parâmetros:
+ *      RegistryColumnStore *store -> as colunas
+ *      const uint8_t *selection -> registros considerados (ver registry_column_store_filter())
+ *      RegistryFieldsMask field -> o campo agrupado (apenas um)
+ *      RegistryColumnGroup **groups_ptr -> onde será guardado o vetor de grupos (deve ser liberado). Os textos dos grupos
+ *          apontam para as colunas e só são válidos enquanto elas existirem
+ *  Retorno:
+ *      int -> quantidade de grupos, ou -1 em caso de erro
+ */
+int registry_column_store_count_by(RegistryColumnStore *store, const uint8_t *selection, RegistryFieldsMask field, RegistryColumnGroup **groups_ptr) {
+    if (groups_ptr == NULL) return -1;
+    *groups_ptr = NULL;
+    if (store == NULL || !store->valid || selection == NULL) return -1;
+
+    int count = store->count, selected = 0;
+    for (int i = 0; i < count; i++) selected += selection[i];
+
+    RegistryColumnGroup *groups = malloc((selected > 0 ? selected : 1) * sizeof(RegistryColumnGroup));
+    if (groups == NULL) {
+        DP("ERROR: not enough memory @registry_column_store_count_by()\n");
+        return -1;
+    }
+
+    int group_count;
+    switch (field) {
+        case MASK_CIDADEMAE: group_count = _count_by_code(store->cidadeMae, &store->cities, selection, count, groups); break;
+        case MASK_CIDADEBEBE: group_count = _count_by_code(store->cidadeBebe, &store->cities, selection, count, groups); break;
+        case MASK_ESTADOMAE: group_count = _count_by_code(store->estadoMae, &store->states, selection, count, groups); break;
+        case MASK_ESTADOBEBE: group_count = _count_by_code(store->estadoBebe, &store->states, selection, count, groups); break;
+        case MASK_IDNASCIMENTO: group_count = _count_by_int(store->idNascimento, selection, count, selected, groups); break;
+        case MASK_IDADEMAE: group_count = _count_by_int(store->idadeMae, selection, count, selected, groups); break;
+        case MASK_DATANASCIMENTO: group_count = _count_by_date(store, selection, selected, groups); break;
+
+        case MASK_SEXOBEBE: {
+            int counts[256] = {0};
+            for (int i = 0; i < count; i++) counts[(unsigned char) store->sexoBebe[i]] += selection[i];
+
+            group_count = 0;
+            for (int value = 0; value < 256; value++) {
+                if (counts[value] == 0) continue;
+                groups[group_count].text.data = NULL;
+                groups[group_count].text.size = 0;
+                groups[group_count].number = value;
+                groups[group_count].count = counts[value];
+                group_count++;
+            }
+            break;
+        }
+
+        default:
+            DP("ERROR: invalid field @registry_column_store_count_by()\n");
+            group_count = -1;
+    }
+
+    if (group_count < 0) {
+        free(groups);
+        return -1;
+    }
+
+    *groups_ptr = groups;
+    return group_count;
+}
+
+//Escreve um dicionário: quantidade de valores, tamanho total, tamanho de cada valor e os bytes dos valores
+static bool _dictionary_write(_dictionary *dict, FILE *file) {
+    int counts[2] = {dict->count, dict->pool_size};
+    return fwrite(counts, sizeof(int), 2, file) == 2
+        && (dict->count == 0 || fwrite(dict->sizes, sizeof(int), dict->count, file) == (size_t) dict->count)
+        && (dict->pool_size == 0 || fwrite(dict->pool, 1, dict->pool_size, file) == (size_t) dict->pool_size);
+}
+
+//Lê um dicionário escrito por _dictionary_write() (os valores são adicionados a um dicionário vazio)
+static bool _dictionary_read(_dictionary *dict, FILE *file) {
+    int counts[2];
+    if (fread(counts, sizeof(int), 2, file) != 2 || counts[0] < 0 || counts[0] > REGISTRY_COLUMN_DICTIONARY_MAX || counts[1] < 0)
+        return false;
+
+    int *sizes = malloc((counts[0] > 0 ? counts[0] : 1) * sizeof(int));
+    char *pool = malloc(counts[1] > 0 ? counts[1] : 1);
+    bool ok = sizes != NULL && pool != NULL
+        && (counts[0] == 0 || fread(sizes, sizeof(int), counts[0], file) == (size_t) counts[0])
+        && (counts[1] == 0 || fread(pool, 1, counts[1], file) == (size_t) counts[1]);
+
+    for (int code = 0, offset = 0; ok && code < counts[0]; code++) {
+        ok = sizes[code] >= 0 && offset + sizes[code] <= counts[1] && _dictionary_append(dict, pool + offset, sizes[code]) == code;
+        if (ok) offset += sizes[code];
+    }
+
+    free(sizes);
+    free(pool);
+    return ok && dict->pool_size == counts[1];
+}
+
+//Lista das colunas na ordem em que são escritas no arquivo (o vetor e o tamanho de cada elemento)
+#define COLUMN_COUNT 9
+static void _columns(RegistryColumnStore *store, void **columns, size_t *sizes) {
+    void *c[COLUMN_COUNT] = {store->live, store->idNascimento, store->idadeMae, store->dataNascimento, store->sexoBebe,
+        store->cidadeMae, store->cidadeBebe, store->estadoMae, store->estadoBebe};
+    size_t s[COLUMN_COUNT] = {sizeof(uint8_t), sizeof(int), sizeof(int), DATANASCIMENTO_SIZE, sizeof(char),
+        sizeof(uint16_t), sizeof(uint16_t), sizeof(uint16_t), sizeof(uint16_t)};
+
+    memcpy(columns, c, sizeof(c));
+    memcpy(sizes, s, sizeof(s));
+}
+
+/*
+    Escreve as colunas em um arquivo, junto das informações do header do arquivo de registros a que elas correspondem
+    Parametros:
+        store -> as colunas (válidas)
+        filename -> nome do arquivo a ser escrito
+        RRN_count, registries_count, removed_count, updated_count -> próximo RRN e quantidades de registros, de removidos
+            e de atualizados do arquivo de registros
+    Retorno:
+        bool -> indica se o arquivo foi escrito
+*/
+bool registry_column_store_write(RegistryColumnStore *store, char *filename, int RRN_count, int registries_count, int removed_count, int updated_count) {
+    if (store == NULL || filename == NULL || RRN_count < 0) return false;
+
+    //Colunas que não correspondem ao arquivo não são escritas (e as de antes são descartadas)
+    if (!store->valid) {
+        remove(filename);
+        return false;
+    }
+
+    registry_column_store_set_count(store, RRN_count);
+    if (store->count != RRN_count) return false;
+
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) return false;
+
+    int stamp[4] = {RRN_count, registries_count, removed_count, updated_count};
+    bool ok = fwrite(COLUMN_STORE_MAGIC, 4, 1, file) == 1 && fwrite(stamp, sizeof(int), 4, file) == 4
+        && _dictionary_write(&store->cities, file) && _dictionary_write(&store->states, file);
+
+    void *columns[COLUMN_COUNT];
+    size_t sizes[COLUMN_COUNT];
+    _columns(store, columns, sizes);
+    for (int c = 0; ok && c < COLUMN_COUNT && RRN_count > 0; c++)
+        ok = fwrite(columns[c], sizes[c], RRN_count, file) == (size_t) RRN_count;
+
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        DP("WARNING: couldn't write column store file @registry_column_store_write()\n");
+        remove(filename);
+    }
+    return ok;
+}
+
+/*
+    Lê as colunas de um arquivo, validando-as com as informações do header do arquivo de registros.
+    Um arquivo inexistente, incompleto ou de outra versão do arquivo de registros é ignorado (a quantidade de
+    atualizados faz com que uma atualização feita sem manter as colunas também as invalide)
+    Parametros:
+        filename -> nome do arquivo
+        RRN_count, registries_count, removed_count, updated_count -> próximo RRN e quantidades de registros, de removidos
+            e de atualizados do arquivo de registros
+    Retorno:
+        RegistryColumnStore* -> as colunas lidas, ou NULL se o arquivo não existir ou não corresponder ao arquivo de registros
+*/
+RegistryColumnStore *registry_column_store_read(char *filename, int RRN_count, int registries_count, int removed_count, int updated_count) {
+    if (filename == NULL || RRN_count < 0) return NULL;
+
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) return NULL;
+
+    char magic[4];
+    int stamp[4];
+    bool ok = fread(magic, 4, 1, file) == 1 && memcmp(magic, COLUMN_STORE_MAGIC, 4) == 0
+        && fread(stamp, sizeof(int), 4, file) == 4
+        && stamp[0] == RRN_count && stamp[1] == registries_count && stamp[2] == removed_count && stamp[3] == updated_count;
+
+    RegistryColumnStore *store = ok ? registry_column_store_create() : NULL;
+    ok = store != NULL && _dictionary_read(&store->cities, file) && _dictionary_read(&store->states, file);
+    if (ok) {
+        registry_column_store_set_count(store, RRN_count);
+        ok = store->count == RRN_count;
+    }
+
+    void *columns[COLUMN_COUNT];
+    size_t sizes[COLUMN_COUNT];
+    if (ok) _columns(store, columns, sizes);
+    for (int c = 0; ok && c < COLUMN_COUNT && RRN_count > 0; c++)
+        ok = fread(columns[c], sizes[c], RRN_count, file) == (size_t) RRN_count;
+
+    //O arquivo deve terminar junto das colunas, os códigos devem existir nos dicionários (nos registros removidos,
+    //o código 0 é aceito mesmo com um dicionário vazio) e a quantidade de registros existentes deve ser a do header
+    ok = ok && fgetc(file) == EOF;
+    int live_count = 0;
+    for (int i = 0; ok && i < RRN_count; i++) {
+        int live = store->live[i];
+        int cities = (live || store->cities.count > 0) ? store->cities.count : 1;
+        int states = (live || store->states.count > 0) ? store->states.count : 1;
+        live_count += live != 0;
+        ok = live <= 1 && store->cidadeMae[i] < cities && store->cidadeBebe[i] < cities
+            && store->estadoMae[i] < states && store->estadoBebe[i] < states;
+    }
+    ok = ok && live_count == registries_count;
+    fclose(file);
+
+    if (!ok) {
+        DP("WARNING: ignoring stale or corrupted column store file '%s' @registry_column_store_read()\n", filename);
+        registry_column_store_free(&store);
+    }
+    return store;
+}
@@ -0,0 +1,245 @@
+#include "registry_live_bitmap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "debug.h"
+
+#define LIVE_BITMAP_WORD_BITS 64
+
+//Identifica o arquivo auxiliar (seguido pelo próximo RRN e pelas quantidades de registros e de removidos do arquivo de registros)
+#define LIVE_BITMAP_MAGIC "RLB1"
+
+/*
+    Struct que representa o mapa de bits. O vetor cresce conforme registros são marcados além da capacidade atual
+*/
+struct _registry_live_bitmap {
+    uint64_t *words;
+    int word_capacity;
+};
+
+//Quantidade de palavras necessárias para RRN_count registros
+static int _word_count(int RRN_count) { return (RRN_count + LIVE_BITMAP_WORD_BITS - 1) / LIVE_BITMAP_WORD_BITS; }
+
+/*
+    Funcao que cria um mapa vazio (nenhum registro existente)
+    Parametros: nenhum
+    Retorno:
+        RegistryLiveBitmap* . O mapa criado, ou NULL em caso de erro
+*/
+RegistryLiveBitmap *registry_live_bitmap_create(void) {
+    RegistryLiveBitmap *bitmap = malloc(sizeof(RegistryLiveBitmap));
+    if (bitmap == NULL) {
+        DP("ERROR: not enough memory for RegistryLiveBitmap @registry_live_bitmap_create()\n");
+        return NULL;
+    }
+
+    bitmap->words = NULL;
+    bitmap->word_capacity = 0;
+    return bitmap;
+}
+
+/*
+    Funcao que desaloca a memoria do mapa
+    Parametros:
+        bitmap_ptr -> o endereco do mapa
+*/
+void registry_live_bitmap_free(RegistryLiveBitmap **bitmap_ptr) {
+    if (bitmap_ptr == NULL || *bitmap_ptr == NULL) return;
+
+    free((*bitmap_ptr)->words);
+    free(*bitmap_ptr);
+    *bitmap_ptr = NULL;
+}
+
+/*
+    Funcao (privada) que garante espaço para word_count palavras (as novas palavras começam zeradas)
+    Retorno:
+        bool -> indica se há espaço
+*/
+static bool _reserve(RegistryLiveBitmap *bitmap, int word_count) {
+    if (word_count <= bitmap->word_capacity) return true;
+
+    int new_capacity = (bitmap->word_capacity > 0) ? bitmap->word_capacity : 16;
+    while (new_capacity < word_count) new_capacity *= 2;
+
+    uint64_t *words = realloc(bitmap->words, new_capacity * sizeof(uint64_t));
+    if (words == NULL) {
+        DP("ERROR: not enough memory @registry_live_bitmap_reserve()\n");
+        return false;
+    }
+
+    memset(words + bitmap->word_capacity, 0, (new_capacity - bitmap->word_capacity) * sizeof(uint64_t));
+    bitmap->words = words;
+    bitmap->word_capacity = new_capacity;
+    return true;
+}
+
+/*
+    Marca um registro como existente ou removido
+    Parametros:
+        bitmap -> o mapa
+        RRN -> RRN do registro
+        live -> true se o registro existe
+*/
+void registry_live_bitmap_set(RegistryLiveBitmap *bitmap, int RRN, bool live) {
+    if (bitmap == NULL || RRN < 0) return;
+    if (!live && RRN / LIVE_BITMAP_WORD_BITS >= bitmap->word_capacity) return;
+    if (!_reserve(bitmap, RRN / LIVE_BITMAP_WORD_BITS + 1)) return;
+
+    uint64_t bit = (uint64_t) 1 << (RRN % LIVE_BITMAP_WORD_BITS);
+    if (live) bitmap->words[RRN / LIVE_BITMAP_WORD_BITS] |= bit;
+    else bitmap->words[RRN / LIVE_BITMAP_WORD_BITS] &= ~bit;
+}
+
+/*
+    Marca count registros consecutivos como existentes (usado nas inserções ao fim do arquivo)
+    Parametros:
+        bitmap -> o mapa
+        first_RRN -> RRN do primeiro registro
+        count -> quantidade de registros
+*/
+void registry_live_bitmap_set_range(RegistryLiveBitmap *bitmap, int first_RRN, int count) {
+    if (bitmap == NULL || first_RRN < 0 || count <= 0) return;
+    if (!_reserve(bitmap, _word_count(first_RRN + count))) return;
+
+    int RRN = first_RRN, end = first_RRN + count;
+
+    //Bits até o início da próxima palavra, palavras inteiras e os bits restantes
+    while (RRN < end && RRN % LIVE_BITMAP_WORD_BITS != 0) registry_live_bitmap_set(bitmap, RRN++, true);
+    for (; RRN + LIVE_BITMAP_WORD_BITS <= end; RRN += LIVE_BITMAP_WORD_BITS) bitmap->words[RRN / LIVE_BITMAP_WORD_BITS] = ~(uint64_t) 0;
+    while (RRN < end) registry_live_bitmap_set(bitmap, RRN++, true);
+}
+
+/*
+    Verifica se um registro existe
+    Parametros:
+        bitmap -> o mapa
+        RRN -> RRN do registro
+    Retorno:
+        bool -> true se o registro existe
+*/
+bool registry_live_bitmap_is_live(RegistryLiveBitmap *bitmap, int RRN) {
+    if (bitmap == NULL || RRN < 0 || RRN / LIVE_BITMAP_WORD_BITS >= bitmap->word_capacity) return false;
+    return (bitmap->words[RRN / LIVE_BITMAP_WORD_BITS] >> (RRN % LIVE_BITMAP_WORD_BITS)) & 1;
+}
+
+/*
+    Obtém o primeiro registro existente a partir de um RRN (inclusive), pulando palavras inteiras de registros removidos
+    Parametros:
+        bitmap -> o mapa
+        RRN -> RRN a partir do qual a busca é feita
+        RRN_count -> quantidade de RRNs do arquivo (o próximo RRN)
+    Retorno:
+        int -> RRN do registro encontrado, ou RRN_count se não houver registro existente a partir de RRN
+*/
+int registry_live_bitmap_next_live(RegistryLiveBitmap *bitmap, int RRN, int RRN_count) {
+    if (bitmap == NULL || RRN < 0) return RRN_count;
+
+    int word = RRN / LIVE_BITMAP_WORD_BITS;
+    int last_word = _word_count(RRN_count);
+    if (last_word > bitmap->word_capacity) last_word = bitmap->word_capacity;
+    if (word >= last_word) return RRN_count;
+
+    //Desconsidera os bits anteriores ao RRN na primeira palavra
+    uint64_t bits = bitmap->words[word] & (~(uint64_t) 0 << (RRN % LIVE_BITMAP_WORD_BITS));
+    while (bits == 0) {
+        if (++word >= last_word) return RRN_count;
+        bits = bitmap->words[word];
+    }
+
+    int found = word * LIVE_BITMAP_WORD_BITS + __builtin_ctzll(bits);
+    return (found < RRN_count) ? found : RRN_count;
+}
+
+/*
+    Conta os registros existentes (popcount de cada palavra)
+    Parametros:
+        bitmap -> o mapa
+        RRN_count -> quantidade de RRNs do arquivo (bits além dela são desconsiderados)
+    Retorno:
+        int -> quantidade de registros existentes
+*/
+int registry_live_bitmap_count(RegistryLiveBitmap *bitmap, int RRN_count) {
+    if (bitmap == NULL || RRN_count <= 0) return 0;
+
+    int word_count = _word_count(RRN_count);
+    if (word_count > bitmap->word_capacity) word_count = bitmap->word_capacity;
+
+    int count = 0;
+    for (int w = 0; w < word_count; w++) {
+        uint64_t bits = bitmap->words[w];
+        if ((w + 1) * LIVE_BITMAP_WORD_BITS > RRN_count) bits &= ((uint64_t) 1 << (RRN_count % LIVE_BITMAP_WORD_BITS)) - 1;
+        count += __builtin_popcountll(bits);
+    }
+    return count;
+}
+
+/*
+    Escreve o mapa em um arquivo, junto das informações do header do arquivo de registros a que ele corresponde
+    Parametros:
+        bitmap -> o mapa
+        filename -> nome do arquivo a ser escrito
+        RRN_count, registries_count, removed_count -> próximo RRN e quantidades de registros e de removidos do arquivo de registros
+    Retorno:
+        bool -> indica se o arquivo foi escrito
+*/
+bool registry_live_bitmap_write(RegistryLiveBitmap *bitmap, char *filename, int RRN_count, int registries_count, int removed_count) {
+    if (bitmap == NULL || filename == NULL || RRN_count < 0) return false;
+    if (!_reserve(bitmap, _word_count(RRN_count))) return false;
+
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) return false;
+
+    int stamp[3] = {RRN_count, registries_count, removed_count};
+    bool ok = fwrite(LIVE_BITMAP_MAGIC, 4, 1, file) == 1 && fwrite(stamp, sizeof(int), 3, file) == 3;
+
+    int word_count = _word_count(RRN_count);
+    if (ok && word_count > 0) ok = fwrite(bitmap->words, sizeof(uint64_t), word_count, file) == (size_t) word_count;
+
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        DP("WARNING: couldn't write live bitmap file @registry_live_bitmap_write()\n");
+        remove(filename);
+    }
+    return ok;
+}
+
+/*
+    Lê o mapa de um arquivo, validando-o com as informações do header do arquivo de registros.
+    Um arquivo inexistente, incompleto ou de outra versão do arquivo de registros é ignorado
+    Parametros:
+        filename -> nome do arquivo
+        RRN_count, registries_count, removed_count -> próximo RRN e quantidades de registros e de removidos do arquivo de registros
+    Retorno:
+        RegistryLiveBitmap* -> o mapa lido, ou NULL se o arquivo não existir ou não corresponder ao arquivo de registros
+*/
+RegistryLiveBitmap *registry_live_bitmap_read(char *filename, int RRN_count, int registries_count, int removed_count) {
+    if (filename == NULL || RRN_count < 0) return NULL;
+
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) return NULL;
+
+    char magic[4];
+    int stamp[3];
+    bool ok = fread(magic, 4, 1, file) == 1 && memcmp(magic, LIVE_BITMAP_MAGIC, 4) == 0
+        && fread(stamp, sizeof(int), 3, file) == 3
+        && stamp[0] == RRN_count && stamp[1] == registries_count && stamp[2] == removed_count;
+
+    RegistryLiveBitmap *bitmap = ok ? registry_live_bitmap_create() : NULL;
+    int word_count = _word_count(RRN_count);
+    ok = bitmap != NULL && _reserve(bitmap, word_count);
+    if (ok && word_count > 0) ok = fread(bitmap->words, sizeof(uint64_t), word_count, file) == (size_t) word_count;
+
+    //O arquivo deve terminar junto do mapa, e a quantidade de bits marcados deve ser a quantidade de registros
+    ok = ok && fgetc(file) == EOF && registry_live_bitmap_count(bitmap, RRN_count) == registries_count;
+    fclose(file);
+
+    if (!ok) {
+        DP("WARNING: ignoring stale or corrupted live bitmap file '%s' @registry_live_bitmap_read()\n", filename);
+        registry_live_bitmap_free(&bitmap);
+    }
+    return bitmap;
+}
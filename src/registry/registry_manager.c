@@ -3,6 +3,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "binary_io.h"
 #include "binary_registry.h"
@@ -12,9 +15,18 @@
 #include "string_utils.h"
 #include "debug.h"
 #include "registry_linked_list.h"
+#include "registry_predicate.h"
+#include "registry_parallel_scan.h"
+#include "registry_rrn_map.h"
+#include "registry_live_bitmap.h"
+#include "registry_column_store.h"
+#include "wal.h"
 
 #define REG_SIZE 128
 
+//Quantidade de registros lidos de uma só vez nas varreduras sem cópia (for_each_view_match)
+#define REG_VIEW_PAGE_REGISTRIES 64
+
 /*
 	Struct que representa o gerenciador do arquivo de registros, usada para
 	armazenar certas informações relacionadas ao arquivo, como os headers, 
@@ -25,6 +37,22 @@ struct _registry_manager {
     OPEN_MODE requested_mode;
     RegistryHeader *header;
 	int currRRN;			//RRN atual do ponteiro
+	WriteAheadLog *wal;		//Log das modificações (apenas no modo MODIFY; NULL nos demais)
+	RegistryLiveBitmap *live;	//Mapa de registros existentes (NULL se o arquivo auxiliar não existir no modo leitura)
+	char *live_filename;	//Nome do arquivo auxiliar com o mapa de registros existentes
+	RegistryColumnStore *columns;	//Cópia colunar do arquivo (NULL se não existir ou ainda não tiver sido carregada)
+	char *columns_filename;	//Nome do arquivo auxiliar com a cópia colunar
+	bool columns_loaded;	//Indica se o arquivo auxiliar com a cópia colunar já foi procurado (modos de leitura)
+
+	//Funções chamadas a cada inserção, remoção ou atualização de registro (usadas, por exemplo, na manutenção de índices)
+	RMChangeCallback change_callbacks[REGISTRY_MANAGER_MAX_CHANGE_CALLBACKS];
+	void *change_contexts[REGISTRY_MANAGER_MAX_CHANGE_CALLBACKS];
+	int change_callback_count;
+
+	//Usados apenas no modo READ_MMAP
+	char *map_base;			//Início do arquivo mapeado na memória (NULL se o arquivo não estiver mapeado)
+	size_t map_size;		//Tamanho do mapeamento, em bytes
+	int map_advice;			//Último conselho de acesso (madvise) informado ao sistema
 };
 
 
@@ -47,16 +75,157 @@ RegistryManager *registry_manager_create(void) {
     registry_manager->requested_mode = READ;
     registry_manager->header = NULL;
 	registry_manager->currRRN = -1;
+	registry_manager->wal = NULL;
+	registry_manager->live = NULL;
+	registry_manager->live_filename = NULL;
+	registry_manager->columns = NULL;
+	registry_manager->columns_filename = NULL;
+	registry_manager->columns_loaded = false;
+	registry_manager->change_callback_count = 0;
+	registry_manager->map_base = NULL;
+	registry_manager->map_size = 0;
+	registry_manager->map_advice = MADV_NORMAL;
 
     return registry_manager;
 }
 
+/*
+	Funcao (privada) que mapeia o arquivo de registros na memória (somente leitura)
+	Parametros:
+		manager -> o gerenciador com o arquivo aberto
+	Retorno:
+		bool -> indica se o arquivo foi mapeado
+*/
+static bool _map_file(RegistryManager *manager) {
+	struct stat file_stat;
+	if (fstat(fileno(manager->bin_file), &file_stat) != 0 || file_stat.st_size <= 0) {
+		DP("WARNING: couldn't stat registry file, falling back to stdio @_map_file()\n");
+		return false;
+	}
+
+	void *map = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED, fileno(manager->bin_file), 0);
+	if (map == MAP_FAILED) {
+		DP("WARNING: couldn't map registry file, falling back to stdio @_map_file()\n");
+		return false;
+	}
+
+	manager->map_base = map;
+	manager->map_size = file_stat.st_size;
+	manager->map_advice = MADV_NORMAL;
+	return true;
+}
+
+/*
+	Funcao (privada) que informa ao sistema o padrão de acesso que será feito ao arquivo mapeado
+	(MADV_SEQUENTIAL em varreduras, MADV_RANDOM em acessos por RRN). O madvise só é chamado quando o padrão muda.
+	Parametros:
+		manager -> o gerenciador
+		advice -> conselho a ser passado para o madvise
+	Retorno: void
+*/
+static void _advise_access(RegistryManager *manager, int advice) {
+	if (manager->map_base == NULL || manager->map_advice == advice) return;
+
+	madvise(manager->map_base, manager->map_size, advice);
+	manager->map_advice = advice;
+}
+
+/*
+	Funcao (privada) que monta o nome do arquivo auxiliar com o mapa de registros existentes
+	Parametros:
+		bin_filename -> nome do arquivo de registros
+	Retorno:
+		char* -> nome do arquivo auxiliar (deve ser liberado), ou NULL em caso de erro
+*/
+static char *_live_bitmap_filename(char *bin_filename) {
+	char *live_filename = malloc(strlen(bin_filename) + strlen(REGISTRY_LIVE_BITMAP_SUFFIX) + 1);
+	if (live_filename == NULL) return NULL;
+
+	strcpy(live_filename, bin_filename);
+	strcat(live_filename, REGISTRY_LIVE_BITMAP_SUFFIX);
+	return live_filename;
+}
+
+//Nome do arquivo auxiliar com a cópia colunar de um arquivo de registros (deve ser liberado)
+static char *_column_store_filename(char *bin_filename) {
+	char *columns_filename = malloc(strlen(bin_filename) + strlen(REGISTRY_COLUMN_STORE_SUFFIX) + 1);
+	if (columns_filename == NULL) return NULL;
+
+	strcpy(columns_filename, bin_filename);
+	strcat(columns_filename, REGISTRY_COLUMN_STORE_SUFFIX);
+	return columns_filename;
+}
+
+/*
+	Funcao (privada) que carrega o mapa de registros existentes do arquivo auxiliar, se ele corresponder ao header atual
+	Parametros:
+		manager -> o gerenciador com o arquivo aberto e o header lido
+	Retorno: void
+*/
+static void _load_live_bitmap(RegistryManager *manager) {
+	manager->live = registry_live_bitmap_read(manager->live_filename,
+		reg_header_get_next_RRN(manager->header),
+		reg_header_get_registries_count(manager->header),
+		reg_header_get_removed_count(manager->header));
+}
+
+static void _seek_first_registry(RegistryManager *manager);
+static int _read_registry_page(RegistryManager *manager, int count, char *buffer, const char **page_ptr);
+
+//Carrega a cópia colunar do arquivo auxiliar, se ela corresponder ao header atual
+static void _load_column_store(RegistryManager *manager) {
+	manager->columns = registry_column_store_read(manager->columns_filename,
+		reg_header_get_next_RRN(manager->header),
+		reg_header_get_registries_count(manager->header),
+		reg_header_get_removed_count(manager->header),
+		reg_header_get_updated_count(manager->header));
+	manager->columns_loaded = true;
+}
+
+//Mantém a cópia colunar atualizada a cada modificação de registro (modo MODIFY)
+static void _RMChange_sync_columns(RegistryManager *manager, int RRN, RegistryView *old_view, RegistryView *new_view, void *context) {
+	registry_column_store_set(manager->columns, RRN, (new_view != NULL) ? new_view->slot : NULL);
+}
+
+/*
+	Funcao (privada) que monta o mapa de registros existentes lendo o indicador de remoção de todos os registros
+	(usada quando o arquivo auxiliar não existe ou está desatualizado). O cursor volta para o primeiro registro
+	Parametros:
+		manager -> o gerenciador com o arquivo aberto e o header lido
+	Retorno: void
+*/
+static void _build_live_bitmap(RegistryManager *manager) {
+	manager->live = registry_live_bitmap_create();
+	if (manager->live == NULL) return;
+
+	char page_buffer[REG_VIEW_PAGE_REGISTRIES * REG_SIZE];
+	int next_RRN = reg_header_get_next_RRN(manager->header);
+
+	_seek_first_registry(manager);
+	while (manager->currRRN < next_RRN) {
+		int page_first_RRN = manager->currRRN;
+		int wanted = next_RRN - page_first_RRN;
+		if (wanted > REG_VIEW_PAGE_REGISTRIES) wanted = REG_VIEW_PAGE_REGISTRIES;
+
+		const char *page;
+		int page_count = _read_registry_page(manager, wanted, page_buffer, &page);
+		if (page_count <= 0) break;
+
+		for (int i = 0; i < page_count; i++)
+			if (!binary_slot_is_removed(page + i * REG_SIZE)) registry_live_bitmap_set(manager->live, page_first_RRN + i, true);
+	}
+	_seek_first_registry(manager);
+
+	if (registry_live_bitmap_count(manager->live, next_RRN) != reg_header_get_registries_count(manager->header))
+		DP("WARNING: registries count in header doesn't match the file @_build_live_bitmap()\n");
+}
+
 /**
  *  Abre ou cria um arquivo binário, o qual será gerenciado pelo RegistryManager.
  *  Parâmetros:
  *      RegistryManager *manager -> instância do gerenciador
  *		char* bin_filename -> nome do arquivo (caminho completo)
- *      OPEN_MODE -> READ, CREATE ou MODIFY, indicando o modo de abertura do arquivo
+ *      OPEN_MODE -> READ, CREATE, MODIFY ou READ_MMAP, indicando o modo de abertura do arquivo
  *  Retorno:
  *      OPEN_RESULT -> resultado da abertura (ler a documentação de OPEN_RESULT em open_mode.h)
  * 
@@ -77,11 +246,18 @@ OPEN_RESULT registry_manager_open(RegistryManager *manager, char* bin_filename,
 	}
 
     //Vetor de conversão do enum modo para a string que o representa (READ = rb, CREATE = )
-    static char* mode_to_str[] = {"rb", "wb+", "rb+"};
+    static char* mode_to_str[] = {"rb", "wb+", "rb+", "rb"};
 
     //Guarda o modo de abertura para uso em outras funções
     manager->requested_mode = mode;
 
+    //Um arquivo recriado não pode receber o log de um arquivo anterior. No modo MODIFY, se o arquivo não foi fechado
+    //corretamente e há um log, ele é recuperado antes da abertura (o status fica no primeiro byte do header). Os modos
+    //de leitura não alteram o arquivo: um arquivo com log é inconsistente
+    if (mode == CREATE) wal_discard(bin_filename);
+    else if (mode == MODIFY && !wal_recover(bin_filename, 0, '1')) return OPEN_FAILED;
+    else if (OPEN_MODE_IS_READ_ONLY(mode) && wal_exists(bin_filename)) return OPEN_INCONSISTENT;
+
     //Abre o arquivo binário no modo selecionado (ler os modos)
     manager->bin_file = fopen(bin_filename, mode_to_str[mode]);
 
@@ -90,22 +266,48 @@ OPEN_RESULT registry_manager_open(RegistryManager *manager, char* bin_filename,
 
     //Inicializa os headers com valores padrão (ou será usado para a escrita de um novo arquivo, ou substituído pelos headers do arquivo existente)
     manager->header = reg_header_create();
+    manager->live_filename = _live_bitmap_filename(bin_filename);
+    manager->columns_filename = _column_store_filename(bin_filename);
     
     //Se o modo for CREATE, ou seja, criar um novo arquivo, defina os headers com valores iniciais (RAM -> disco)
     if (mode == CREATE) {
         reg_header_write_to_bin(manager->header, manager->bin_file);
+
+		//O mapa de um arquivo anterior é descartado; o do arquivo novo é escrito no fechamento
+		remove(manager->live_filename);
+		manager->live = registry_live_bitmap_create();
+		remove(manager->columns_filename);
     } else { 
         //Se for outro modo, ou seja, o arquivo já existe, atualize o headers (disco -> RAM) e certifique-se de que o arquivo está consistente e não vazio
         reg_header_read_from_bin(manager->header, manager->bin_file);
         if (reg_header_get_status(manager->header) != '1') return OPEN_INCONSISTENT;
 
         if (mode == MODIFY) { 
+			//As modificações passam a ser feitas pela stream do log (se ele não puder ser criado, o arquivo é modificado sem log)
+			manager->wal = wal_open(bin_filename, &manager->bin_file);
+
 			//Se houver intenção de modificar o arquivo, defina o status como inconsistente
             reg_header_set_status(manager->header, '0');
-            reg_header_write_to_bin(manager->header, manager->bin_file);
-        }
+            registry_manager_write_headers_to_disk(manager);
+
+			//O mapa de registros existentes fica apenas na RAM enquanto o arquivo é modificado (e é reescrito no fechamento),
+			//para que um mapa desatualizado nunca seja lido após uma falha
+			_load_live_bitmap(manager);
+			remove(manager->live_filename);
+			if (manager->live == NULL) _build_live_bitmap(manager);
+
+			//A cópia colunar, se existir, também passa a ficar apenas na RAM, acompanhando cada modificação
+			_load_column_store(manager);
+			remove(manager->columns_filename);
+			if (manager->columns != NULL) registry_manager_add_change_callback(manager, _RMChange_sync_columns, NULL);
+        } else {
+			_load_live_bitmap(manager);
+		}
+
+		//No modo READ_MMAP, mapeia o arquivo inteiro (se o mapeamento falhar, a leitura continua sendo feita pela stream)
+		if (mode == READ_MMAP) _map_file(manager);
     }
-    
+
     return OPEN_OK;
 }
 
@@ -119,13 +321,47 @@ void registry_manager_close(RegistryManager *manager) {
     //Verifica se o manager já foi deletado ou se o arquivo já foi fechado
     if (manager == NULL || manager->bin_file == NULL) return;
     
-    if (manager->requested_mode != READ) {
+    if (!OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
 		//Marca o arquivo como consistente. (OBS: não é necessário no caso da leitura, pois nenhuma modificação foi feita)
         reg_header_set_status(manager->header, '1');
 		//Salva os headers no disco
         registry_manager_write_headers_to_disk(manager);
+
+		//Confirma as últimas modificações, sincroniza o arquivo e descarta o log
+		wal_close(&manager->wal);
+
+		//Salva o mapa de registros existentes, identificado pelos headers que acabaram de ser escritos
+		registry_live_bitmap_write(manager->live, manager->live_filename,
+			reg_header_get_next_RRN(manager->header),
+			reg_header_get_registries_count(manager->header),
+			reg_header_get_removed_count(manager->header));
+
+		//Salva a cópia colunar, se ela existir
+		if (manager->columns != NULL) {
+			registry_column_store_write(manager->columns, manager->columns_filename,
+				reg_header_get_next_RRN(manager->header),
+				reg_header_get_registries_count(manager->header),
+				reg_header_get_removed_count(manager->header),
+				reg_header_get_updated_count(manager->header));
+			registry_manager_remove_change_callback(manager, _RMChange_sync_columns, NULL);
+		}
     }
 
+	registry_live_bitmap_free(&manager->live);
+	free(manager->live_filename);
+	manager->live_filename = NULL;
+	registry_column_store_free(&manager->columns);
+	free(manager->columns_filename);
+	manager->columns_filename = NULL;
+	manager->columns_loaded = false;
+
+	//Desfaz o mapeamento do arquivo, se houver
+	if (manager->map_base != NULL) {
+		munmap(manager->map_base, manager->map_size);
+		manager->map_base = NULL;
+		manager->map_size = 0;
+	}
+
 	//Limpa a memória dos headers na RAM
     reg_header_delete(&manager->header);
 
@@ -183,7 +419,8 @@ static void _seek_registry(RegistryManager *manager, int RRN) {
 		return;
 	}
 
-	fseek(manager->bin_file, (RRN+1) * REG_SIZE, SEEK_SET);
+	//Com o arquivo mapeado, a posição é dada apenas pelo currRRN
+	if (manager->map_base == NULL) fseek(manager->bin_file, (RRN+1) * REG_SIZE, SEEK_SET);
 	manager->currRRN = RRN;
 }
 
@@ -204,6 +441,66 @@ static void _seek_first_registry(RegistryManager *manager) { _seek_registry(mana
 */
 static void _seek_new_registry(RegistryManager *manager) { _seek_registry(manager, reg_header_get_next_RRN(manager->header)); }
 
+/*
+	Funcao (privada) que confirma no log as modificações feitas até agora (os headers são escritos antes,
+	para que o lote confirmado seja consistente). A posição do cursor é preservada
+	Parametros:
+		manager -> o gerenciador
+	Retorno: void
+*/
+static void _commit(RegistryManager *manager) {
+	if (manager->wal == NULL) return;
+
+	long position = ftell(manager->bin_file);
+	registry_manager_write_headers_to_disk(manager);
+	fseek(manager->bin_file, position, SEEK_SET);
+
+	wal_commit(manager->wal);
+}
+
+/*
+	Funcao (privada) que contabiliza operações de modificação, confirmando o grupo quando ele estiver completo
+	Parametros:
+		manager -> o gerenciador
+		count -> quantidade de operações feitas
+	Retorno: void
+*/
+static void _end_operations(RegistryManager *manager, int count) {
+	if (wal_end_operations(manager->wal, count)) _commit(manager);
+}
+
+/*
+	Funcao (privada) que informa uma modificação de registro ao callback de modificações, se houver
+	Parametros:
+		manager -> o gerenciador
+		RRN -> RRN do registro modificado
+		old_slot -> bytes do registro antes da modificação (NULL na inserção)
+		new_slot -> bytes do registro após a modificação (NULL na remoção)
+	Retorno: void
+*/
+static void _notify_change(RegistryManager *manager, int RRN, const char *old_slot, const char *new_slot) {
+	if (manager->change_callback_count == 0) return;
+
+	RegistryView old_view = registry_view_create(old_slot, RRN);
+	RegistryView new_view = registry_view_create(new_slot, RRN);
+	for (int i = 0; i < manager->change_callback_count; i++)
+		manager->change_callbacks[i](manager, RRN, (old_slot != NULL) ? &old_view : NULL, (new_slot != NULL) ? &new_view : NULL, manager->change_contexts[i]);
+}
+
+/*
+	Funcao (privada) que calcula o endereço de um registro no arquivo mapeado (base + (RRN+1) * REG_SIZE)
+	Parametros:
+		manager -> o gerenciador com o arquivo mapeado
+		RRN -> RRN do registro
+	Retorno:
+		const char* -> início do registro na memória, ou NULL caso o registro esteja fora do arquivo
+*/
+static const char *_mapped_slot(RegistryManager *manager, int RRN) {
+	size_t offset = (size_t) (RRN+1) * REG_SIZE;
+	if (RRN < 0 || offset + REG_SIZE > manager->map_size) return NULL;
+	return manager->map_base + offset;
+}
+
 /*
 	Funcao que le um registro, precisa estar exatamente no comeco do registro para funcionar
 	Parametros:
@@ -217,11 +514,32 @@ static VirtualRegistry *_read_current_registry(RegistryManager *manager) {
 		return NULL;
 	}
 
+	if (manager->map_base != NULL) {
+		const char *slot = _mapped_slot(manager, manager->currRRN++);
+		return (slot == NULL) ? NULL : binary_decode_registry(slot);
+	}
+
 	manager->currRRN++;
 	return binary_read_registry(manager->bin_file);
 }
 
 
+/*
+	Funcao que le os bytes de um registro, com uma única leitura do disco (ou nenhuma, se o arquivo estiver mapeado).
+	Precisa estar exatamente no comeco do registro para funcionar
+	Parametros:
+		manager -> o gerenciador de registro que tera' um registro lido em seu binario
+		buffer -> buffer com REGISTRY_SIZE bytes, onde o registro sera' lido (usado apenas sem mapeamento)
+	Retorno:
+		const char* -> bytes do registro, ou NULL caso ele nao possa ser lido
+*/
+static const char *_read_current_slot(RegistryManager *manager, char *buffer) {
+	if (manager->map_base != NULL) return _mapped_slot(manager, manager->currRRN++);
+
+	manager->currRRN++;
+	return binary_read_registry_slot(manager->bin_file, buffer) ? buffer : NULL;
+}
+
 /*
 	Funcao que le um registro em um RRN dado
 	Parametros:
@@ -241,25 +559,6 @@ static VirtualRegistry *_read_registry_at(RegistryManager *manager, int RRN) {
 }
 
 
-/*
-	Funcao que escreve um registro onde o ponteiro esta. Precisa estar exatamente no 
-	comeco de um RRN para ser eficiente
-	Paramentros:
-		manager -> o gerenciador de registro que tera' um registro escrito em seu binario
-		reg_data -> o registro que sera escrito
-	Retorno: void
-*/
-static void _write_current_registry(RegistryManager *manager, VirtualRegistry *reg_data) {
-	if (manager == NULL || reg_data == NULL) {
-		DP("ERROR: invalid parameter @_write_current_registry()\n");
-		return;
-	}
-
-	registry_prepare_for_write(reg_data);					//faz o tratamento de campos invalidos
-	binary_write_registry(manager->bin_file, reg_data);		//escreve no binario
-	manager->currRRN++;
-}
-
 /*
 	Funcao que deleta o registro onde o ponteiro esta'
 	Precisa estar exatamente no comeco do registro para ser eficiente
@@ -272,8 +571,22 @@ static void _delete_current_registry (RegistryManager *manager) {
 		DP("ERROR: invalid parameter @_delete_current_registry()\n");
 		return;
 	}
+	//O registro antigo só é lido se alguém precisar ser informado da remoção
+	char old_slot[REGISTRY_SIZE];
+	bool notify = manager->change_callback_count > 0 && binary_read_registry_slot(manager->bin_file, old_slot);
+	if (manager->change_callback_count > 0) fseek(manager->bin_file, (long) (manager->currRRN+1) * REG_SIZE, SEEK_SET);
+
+	//Com lista de registros livres, o RRN do próximo registro livre é escrito logo após o indicador
+	bool chain = reg_header_has_free_list(manager->header);
+
 	binary_write_int(manager->bin_file, -1);	//escreve o indicador de registro deletado: -1
-	fseek(manager->bin_file, REG_SIZE-sizeof(int), SEEK_CUR); //faz o seek para ir para o final do registro
+	if (chain) {
+		binary_write_int(manager->bin_file, reg_header_get_free_list_head(manager->header));	//encadeia o registro no inicio da lista de livres
+		reg_header_set_free_list_head(manager->header, manager->currRRN);
+	}
+	fseek(manager->bin_file, (long) (manager->currRRN+2) * REG_SIZE, SEEK_SET); //faz o seek para ir para o final do registro
+	registry_live_bitmap_set(manager->live, manager->currRRN, false);
+	if (notify) _notify_change(manager, manager->currRRN, old_slot, NULL);
 	manager->currRRN++;
 }
 
@@ -292,7 +605,7 @@ static void _jump_registry (RegistryManager *manager, int direction) {
 		return;
 	}
 
-	fseek(manager->bin_file, REG_SIZE*direction, SEEK_CUR); //faz o seek para de +-128 bytes, pulando um registro pra frente ou pra tras 
+	fseek(manager->bin_file, (long) (manager->currRRN+direction+1) * REG_SIZE, SEEK_SET); //faz o seek para de +-128 bytes, pulando um registro pra frente ou pra tras 
 	manager->currRRN += direction;
 }
 
@@ -356,7 +669,7 @@ void registry_manager_write_headers_to_disk(RegistryManager *manager) {
     }
 
     //Valida o modo, impedindo tentativas de escrita no modo somente leitura
-    if (manager->requested_mode == READ) {
+    if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
         DP("ERROR: trying to write headers on a read-only RegistryManager @registry_manager_write_headers_to_disk()\n");
         return;
     }
@@ -367,7 +680,7 @@ void registry_manager_write_headers_to_disk(RegistryManager *manager) {
         return;
     }
 
-    //Escreve os headers no arquivo binário
+    //Escreve os headers no arquivo binário (o header ocupa o espaço de um registro)
     reg_header_write_to_bin(manager->header, manager->bin_file);
 }
 
@@ -397,10 +710,110 @@ void registry_manager_read_headers_from_disk(RegistryManager *manager) {
 
 
 
+/*
+	Funcao (privada) que retira o primeiro registro da lista de registros livres, para que ele seja reaproveitado.
+	O cursor fica posicionado no início do registro
+	Parametros:
+		manager -> o gerenciador com o arquivo aberto em modo que permita a escrita
+	Retorno:
+		int -> RRN do registro livre, ou -1 se não houver (ou se o arquivo não tiver lista de registros livres)
+*/
+static int _pop_free_registry(RegistryManager *manager) {
+	int RRN = reg_header_get_free_list_head(manager->header);
+	if (RRN < 0) return -1;
+
+	//O registro livre guarda o indicador de remoção seguido do RRN do próximo registro livre
+	int removed = -1, next = -1;
+	if (RRN < reg_header_get_next_RRN(manager->header)) {
+		_seek_registry(manager, RRN);
+		removed = binary_read_int(manager->bin_file);
+		next = binary_read_int(manager->bin_file);
+	}
+
+	if (RRN >= reg_header_get_next_RRN(manager->header) || removed != -1) {
+		DP("WARNING: corrupted free list, it will no longer be used @_pop_free_registry()\n");
+		reg_header_set_free_list_head(manager->header, -1);
+		return -1;
+	}
+
+	reg_header_set_free_list_head(manager->header, next);
+	reg_header_set_removed_count(manager->header, H_DECREASE);
+	_seek_registry(manager, RRN);
+	return RRN;
+}
+
+/*
+	Funcao (privada) que insere registros, reaproveitando primeiro os registros livres (se o arquivo tiver lista de livres)
+	e escrevendo os demais ao fim do arquivo, em lotes
+	Parametros:
+		manager -> o gerenciador
+		reg_arr -> vetor de registros a serem inseridos
+		arr_size -> tamanho do vetor
+	Retorno:
+		int -> RRN do último registro inserido, ou -1 em caso de erro
+*/
+static int _insert_registries(RegistryManager *manager, VirtualRegistry **reg_arr, int arr_size) {
+    //Valida o estado atual com um manager instanciado e o arquivo aberto
+    if (manager == NULL || manager->bin_file == NULL || (reg_arr == NULL && arr_size > 0) || arr_size < 0) {
+        DP("ERROR: invalid RegistryManager state! @registry_manager_insert_at_end\n");
+        return -1;
+    }
+
+    //O arquivo deve ter sido aberto em um modo que permita a escrita
+    if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
+        DP("ERROR: RegistryManager is in read-only mode @registry_manager_insert_at_end\n");
+        return -1;
+    }
+
+    //Trata os campos inválidos (os valores normalizados continuam visíveis a quem chamou)
+    for (int i = 0; i < arr_size; i++)
+        registry_prepare_for_write(reg_arr[i]);
+
+    //Reaproveita os registros livres, um a um
+    int last_RRN = -1;
+    int reused = 0;
+    char slot[REGISTRY_SIZE];
+    while (reused < arr_size && (last_RRN = _pop_free_registry(manager)) != -1) {
+        binary_write_registry(manager->bin_file, reg_arr[reused++]);
+        registry_live_bitmap_set(manager->live, last_RRN, true);
+        manager->currRRN++;
+
+        if (manager->change_callback_count > 0) {
+            binary_encode_registry(slot, reg_arr[reused-1]);
+            _notify_change(manager, last_RRN, NULL, slot);
+        }
+    }
+
+    //Escreve os demais registros ao fim do arquivo, em lotes com uma única escrita cada
+    int appended = arr_size - reused;
+    if (appended > 0) {
+        _seek_new_registry(manager);
+        binary_write_registries(manager->bin_file, reg_arr + reused, appended);
+        registry_live_bitmap_set_range(manager->live, manager->currRRN, appended);
+        manager->currRRN += appended;
+        last_RRN = manager->currRRN - 1;
+
+        for (int i = 0; manager->change_callback_count > 0 && i < appended; i++) {
+            binary_encode_registry(slot, reg_arr[reused + i]);
+            _notify_change(manager, last_RRN - appended + 1 + i, NULL, slot);
+        }
+
+        //Atualiza apenas ao fim de toda a operação o próximo RRN
+        reg_header_set_next_RRN(manager->header, reg_header_get_next_RRN(manager->header) + appended);
+    }
+
+    reg_header_set_registries_count(manager->header, reg_header_get_registries_count(manager->header) + arr_size);
+
+    _end_operations(manager, arr_size);
+    return last_RRN;
+}
+
 /**
- *  Adiciona um vetor de VirtualRegistries ao fim do arquivo binário
+ *  Adiciona um vetor de VirtualRegistries ao arquivo binário.
  *  Dessa forma, menos atualizações são feitas, pois o programa já sabe que
  *  serão inseridos diversos registros.
+ *  Se o arquivo tiver lista de registros livres, os registros removidos são reaproveitados antes
+ *  que o arquivo cresça; senão, todos são escritos ao fim do arquivo.
  *  Parâmetros:
  *      RegistryManager *manager -> gerenciador que possui o arquivo referido aberto
  *      VirtualRegistry *reg_arr -> vetor de registros a serem inseridos
@@ -408,43 +821,137 @@ void registry_manager_read_headers_from_disk(RegistryManager *manager) {
  *  Retorno: void
  */
 void registry_manager_insert_arr_at_end(RegistryManager *manager, VirtualRegistry **reg_arr, int arr_size) {
+    _insert_registries(manager, reg_arr, arr_size);
+}
+
+
+/**
+ *  Adiciona ao arquivo registros já codificados em memória (imagens de REGISTRY_SIZE bytes, como as geradas
+ *  por binary_encode_registry()). Os registros livres são reaproveitados (se houver lista de livres) e
+ *  os demais são escritos ao fim do arquivo com uma única escrita.
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador que possui o arquivo aberto em modo que permita a escrita
+ *      const char *slots -> imagens dos registros, consecutivas
+ *      int count -> quantidade de registros
+ *  Retorno: void
+ */
+void registry_manager_insert_slots_at_end(RegistryManager *manager, const char *slots, int count) {
     //Valida o estado atual com um manager instanciado e o arquivo aberto
-    if (manager == NULL || manager->bin_file == NULL) {
-        DP("ERROR: invalid RegistryManager state! @registry_manager_insert_at_end\n");
+    if (manager == NULL || manager->bin_file == NULL || (slots == NULL && count > 0) || count < 0) {
+        DP("ERROR: invalid RegistryManager state or parameters! @registry_manager_insert_slots_at_end\n");
         return;
     }
 
     //O arquivo deve ter sido aberto em um modo que permita a escrita
-    if (manager->requested_mode == READ) {
-        DP("ERROR: RegistryManager is in read-only mode @registry_manager_insert_at_end\n");
+    if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
+        DP("ERROR: RegistryManager is in read-only mode @registry_manager_insert_slots_at_end\n");
         return;
     }
 
-    //Posiciona o cursor do arquivo ao fim do arquivo
-    _seek_new_registry(manager);
+    if (count == 0) return;
 
-    //Escreve diversos registros
-    for (int i = 0; i < arr_size; i++) {
-        VirtualRegistry *curr_reg_data = reg_arr[i];
-        _write_current_registry(manager, curr_reg_data);
+    //Reaproveita os registros livres, um a um
+    int reused = 0, RRN;
+    while (reused < count && (RRN = _pop_free_registry(manager)) != -1) {
+        fwrite(slots + (size_t) reused * REG_SIZE, REG_SIZE, 1, manager->bin_file);
+        registry_live_bitmap_set(manager->live, RRN, true);
+        _notify_change(manager, RRN, NULL, slots + (size_t) reused * REG_SIZE);
+        manager->currRRN++;
+        reused++;
     }
 
-    //Atualiza apenas ao fim de toda a operação o próximo RRN
-    reg_header_set_next_RRN(manager->header, reg_header_get_next_RRN(manager->header) + arr_size);
-    reg_header_set_registries_count(manager->header, reg_header_get_registries_count(manager->header) + arr_size);
+    //Posiciona o cursor do arquivo ao fim do arquivo e escreve todos os demais registros de uma vez
+    int appended = count - reused;
+    if (appended > 0) {
+        _seek_new_registry(manager);
+        fwrite(slots + (size_t) reused * REG_SIZE, REG_SIZE, appended, manager->bin_file);
+        registry_live_bitmap_set_range(manager->live, manager->currRRN, appended);
+        for (int i = 0; manager->change_callback_count > 0 && i < appended; i++)
+            _notify_change(manager, manager->currRRN + i, NULL, slots + (size_t) (reused + i) * REG_SIZE);
+        manager->currRRN += appended;
+
+        //Atualiza apenas ao fim de toda a operação o próximo RRN
+        reg_header_set_next_RRN(manager->header, reg_header_get_next_RRN(manager->header) + appended);
+    }
+
+    reg_header_set_registries_count(manager->header, reg_header_get_registries_count(manager->header) + count);
+
+    _end_operations(manager, count);
 }
 
 
 /**
- *  Adiciona um registro ao fim do arquivo.
+ *  Adiciona um registro ao arquivo (em um registro livre, se houver lista de livres, ou ao fim do arquivo).
  *  Parâmetros:
  *      RegistryManager *manager -> gerenciador que possui o arquivo referido aberto
- *  Retorno: int - RRN no qual o registro foi inserido
+ *  Retorno: int - RRN no qual o registro foi inserido (-1 em caso de erro)
  */
 int registry_manager_insert_at_end(RegistryManager *manager, VirtualRegistry *reg_data) {
     //Inserir um registro é apenas um caso especial de inserir um vetor de tamanho 1
-    registry_manager_insert_arr_at_end(manager, &reg_data, 1);
-    return reg_header_get_next_RRN(manager->header) - 1;
+    return _insert_registries(manager, &reg_data, 1);
+}
+
+/**
+ *  Ativa a lista de registros livres do arquivo: os registros já removidos são encadeados (o RRN do próximo
+ *  registro livre é guardado logo após o indicador de remoção) e, a partir de então, as remoções entram na lista
+ *  e as inserções reaproveitam os registros da lista antes de aumentar o arquivo.
+ *  O arquivo continua legível como um arquivo da especificação (os registros removidos continuam marcados com -1).
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador com o arquivo aberto em modo que permita a escrita
+ *  Retorno:
+ *      bool -> indica se a lista foi ativada (true também se ela já existia)
+ */
+bool registry_manager_enable_free_list(RegistryManager *manager) {
+    if (manager == NULL || manager->bin_file == NULL || OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
+        DP("ERROR: invalid RegistryManager state! @registry_manager_enable_free_list()\n");
+        return false;
+    }
+
+    if (reg_header_has_free_list(manager->header)) return true;
+
+    //Obtém os RRNs dos registros removidos, em ordem
+    int removed_capacity = 64, removed_count = 0;
+    int *removed = malloc(removed_capacity * sizeof(int));
+    if (removed == NULL) {
+        DP("ERROR: not enough memory @registry_manager_enable_free_list()\n");
+        return false;
+    }
+
+    _seek_first_registry(manager);
+    int next_RRN = reg_header_get_next_RRN(manager->header);
+    char buffer[REGISTRY_SIZE];
+    for (int RRN = 0; RRN < next_RRN; RRN++) {
+        const char *slot = _read_current_slot(manager, buffer);
+        if (slot == NULL || !binary_slot_is_removed(slot)) continue;
+
+        if (removed_count == removed_capacity) {
+            int *bigger = realloc(removed, 2 * removed_capacity * sizeof(int));
+            if (bigger == NULL) {
+                DP("ERROR: not enough memory @registry_manager_enable_free_list()\n");
+                free(removed);
+                return false;
+            }
+            removed = bigger;
+            removed_capacity *= 2;
+        }
+        removed[removed_count++] = RRN;
+    }
+
+    //Encadeia os registros removidos, do menor RRN para o maior, para que o início do arquivo seja preenchido primeiro
+    for (int i = 0; i < removed_count; i++) {
+        long offset = (long) (removed[i]+1) * REG_SIZE + sizeof(int);
+        fseek(manager->bin_file, offset, SEEK_SET);
+        binary_write_int(manager->bin_file, (i+1 < removed_count) ? removed[i+1] : -1);
+    }
+
+    reg_header_enable_free_list(manager->header);
+    reg_header_set_free_list_head(manager->header, (removed_count > 0) ? removed[0] : -1);
+    free(removed);
+
+    //O cursor volta para uma posição conhecida
+    _seek_first_registry(manager);
+    _end_operations(manager, 1);
+    return true;
 }
 
 
@@ -511,6 +1018,10 @@ VirtualRegistry *registry_manager_fetch_at(RegistryManager *manager, int RRN) {
     //Indica que o registro é inexistente se o RRN for inexistente
     if (reg_header_get_next_RRN(manager->header) <= RRN || RRN < 0) return NULL;
 
+    //Registros removidos são identificados pelo mapa, sem leitura do arquivo
+    if (manager->live != NULL && !registry_live_bitmap_is_live(manager->live, RRN)) return NULL;
+
+    _advise_access(manager, MADV_RANDOM);
     return _read_registry_at(manager, RRN);
 }
 
@@ -541,34 +1052,320 @@ int registry_manager_for_each_match(RegistryManager *manager, VirtualRegistryArr
     //Garante que existem registros para sererm removidos
     if (registry_manager_is_empty(manager)) return 0;
 
+    //O mesmo registro é reaproveitado para todos os registros lidos (o callback não deve guardar o pointer recebido)
+    VirtualRegistry *reg_data = virtual_registry_create_buffered();
+    if (reg_data == NULL) {
+        DP("ERROR: couldn't create VirtualRegistry @registry_manager_for_each_match()\n");
+        return -1;
+    }
+
+    //Os termos de busca são compilados uma única vez e comparados com os bytes do registro, antes de interpretá-lo
+    RegistryPredicate *predicate = registry_predicate_compile(match_conditions);
+    if (predicate == NULL) {
+        DP("ERROR: couldn't compile search terms @registry_manager_for_each_match()\n");
+        virtual_registry_free(&reg_data);
+        return -1;
+    }
+
     //Move o cursor para o primeiro registro
+    _advise_access(manager, MADV_SEQUENTIAL);
     _seek_first_registry(manager);
 
     int reg_count = reg_header_get_registries_count(manager->header) + reg_header_get_removed_count(manager->header);
+    char buffer[REGISTRY_SIZE];
     for (int i = 0; i < reg_count; i++) {
-        VirtualRegistry *reg_data = _read_current_registry(manager);
+        //Sequências longas de registros removidos são puladas com um único seek (as curtas são lidas do buffer)
+        if (manager->live != NULL) {
+            int next_live = registry_live_bitmap_next_live(manager->live, i, reg_count);
+            if (next_live >= reg_count) break;
+            if (next_live - i >= REG_VIEW_PAGE_REGISTRIES) {
+                _seek_registry(manager, next_live);
+                i = next_live;
+            }
+        }
 
-        if (reg_data == NULL) continue;
+        const char *slot = _read_current_slot(manager, buffer);
+        if (slot == NULL || binary_slot_is_removed(slot)) continue;
 
-        //Verifica se o registro atual se encaixa em um dos termos de busca. Se sim, chame o callback
-        if (match_conditions == NULL || virtual_registry_array_contains(match_conditions, reg_data, virtual_registry_compare) == true) {
+        //Verifica se o registro atual se encaixa em um dos termos de busca. Se sim, interpreta-o e chama o callback
+        if (registry_predicate_matches(predicate, slot) && binary_decode_registry_into(slot, reg_data)) {
             callback_func(manager, reg_data);
 			foundRegistries++;
         }
+    }
+
+    //Libera a memória do registro e dos termos compilados na RAM
+    registry_predicate_free(&predicate);
+    virtual_registry_free(&reg_data);
 
-        //Libera a memória do registro na RAM
+	return foundRegistries;
+}
+
+/**
+ *  Percorre apenas os registros candidatos informados (ex.: RRNs obtidos de um índice), chamando o callback para
+ *  os que condigam com um dos termos de busca, como registry_manager_for_each_match(). Os registros são visitados
+ *  na ordem do vetor e, ao chamar o callback, o cursor está logo após o registro (como na varredura completa).
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador que tem o arquivo aberto (pode ser modo leitura também)
+ *      const int *RRNs -> vetor de RRNs candidatos, em ordem crescente e sem repetições
+ *      int RRN_count -> tamanho do vetor
+ *      VirtualRegistryArray *match_conditions -> vetor de termos de busca (NULL indica todos os candidatos)
+ *      RMForeachCallback callback_func -> função chamada para cada registro encontrado
+ *  Retorno:
+ *      int -> número de registros encontrados, ou -1 em caso de erro
+ */
+int registry_manager_for_each_match_at(RegistryManager *manager, const int *RRNs, int RRN_count, VirtualRegistryArray *match_conditions, RMForeachCallback callback_func) {
+    //Validação de parâmetros
+    if (manager == NULL || callback_func == NULL || (RRNs == NULL && RRN_count > 0)) {
+        DP("ERROR: (parameter) invalid parameter @registry_manager_for_each_match_at()\n");
+        return -1;
+    }
+
+    if (RRN_count <= 0 || registry_manager_is_empty(manager)) return 0;
+
+    VirtualRegistry *reg_data = virtual_registry_create_buffered();
+    if (reg_data == NULL) {
+        DP("ERROR: couldn't create VirtualRegistry @registry_manager_for_each_match_at()\n");
+        return -1;
+    }
+
+    RegistryPredicate *predicate = registry_predicate_compile(match_conditions);
+    if (predicate == NULL) {
+        DP("ERROR: couldn't compile search terms @registry_manager_for_each_match_at()\n");
         virtual_registry_free(&reg_data);
+        return -1;
     }
 
+    _advise_access(manager, MADV_RANDOM);
+
+    int foundRegistries = 0;
+    int next_RRN = reg_header_get_next_RRN(manager->header);
+    char buffer[REGISTRY_SIZE];
+    for (int i = 0; i < RRN_count; i++) {
+        int RRN = RRNs[i];
+        if (RRN < 0 || RRN >= next_RRN) continue;
+
+        //Candidatos já removidos são descartados pelo mapa, sem leitura do arquivo
+        if (manager->live != NULL && !registry_live_bitmap_is_live(manager->live, RRN)) continue;
+
+        if (manager->currRRN != RRN) _seek_registry(manager, RRN);
+        const char *slot = _read_current_slot(manager, buffer);
+        if (slot == NULL || binary_slot_is_removed(slot)) continue;
+
+        if (registry_predicate_matches(predicate, slot) && binary_decode_registry_into(slot, reg_data)) {
+            callback_func(manager, reg_data);
+            foundRegistries++;
+        }
+    }
+
+    registry_predicate_free(&predicate);
+    virtual_registry_free(&reg_data);
+
+    return foundRegistries;
+}
+
+/*
+	Funcao (privada) que obtém uma página de registros consecutivos para as varreduras sem cópia.
+	Com o arquivo mapeado, a página aponta diretamente para o mapeamento. Senão, os registros são lidos
+	para o buffer com uma única leitura. O cursor deve estar no primeiro registro da página.
+	Parametros:
+		manager -> o gerenciador
+		count -> quantidade de registros desejada
+		buffer -> buffer com espaço para count registros (usado apenas sem mapeamento)
+		page_ptr -> onde será guardado o início da página
+	Retorno:
+		int -> quantidade de registros disponíveis na página (pode ser menor que count no fim do arquivo)
+*/
+static int _read_registry_page(RegistryManager *manager, int count, char *buffer, const char **page_ptr) {
+	int first_RRN = manager->currRRN;
+
+	if (manager->map_base != NULL) {
+		//Quantidade de registros inteiros no mapeamento (desconsiderando o header)
+		int mapped_registries = manager->map_size / REG_SIZE - 1;
+		if (first_RRN >= mapped_registries) return 0;
+		if (count > mapped_registries - first_RRN) count = mapped_registries - first_RRN;
+
+		*page_ptr = _mapped_slot(manager, first_RRN);
+	} else {
+		count = fread(buffer, REG_SIZE, count, manager->bin_file);
+		*page_ptr = buffer;
+	}
+
+	manager->currRRN += count;
+	return count;
+}
+
+static int _for_each_view_match(RegistryManager *manager, VirtualRegistryArray *match_conditions, RMViewCallback callback_func, RMViewContextCallback context_func, void *context);
+
+/**
+ *  Percorre todos os registros que condigam com um dos termos de busca, como registry_manager_for_each_match(),
+ *  mas sem criar nenhum VirtualRegistry: os registros são lidos em páginas (ou acessados diretamente no arquivo mapeado)
+ *  e o callback recebe apenas uma visão (RegistryView) de cada registro.
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador que tem o arquivo aberto (pode ser modo leitura também)
+ *      VirtualRegistryArray *match_conditions -> vetor de termos de busca (NULL indica todos os registros)
+ *      RMViewCallback callback_func -> função chamada para cada registro encontrado
+ *  Retorno:
+ *      int -> número de registros encontrados
+ */
+int registry_manager_for_each_view_match(RegistryManager *manager, VirtualRegistryArray *match_conditions, RMViewCallback callback_func) {
+	return _for_each_view_match(manager, match_conditions, callback_func, NULL, NULL);
+}
+
+/*
+	Funcao (privada) que faz a varredura de registry_manager_for_each_view_match(), chamando para cada registro encontrado
+	callback_func ou, se ele for NULL, context_func com o contexto informado
+*/
+static int _for_each_view_match(RegistryManager *manager, VirtualRegistryArray *match_conditions, RMViewCallback callback_func, RMViewContextCallback context_func, void *context) {
+	int foundRegistries = 0;
+
+	//Validação de parâmetros
+	if (manager == NULL || (callback_func == NULL && context_func == NULL)) {
+		DP("ERROR: (parameter) invalid parameter @registry_manager_for_each_view_match()\n");
+		return -1;
+	}
+
+	if (registry_manager_is_empty(manager)) return 0;
+
+	//Os termos de busca são compilados uma única vez e comparados com os bytes de cada registro
+	RegistryPredicate *predicate = registry_predicate_compile(match_conditions);
+	if (predicate == NULL) {
+		DP("ERROR: couldn't compile search terms @registry_manager_for_each_view_match()\n");
+		return -1;
+	}
+
+	//Buffer da página atual (não é usado quando o arquivo está mapeado)
+	char page_buffer[REG_VIEW_PAGE_REGISTRIES * REG_SIZE];
+
+	//Move o cursor para o primeiro registro
+	_advise_access(manager, MADV_SEQUENTIAL);
+	_seek_first_registry(manager);
+
+	int reg_count = reg_header_get_registries_count(manager->header) + reg_header_get_removed_count(manager->header);
+	while (manager->currRRN < reg_count) {
+		//Cada página começa no próximo registro existente (os removidos antes dele não são lidos)
+		if (manager->live != NULL) {
+			int next_live = registry_live_bitmap_next_live(manager->live, manager->currRRN, reg_count);
+			if (next_live >= reg_count) break;
+			if (next_live != manager->currRRN) _seek_registry(manager, next_live);
+		}
+
+		int page_first_RRN = manager->currRRN;
+		int wanted = reg_count - page_first_RRN;
+		if (wanted > REG_VIEW_PAGE_REGISTRIES) wanted = REG_VIEW_PAGE_REGISTRIES;
+
+		const char *page;
+		int page_count = _read_registry_page(manager, wanted, page_buffer, &page);
+		if (page_count <= 0) break;
+
+		for (int i = 0; i < page_count; i++) {
+			RegistryView view = registry_view_create(page + i * REG_SIZE, page_first_RRN + i);
+			if (registry_view_is_removed(view)) continue;
+
+			//Verifica se o registro atual se encaixa em um dos termos de busca. Se sim, chame o callback
+			if (registry_predicate_matches(predicate, view.slot)) {
+				if (callback_func != NULL) callback_func(manager, view);
+				else context_func(manager, view, context);
+				foundRegistries++;
+			}
+		}
+	}
+
+	registry_predicate_free(&predicate);
 	return foundRegistries;
 }
 
+//Contexto repassado pela varredura paralela para a função de emissão
+typedef struct {
+	RegistryManager *manager;
+	RMViewCallback callback_func;
+} _ParallelScanContext;
+
+static void _parallel_scan_emit(RegistryView view, void *context) {
+	_ParallelScanContext *scan_context = context;
+	scan_context->callback_func(scan_context->manager, view);
+}
+
+/**
+ *  Versão paralela de registry_manager_for_each_view_match(): o intervalo de RRNs é dividido entre várias threads,
+ *  que leem (com pread() ou pelo mapeamento) e filtram seus registros de forma independente.
+ *  O callback é chamado na thread atual e em ordem de RRN, portanto o resultado é idêntico ao da versão sequencial.
+ *  Arquivos pequenos (com apenas um pedaço) são varridos sequencialmente.
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador que tem o arquivo aberto (pode ser modo leitura também)
+ *      VirtualRegistryArray *match_conditions -> vetor de termos de busca (NULL indica todos os registros)
+ *      RMViewCallback callback_func -> função chamada para cada registro encontrado
+ *      int thread_count -> quantidade de threads (<= 0 usa uma por processador)
+ *  Retorno:
+ *      int -> número de registros encontrados
+ */
+int registry_manager_parallel_for_each_view_match(RegistryManager *manager, VirtualRegistryArray *match_conditions, RMViewCallback callback_func, int thread_count) {
+	//Validação de parâmetros
+	if (manager == NULL || manager->bin_file == NULL || callback_func == NULL) {
+		DP("ERROR: (parameter) invalid parameter @registry_manager_parallel_for_each_view_match()\n");
+		return -1;
+	}
+
+	if (registry_manager_is_empty(manager)) return 0;
+
+	int reg_count = reg_header_get_registries_count(manager->header) + reg_header_get_removed_count(manager->header);
+	//Com log, as escritas do lote aberto ainda não estão no disco e só são vistas pela stream: a varredura é sequencial
+	if (reg_count <= REGISTRY_SCAN_CHUNK_REGISTRIES || thread_count == 1 || manager->wal != NULL)
+		return registry_manager_for_each_view_match(manager, match_conditions, callback_func);
+
+	RegistryPredicate *predicate = registry_predicate_compile(match_conditions);
+	if (predicate == NULL) {
+		DP("ERROR: couldn't compile search terms @registry_manager_parallel_for_each_view_match()\n");
+		return -1;
+	}
+
+	//As threads leem o arquivo diretamente (pread), portanto escritas pendentes na stream devem ir para o disco antes
+	if (manager->map_base == NULL) fflush(manager->bin_file);
+	_advise_access(manager, MADV_SEQUENTIAL);
+
+	RegistryScanSource source;
+	source.fd = fileno(manager->bin_file);
+	source.map_base = manager->map_base;
+	source.map_size = manager->map_size;
+	source.reg_count = reg_count;
+
+	_ParallelScanContext context;
+	context.manager = manager;
+	context.callback_func = callback_func;
+
+	int foundRegistries = registry_parallel_scan(source, predicate, thread_count, _parallel_scan_emit, &context);
+
+	//Deixa o cursor no mesmo lugar em que a varredura sequencial o deixaria
+	_seek_registry(manager, reg_count);
+
+	registry_predicate_free(&predicate);
+	return foundRegistries;
+}
+
+void registry_manager_for_each_view(RegistryManager *manager, RMViewCallback callback_func) {
+	registry_manager_for_each_view_match(manager, NULL, callback_func);
+}
+
+/**
+ *  Assim como registry_manager_for_each_view(), percorre todos os registros existentes, mas repassa um contexto ao callback
+ *  (para que o estado da varredura não precise ser capturado por uma função aninhada)
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador que tem o arquivo aberto (pode ser modo leitura também)
+ *      RMViewContextCallback callback_func -> função chamada para cada registro
+ *      void *context -> repassado para callback_func
+ *  Retorno: void
+ */
+void registry_manager_for_each_view_with_context(RegistryManager *manager, RMViewContextCallback callback_func, void *context) {
+	_for_each_view_match(manager, NULL, NULL, callback_func, context);
+}
+
 void _DMForeachCallback_remove(RegistryManager *manager, VirtualRegistry *reg) {
     //Supõe-se que o registro recebido já foi lido e por isso o cursor se encontra um registro além
     _jump_registry(manager, BACK);
     _delete_current_registry(manager);
     reg_header_set_removed_count(manager->header, H_INCREASE);
     reg_header_set_registries_count(manager->header, H_DECREASE);
+    _end_operations(manager, 1);
 }
 
 /**
@@ -582,6 +1379,19 @@ void registry_manager_remove_matches (RegistryManager *manager, VirtualRegistryA
     registry_manager_for_each_match(manager, match_terms_arr, _DMForeachCallback_remove);
 } 
 
+/**
+ *  Remove, dentre os registros candidatos informados, os que se encaixem em um dos termos especificados.
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador que  possui o arquivo aberto
+ *      const int *RRNs -> vetor de RRNs candidatos, em ordem crescente e sem repetições
+ *      int RRN_count -> tamanho do vetor
+ *      VirtualRegistryArray *search_terms_array -> vetor de termos de busca
+ *  Retorno: void
+ */
+void registry_manager_remove_matches_at (RegistryManager *manager, const int *RRNs, int RRN_count, VirtualRegistryArray *match_terms_arr) {
+    registry_manager_for_each_match_at(manager, RRNs, RRN_count, match_terms_arr, _DMForeachCallback_remove);
+}
+
 /**
  *  Atualiza no disco um registro dado um RRN
  *  Parâmetros:
@@ -603,18 +1413,34 @@ void registry_manager_update_at(RegistryManager *manager, int RRN, VirtualRegist
         return;
     }
 
-    if (manager->requested_mode == READ) {
+    if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode)) {
         DP("ERROR: RegistryManager is in read-only mode @registry_manager_update_at()\n");
         return;
     }
 
     if (reg_header_get_next_RRN(manager->header) <= RRN) return;
 
+    //O registro antigo só é lido se alguém precisar ser informado da atualização
+    char old_slot[REGISTRY_SIZE], new_slot[REGISTRY_SIZE];
+    bool notify = false;
+    if (manager->change_callback_count > 0) {
+        _seek_registry(manager, RRN);
+        notify = binary_read_registry_slot(manager->bin_file, old_slot) && !binary_slot_is_removed(old_slot);
+    }
+
     _seek_registry(manager, RRN);
 
     if (_update_current_registry(manager, new_data) == true) { //Indica que o registro a ser atualizado não era deletado e não houveram mais erros
         reg_header_set_updated_count(manager->header, H_INCREASE);
+
+        //Informa os valores antigos e os novos (relidos do arquivo, já que apenas alguns campos foram escritos)
+        if (notify) {
+            _seek_registry(manager, RRN);
+            if (binary_read_registry_slot(manager->bin_file, new_slot)) _notify_change(manager, RRN, old_slot, new_slot);
+            manager->currRRN++;
+        }
     }
+    _end_operations(manager, 1);
 }   
 
 void registry_manager_for_each(RegistryManager *manager, RMForeachCallback callback_func) {
@@ -636,4 +1462,258 @@ RegistryHeader *registry_manager_get_registry_header (RegistryManager *manager)
     }
 
     return manager->header;
-}
\ No newline at end of file
+}
+
+
+/**
+ *  Compacta o arquivo de registros: copia apenas os registros existentes, em ordem, para um arquivo novo
+ *  (lendo e escrevendo em páginas, com memória limitada) e preenche o mapa RRN antigo -> RRN novo,
+ *  usado para atualizar os índices. O arquivo atual não é alterado, e pode continuar sendo lido.
+ *  O arquivo novo é escrito como consistente e sincronizado com o disco; a troca (rename) fica a cargo de quem chamou.
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador com o arquivo aberto (pode ser modo leitura)
+ *      char *new_filename -> nome do arquivo compactado a ser criado
+ *      RegistryRRNMap *map -> mapa criado com a quantidade de RRNs do arquivo (o próximo RRN do header)
+ *  Retorno:
+ *      long -> quantidade de bytes recuperados (diferença de tamanho entre os arquivos), ou -1 em caso de erro
+ */
+long registry_manager_compact_to(RegistryManager *manager, char *new_filename, RegistryRRNMap *map) {
+	if (manager == NULL || manager->bin_file == NULL || new_filename == NULL || map == NULL) {
+		DP("ERROR: invalid parameters @registry_manager_compact_to()\n");
+		return -1;
+	}
+
+	FILE *new_file = fopen(new_filename, "wb");
+	if (new_file == NULL) return -1;
+
+	//Header do arquivo novo: apenas os registros existentes, sem removidos (o lixo é escrito na criação)
+	int next_RRN = reg_header_get_next_RRN(manager->header);
+	RegistryHeader *new_header = reg_header_create();
+	reg_header_write_to_bin(new_header, new_file);
+
+	//Copia os registros existentes, página a página
+	char *in_page = malloc(REG_VIEW_PAGE_REGISTRIES * REG_SIZE);
+	char *out_page = malloc(REG_VIEW_PAGE_REGISTRIES * REG_SIZE);
+	bool ok = (in_page != NULL && out_page != NULL);
+
+	_advise_access(manager, MADV_SEQUENTIAL);
+	_seek_first_registry(manager);
+
+	int out_count = 0;
+	for (int RRN = 0; ok && RRN < next_RRN; ) {
+		int wanted = next_RRN - RRN;
+		if (wanted > REG_VIEW_PAGE_REGISTRIES) wanted = REG_VIEW_PAGE_REGISTRIES;
+
+		const char *page;
+		int count = _read_registry_page(manager, wanted, in_page, &page);
+		if (count <= 0) break;
+
+		for (int i = 0; i < count; i++, RRN++) {
+			const char *slot = page + i * REG_SIZE;
+			if (binary_slot_is_removed(slot)) continue;
+
+			memcpy(out_page + out_count * REG_SIZE, slot, REG_SIZE);
+			registry_rrn_map_set_live(map, RRN);
+			if (++out_count == REG_VIEW_PAGE_REGISTRIES) {
+				ok = fwrite(out_page, REG_SIZE, out_count, new_file) == (size_t) out_count;
+				out_count = 0;
+			}
+		}
+	}
+	if (ok && out_count > 0) ok = fwrite(out_page, REG_SIZE, out_count, new_file) == (size_t) out_count;
+
+	free(in_page);
+	free(out_page);
+
+	//Finaliza o header do arquivo novo (a lista de registros livres, se existir, continua ativa e vazia)
+	int live_count = registry_rrn_map_get_live_count(map);
+	reg_header_set_next_RRN(new_header, live_count);
+	reg_header_set_registries_count(new_header, live_count);
+	reg_header_set_removed_count(new_header, 0);
+	reg_header_set_updated_count(new_header, reg_header_get_updated_count(manager->header));
+	if (reg_header_has_free_list(manager->header)) reg_header_enable_free_list(new_header);
+	reg_header_set_status(new_header, '1');
+	reg_header_write_to_bin(new_header, new_file);
+
+	//O arquivo compactado não tem registros removidos: o mapa de registros existentes é um único intervalo
+	char *live_filename = _live_bitmap_filename(new_filename);
+	RegistryLiveBitmap *live = registry_live_bitmap_create();
+	registry_live_bitmap_set_range(live, 0, live_count);
+	registry_live_bitmap_write(live, live_filename, live_count, live_count, 0);
+	registry_live_bitmap_free(&live);
+	reg_header_delete(&new_header);
+
+	ok = ok && fflush(new_file) == 0 && fsync(fileno(new_file)) == 0;
+	ok = (fclose(new_file) == 0) && ok;
+
+	if (!ok) {
+		DP("ERROR: couldn't write the compacted file @registry_manager_compact_to()\n");
+		remove(new_filename);
+		if (live_filename != NULL) remove(live_filename);
+		free(live_filename);
+		return -1;
+	}
+
+	free(live_filename);
+
+	return (long) (next_RRN - live_count) * REG_SIZE;
+}
+
+/**
+ *  Substitui um arquivo de registros (fechado) por outro, como o gerado por registry_manager_compact_to(),
+ *  levando junto o arquivo auxiliar com o mapa de registros existentes. O mapa é trocado antes do arquivo de registros;
+ *  se o processo for interrompido entre as trocas, o mapa não corresponderá ao header e será ignorado.
+ *  Parâmetros:
+ *      char *new_filename -> nome do arquivo que ocupará o lugar do atual
+ *      char *bin_filename -> nome do arquivo a ser substituído
+ *  Retorno:
+ *      bool -> indica se o arquivo foi substituído
+ */
+bool registry_manager_replace_file(char *new_filename, char *bin_filename) {
+	if (new_filename == NULL || bin_filename == NULL) return false;
+
+	char *new_live_filename = _live_bitmap_filename(new_filename);
+	char *live_filename = _live_bitmap_filename(bin_filename);
+	if (new_live_filename == NULL || live_filename == NULL) {
+		free(new_live_filename);
+		free(live_filename);
+		return false;
+	}
+
+	if (rename(new_live_filename, live_filename) != 0) remove(live_filename);
+	free(new_live_filename);
+	free(live_filename);
+
+	//Os RRNs mudam, portanto as cópias colunares dos dois arquivos são descartadas (podem ser reconstruídas)
+	char *new_columns_filename = _column_store_filename(new_filename);
+	char *columns_filename = _column_store_filename(bin_filename);
+	if (new_columns_filename != NULL) remove(new_columns_filename);
+	if (columns_filename != NULL) remove(columns_filename);
+	free(new_columns_filename);
+	free(columns_filename);
+
+	return rename(new_filename, bin_filename) == 0;
+}
+
+/**
+ *  Adiciona uma função a ser chamada a cada modificação de registro feita pelo gerenciador: inserção (old_view NULL),
+ *  remoção (new_view NULL) e atualização (ambos). Usada para manter estruturas auxiliares, como índices, atualizadas.
+ *  As funções são chamadas na ordem em que foram adicionadas.
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador
+ *      RMChangeCallback callback_func -> função a ser chamada
+ *      void *context -> repassado para callback_func
+ *  Retorno:
+ *      bool -> false se já houver REGISTRY_MANAGER_MAX_CHANGE_CALLBACKS funções
+ */
+bool registry_manager_add_change_callback(RegistryManager *manager, RMChangeCallback callback_func, void *context) {
+	if (manager == NULL || callback_func == NULL) {
+		DP("ERROR: (parameter) invalid parameter @registry_manager_add_change_callback()\n");
+		return false;
+	}
+
+	if (manager->change_callback_count == REGISTRY_MANAGER_MAX_CHANGE_CALLBACKS) {
+		DP("ERROR: too many change callbacks @registry_manager_add_change_callback()\n");
+		return false;
+	}
+
+	manager->change_callbacks[manager->change_callback_count] = callback_func;
+	manager->change_contexts[manager->change_callback_count] = context;
+	manager->change_callback_count++;
+	return true;
+}
+
+/**
+ *  Remove uma função adicionada com registry_manager_add_change_callback() (com o mesmo contexto)
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador
+ *      RMChangeCallback callback_func -> função a ser removida
+ *      void *context -> contexto com o qual foi adicionada
+ *  Retorno: void
+ */
+void registry_manager_remove_change_callback(RegistryManager *manager, RMChangeCallback callback_func, void *context) {
+	if (manager == NULL) return;
+
+	for (int i = 0; i < manager->change_callback_count; i++) {
+		if (manager->change_callbacks[i] != callback_func || manager->change_contexts[i] != context) continue;
+
+		for (int j = i+1; j < manager->change_callback_count; j++) {
+			manager->change_callbacks[j-1] = manager->change_callbacks[j];
+			manager->change_contexts[j-1] = manager->change_contexts[j];
+		}
+		manager->change_callback_count--;
+		return;
+	}
+}
+
+/**
+ *  Obtém a cópia colunar do arquivo (ver registry_column_store.h). Nos modos de leitura, ela é carregada do arquivo
+ *  auxiliar no primeiro uso; no modo MODIFY, ela existe apenas se o arquivo auxiliar existia na abertura ou se foi
+ *  construída com registry_manager_build_column_store().
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador com o arquivo aberto
+ *  Retorno:
+ *      RegistryColumnStore* -> a cópia colunar (pertence ao gerenciador), ou NULL se ela não existir ou não for válida
+ */
+RegistryColumnStore *registry_manager_get_column_store(RegistryManager *manager) {
+	if (manager == NULL || manager->bin_file == NULL) return NULL;
+
+	if (OPEN_MODE_IS_READ_ONLY(manager->requested_mode) && !manager->columns_loaded) _load_column_store(manager);
+	return registry_column_store_is_valid(manager->columns) ? manager->columns : NULL;
+}
+
+/**
+ *  Constrói a cópia colunar lendo todos os registros do arquivo. Nos modos de leitura, ela é escrita imediatamente no
+ *  arquivo auxiliar; nos demais, ela acompanha as modificações seguintes e é escrita no fechamento.
+ *  O cursor volta para o primeiro registro.
+ *  Parâmetros:
+ *      RegistryManager *manager -> gerenciador com o arquivo aberto
+ *  Retorno:
+ *      bool -> indica se a cópia colunar foi construída
+ */
+bool registry_manager_build_column_store(RegistryManager *manager) {
+	if (manager == NULL || manager->bin_file == NULL || manager->requested_mode == CREATE) {
+		DP("ERROR: RegistryManager is in an invalid state @registry_manager_build_column_store()\n");
+		return false;
+	}
+
+	bool read_only = OPEN_MODE_IS_READ_ONLY(manager->requested_mode);
+	if (!read_only && manager->columns != NULL) registry_manager_remove_change_callback(manager, _RMChange_sync_columns, NULL);
+	registry_column_store_free(&manager->columns);
+	manager->columns_loaded = true;
+
+	RegistryColumnStore *columns = registry_column_store_create();
+	if (columns == NULL) return false;
+
+	char page_buffer[REG_VIEW_PAGE_REGISTRIES * REG_SIZE];
+	int next_RRN = reg_header_get_next_RRN(manager->header);
+	registry_column_store_set_count(columns, next_RRN);
+
+	_seek_first_registry(manager);
+	while (manager->currRRN < next_RRN) {
+		int page_first_RRN = manager->currRRN;
+		int wanted = next_RRN - page_first_RRN;
+		if (wanted > REG_VIEW_PAGE_REGISTRIES) wanted = REG_VIEW_PAGE_REGISTRIES;
+
+		const char *page;
+		int page_count = _read_registry_page(manager, wanted, page_buffer, &page);
+		if (page_count <= 0) break;
+
+		for (int i = 0; i < page_count; i++) registry_column_store_set(columns, page_first_RRN + i, page + i * REG_SIZE);
+	}
+	_seek_first_registry(manager);
+
+	if (!registry_column_store_is_valid(columns) || registry_column_store_get_count(columns) != next_RRN) {
+		registry_column_store_free(&columns);
+		return false;
+	}
+
+	manager->columns = columns;
+	if (read_only) {
+		return registry_column_store_write(columns, manager->columns_filename, next_RRN,
+			reg_header_get_registries_count(manager->header),
+			reg_header_get_removed_count(manager->header),
+			reg_header_get_updated_count(manager->header));
+	}
+	return registry_manager_add_change_callback(manager, _RMChange_sync_columns, NULL);
+}
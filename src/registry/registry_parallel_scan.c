@@ -0,0 +1,245 @@
+#include "registry_parallel_scan.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "binary_registry.h"
+#include "debug.h"
+
+/*
+    Espaço onde uma thread guarda o resultado de um pedaço (chunk) do arquivo até que ele seja emitido.
+    Sem mapeamento, os registros do pedaço são lidos para "records" e os encontrados são compactados no início do buffer.
+    Com mapeamento, apenas os RRNs encontrados são guardados (os registros são acessados diretamente no mapeamento).
+*/
+typedef struct {
+    int chunk;              //Pedaço guardado no espaço (-1 se nenhum)
+    bool done;              //Indica que o pedaço já foi processado e pode ser emitido
+    char *records;
+    int *RRNs;
+    int count;              //Quantidade de registros encontrados no pedaço
+} ScanSlot;
+
+/*
+    Estado compartilhado da varredura. As threads pegam os pedaços em ordem crescente; a thread principal
+    os emite também em ordem. Como há apenas "window" espaços, uma thread que estiver muito à frente
+    espera até que o espaço do seu pedaço seja liberado pela emissão.
+*/
+typedef struct {
+    RegistryScanSource source;
+    RegistryPredicate *predicate;
+
+    pthread_mutex_t lock;
+    pthread_cond_t chunk_done;      //Sinalizado quando um pedaço termina de ser processado
+    pthread_cond_t slot_free;       //Sinalizado quando um pedaço é emitido (liberando seu espaço)
+
+    int chunk_count;
+    int next_chunk;                 //Próximo pedaço a ser pego por uma thread
+    int next_emit;                  //Próximo pedaço a ser emitido
+    int window;
+    ScanSlot *slots;                //O pedaço i usa o espaço i % window
+} ParallelScan;
+
+//Retorna a quantidade de threads usada por padrão (uma por processador, com um máximo)
+int registry_scan_default_thread_count(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return 1;
+    if (cpus > REGISTRY_SCAN_MAX_THREADS) return REGISTRY_SCAN_MAX_THREADS;
+    return (int) cpus;
+}
+
+/*
+    Lê e filtra um pedaço do arquivo
+    Parametros:
+        scan -> estado da varredura
+        chunk -> índice do pedaço
+        slot -> espaço onde o resultado será guardado
+*/
+static void _scan_chunk(ParallelScan *scan, int chunk, ScanSlot *slot) {
+    int first_RRN = chunk * REGISTRY_SCAN_CHUNK_REGISTRIES;
+    int count = scan->source.reg_count - first_RRN;
+    if (count > REGISTRY_SCAN_CHUNK_REGISTRIES) count = REGISTRY_SCAN_CHUNK_REGISTRIES;
+
+    const char *records;
+    if (scan->source.map_base != NULL) {
+        //Registros inteiros disponíveis no mapeamento (desconsiderando o header)
+        int mapped_registries = scan->source.map_size / REGISTRY_SIZE - 1;
+        if (count > mapped_registries - first_RRN) count = mapped_registries - first_RRN;
+        records = scan->source.map_base + (size_t) (first_RRN + 1) * REGISTRY_SIZE;
+    } else {
+        //Cada thread tem seu próprio "cursor": pread() não altera a posição compartilhada do arquivo
+        ssize_t read_bytes = pread(scan->source.fd, slot->records, (size_t) count * REGISTRY_SIZE, (off_t) (first_RRN + 1) * REGISTRY_SIZE);
+        count = (read_bytes < 0) ? 0 : read_bytes / REGISTRY_SIZE;
+        records = slot->records;
+    }
+
+    slot->count = 0;
+    for (int i = 0; i < count; i++) {
+        const char *record = records + (size_t) i * REGISTRY_SIZE;
+        if (binary_slot_is_removed(record) || !registry_predicate_matches(scan->predicate, record)) continue;
+
+        //Compacta os registros encontrados no início do buffer (não é necessário com mapeamento)
+        if (scan->source.map_base == NULL && slot->count != i)
+            memcpy(slot->records + (size_t) slot->count * REGISTRY_SIZE, record, REGISTRY_SIZE);
+
+        slot->RRNs[slot->count++] = first_RRN + i;
+    }
+}
+
+//Função executada por cada thread: processa pedaços até que não haja mais nenhum
+static void *_scan_worker(void *arg) {
+    ParallelScan *scan = arg;
+
+    pthread_mutex_lock(&scan->lock);
+    while (scan->next_chunk < scan->chunk_count) {
+        int chunk = scan->next_chunk++;
+
+        //Espera o espaço do pedaço ser liberado
+        while (chunk >= scan->next_emit + scan->window)
+            pthread_cond_wait(&scan->slot_free, &scan->lock);
+
+        ScanSlot *slot = &scan->slots[chunk % scan->window];
+        slot->chunk = chunk;
+        pthread_mutex_unlock(&scan->lock);
+
+        _scan_chunk(scan, chunk, slot);
+
+        pthread_mutex_lock(&scan->lock);
+        slot->done = true;
+        pthread_cond_broadcast(&scan->chunk_done);
+    }
+    pthread_mutex_unlock(&scan->lock);
+
+    return NULL;
+}
+
+//Libera os espaços de resultado
+static void _free_slots(ScanSlot *slots, int window) {
+    if (slots == NULL) return;
+
+    for (int i = 0; i < window; i++) {
+        free(slots[i].records);
+        free(slots[i].RRNs);
+    }
+    free(slots);
+}
+
+//Aloca os espaços de resultado (NULL em caso de falta de memória)
+static ScanSlot *_create_slots(int window, bool needs_records) {
+    ScanSlot *slots = calloc(window, sizeof(ScanSlot));
+    if (slots == NULL) return NULL;
+
+    for (int i = 0; i < window; i++) {
+        slots[i].chunk = -1;
+        slots[i].done = false;
+        slots[i].RRNs = malloc(sizeof(int) * REGISTRY_SCAN_CHUNK_REGISTRIES);
+        if (needs_records) slots[i].records = malloc((size_t) REGISTRY_SCAN_CHUNK_REGISTRIES * REGISTRY_SIZE);
+
+        if (slots[i].RRNs == NULL || (needs_records && slots[i].records == NULL)) {
+            _free_slots(slots, window);
+            return NULL;
+        }
+    }
+
+    return slots;
+}
+
+/**
+ *  Varre o arquivo de registros com várias threads: o intervalo de RRNs é dividido em pedaços, que são lidos e
+ *  filtrados de forma independente. Os registros encontrados são emitidos na thread que chamou a função,
+ *  em ordem de RRN, ou seja, na mesma ordem de uma varredura sequencial.
+ *  Parâmetros:
+ *      RegistryScanSource source -> arquivo a ser varrido
+ *      RegistryPredicate *predicate -> filtros compilados (NULL aceita todos os registros)
+ *      int thread_count -> quantidade de threads (<= 0 usa registry_scan_default_thread_count())
+ *      RegistryScanEmitFunc emit -> função chamada para cada registro encontrado (a visão só é válida durante a chamada)
+ *      void *context -> valor repassado para a função emit
+ *  Retorno:
+ *      int -> quantidade de registros encontrados, ou -1 em caso de erro
+ */
+int registry_parallel_scan(RegistryScanSource source, RegistryPredicate *predicate, int thread_count, RegistryScanEmitFunc emit, void *context) {
+    if (emit == NULL || source.reg_count < 0 || (source.map_base == NULL && source.fd < 0)) {
+        DP("ERROR: invalid parameters @registry_parallel_scan()\n");
+        return -1;
+    }
+
+    if (thread_count <= 0) thread_count = registry_scan_default_thread_count();
+
+    ParallelScan scan;
+    scan.source = source;
+    scan.predicate = predicate;
+    scan.chunk_count = (source.reg_count + REGISTRY_SCAN_CHUNK_REGISTRIES - 1) / REGISTRY_SCAN_CHUNK_REGISTRIES;
+    scan.next_chunk = 0;
+    scan.next_emit = 0;
+
+    if (scan.chunk_count == 0) return 0;
+    if (thread_count > scan.chunk_count) thread_count = scan.chunk_count;
+
+    //Dois espaços por thread: enquanto um pedaço espera ser emitido, a thread já pode processar o próximo
+    scan.window = 2 * thread_count;
+    scan.slots = _create_slots(scan.window, source.map_base == NULL);
+    pthread_t *threads = malloc(sizeof(pthread_t) * thread_count);
+    if (scan.slots == NULL || threads == NULL) {
+        DP("ERROR: not enough memory for parallel scan @registry_parallel_scan()\n");
+        _free_slots(scan.slots, scan.window);
+        free(threads);
+        return -1;
+    }
+
+    pthread_mutex_init(&scan.lock, NULL);
+    pthread_cond_init(&scan.chunk_done, NULL);
+    pthread_cond_init(&scan.slot_free, NULL);
+
+    int started = 0;
+    for (; started < thread_count; started++) {
+        if (pthread_create(&threads[started], NULL, _scan_worker, &scan) != 0) break;
+    }
+
+    //Sem nenhuma thread, a própria thread principal processa os pedaços
+    bool sequential = (started == 0);
+    if (sequential) DP("WARNING: couldn't start scan threads, scanning sequentially @registry_parallel_scan()\n");
+
+    int found = 0;
+    for (int chunk = 0; chunk < scan.chunk_count; chunk++) {
+        ScanSlot *slot = &scan.slots[chunk % scan.window];
+
+        if (sequential) {
+            slot->chunk = chunk;
+            _scan_chunk(&scan, chunk, slot);
+        } else {
+            //Espera o pedaço ser processado
+            pthread_mutex_lock(&scan.lock);
+            while (!slot->done || slot->chunk != chunk)
+                pthread_cond_wait(&scan.chunk_done, &scan.lock);
+            pthread_mutex_unlock(&scan.lock);
+        }
+
+        for (int i = 0; i < slot->count; i++) {
+            const char *record = (source.map_base != NULL)
+                ? source.map_base + (size_t) (slot->RRNs[i] + 1) * REGISTRY_SIZE
+                : slot->records + (size_t) i * REGISTRY_SIZE;
+
+            emit(registry_view_create(record, slot->RRNs[i]), context);
+        }
+        found += slot->count;
+
+        //Libera o espaço para o pedaço chunk + window
+        pthread_mutex_lock(&scan.lock);
+        slot->done = false;
+        scan.next_emit++;
+        pthread_cond_broadcast(&scan.slot_free);
+        pthread_mutex_unlock(&scan.lock);
+    }
+
+    for (int i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+
+    pthread_cond_destroy(&scan.slot_free);
+    pthread_cond_destroy(&scan.chunk_done);
+    pthread_mutex_destroy(&scan.lock);
+    _free_slots(scan.slots, scan.window);
+    free(threads);
+
+    return found;
+}
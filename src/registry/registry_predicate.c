@@ -0,0 +1,276 @@
+#include "registry_predicate.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary_registry.h"
+#include "debug.h"
+
+/*
+    Os campos estáticos (idNascimento, idadeMae, dataNascimento, sexoBebe, estadoMae e estadoBebe) ocupam
+    o final do registro. Essa região é comparada em palavras de 8 bytes: cada filtro guarda, para cada palavra,
+    os bytes esperados e uma máscara com os bytes que importam. Assim, vários campos são comparados de uma só vez.
+*/
+#define PREDICATE_WORD_COUNT 3
+#define PREDICATE_STATIC_START (REGISTRY_SIZE - PREDICATE_WORD_COUNT * sizeof(uint64_t))
+
+//Tamanho máximo das cidades (as duas dividem o espaço dos campos variáveis, após seus tamanhos)
+#define PREDICATE_MAX_CITY_SIZE (REG_VARIABLE_FIELDS_TOTAL_SIZE - SLOT_VARIABLE_FIELDS_OFFSET)
+
+//Um filtro já compilado
+typedef struct {
+    uint64_t expected[PREDICATE_WORD_COUNT];    //Bytes esperados de cada palavra (já com a máscara aplicada)
+    uint64_t masks[PREDICATE_WORD_COUNT];       //Bytes relevantes de cada palavra
+    int cidadeMae_size;
+    char cidadeMae[PREDICATE_MAX_CITY_SIZE];
+    int cidadeBebe_size;
+    char cidadeBebe[PREDICATE_MAX_CITY_SIZE];
+} PredicateFilter;
+
+//Filtros com a mesma máscara de campos: as palavras lidas do registro são compartilhadas por todos eles
+typedef struct {
+    RegistryFieldsMask mask;
+    int words[PREDICATE_WORD_COUNT];            //Índices das palavras usadas pelos filtros do grupo
+    int word_count;
+    PredicateFilter *filters;
+    int filter_count;
+} PredicateGroup;
+
+/*
+    Struct que representa um vetor de filtros (VirtualRegistryFilter) compilado para ser comparado
+    diretamente com os bytes de um registro, sem que ele precise ser interpretado.
+*/
+struct _registry_predicate {
+    bool match_all;                             //Nenhum filtro informado (NULL): todos os registros são aceitos
+    PredicateGroup *groups;
+    int group_count;
+};
+
+//Copia um valor para a imagem esperada do registro, marcando os bytes como relevantes
+static void _set_expected(unsigned char *expected, unsigned char *mask, int offset, const void *value, int size) {
+    memcpy(expected + offset, value, size);
+    memset(mask + offset, 0xFF, size);
+}
+
+/*
+    Compila um campo de tamanho fixo. No disco, o campo termina no primeiro '\0' (ou ocupa todo o espaço),
+    portanto são comparados os caracteres do filtro e, se houver espaço, o '\0' que os segue.
+    Retorno:
+        bool. false se nenhum registro puder satisfazer o filtro (string nula ou maior que o campo)
+*/
+static bool _compile_fixed_string(unsigned char *expected, unsigned char *mask, int offset, int width, const char *value) {
+    if (value == NULL) return false;
+
+    int size = strlen(value);
+    if (size > width) return false;
+
+    _set_expected(expected, mask, offset, value, size);
+    if (size < width) _set_expected(expected, mask, offset + size, "", 1);
+    return true;
+}
+
+//Compila uma cidade (comparada pelo tamanho e pelo conteúdo). Retorna false se nenhum registro puder satisfazer o filtro
+static bool _compile_city(const char *value, int *size_ptr, char *dest) {
+    if (value == NULL) return false;
+
+    int size = strlen(value);
+    if (size > PREDICATE_MAX_CITY_SIZE) return false;
+
+    memcpy(dest, value, size);
+    *size_ptr = size;
+    return true;
+}
+
+/*
+    Compila um filtro
+    Parametros:
+        filter -> o filtro a ser compilado
+        compiled -> onde o filtro compilado será guardado
+    Retorno:
+        bool. false se nenhum registro puder satisfazer o filtro (nesse caso ele é descartado)
+*/
+static bool _compile_filter(VirtualRegistryFilter *filter, PredicateFilter *compiled) {
+    //Imagem esperada do registro e bytes relevantes dessa imagem
+    unsigned char expected[REGISTRY_SIZE] = {0};
+    unsigned char mask[REGISTRY_SIZE] = {0};
+
+    RegistryFieldsMask fields = filter->fieldMask;
+
+    if (fields & MASK_IDNASCIMENTO) _set_expected(expected, mask, SLOT_IDNASCIMENTO_OFFSET, &filter->idNascimento, sizeof(int));
+    if (fields & MASK_IDADEMAE) _set_expected(expected, mask, SLOT_IDADEMAE_OFFSET, &filter->idadeMae, sizeof(int));
+    if (fields & MASK_SEXOBEBE) _set_expected(expected, mask, SLOT_SEXOBEBE_OFFSET, &filter->sexoBebe, sizeof(char));
+
+    if ((fields & MASK_DATANASCIMENTO) && !_compile_fixed_string(expected, mask, SLOT_DATANASCIMENTO_OFFSET, 10, filter->dataNascimento))
+        return false;
+
+    if ((fields & MASK_ESTADOMAE) && !_compile_fixed_string(expected, mask, SLOT_ESTADOMAE_OFFSET, 2, filter->estadoMae))
+        return false;
+
+    if ((fields & MASK_ESTADOBEBE) && !_compile_fixed_string(expected, mask, SLOT_ESTADOBEBE_OFFSET, 2, filter->estadoBebe))
+        return false;
+
+    compiled->cidadeMae_size = compiled->cidadeBebe_size = 0;
+    if ((fields & MASK_CIDADEMAE) && !_compile_city(filter->cidadeMae, &compiled->cidadeMae_size, compiled->cidadeMae))
+        return false;
+
+    if ((fields & MASK_CIDADEBEBE) && !_compile_city(filter->cidadeBebe, &compiled->cidadeBebe_size, compiled->cidadeBebe))
+        return false;
+
+    //Empacota a região estática em palavras
+    for (int w = 0; w < PREDICATE_WORD_COUNT; w++) {
+        memcpy(&compiled->expected[w], expected + PREDICATE_STATIC_START + w * sizeof(uint64_t), sizeof(uint64_t));
+        memcpy(&compiled->masks[w], mask + PREDICATE_STATIC_START + w * sizeof(uint64_t), sizeof(uint64_t));
+    }
+
+    return true;
+}
+
+//Retorna o grupo com a máscara dada, criando-o se ainda não existir (NULL em caso de falta de memória)
+static PredicateGroup *_group_of(RegistryPredicate *predicate, RegistryFieldsMask mask, int max_filters) {
+    for (int i = 0; i < predicate->group_count; i++) {
+        if (predicate->groups[i].mask == mask) return &predicate->groups[i];
+    }
+
+    PredicateGroup *group = &predicate->groups[predicate->group_count];
+    group->filters = malloc(sizeof(PredicateFilter) * max_filters);
+    if (group->filters == NULL) return NULL;
+
+    group->mask = mask;
+    group->word_count = 0;
+    group->filter_count = 0;
+    predicate->group_count++;
+    return group;
+}
+
+/**
+ *  Compila um vetor de filtros para ser comparado diretamente com os bytes dos registros.
+ *  O resultado é equivalente a virtual_registry_array_contains() com virtual_registry_compare().
+ *  Parâmetros:
+ *      VirtualRegistryArray *filters -> vetor de filtros (NULL indica que todos os registros são aceitos).
+ *          Os filtros não precisam existir após a compilação.
+ *  Retorno:
+ *      RegistryPredicate* -> filtros compilados, ou NULL em caso de erro
+ */
+RegistryPredicate *registry_predicate_compile(VirtualRegistryArray *filters) {
+    RegistryPredicate *predicate = malloc(sizeof(RegistryPredicate));
+    if (predicate == NULL) {
+        DP("ERROR: not enough memory for RegistryPredicate @registry_predicate_compile()\n");
+        return NULL;
+    }
+
+    predicate->match_all = (filters == NULL);
+    predicate->groups = NULL;
+    predicate->group_count = 0;
+    if (filters == NULL || filters->size == 0) return predicate;
+
+    //No pior caso, cada filtro tem uma máscara diferente
+    predicate->groups = malloc(sizeof(PredicateGroup) * filters->size);
+    if (predicate->groups == NULL) {
+        DP("ERROR: not enough memory for RegistryPredicate groups @registry_predicate_compile()\n");
+        registry_predicate_free(&predicate);
+        return NULL;
+    }
+
+    for (int i = 0; i < filters->size; i++) {
+        VirtualRegistryFilter *filter = filters->data_arr[i];
+        if (filter == NULL) continue;
+
+        PredicateGroup *group = _group_of(predicate, filter->fieldMask, filters->size);
+        if (group == NULL) {
+            DP("ERROR: not enough memory for RegistryPredicate filters @registry_predicate_compile()\n");
+            registry_predicate_free(&predicate);
+            return NULL;
+        }
+
+        //Filtros impossíveis de serem satisfeitos são descartados
+        if (_compile_filter(filter, &group->filters[group->filter_count])) group->filter_count++;
+    }
+
+    //Define quais palavras cada grupo precisa ler do registro
+    for (int g = 0; g < predicate->group_count; g++) {
+        PredicateGroup *group = &predicate->groups[g];
+        for (int w = 0; w < PREDICATE_WORD_COUNT; w++) {
+            bool used = false;
+            for (int f = 0; f < group->filter_count && !used; f++)
+                used = group->filters[f].masks[w] != 0;
+
+            if (used) group->words[group->word_count++] = w;
+        }
+    }
+
+    return predicate;
+}
+
+/**
+ *  Verifica se um registro (em memória e não removido) satisfaz ao menos um dos filtros compilados
+ *  Parâmetros:
+ *      RegistryPredicate *predicate -> filtros compilados
+ *      const char *slot -> bytes do registro (REGISTRY_SIZE)
+ *  Retorno:
+ *      bool -> true se algum dos filtros for satisfeito
+ */
+bool registry_predicate_matches(RegistryPredicate *predicate, const char *slot) {
+    if (predicate == NULL || predicate->match_all) return true;
+
+    for (int g = 0; g < predicate->group_count; g++) {
+        PredicateGroup *group = &predicate->groups[g];
+
+        //Lê uma única vez as palavras usadas pelo grupo
+        uint64_t words[PREDICATE_WORD_COUNT];
+        for (int i = 0; i < group->word_count; i++) {
+            int w = group->words[i];
+            memcpy(&words[w], slot + PREDICATE_STATIC_START + w * sizeof(uint64_t), sizeof(uint64_t));
+        }
+
+        int cidadeMae_size = 0, cidadeBebe_size = 0;
+        if (group->mask & (MASK_CIDADEMAE | MASK_CIDADEBEBE))
+            binary_slot_cities_sizes(slot, &cidadeMae_size, &cidadeBebe_size);
+
+        for (int f = 0; f < group->filter_count; f++) {
+            PredicateFilter *filter = &group->filters[f];
+
+            bool matches = true;
+            for (int i = 0; i < group->word_count && matches; i++) {
+                int w = group->words[i];
+                matches = (words[w] & filter->masks[w]) == filter->expected[w];
+            }
+
+            if (matches && (group->mask & MASK_CIDADEMAE))
+                matches = cidadeMae_size == filter->cidadeMae_size
+                    && memcmp(slot + SLOT_VARIABLE_FIELDS_OFFSET, filter->cidadeMae, cidadeMae_size) == 0;
+
+            if (matches && (group->mask & MASK_CIDADEBEBE))
+                matches = cidadeBebe_size == filter->cidadeBebe_size
+                    && memcmp(slot + SLOT_VARIABLE_FIELDS_OFFSET + cidadeMae_size, filter->cidadeBebe, cidadeBebe_size) == 0;
+
+            if (matches) return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+    Funcao que desaloca a memoria dos filtros compilados
+    Parametros:
+        predicate_ptr -> o endereco dos filtros compilados
+*/
+void registry_predicate_free(RegistryPredicate **predicate_ptr) {
+    if (predicate_ptr == NULL) {
+        DP("ERROR: invalid parameter @registry_predicate_free()\n");
+        return;
+    }
+    #define predicate (*predicate_ptr)
+
+    //Já foi liberado
+    if (predicate == NULL) return;
+
+    for (int i = 0; i < predicate->group_count; i++)
+        free(predicate->groups[i].filters);
+
+    free(predicate->groups);
+    free(predicate);
+    predicate = NULL;
+    #undef predicate
+}
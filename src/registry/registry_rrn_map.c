@@ -0,0 +1,128 @@
+#include "registry_rrn_map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "debug.h"
+
+#define RRN_MAP_BLOCK_BITS 64
+
+/*
+    Struct que representa o mapa. live_bits tem um bit por registro antigo (1 = existente) e
+    prefix[b] guarda quantos registros existentes há antes do bloco b (recalculado apenas quando necessário)
+*/
+struct _registry_rrn_map {
+    uint64_t *live_bits;
+    int *prefix;
+    int block_count;
+    int RRN_count;
+    int live_count;
+    bool prefix_valid;
+};
+
+/*
+    Funcao que cria um mapa vazio (todos os registros removidos)
+    Parametros:
+        RRN_count -> quantidade de RRNs do arquivo antigo
+    Retorno:
+        RegistryRRNMap* . O mapa criado, ou NULL em caso de erro
+*/
+RegistryRRNMap *registry_rrn_map_create(int RRN_count) {
+    if (RRN_count < 0) {
+        DP("ERROR: invalid RRN count @registry_rrn_map_create()\n");
+        return NULL;
+    }
+
+    RegistryRRNMap *map = malloc(sizeof(RegistryRRNMap));
+    if (map == NULL) {
+        DP("ERROR: not enough memory for RegistryRRNMap @registry_rrn_map_create()\n");
+        return NULL;
+    }
+
+    map->block_count = RRN_count / RRN_MAP_BLOCK_BITS + 1;
+    map->live_bits = calloc(map->block_count, sizeof(uint64_t));
+    map->prefix = malloc(map->block_count * sizeof(int));
+    map->RRN_count = RRN_count;
+    map->live_count = 0;
+    map->prefix_valid = false;
+
+    if (map->live_bits == NULL || map->prefix == NULL) {
+        DP("ERROR: not enough memory for RegistryRRNMap @registry_rrn_map_create()\n");
+        registry_rrn_map_free(&map);
+        return NULL;
+    }
+
+    return map;
+}
+
+/*
+    Funcao que desaloca a memoria do mapa
+    Parametros:
+        map_ptr -> o endereco do mapa
+*/
+void registry_rrn_map_free(RegistryRRNMap **map_ptr) {
+    if (map_ptr == NULL || *map_ptr == NULL) return;
+
+    free((*map_ptr)->live_bits);
+    free((*map_ptr)->prefix);
+    free(*map_ptr);
+    *map_ptr = NULL;
+}
+
+/*
+    Marca um registro antigo como existente (ele ocupará, no arquivo novo, a posição seguinte aos existentes antes dele)
+    Parametros:
+        map -> o mapa
+        old_RRN -> RRN do registro no arquivo antigo
+*/
+void registry_rrn_map_set_live(RegistryRRNMap *map, int old_RRN) {
+    if (map == NULL || old_RRN < 0 || old_RRN >= map->RRN_count) {
+        DP("ERROR: invalid parameters @registry_rrn_map_set_live()\n");
+        return;
+    }
+
+    uint64_t bit = (uint64_t) 1 << (old_RRN % RRN_MAP_BLOCK_BITS);
+    if (map->live_bits[old_RRN / RRN_MAP_BLOCK_BITS] & bit) return;
+
+    map->live_bits[old_RRN / RRN_MAP_BLOCK_BITS] |= bit;
+    map->live_count++;
+    map->prefix_valid = false;
+}
+
+/*
+    Obtém o RRN novo de um registro: a quantidade de registros existentes antes dele
+    (contagem do bloco + popcount dos bits anteriores dentro do bloco)
+    Parametros:
+        map -> o mapa
+        old_RRN -> RRN do registro no arquivo antigo
+    Retorno:
+        int. o RRN no arquivo novo, ou -1 se o registro tiver sido removido (ou não existir)
+*/
+int registry_rrn_map_get(RegistryRRNMap *map, int old_RRN) {
+    if (map == NULL || old_RRN < 0 || old_RRN >= map->RRN_count) return -1;
+
+    if (!map->prefix_valid) {
+        int count = 0;
+        for (int b = 0; b < map->block_count; b++) {
+            map->prefix[b] = count;
+            count += __builtin_popcountll(map->live_bits[b]);
+        }
+        map->prefix_valid = true;
+    }
+
+    int block = old_RRN / RRN_MAP_BLOCK_BITS;
+    uint64_t bit = (uint64_t) 1 << (old_RRN % RRN_MAP_BLOCK_BITS);
+    if (!(map->live_bits[block] & bit)) return -1;
+
+    return map->prefix[block] + __builtin_popcountll(map->live_bits[block] & (bit - 1));
+}
+
+/*
+    Retorna a quantidade de registros marcados como existentes
+    Parametros:
+        map -> o mapa
+    Retorno:
+        int. a quantidade de registros existentes (o tamanho do arquivo novo, em registros)
+*/
+int registry_rrn_map_get_live_count(RegistryRRNMap *map) { return (map == NULL) ? 0 : map->live_count; }
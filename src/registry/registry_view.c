@@ -0,0 +1,173 @@
+#include "registry_view.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "binary_registry.h"
+#include "string_utils.h"
+#include "debug.h"
+
+/**
+ *  Cria uma visão de um registro que já está em memória. Nenhuma alocação é feita.
+ *  Parâmetros:
+ *      const char *slot -> início do registro (REGISTRY_SIZE bytes) em memória
+ *      int RRN -> RRN do registro no arquivo
+ *  Retorno:
+ *      RegistryView -> visão do registro
+ */
+RegistryView registry_view_create(const char *slot, int RRN) {
+    RegistryView view;
+    view.slot = slot;
+    view.RRN = RRN;
+    return view;
+}
+
+//Retorna se o registro visto está marcado como removido
+bool registry_view_is_removed(RegistryView view) {
+    return view.slot == NULL || binary_slot_is_removed(view.slot);
+}
+
+//Lê um int de uma posição do registro em memória
+static int _view_int(RegistryView view, int offset) {
+    int num;
+    memcpy(&num, view.slot + offset, sizeof(int));
+    return num;
+}
+
+/*
+    Cria o trecho de um campo de tamanho fixo. O campo termina no primeiro '\0' (campos vazios são
+    escritos como '\0' seguido de lixo), assim como na leitura para um VirtualRegistry
+*/
+static RegistryStringSlice _view_fixed_slice(RegistryView view, int offset, int max_size) {
+    RegistryStringSlice slice;
+    slice.data = view.slot + offset;
+    slice.size = 0;
+    while (slice.size < max_size && slice.data[slice.size] != '\0') slice.size++;
+    return slice;
+}
+
+RegistryStringSlice registry_view_get_cidadeMae(RegistryView view) {
+    int cidadeMae_size, cidadeBebe_size;
+    binary_slot_cities_sizes(view.slot, &cidadeMae_size, &cidadeBebe_size);
+
+    RegistryStringSlice slice;
+    slice.data = view.slot + SLOT_VARIABLE_FIELDS_OFFSET;
+    slice.size = cidadeMae_size;
+    return slice;
+}
+
+RegistryStringSlice registry_view_get_cidadeBebe(RegistryView view) {
+    int cidadeMae_size, cidadeBebe_size;
+    binary_slot_cities_sizes(view.slot, &cidadeMae_size, &cidadeBebe_size);
+
+    //A cidadeBebe começa logo após a cidadeMae
+    RegistryStringSlice slice;
+    slice.data = view.slot + SLOT_VARIABLE_FIELDS_OFFSET + cidadeMae_size;
+    slice.size = cidadeBebe_size;
+    return slice;
+}
+
+int registry_view_get_idNascimento(RegistryView view) { return _view_int(view, SLOT_IDNASCIMENTO_OFFSET); }
+int registry_view_get_idadeMae(RegistryView view) { return _view_int(view, SLOT_IDADEMAE_OFFSET); }
+RegistryStringSlice registry_view_get_dataNascimento(RegistryView view) { return _view_fixed_slice(view, SLOT_DATANASCIMENTO_OFFSET, 10); }
+char registry_view_get_sexoBebe(RegistryView view) { return view.slot[SLOT_SEXOBEBE_OFFSET]; }
+RegistryStringSlice registry_view_get_estadoMae(RegistryView view) { return _view_fixed_slice(view, SLOT_ESTADOMAE_OFFSET, 2); }
+RegistryStringSlice registry_view_get_estadoBebe(RegistryView view) { return _view_fixed_slice(view, SLOT_ESTADOBEBE_OFFSET, 2); }
+
+/*
+    Compara um trecho do registro com uma string terminada em '\0' (equivalente ao compare_string_field())
+    Retorno:
+        bool. true caso sejam iguais. false caso a string seja nula ou diferente
+*/
+static bool _slice_equals(RegistryStringSlice slice, const char *str) {
+    if (str == NULL) return false;
+    return (int) strlen(str) == slice.size && memcmp(slice.data, str, slice.size) == 0;
+}
+
+/**
+ *  Verifica se o registro visto satisfaz um filtro, com a mesma semântica de virtual_registry_compare(),
+ *  mas sem interpretar (nem copiar) os campos que não fazem parte da máscara do filtro.
+ *  Parâmetros:
+ *      RegistryView view -> visão do registro (não removido)
+ *      VirtualRegistryFilter *filter -> filtro com máscara de bits indicando quais campos devem ser comparados
+ *  Retorno:
+ *      bool -> true se todos os campos do filtro forem iguais aos do registro
+ */
+bool registry_view_matches(RegistryView view, VirtualRegistryFilter *filter) {
+    if (filter == NULL) return true;
+    if (view.slot == NULL) return false;
+
+    RegistryFieldsMask mask = filter->fieldMask;
+
+    //Campos estáticos primeiro: são os mais baratos de se comparar
+    if ((mask & MASK_IDNASCIMENTO) && registry_view_get_idNascimento(view) != filter->idNascimento)
+        return false;
+
+    if ((mask & MASK_IDADEMAE) && registry_view_get_idadeMae(view) != filter->idadeMae)
+        return false;
+
+    if ((mask & MASK_SEXOBEBE) && registry_view_get_sexoBebe(view) != filter->sexoBebe)
+        return false;
+
+    if ((mask & MASK_ESTADOMAE) && !_slice_equals(registry_view_get_estadoMae(view), filter->estadoMae))
+        return false;
+
+    if ((mask & MASK_ESTADOBEBE) && !_slice_equals(registry_view_get_estadoBebe(view), filter->estadoBebe))
+        return false;
+
+    if ((mask & MASK_DATANASCIMENTO) && !_slice_equals(registry_view_get_dataNascimento(view), filter->dataNascimento))
+        return false;
+
+    if ((mask & MASK_CIDADEMAE) && !_slice_equals(registry_view_get_cidadeMae(view), filter->cidadeMae))
+        return false;
+
+    if ((mask & MASK_CIDADEBEBE) && !_slice_equals(registry_view_get_cidadeBebe(view), filter->cidadeBebe))
+        return false;
+
+    return true;
+}
+
+/**
+ *  Verifica se o registro visto satisfaz ao menos um dos filtros (equivalente ao virtual_registry_array_contains())
+ *  Parâmetros:
+ *      RegistryView view -> visão do registro (não removido)
+ *      VirtualRegistryArray *filters -> vetor de filtros (NULL indica que qualquer registro é aceito)
+ *  Retorno:
+ *      bool -> true se algum dos filtros for satisfeito
+ */
+bool registry_view_matches_any(RegistryView view, VirtualRegistryArray *filters) {
+    if (filters == NULL) return true;
+
+    for (int i = 0; i < filters->size; i++) {
+        if (registry_view_matches(view, filters->data_arr[i])) return true;
+    }
+
+    return false;
+}
+
+//Imprime um trecho de acordo com as especificações do trabalho (igual ao parse_string_for_print(), mas sem cópia)
+static void _print_slice(RegistryStringSlice slice) {
+    if (slice.size == 0) fputs("-", stdout);
+    else fwrite(slice.data, sizeof(char), slice.size, stdout);
+}
+
+/**
+ *  Printa na tela as informações do registro visto, no mesmo formato de virtual_registry_print()
+ *  Parâmetros:
+ *      RegistryView view -> visão do registro (não removido)
+ *  Retorno: void
+ */
+void registry_view_print(RegistryView view) {
+    if (view.slot == NULL) {
+        DP("Nao ha registro para mostrar em registry_view_print()\n");
+        return;
+    }
+
+    fputs("Nasceu em ", stdout);
+    _print_slice(registry_view_get_cidadeBebe(view));
+    fputs("/", stdout);
+    _print_slice(registry_view_get_estadoBebe(view));
+    fputs(", em ", stdout);
+    _print_slice(registry_view_get_dataNascimento(view));
+    printf(", um bebê de sexo %s.\n", parse_sexoBebe_for_print(registry_view_get_sexoBebe(view)));
+}
@@ -0,0 +1,724 @@
+#define _GNU_SOURCE     //fopencookie()
+
+#include "wal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "debug.h"
+
+/*
+    Formato do log: sequência de registros, cada um com um cabeçalho de WAL_RECORD_HEADER_SIZE bytes
+    (tipo, lote, offset no arquivo de dados e tamanho da imagem), a imagem e um checksum de 4 bytes.
+    Um registro com checksum inválido (escrita interrompida) marca o fim do log.
+        'R' -> imagem final de uma região modificada pelo lote (usada para refazer um lote confirmado)
+        'C' -> confirmação do lote, formado pelos registros 'R' desde a confirmação anterior
+*/
+#define WAL_RECORD_HEADER_SIZE 17
+#define WAL_RECORD_REDO 'R'
+#define WAL_RECORD_COMMIT 'C'
+
+//Maior imagem aceita na leitura do log (valores maiores indicam um registro corrompido)
+#define WAL_MAX_IMAGE_SIZE (1 << 30)
+
+//Tamanho dos blocos em que as escritas do lote ficam guardadas na RAM (o tamanho de um registro de dados)
+#define WAL_BLOCK_SIZE 128
+
+//Tamanho da janela de leitura do arquivo de dados (a stream do log não tem buffer próprio, ver wal_open())
+#define WAL_READ_WINDOW_SIZE (1 << 16)
+
+//Bloco do arquivo de dados modificado pelo lote atual (conteúdo completo do bloco, já com as escritas do lote)
+typedef struct {
+    long number;
+    char data[WAL_BLOCK_SIZE];
+} WalBlock;
+
+//Registro do log já validado, usado na recuperação (a imagem é lida novamente do log apenas se for aplicada)
+typedef struct {
+    char type;
+    long offset;
+    int size;
+    long image_position;
+} WalRecoveryRecord;
+
+/*
+    Struct que representa o log de um arquivo de dados aberto para modificação.
+    O gerenciador passa a usar uma stream do próprio log: as escritas de um lote ficam em blocos na RAM (e as leituras
+    as enxergam) até a confirmação, quando as imagens finais são registradas, o log é sincronizado uma única vez e só
+    então os blocos são escritos no arquivo de dados. Assim, o arquivo de dados nunca recebe escritas de um lote não confirmado.
+*/
+struct _write_ahead_log {
+    FILE *log_file;
+    FILE *data_file;            //Stream original do arquivo de dados (o acesso é feito pelo seu descritor)
+    int data_fd;
+    FILE *stream;               //Stream entregue ao gerenciador no lugar de data_file
+    char *log_filename;
+
+    bool closed;                //true após wal_close(): a stream passa a escrever diretamente no arquivo de dados
+    int batch_id;
+    long position;              //Posição atual da stream
+    long size;                  //Tamanho do arquivo, incluindo o que o lote acrescentou
+    long disk_size;             //Tamanho do arquivo no disco
+
+    WalBlock *blocks;           //Blocos modificados pelo lote atual
+    int block_count;
+    int block_capacity;
+    int *table;                 //Tabela de dispersão número do bloco -> índice+1 em blocks (0 = posição vazia)
+    int table_size;             //Potência de 2
+
+    int pending_operations;     //Operações feitas desde a última confirmação
+    long log_size;
+
+    char *window;               //Janela de leitura: cópia de uma região do arquivo de dados no disco
+    long window_offset;
+    long window_size;           //0 indica janela vazia
+
+    char *buffer;               //Buffer das imagens
+    int buffer_capacity;
+};
+
+
+//Checksum FNV-1a (32 bits), acumulado sobre o cabeçalho e a imagem de cada registro
+static unsigned int _checksum(unsigned int hash, const char *bytes, int size) {
+    for (int i = 0; i < size; i++) {
+        hash ^= (unsigned char) bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//Monta o nome do arquivo de log de um arquivo de dados
+static char *_log_filename(char *data_filename) {
+    char *log_filename = malloc(strlen(data_filename) + strlen(WAL_FILE_SUFFIX) + 1);
+    if (log_filename == NULL) return NULL;
+
+    strcpy(log_filename, data_filename);
+    strcat(log_filename, WAL_FILE_SUFFIX);
+    return log_filename;
+}
+
+//Garante que o buffer de imagens tenha espaço para size bytes
+static bool _reserve_buffer(WriteAheadLog *wal, int size) {
+    if (size <= wal->buffer_capacity) return true;
+
+    char *bigger = realloc(wal->buffer, size);
+    if (bigger == NULL) {
+        DP("ERROR: not enough memory for a log image @_reserve_buffer()\n");
+        return false;
+    }
+
+    wal->buffer = bigger;
+    wal->buffer_capacity = size;
+    return true;
+}
+
+//Lê size bytes do descritor a partir de offset, sem alterar a posição do arquivo
+static long _pread_full(int fd, char *dest, long size, long offset) {
+    long total = 0;
+    while (total < size) {
+        ssize_t read_bytes = pread(fd, dest + total, size - total, offset + total);
+        if (read_bytes <= 0) break;
+        total += read_bytes;
+    }
+    return total;
+}
+
+//Escreve size bytes no descritor a partir de offset, sem alterar a posição do arquivo
+static bool _pwrite_full(int fd, const char *src, long size, long offset) {
+    long total = 0;
+    while (total < size) {
+        ssize_t written = pwrite(fd, src + total, size - total, offset + total);
+        if (written <= 0) return false;
+        total += written;
+    }
+    return true;
+}
+
+/*
+    Acrescenta um registro ao log (apenas no buffer da stream do log)
+    Parametros:
+        wal -> o log
+        type -> tipo do registro ('R' ou 'C')
+        offset -> offset da região no arquivo de dados
+        image -> imagem da região (pode ser NULL se size == 0)
+        size -> tamanho da imagem
+    Retorno:
+        bool. indica se o registro foi escrito
+*/
+static bool _append_record(WriteAheadLog *wal, char type, long offset, const char *image, int size) {
+    char header[WAL_RECORD_HEADER_SIZE];
+    long long offset_ll = offset;
+
+    header[0] = type;
+    memcpy(header + 1, &wal->batch_id, sizeof(int));
+    memcpy(header + 5, &offset_ll, sizeof(long long));
+    memcpy(header + 13, &size, sizeof(int));
+
+    unsigned int checksum = _checksum(_checksum(2166136261u, header, WAL_RECORD_HEADER_SIZE), image, size);
+
+    if (fwrite(header, WAL_RECORD_HEADER_SIZE, 1, wal->log_file) != 1) return false;
+    if (size > 0 && fwrite(image, size, 1, wal->log_file) != 1) return false;
+    if (fwrite(&checksum, sizeof(unsigned int), 1, wal->log_file) != 1) return false;
+
+    wal->log_size += WAL_RECORD_HEADER_SIZE + size + sizeof(unsigned int);
+    return true;
+}
+
+//Descarrega o log até um tamanho dado, descartando o que foi escrito depois (registros de uma confirmação que falhou)
+static void _truncate_log(WriteAheadLog *wal, long log_size) {
+    fflush(wal->log_file);
+    if (ftruncate(fileno(wal->log_file), log_size) != 0) return;
+    fseek(wal->log_file, log_size, SEEK_SET);
+    wal->log_size = log_size;
+}
+
+//Lê uma região do arquivo de dados no disco, completando com zeros o que estiver além do seu fim.
+//Leituras pequenas são feitas pela janela de leitura, que é trazida do disco de WAL_READ_WINDOW_SIZE em WAL_READ_WINDOW_SIZE bytes
+static void _read_disk(WriteAheadLog *wal, char *dest, long size, long offset) {
+    if (wal->window != NULL && (offset < wal->window_offset || offset + size > wal->window_offset + wal->window_size)
+        && size <= WAL_READ_WINDOW_SIZE / 2) {
+        wal->window_offset = offset - offset % WAL_BLOCK_SIZE;
+        wal->window_size = _pread_full(wal->data_fd, wal->window, WAL_READ_WINDOW_SIZE, wal->window_offset);
+        if (wal->window_size < 0) wal->window_size = 0;
+    }
+
+    long read_bytes;
+    if (wal->window != NULL && offset >= wal->window_offset && offset + size <= wal->window_offset + wal->window_size) {
+        memcpy(dest, wal->window + (offset - wal->window_offset), size);
+        read_bytes = size;
+    } else {
+        read_bytes = _pread_full(wal->data_fd, dest, size, offset);
+        if (read_bytes < 0) read_bytes = 0;
+    }
+
+    memset(dest + read_bytes, 0, size - read_bytes);
+}
+
+//Posição de um bloco na tabela de dispersão (a posição vazia onde ele entraria, se ele não estiver no lote)
+static int _block_slot(WriteAheadLog *wal, long number) {
+    unsigned int mask = wal->table_size - 1;
+    unsigned int slot = ((unsigned long) number * 2654435761u) & mask;
+    while (wal->table[slot] != 0 && wal->blocks[wal->table[slot]-1].number != number) slot = (slot + 1) & mask;
+    return slot;
+}
+
+//Refaz a tabela de dispersão com todos os blocos do lote, com um tamanho dado (ocupação abaixo da metade)
+static bool _index_blocks(WriteAheadLog *wal, int table_size) {
+    if (table_size != wal->table_size) {
+        int *table = realloc(wal->table, table_size * sizeof(int));
+        if (table == NULL) return false;
+        wal->table = table;
+        wal->table_size = table_size;
+    }
+
+    memset(wal->table, 0, wal->table_size * sizeof(int));
+    for (int i = 0; i < wal->block_count; i++) wal->table[_block_slot(wal, wal->blocks[i].number)] = i + 1;
+    return true;
+}
+
+/*
+    Funcao (privada) que busca um bloco modificado pelo lote atual
+    Retorno:
+        WalBlock* . o bloco, ou NULL se ele não foi modificado pelo lote
+*/
+static WalBlock *_find_block(WriteAheadLog *wal, long number) {
+    if (wal->block_count == 0) return NULL;
+
+    int index = wal->table[_block_slot(wal, number)];
+    return (index != 0) ? &wal->blocks[index-1] : NULL;
+}
+
+/*
+    Funcao (privada) que obtém um bloco para ser modificado pelo lote, trazendo seu conteúdo do disco na primeira modificação
+    Retorno:
+        WalBlock* . o bloco, ou NULL se faltar memória
+*/
+static WalBlock *_stage_block(WriteAheadLog *wal, long number) {
+    WalBlock *block = _find_block(wal, number);
+    if (block != NULL) return block;
+
+    if (wal->block_count == wal->block_capacity) {
+        int capacity = (wal->block_capacity == 0) ? 256 : 2 * wal->block_capacity;
+        WalBlock *blocks = realloc(wal->blocks, capacity * sizeof(WalBlock));
+        if (blocks == NULL) {
+            DP("ERROR: not enough memory for the batch blocks @_stage_block()\n");
+            return NULL;
+        }
+
+        wal->blocks = blocks;
+        wal->block_capacity = capacity;
+    }
+
+    if (2 * (wal->block_count + 1) > wal->table_size && !_index_blocks(wal, (wal->table_size > 0) ? 2 * wal->table_size : 512)) {
+        DP("ERROR: not enough memory for the batch blocks @_stage_block()\n");
+        return NULL;
+    }
+
+    block = &wal->blocks[wal->block_count];
+    block->number = number;
+    _read_disk(wal, block->data, WAL_BLOCK_SIZE, number * WAL_BLOCK_SIZE);
+    wal->table[_block_slot(wal, number)] = ++wal->block_count;
+    return block;
+}
+
+/*
+    Leitura da stream do gerenciador: os blocos modificados pelo lote vêm da RAM e os demais, do disco
+    (blocos seguidos que não foram modificados são lidos de uma só vez)
+*/
+static ssize_t _stream_read(void *cookie, char *dest, size_t size) {
+    WriteAheadLog *wal = cookie;
+    if (wal->position >= wal->size) return 0;
+    if ((long) size > wal->size - wal->position) size = wal->size - wal->position;
+
+    size_t done = 0;
+    while (done < size) {
+        long offset = wal->position + done;
+        size_t piece = WAL_BLOCK_SIZE - offset % WAL_BLOCK_SIZE;
+        WalBlock *block = _find_block(wal, offset / WAL_BLOCK_SIZE);
+
+        if (block != NULL) {
+            if (piece > size - done) piece = size - done;
+            memcpy(dest + done, block->data + offset % WAL_BLOCK_SIZE, piece);
+        } else {
+            while (done + piece < size && _find_block(wal, (offset + piece) / WAL_BLOCK_SIZE) == NULL) piece += WAL_BLOCK_SIZE;
+            if (piece > size - done) piece = size - done;
+            _read_disk(wal, dest + done, piece, offset);
+        }
+
+        done += piece;
+    }
+
+    wal->position += done;
+    return done;
+}
+
+//Escrita da stream do gerenciador: dentro de um lote, apenas nos blocos em RAM; após wal_close(), diretamente no disco
+static ssize_t _stream_write(void *cookie, const char *src, size_t size) {
+    WriteAheadLog *wal = cookie;
+
+    if (wal->closed) {
+        wal->window_size = 0;
+        if (!_pwrite_full(wal->data_fd, src, size, wal->position)) return -1;
+    } else {
+        size_t done = 0;
+        while (done < size) {
+            long offset = wal->position + done;
+            size_t piece = WAL_BLOCK_SIZE - offset % WAL_BLOCK_SIZE;
+            if (piece > size - done) piece = size - done;
+
+            WalBlock *block = _stage_block(wal, offset / WAL_BLOCK_SIZE);
+            if (block == NULL) return (done > 0) ? (ssize_t) done : -1;
+
+            memcpy(block->data + offset % WAL_BLOCK_SIZE, src + done, piece);
+            done += piece;
+        }
+    }
+
+    wal->position += size;
+    if (wal->position > wal->size) wal->size = wal->position;
+    if (wal->closed && wal->size > wal->disk_size) wal->disk_size = wal->size;
+    return size;
+}
+
+static int _stream_seek(void *cookie, off64_t *offset, int whence) {
+    WriteAheadLog *wal = cookie;
+
+    long base = (whence == SEEK_SET) ? 0 : (whence == SEEK_CUR) ? wal->position : wal->size;
+    if (base + *offset < 0) return -1;
+
+    wal->position = base + *offset;
+    *offset = wal->position;
+    return 0;
+}
+
+//Fechamento da stream do gerenciador: fecha o arquivo de dados e libera o log (o lote aberto, se houver, é perdido)
+static int _stream_close(void *cookie) {
+    WriteAheadLog *wal = cookie;
+
+    if (!wal->closed) {
+        DP("WARNING: closing a logged file without wal_close(), its open batch is lost @_stream_close()\n");
+        fclose(wal->log_file);
+    }
+
+    int result = fclose(wal->data_file);
+    free(wal->log_filename);
+    free(wal->blocks);
+    free(wal->table);
+    free(wal->window);
+    free(wal->buffer);
+    free(wal);
+    return result;
+}
+
+//Função de comparação usada no qsort dos blocos: ordena por número
+static int _compare_blocks(const void *a, const void *b) {
+    long number_a = ((const WalBlock*) a)->number;
+    long number_b = ((const WalBlock*) b)->number;
+    return (number_a > number_b) - (number_a < number_b);
+}
+
+/*
+    Funcao (privada) que monta no buffer a imagem de uma sequência de blocos contíguos do lote (já ordenado),
+    limitada ao tamanho do arquivo
+    Parametros:
+        wal -> o log
+        first -> índice do primeiro bloco da sequência
+        count_ptr -> recebe a quantidade de blocos da sequência
+    Retorno:
+        int. tamanho da imagem, ou -1 se faltar memória
+*/
+static int _run_image(WriteAheadLog *wal, int first, int *count_ptr) {
+    int count = 1;
+    while (first + count < wal->block_count && wal->blocks[first+count].number == wal->blocks[first].number + count) count++;
+    *count_ptr = count;
+
+    long offset = wal->blocks[first].number * WAL_BLOCK_SIZE;
+    long size = (long) count * WAL_BLOCK_SIZE;
+    if (offset + size > wal->size) size = wal->size - offset;
+    if (size <= 0) return 0;
+    if (!_reserve_buffer(wal, size)) return -1;
+
+    for (int i = 0; i < count; i++) {
+        long piece = size - (long) i * WAL_BLOCK_SIZE;
+        if (piece > WAL_BLOCK_SIZE) piece = WAL_BLOCK_SIZE;
+        if (piece > 0) memcpy(wal->buffer + (long) i * WAL_BLOCK_SIZE, wal->blocks[first+i].data, piece);
+    }
+    return size;
+}
+
+/*
+    Sincroniza o arquivo de dados e esvazia o log. Só pode ser feito entre lotes,
+    quando todas as modificações já foram confirmadas e escritas
+*/
+static bool _checkpoint(WriteAheadLog *wal) {
+    if (fsync(wal->data_fd) != 0) return false;
+    if (fflush(wal->log_file) != 0 || ftruncate(fileno(wal->log_file), 0) != 0) return false;
+
+    fseek(wal->log_file, 0, SEEK_SET);
+    wal->log_size = 0;
+    return true;
+}
+
+
+/**
+ *  Cria o log de um arquivo de dados aberto para modificação (ao lado dele, com o sufixo WAL_FILE_SUFFIX).
+ *  A stream do arquivo passa a ser a stream do log, que guarda as escritas de cada lote na RAM até a sua confirmação:
+ *  *data_file_ptr é trocado por ela (a stream original fica com o log e é fechada junto com a nova, por fclose()).
+ *  Um log anterior deve ter sido recuperado com wal_recover() antes da abertura do arquivo de dados.
+ *  Parâmetros:
+ *      char *data_filename -> nome do arquivo de dados
+ *      FILE **data_file_ptr -> endereço da stream do arquivo de dados, aberta em modo que permita escrita
+ *  Retorno:
+ *      WriteAheadLog* -> o log criado, ou NULL em caso de erro (a stream original continua sendo usada, sem log)
+ */
+WriteAheadLog *wal_open(char *data_filename, FILE **data_file_ptr) {
+    if (data_filename == NULL || data_file_ptr == NULL || *data_file_ptr == NULL) {
+        DP("ERROR: invalid parameters @wal_open()\n");
+        return NULL;
+    }
+
+    WriteAheadLog *wal = calloc(1, sizeof(WriteAheadLog));
+    if (wal == NULL) {
+        DP("ERROR: not enough memory for WriteAheadLog @wal_open()\n");
+        return NULL;
+    }
+
+    //A partir daqui o arquivo de dados só é acessado pelo descritor, na posição da stream original
+    struct stat file_stat;
+    wal->data_file = *data_file_ptr;
+    wal->data_fd = fileno(wal->data_file);
+    wal->position = ftell(wal->data_file);
+    bool ok = fflush(wal->data_file) == 0 && fstat(wal->data_fd, &file_stat) == 0 && wal->position >= 0;
+    wal->size = wal->disk_size = ok ? file_stat.st_size : 0;
+
+    wal->log_filename = _log_filename(data_filename);
+    if (ok && wal->log_filename != NULL) wal->log_file = fopen(wal->log_filename, "wb");
+
+    //A glibc não atualiza a posição que guarda de uma stream criada por fopencookie() quando descarrega as escritas
+    //pendentes dentro de um fseek(): um fseek(SEEK_CUR) logo após um fwrite() iria para a posição errada, então quem
+    //escreve pela stream só faz seeks absolutos (SEEK_SET/SEEK_END). Sem buffer, a glibc leria byte a byte
+    cookie_io_functions_t functions = {_stream_read, _stream_write, _stream_seek, _stream_close};
+    wal->window = malloc(WAL_READ_WINDOW_SIZE);
+    if (wal->log_file != NULL && wal->window != NULL) wal->stream = fopencookie(wal, "r+", functions);
+
+    if (wal->stream == NULL) {
+        DP("ERROR: couldn't create the log file @wal_open()\n");
+        if (wal->log_file != NULL) {
+            fclose(wal->log_file);
+            remove(wal->log_filename);
+        }
+        free(wal->log_filename);
+        free(wal->window);
+        free(wal);
+        return NULL;
+    }
+
+    *data_file_ptr = wal->stream;
+    return wal;
+}
+
+/**
+ *  Contabiliza operações feitas no arquivo de dados, para a confirmação em grupo
+ *  Parâmetros:
+ *      WriteAheadLog *wal -> o log (NULL indica que o arquivo não tem log)
+ *      int count -> quantidade de operações feitas
+ *  Retorno:
+ *      bool -> true se o grupo atingiu WAL_GROUP_COMMIT_OPERATIONS e deve ser confirmado (wal_commit)
+ */
+bool wal_end_operations(WriteAheadLog *wal, int count) {
+    if (wal == NULL) return false;
+
+    wal->pending_operations += count;
+    return wal->pending_operations >= WAL_GROUP_COMMIT_OPERATIONS;
+}
+
+/**
+ *  Confirma o lote atual: registra a imagem final dos blocos modificados, sincroniza o log (um único fsync por lote)
+ *  e só então escreve os blocos no arquivo de dados. As escritas do lote já devem ter sido feitas na stream.
+ *  Quando o log ultrapassa WAL_CHECKPOINT_BYTES, o arquivo de dados é sincronizado e o log esvaziado.
+ *  Parâmetros:
+ *      WriteAheadLog *wal -> o log (NULL indica que o arquivo não tem log, e nada é feito)
+ *  Retorno:
+ *      bool -> indica se o lote foi confirmado e escrito (se não, os blocos continuam na RAM, no lote seguinte)
+ */
+bool wal_commit(WriteAheadLog *wal) {
+    if (wal == NULL) return true;
+
+    wal->pending_operations = 0;
+    if (wal->closed || fflush(wal->stream) != 0) return false;
+    if (wal->block_count == 0) return true;
+
+    //Ordena os blocos, para que o log e o arquivo de dados sejam escritos sequencialmente e blocos contíguos formem uma única imagem
+    qsort(wal->blocks, wal->block_count, sizeof(WalBlock), _compare_blocks);
+
+    long log_size = wal->log_size;
+    bool logged = true;
+    for (int i = 0, count; logged && i < wal->block_count; i += count) {
+        int size = _run_image(wal, i, &count);
+        logged = size >= 0 && _append_record(wal, WAL_RECORD_REDO, wal->blocks[i].number * WAL_BLOCK_SIZE, wal->buffer, size);
+    }
+    logged = logged && _append_record(wal, WAL_RECORD_COMMIT, 0, NULL, 0) && fflush(wal->log_file) == 0
+        && fsync(fileno(wal->log_file)) == 0;
+
+    if (!logged) {
+        DP("ERROR: couldn't sync the log @wal_commit()\n");
+        _truncate_log(wal, log_size);
+        _index_blocks(wal, wal->table_size);
+        return false;
+    }
+
+    //O lote já pode ser refeito pelo log: os blocos são escritos no arquivo de dados
+    wal->window_size = 0;
+    bool written = true;
+    for (int i = 0, count; written && i < wal->block_count; i += count) {
+        int size = _run_image(wal, i, &count);
+        written = size >= 0 && _pwrite_full(wal->data_fd, wal->buffer, size, wal->blocks[i].number * WAL_BLOCK_SIZE);
+    }
+
+    if (!written) {
+        DP("ERROR: couldn't write the batch to the data file @wal_commit()\n");
+        _index_blocks(wal, wal->table_size);
+        return false;
+    }
+
+    if (wal->size > wal->disk_size) wal->disk_size = wal->size;
+    wal->block_count = 0;
+    memset(wal->table, 0, wal->table_size * sizeof(int));
+    wal->batch_id++;
+
+    if (wal->log_size >= WAL_CHECKPOINT_BYTES) return _checkpoint(wal);
+    return true;
+}
+
+/**
+ *  Confirma o que estiver pendente, sincroniza o arquivo de dados e remove o log. A partir daí, a stream do arquivo
+ *  escreve diretamente no disco, e a memória do log é liberada quando ela for fechada (fclose).
+ *  Se algo falhar, o lote aberto é perdido e o log é mantido no disco, para ser recuperado na próxima abertura.
+ *  Parâmetros:
+ *      WriteAheadLog **wal_ptr -> endereço do log
+ *  Retorno: void
+ */
+void wal_close(WriteAheadLog **wal_ptr) {
+    if (wal_ptr == NULL || *wal_ptr == NULL) return;
+    #define wal (*wal_ptr)
+
+    bool synced = wal_commit(wal) && fsync(wal->data_fd) == 0;
+
+    fclose(wal->log_file);
+    wal->log_file = NULL;
+    if (synced) remove(wal->log_filename);
+    else DP("WARNING: keeping the log of an unsynced file @wal_close()\n");
+
+    //Um lote que não pôde ser confirmado é descartado, como em uma queda
+    wal->block_count = 0;
+    wal->size = wal->disk_size;
+    wal->closed = true;
+    wal = NULL;
+
+    #undef wal
+}
+
+/**
+ *  Indica se um arquivo de dados tem um log, ou seja, se ele está sendo modificado ou não foi fechado corretamente
+ *  (e deve ser recuperado com wal_recover() antes de ser lido)
+ *  Parâmetros:
+ *      char *data_filename -> nome do arquivo de dados
+ *  Retorno:
+ *      bool -> true se o log existe
+ */
+bool wal_exists(char *data_filename) {
+    if (data_filename == NULL) return false;
+
+    char *log_filename = _log_filename(data_filename);
+    if (log_filename == NULL) return false;
+
+    bool exists = access(log_filename, F_OK) == 0;
+    free(log_filename);
+    return exists;
+}
+
+/**
+ *  Remove o log de um arquivo de dados, se existir. Usado quando o arquivo é recriado, para que
+ *  um log antigo não seja aplicado ao arquivo novo.
+ *  Parâmetros:
+ *      char *data_filename -> nome do arquivo de dados
+ *  Retorno: void
+ */
+void wal_discard(char *data_filename) {
+    if (data_filename == NULL) return;
+
+    char *log_filename = _log_filename(data_filename);
+    if (log_filename == NULL) return;
+
+    remove(log_filename);
+    free(log_filename);
+}
+
+
+/*
+    Lê o próximo registro do log, validando seu checksum
+    Parametros:
+        log_file -> stream do log
+        record -> onde o registro será guardado
+        buffer_ptr, capacity_ptr -> buffer usado para a leitura da imagem (aumentado se necessário)
+    Retorno:
+        bool. false se não houver um registro válido (fim do log ou escrita interrompida)
+*/
+static bool _read_record(FILE *log_file, WalRecoveryRecord *record, char **buffer_ptr, int *capacity_ptr) {
+    char header[WAL_RECORD_HEADER_SIZE];
+    long long offset_ll;
+    unsigned int checksum;
+
+    if (fread(header, WAL_RECORD_HEADER_SIZE, 1, log_file) != 1) return false;
+
+    record->type = header[0];
+    memcpy(&offset_ll, header + 5, sizeof(long long));
+    memcpy(&record->size, header + 13, sizeof(int));
+    record->offset = offset_ll;
+
+    if (record->type != WAL_RECORD_REDO && record->type != WAL_RECORD_COMMIT) return false;
+    if (record->offset < 0 || record->size < 0 || record->size > WAL_MAX_IMAGE_SIZE) return false;
+
+    if (record->size > *capacity_ptr) {
+        char *bigger = realloc(*buffer_ptr, record->size);
+        if (bigger == NULL) return false;
+        *buffer_ptr = bigger;
+        *capacity_ptr = record->size;
+    }
+
+    record->image_position = ftell(log_file);
+    if (record->size > 0 && fread(*buffer_ptr, record->size, 1, log_file) != 1) return false;
+    if (fread(&checksum, sizeof(unsigned int), 1, log_file) != 1) return false;
+
+    return checksum == _checksum(_checksum(2166136261u, header, WAL_RECORD_HEADER_SIZE), *buffer_ptr, record->size);
+}
+
+//Copia a imagem de um registro do log para sua região no arquivo de dados
+static bool _apply_record(FILE *log_file, int data_fd, WalRecoveryRecord *record, char *buffer) {
+    if (record->size == 0) return true;
+
+    fseek(log_file, record->image_position, SEEK_SET);
+    if (fread(buffer, record->size, 1, log_file) != 1) return false;
+    return _pwrite_full(data_fd, buffer, record->size, record->offset);
+}
+
+/**
+ *  Recupera um arquivo de dados a partir do seu log, caso ele exista (o arquivo não foi fechado corretamente).
+ *  Os lotes confirmados são refeitos e o arquivo volta a ser consistente (um lote não confirmado nunca chegou ao
+ *  arquivo de dados e é apenas descartado). Deve ser chamada antes da abertura do arquivo de dados para modificação;
+ *  nos modos de leitura, um arquivo com log (wal_exists()) deve ser tratado como inconsistente.
+ *  Parâmetros:
+ *      char *data_filename -> nome do arquivo de dados
+ *      long status_offset -> posição, no arquivo de dados, do byte de status do header
+ *      char consistent_status -> valor do status que indica um arquivo consistente
+ *  Retorno:
+ *      bool -> false se havia um log e a recuperação falhou (o log é mantido)
+ */
+bool wal_recover(char *data_filename, long status_offset, char consistent_status) {
+    if (data_filename == NULL) return false;
+
+    char *log_filename = _log_filename(data_filename);
+    if (log_filename == NULL) return false;
+
+    //Sem log, não há nada a ser recuperado
+    FILE *log_file = fopen(log_filename, "rb");
+    if (log_file == NULL) {
+        free(log_filename);
+        return true;
+    }
+
+    int data_fd = open(data_filename, O_RDWR);
+    if (data_fd < 0) {
+        DP("ERROR: couldn't open the data file to recover it @wal_recover()\n");
+        fclose(log_file);
+        free(log_filename);
+        return false;
+    }
+
+    //Primeira passada: obtém todos os registros válidos do log
+    WalRecoveryRecord *records = NULL;
+    int record_count = 0, record_capacity = 0;
+    char *buffer = NULL;
+    int buffer_capacity = 0;
+    bool ok = true;
+
+    WalRecoveryRecord record;
+    while (ok && _read_record(log_file, &record, &buffer, &buffer_capacity)) {
+        if (record_count == record_capacity) {
+            int capacity = (record_capacity == 0) ? 256 : 2 * record_capacity;
+            WalRecoveryRecord *bigger = realloc(records, capacity * sizeof(WalRecoveryRecord));
+            if (bigger == NULL) ok = false;
+            else {
+                records = bigger;
+                record_capacity = capacity;
+            }
+        }
+        if (ok) records[record_count++] = record;
+    }
+
+    //Segunda passada: refaz os lotes confirmados, na ordem do log (os registros após a última confirmação são descartados)
+    int batch_first = 0;
+    for (int i = 0; ok && i < record_count; i++) {
+        if (records[i].type != WAL_RECORD_COMMIT) continue;
+
+        for (int j = batch_first; ok && j < i; j++) ok = _apply_record(log_file, data_fd, &records[j], buffer);
+        batch_first = i + 1;
+    }
+
+    //Marca o arquivo como consistente e só então descarta o log
+    ok = ok && _pwrite_full(data_fd, &consistent_status, 1, status_offset) && fsync(data_fd) == 0;
+
+    close(data_fd);
+    fclose(log_file);
+    if (ok) remove(log_filename);
+    else DP("ERROR: couldn't recover the data file from its log @wal_recover()\n");
+
+    free(records);
+    free(buffer);
+    free(log_filename);
+    return ok;
+}
@@ -0,0 +1,48 @@
+#!/bin/bash
+# Verifica que a cópia colunar (<arquivo>.cols) é rejeitada quando o arquivo de registros é atualizado por um programa
+# que não a mantém, e que ela é reconstruída em seguida pela funcionalidade 25.
+# Uso: tests/column_store_stale.sh [caminho do prog]
+
+PROG=$(realpath "${1:-./prog}")
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+cd "$DIR" || exit 1
+
+run() { printf '%s\n' "$1" | "$PROG"; }
+fail() { echo "FALHOU: $1"; exit 1; }
+
+cat > t.csv <<'CSV'
+cidadeMae,cidadeBebe,idNascimento,idadeMae,dataNascimento,sexoBebe,estadoMae,estadoBebe
+SAO CARLOS,CAMPINAS,1,20,2010-01-01,1,SP,SP
+RIO DE JANEIRO,NITEROI,2,25,2011-02-02,2,RJ,RJ
+CURITIBA,LONDRINA,3,30,2012-03-03,0,PR,PR
+BELO HORIZONTE,CONTAGEM,4,35,2013-04-04,1,MG,MG
+PORTO ALEGRE,CANOAS,5,22,2014-05-05,2,RS,RS
+SALVADOR,FEIRA DE SANTANA,6,28,2015-06-06,1,BA,BA
+RECIFE,OLINDA,7,31,2016-07-07,2,PE,PE
+FORTALEZA,SOBRAL,8,27,2017-08-08,0,CE,CE
+CSV
+
+run '1 t.csv t.bin' > /dev/null
+run '24 t.bin' > /dev/null
+[ -f t.bin.cols ] || fail "a funcionalidade 24 não criou a cópia colunar"
+
+# Atualização feita sem a cópia colunar (como a funcionalidade 7 de um programa que não a mantém):
+# estadoMae do RRN 0 passa a ser "AC" e a quantidade de atualizados do header (offset 13) é incrementada
+printf 'AC' | dd of=t.bin bs=1 seek=$((128 + 124)) conv=notrunc status=none
+updated=$(( $(od -An -tu4 -j13 -N4 t.bin) + 1 ))
+printf "$(printf '\\x%02x\\x%02x\\x%02x\\x%02x' $((updated & 255)) $((updated >> 8 & 255)) $((updated >> 16 & 255)) $((updated >> 24 & 255)))" \
+    | dd of=t.bin bs=1 seek=13 conv=notrunc status=none
+
+# A cópia desatualizada deve ser ignorada: a busca encontra o registro atualizado e a agregação o conta
+run '3 t.bin
+1 estadoMae "AC"' | grep -q "^Nasceu em CAMPINAS/SP" || fail "a busca usou a cópia colunar desatualizada"
+[ "$(run '25 t.bin estadoMae
+0' | grep '^AC:')" = "AC: 1" ] || fail "a agregação usou a cópia colunar desatualizada"
+
+# A funcionalidade 25 reconstrói a cópia, agora identificada pela nova quantidade de atualizados
+[ "$(od -An -tu4 -j16 -N4 t.bin.cols | tr -d ' ')" = "$updated" ] || fail "a cópia colunar não foi reconstruída"
+[ "$(run '25 t.bin estadoMae
+0' | grep -c ':')" = "8" ] || fail "a cópia colunar reconstruída não corresponde ao arquivo"
+
+echo "OK"